@@ -0,0 +1,520 @@
+#ifndef OHMY_ALLOCATION_TRACKING_HPP
+#define OHMY_ALLOCATION_TRACKING_HPP
+
+#include "c++config.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// Per-thread allocation counters, and the allocator and deleter that feed
+// them. allocation_scope takes a snapshot of the calling thread's counters,
+// so a test can assert that a call performs no allocations:
+//
+//     ohmy::allocation_scope scope;
+//     text.find("needle");
+//     REQUIRE(scope.allocations() == 0);
+//
+// Only tracking_allocator, make_tracked_unique and tracked_delete report to
+// the counters by default. Defining OHMY_TRACK_GLOBAL_ALLOCATIONS before
+// including this header in exactly one translation unit also replaces the
+// global operator new and delete, so every allocation made through them is
+// counted; ohmy::allocator goes to malloc directly and is only seen when
+// wrapped in a tracking_allocator. Memory freed on another thread than the
+// one that allocated it is credited to the freeing thread, so live_bytes can
+// go negative.
+namespace ohmy
+{
+struct allocation_stats
+{
+    static constexpr size_t histogram_buckets = 16;
+
+    // Bucket 0 counts allocations of at most 16 bytes, bucket i those of at
+    // most 16 << i bytes, and the last bucket everything larger.
+    static constexpr size_t bucket_for(size_t bytes) noexcept
+    {
+        size_t bucket = 0;
+        while (bucket + 1 < histogram_buckets and bytes > bucket_limit(bucket))
+        {
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    static constexpr size_t bucket_limit(size_t bucket) noexcept
+    {
+        return size_t{16} << bucket;
+    }
+
+    size_t allocations;
+    size_t deallocations;
+    size_t bytes_allocated;
+    size_t bytes_deallocated;
+    long long live_bytes;
+    long long peak_live_bytes;
+    size_t histogram[histogram_buckets];
+};
+
+// Zero-initialized without a constructor, so it is safe to touch from a
+// replaced operator new before and after the thread's dynamic
+// initialization.
+inline allocation_stats& thread_allocation_stats() noexcept
+{
+    thread_local allocation_stats stats;
+    return stats;
+}
+
+inline void record_allocation(size_t bytes) noexcept
+{
+    allocation_stats& stats = thread_allocation_stats();
+    ++stats.allocations;
+    stats.bytes_allocated += bytes;
+    stats.live_bytes += static_cast<long long>(bytes);
+    if (stats.live_bytes > stats.peak_live_bytes)
+    {
+        stats.peak_live_bytes = stats.live_bytes;
+    }
+    ++stats.histogram[allocation_stats::bucket_for(bytes)];
+}
+
+inline void record_deallocation(size_t bytes) noexcept
+{
+    allocation_stats& stats = thread_allocation_stats();
+    ++stats.deallocations;
+    stats.bytes_deallocated += bytes;
+    stats.live_bytes -= static_cast<long long>(bytes);
+}
+
+// Reports the difference between the calling thread's counters at
+// construction and now. While the scope is alive the peak is measured from
+// the live byte count at construction; nested scopes see their own peaks and
+// the enclosing peak is restored on destruction.
+class allocation_scope
+{
+public:
+    allocation_scope() noexcept : m_start{thread_allocation_stats()}
+    {
+        allocation_stats& stats = thread_allocation_stats();
+        stats.peak_live_bytes = stats.live_bytes;
+    }
+
+    ~allocation_scope()
+    {
+        allocation_stats& stats = thread_allocation_stats();
+        if (m_start.peak_live_bytes > stats.peak_live_bytes)
+        {
+            stats.peak_live_bytes = m_start.peak_live_bytes;
+        }
+    }
+
+    allocation_scope(const allocation_scope&) = delete;
+    allocation_scope& operator=(const allocation_scope&) = delete;
+
+    size_t allocations() const noexcept
+    {
+        return thread_allocation_stats().allocations - m_start.allocations;
+    }
+
+    size_t deallocations() const noexcept
+    {
+        return thread_allocation_stats().deallocations - m_start.deallocations;
+    }
+
+    size_t bytes_allocated() const noexcept
+    {
+        return thread_allocation_stats().bytes_allocated -
+               m_start.bytes_allocated;
+    }
+
+    size_t bytes_deallocated() const noexcept
+    {
+        return thread_allocation_stats().bytes_deallocated -
+               m_start.bytes_deallocated;
+    }
+
+    // Bytes allocated in the scope and not yet freed.
+    long long live_bytes() const noexcept
+    {
+        return thread_allocation_stats().live_bytes - m_start.live_bytes;
+    }
+
+    long long peak_live_bytes() const noexcept
+    {
+        return thread_allocation_stats().peak_live_bytes - m_start.live_bytes;
+    }
+
+    allocation_stats stats() const noexcept
+    {
+        const allocation_stats& now = thread_allocation_stats();
+        allocation_stats delta = {};
+        delta.allocations = allocations();
+        delta.deallocations = deallocations();
+        delta.bytes_allocated = bytes_allocated();
+        delta.bytes_deallocated = bytes_deallocated();
+        delta.live_bytes = live_bytes();
+        delta.peak_live_bytes = peak_live_bytes();
+        for (size_t i = 0; i < allocation_stats::histogram_buckets; ++i)
+        {
+            delta.histogram[i] = now.histogram[i] - m_start.histogram[i];
+        }
+        return delta;
+    }
+
+private:
+    allocation_stats m_start;
+};
+
+// Forwards to Allocator and records every allocation and deallocation in
+// the calling thread's counters.
+template <typename Type, typename Allocator = allocator<Type>>
+class tracking_allocator
+{
+public:
+    using value_type = Type;
+
+    template <typename Other>
+    struct rebind
+    {
+        using other =
+            tracking_allocator<Other, detail::rebind_alloc_t<Allocator, Other>>;
+    };
+
+    constexpr tracking_allocator() = default;
+
+    explicit tracking_allocator(const Allocator& alloc) : m_allocator{alloc}
+    {
+    }
+
+    template <typename Other, typename OtherAllocator>
+    tracking_allocator(const tracking_allocator<Other, OtherAllocator>& other)
+        : m_allocator{other.underlying()}
+    {
+    }
+
+    Type* allocate(size_t count)
+    {
+        Type* result = m_allocator.allocate(count);
+        record_allocation(count * sizeof(Type));
+        return result;
+    }
+
+    void deallocate(Type* ptr, size_t count) noexcept
+    {
+        m_allocator.deallocate(ptr, count);
+        record_deallocation(count * sizeof(Type));
+    }
+
+    // Counted as freeing the old block and allocating the new one.
+    template <typename Underlying = Allocator,
+              typename = enable_if_t<detail::has_reallocate_v<Underlying>>>
+    Type* reallocate(Type* ptr, size_t old_count, size_t new_count)
+    {
+        Type* result = m_allocator.reallocate(ptr, old_count, new_count);
+        record_deallocation(old_count * sizeof(Type));
+        record_allocation(new_count * sizeof(Type));
+        return result;
+    }
+
+    const Allocator& underlying() const noexcept
+    {
+        return m_allocator;
+    }
+
+    template <typename Other, typename OtherAllocator>
+    bool operator==(
+        const tracking_allocator<Other, OtherAllocator>& other) const
+    {
+        return m_allocator == other.underlying();
+    }
+
+    template <typename Other, typename OtherAllocator>
+    bool operator!=(
+        const tracking_allocator<Other, OtherAllocator>& other) const
+    {
+        return not(*this == other);
+    }
+
+private:
+    [[no_unique_address]] Allocator m_allocator;
+};
+
+// Deleter for objects created by make_tracked_unique. The storage comes
+// from ohmy::allocator rather than operator new, so it is counted once even
+// when the global operators are tracked as well.
+template <typename Type>
+struct tracked_delete
+{
+    constexpr tracked_delete() noexcept = default;
+
+    void operator()(Type* ptr) const noexcept
+    {
+        static_assert(sizeof(Type) > 0,
+                      "cannot delete pointer to incomplete type");
+        ohmy::destroy_at(ptr);
+        allocator<Type>{}.deallocate(ptr, 1);
+        record_deallocation(sizeof(Type));
+    }
+};
+
+template <typename Type>
+class tracked_delete<Type[]>
+{
+public:
+    constexpr tracked_delete() noexcept = default;
+
+    constexpr explicit tracked_delete(size_t count) noexcept : m_count{count}
+    {
+    }
+
+    void operator()(Type* ptr) const noexcept
+    {
+        static_assert(sizeof(Type) > 0,
+                      "cannot delete pointer to incomplete type");
+        ohmy::destroy(ptr, ptr + m_count);
+        allocator<Type>{}.deallocate(ptr, m_count);
+        record_deallocation(m_count * sizeof(Type));
+    }
+
+    size_t size() const noexcept
+    {
+        return m_count;
+    }
+
+private:
+    size_t m_count = 0;
+};
+
+template <typename Type, typename... ArgumentTypes>
+enable_if_t<not is_array_v<Type>, unique_ptr<Type, tracked_delete<Type>>>
+make_tracked_unique(ArgumentTypes&&... arguments)
+{
+    Type* storage = allocator<Type>{}.allocate(1);
+    try
+    {
+        ohmy::construct_at(storage, ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+    catch (...)
+    {
+        allocator<Type>{}.deallocate(storage, 1);
+        throw;
+    }
+    record_allocation(sizeof(Type));
+    return unique_ptr<Type, tracked_delete<Type>>(storage);
+}
+
+template <typename Type>
+enable_if_t<is_array_v<Type> and extent_v<Type> == 0,
+            unique_ptr<Type, tracked_delete<Type>>>
+make_tracked_unique(size_t count)
+{
+    using element_type = remove_extent_t<Type>;
+    element_type* storage = allocator<element_type>{}.allocate(count);
+    try
+    {
+        ohmy::uninitialized_value_construct_n(storage, count);
+    }
+    catch (...)
+    {
+        allocator<element_type>{}.deallocate(storage, count);
+        throw;
+    }
+    record_allocation(count * sizeof(element_type));
+    return unique_ptr<Type, tracked_delete<Type>>(storage,
+                                                  tracked_delete<Type>{count});
+}
+
+namespace detail
+{
+// The replaced global operators keep the requested size in front of the
+// block, so that unsized operator delete can report it.
+inline size_t tracked_header_size(size_t alignment) noexcept
+{
+    return alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__
+               ? alignment
+               : __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+inline void* tracked_try_allocate(size_t bytes, size_t alignment) noexcept
+{
+    const size_t header = tracked_header_size(alignment);
+    size_t total;
+    if (__builtin_add_overflow(bytes, header, &total))
+    {
+        return nullptr;
+    }
+
+    void* block;
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        if (__builtin_add_overflow(total, alignment - 1, &total))
+        {
+            return nullptr;
+        }
+        block = std::aligned_alloc(alignment, total & ~(alignment - 1));
+    }
+    else
+    {
+        block = std::malloc(total);
+    }
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+
+    unsigned char* user = static_cast<unsigned char*>(block) + header;
+    __builtin_memcpy(user - sizeof(size_t), &bytes, sizeof(size_t));
+    record_allocation(bytes);
+    return user;
+}
+
+inline void* tracked_allocate(size_t bytes, size_t alignment)
+{
+    for (;;)
+    {
+        if (void* result = tracked_try_allocate(bytes, alignment))
+        {
+            return result;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+
+inline void* tracked_allocate_nothrow(size_t bytes, size_t alignment) noexcept
+{
+    try
+    {
+        return tracked_allocate(bytes, alignment);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+inline void tracked_deallocate(void* ptr, size_t alignment) noexcept
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    unsigned char* user = static_cast<unsigned char*>(ptr);
+    size_t bytes;
+    __builtin_memcpy(&bytes, user - sizeof(size_t), sizeof(size_t));
+    record_deallocation(bytes);
+    std::free(user - tracked_header_size(alignment));
+}
+} // namespace detail
+} // namespace ohmy
+
+#ifdef OHMY_TRACK_GLOBAL_ALLOCATIONS
+
+#define OHMY_DEFAULT_ALIGNMENT __STDCPP_DEFAULT_NEW_ALIGNMENT__
+
+void* operator new(std::size_t bytes)
+{
+    return ohmy::detail::tracked_allocate(bytes, OHMY_DEFAULT_ALIGNMENT);
+}
+void* operator new[](std::size_t bytes)
+{
+    return ohmy::detail::tracked_allocate(bytes, OHMY_DEFAULT_ALIGNMENT);
+}
+void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept
+{
+    return ohmy::detail::tracked_allocate_nothrow(bytes,
+                                                  OHMY_DEFAULT_ALIGNMENT);
+}
+void* operator new[](std::size_t bytes, const std::nothrow_t&) noexcept
+{
+    return ohmy::detail::tracked_allocate_nothrow(bytes,
+                                                  OHMY_DEFAULT_ALIGNMENT);
+}
+void* operator new(std::size_t bytes, std::align_val_t alignment)
+{
+    return ohmy::detail::tracked_allocate(bytes,
+                                          static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t bytes, std::align_val_t alignment)
+{
+    return ohmy::detail::tracked_allocate(bytes,
+                                          static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t bytes, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept
+{
+    return ohmy::detail::tracked_allocate_nothrow(
+        bytes, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t bytes, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept
+{
+    return ohmy::detail::tracked_allocate_nothrow(
+        bytes, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, OHMY_DEFAULT_ALIGNMENT);
+}
+void operator delete[](void* ptr) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, OHMY_DEFAULT_ALIGNMENT);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, OHMY_DEFAULT_ALIGNMENT);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, OHMY_DEFAULT_ALIGNMENT);
+}
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, OHMY_DEFAULT_ALIGNMENT);
+}
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, OHMY_DEFAULT_ALIGNMENT);
+}
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* ptr, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+void operator delete[](void* ptr, std::align_val_t alignment,
+                       const std::nothrow_t&) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* ptr, std::size_t,
+                     std::align_val_t alignment) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+void operator delete[](void* ptr, std::size_t,
+                       std::align_val_t alignment) noexcept
+{
+    ohmy::detail::tracked_deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+#undef OHMY_DEFAULT_ALIGNMENT
+
+#endif // OHMY_TRACK_GLOBAL_ALLOCATIONS
+
+#endif // OHMY_ALLOCATION_TRACKING_HPP
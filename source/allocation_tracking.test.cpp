@@ -0,0 +1,148 @@
+#include <catch/catch.hpp>
+
+// The test executable counts every allocation, so that allocation-free
+// guarantees of other headers can be checked with allocation_scope.
+#define OHMY_TRACK_GLOBAL_ALLOCATIONS
+#include "allocation_tracking.hpp"
+
+#include "small_vector.hpp"
+#include "static_vector.hpp"
+#include "string_view.hpp"
+#include "vector.hpp"
+
+#include <string>
+
+namespace
+{
+struct alignas(64) OverAligned
+{
+    int value;
+};
+} // namespace
+
+static_assert(ohmy::allocation_stats::bucket_for(0) == 0);
+static_assert(ohmy::allocation_stats::bucket_for(16) == 0);
+static_assert(ohmy::allocation_stats::bucket_for(17) == 1);
+static_assert(ohmy::allocation_stats::bucket_for(std::size_t{1} << 40) ==
+              ohmy::allocation_stats::histogram_buckets - 1);
+static_assert(ohmy::detail::has_reallocate_v<ohmy::tracking_allocator<int>>);
+static_assert(
+    not ohmy::detail::has_reallocate_v<ohmy::tracking_allocator<OverAligned>>);
+
+TEST_CASE("allocation scope")
+{
+    SECTION("counts global allocations and their sizes")
+    {
+        ohmy::allocation_scope scope;
+        int* first = new int{1};
+        auto* second = new OverAligned{2};
+        REQUIRE(reinterpret_cast<std::uintptr_t>(second) % 64 == 0u);
+
+        REQUIRE(scope.allocations() == 2u);
+        REQUIRE(scope.bytes_allocated() == sizeof(int) + sizeof(OverAligned));
+        REQUIRE(scope.live_bytes() ==
+                static_cast<long long>(sizeof(int) + sizeof(OverAligned)));
+
+        delete first;
+        delete second;
+        REQUIRE(scope.deallocations() == 2u);
+        REQUIRE(scope.live_bytes() == 0);
+    }
+
+    SECTION("tracks the peak and the size histogram")
+    {
+        ohmy::allocation_scope scope;
+        delete[] new char[1000];
+        delete[] new char[10];
+
+        ohmy::allocation_stats stats = scope.stats();
+        REQUIRE(stats.allocations == 2u);
+        REQUIRE(stats.peak_live_bytes == 1000);
+        REQUIRE(stats.live_bytes == 0);
+        const std::size_t bucket = ohmy::allocation_stats::bucket_for(1000);
+        REQUIRE(stats.histogram[bucket] == 1u);
+        REQUIRE(stats.histogram[0] == 1u);
+    }
+
+    SECTION("nested scopes measure their own peak")
+    {
+        ohmy::allocation_scope outer;
+        char* big = new char[4096];
+        delete[] big;
+        {
+            ohmy::allocation_scope inner;
+            delete[] new char[100];
+            REQUIRE(inner.peak_live_bytes() == 100);
+        }
+        REQUIRE(outer.peak_live_bytes() == 4096);
+        REQUIRE(outer.allocations() == 2u);
+    }
+}
+
+TEST_CASE("tracking allocator and tracked unique_ptr")
+{
+    SECTION("tracking_allocator records vector growth")
+    {
+        ohmy::allocation_scope scope;
+        {
+            ohmy::vector<int, ohmy::tracking_allocator<int>> v;
+            v.reserve(10);
+            REQUIRE(scope.allocations() == 1u);
+            REQUIRE(scope.bytes_allocated() == 10 * sizeof(int));
+        }
+        REQUIRE(scope.live_bytes() == 0);
+    }
+
+    SECTION("make_tracked_unique counts its storage once")
+    {
+        ohmy::allocation_scope scope;
+        {
+            auto single = ohmy::make_tracked_unique<std::uint64_t>(7u);
+            auto array = ohmy::make_tracked_unique<int[]>(5);
+            REQUIRE(*single == 7u);
+            REQUIRE(array[4] == 0);
+            REQUIRE(array.get_deleter().size() == 5u);
+            REQUIRE(scope.allocations() == 2u);
+            REQUIRE(scope.bytes_allocated() ==
+                    sizeof(std::uint64_t) + 5 * sizeof(int));
+        }
+        REQUIRE(scope.deallocations() == 2u);
+        REQUIRE(scope.live_bytes() == 0);
+    }
+}
+
+TEST_CASE("allocation-free operations")
+{
+    const std::string text = "a haystack long enough to defeat the small "
+                             "string optimization, with a needle inside";
+
+    SECTION("string_view does not allocate")
+    {
+        ohmy::allocation_scope scope;
+        my::string_view view{text.data(), text.size()};
+        REQUIRE(view.find("needle") != my::string_view::npos);
+        REQUIRE(view.substr(2, 8).compare("haystack") == 0);
+        REQUIRE(view.rfind('a') != my::string_view::npos);
+        REQUIRE(scope.allocations() == 0u);
+    }
+
+    SECTION("containers within their capacity do not allocate")
+    {
+        ohmy::vector<int> v;
+        v.reserve(64);
+
+        ohmy::allocation_scope scope;
+        ohmy::static_vector<int, 64> fixed;
+        ohmy::small_vector<int, 64, ohmy::tracking_allocator<int>> small;
+        for (int i = 0; i < 64; ++i)
+        {
+            v.push_back(i);
+            fixed.push_back(i);
+            small.push_back(i);
+        }
+        REQUIRE(scope.allocations() == 0u);
+
+        small.push_back(64);
+        REQUIRE(scope.allocations() == 1u);
+    }
+}
@@ -0,0 +1,668 @@
+#ifndef OHMY_BITSET_HPP
+#define OHMY_BITSET_HPP
+
+#include "c++config.hpp"
+#include "memory.hpp"
+#include "vector.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// A bitset whose size is set at run time, for large bitmaps such as set
+// membership and the results of filters. The bits are packed into 64-bit
+// words aligned to a cache line, and the word array is padded to whole
+// cache lines, so the bulk operations (&=, |=, ^=, and_not) and count
+// work in blocks of eight words with no remainder loop, which the
+// compiler turns into vector instructions for the target.
+//
+// Bits past size() are always clear, so count, == and the searches never
+// need to mask the last word. There is no reference proxy: operator[]
+// reads a bit and set, reset and flip write one.
+//
+// ones() visits the set bits in order, taking each position from a count
+// of trailing zeros (tzcnt where the target has it). rank_select adds
+// tables over a bitset that answer how many bits are set before a
+// position, and where the n-th set bit is, without scanning.
+namespace ohmy
+{
+namespace detail
+{
+inline constexpr size_t bits_per_word = 64;
+
+// One cache line of words.
+inline constexpr size_t bitset_block_words = 8;
+
+inline constexpr size_t bitset_alignment =
+    bitset_block_words * sizeof(uint64_t);
+
+inline unsigned popcount(uint64_t word) noexcept
+{
+#if defined(__POPCNT__)
+    return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+    // Without the instruction, __builtin_popcountll is a library call.
+    word -= (word >> 1) & 0x5555555555555555u;
+    word = (word & 0x3333333333333333u) + ((word >> 2) & 0x3333333333333333u);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fu;
+    return static_cast<unsigned>((word * 0x0101010101010101u) >> 56);
+#endif
+}
+
+// The number of set bits in a block of words.
+inline unsigned popcount_block(const uint64_t* words) noexcept
+{
+    words = static_cast<const uint64_t*>(
+        __builtin_assume_aligned(words, bitset_alignment));
+#if defined(__POPCNT__)
+    unsigned count = 0;
+    for (size_t lane = 0; lane < bitset_block_words; ++lane)
+    {
+        count += popcount(words[lane]);
+    }
+    return count;
+#else
+    // Adds up the counts per byte of all the words before adding across
+    // bytes, which no byte overflows since each holds at most 64.
+    uint64_t bytes = 0;
+    for (size_t lane = 0; lane < bitset_block_words; ++lane)
+    {
+        uint64_t word = words[lane];
+        word -= (word >> 1) & 0x5555555555555555u;
+        word = (word & 0x3333333333333333u) +
+               ((word >> 2) & 0x3333333333333333u);
+        bytes += (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fu;
+    }
+    const uint64_t pairs = (bytes & 0x00ff00ff00ff00ffu) +
+                           ((bytes >> 8) & 0x00ff00ff00ff00ffu);
+    return static_cast<unsigned>((pairs * 0x0001000100010001u) >> 48);
+#endif
+}
+
+inline unsigned count_trailing_zeros(uint64_t word) noexcept
+{
+    return static_cast<unsigned>(__builtin_ctzll(word));
+}
+
+// The position of the set bit of word that has rank set bits below it.
+inline unsigned select_in_word(uint64_t word, unsigned rank) noexcept
+{
+#if defined(__BMI2__)
+    return count_trailing_zeros(_pdep_u64(uint64_t{1} << rank, word));
+#else
+    unsigned position = 0;
+    for (unsigned width = 32; width >= 8; width /= 2)
+    {
+        const uint64_t low = word & ((uint64_t{1} << width) - 1);
+        const unsigned count = popcount(low);
+        if (rank >= count)
+        {
+            rank -= count;
+            word >>= width;
+            position += width;
+        }
+        else
+        {
+            word = low;
+        }
+    }
+    for (; rank > 0; --rank)
+    {
+        word &= word - 1;
+    }
+    return position + count_trailing_zeros(word);
+#endif
+}
+
+// Combines whole blocks of source into target. The pointers are aligned
+// and do not alias, and the count is a multiple of the block, so the inner
+// loop vectorizes without checks or a remainder.
+template <typename Operation>
+inline void combine_words(uint64_t* __restrict target,
+                          const uint64_t* __restrict source, size_t words,
+                          Operation operation) noexcept
+{
+    target = static_cast<uint64_t*>(
+        __builtin_assume_aligned(target, bitset_alignment));
+    source = static_cast<const uint64_t*>(
+        __builtin_assume_aligned(source, bitset_alignment));
+    for (size_t block = 0; block < words; block += bitset_block_words)
+    {
+        for (size_t lane = 0; lane < bitset_block_words; ++lane)
+        {
+            target[block + lane] =
+                operation(target[block + lane], source[block + lane]);
+        }
+    }
+}
+} // namespace detail
+
+class dynamic_bitset
+{
+public:
+    using size_type = size_t;
+    using word_type = uint64_t;
+    using allocator_type =
+        aligned_allocator<word_type, detail::bitset_alignment>;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // The positions of the set bits, in increasing order.
+    class set_bit_iterator
+    {
+    public:
+        using value_type = size_type;
+        using difference_type = ptrdiff_t;
+        using pointer = const size_type*;
+        using reference = size_type;
+
+        set_bit_iterator(const word_type* words, size_type index,
+                         size_type count) noexcept
+            : m_words{words}, m_index{index}, m_count{count},
+              m_word{index < count ? words[index] : 0}
+        {
+            skip_empty_words();
+        }
+
+        size_type operator*() const noexcept
+        {
+            return m_index * detail::bits_per_word +
+                   detail::count_trailing_zeros(m_word);
+        }
+
+        set_bit_iterator& operator++() noexcept
+        {
+            m_word &= m_word - 1;
+            skip_empty_words();
+            return *this;
+        }
+
+        set_bit_iterator operator++(int) noexcept
+        {
+            set_bit_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const set_bit_iterator& lhs,
+                               const set_bit_iterator& rhs) noexcept
+        {
+            return lhs.m_index == rhs.m_index and lhs.m_word == rhs.m_word;
+        }
+
+        friend bool operator!=(const set_bit_iterator& lhs,
+                               const set_bit_iterator& rhs) noexcept
+        {
+            return not(lhs == rhs);
+        }
+
+    private:
+        void skip_empty_words() noexcept
+        {
+            while (m_word == 0 and ++m_index < m_count)
+            {
+                m_word = m_words[m_index];
+            }
+            if (m_index > m_count)
+            {
+                m_index = m_count;
+            }
+        }
+
+        const word_type* m_words;
+        size_type m_index;
+        size_type m_count;
+        word_type m_word;
+    };
+
+    class set_bit_range
+    {
+    public:
+        set_bit_range(const word_type* words, size_type count) noexcept
+            : m_words{words}, m_count{count}
+        {
+        }
+
+        set_bit_iterator begin() const noexcept
+        {
+            return set_bit_iterator{m_words, 0, m_count};
+        }
+
+        set_bit_iterator end() const noexcept
+        {
+            return set_bit_iterator{m_words, m_count, m_count};
+        }
+
+    private:
+        const word_type* m_words;
+        size_type m_count;
+    };
+
+    dynamic_bitset() noexcept = default;
+
+    explicit dynamic_bitset(size_type size, bool value = false)
+    {
+        resize(size, value);
+    }
+
+    size_type size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    // The words that hold the bits, least significant bit first, padded
+    // with clear words to a whole number of cache lines.
+    const word_type* data() const noexcept
+    {
+        return m_words.data();
+    }
+
+    size_type word_count() const noexcept
+    {
+        return m_words.size();
+    }
+
+    void resize(size_type size, bool value = false)
+    {
+        const size_type old_size = m_size;
+        m_words.resize(padded_words(size), 0);
+        m_size = size;
+        if (value and size > old_size)
+        {
+            // Some of the new bits may be in words that were padding.
+            size_type word = old_size / detail::bits_per_word;
+            if (old_size % detail::bits_per_word != 0)
+            {
+                m_words[word++] |= ~word_type{0} << bit(old_size);
+            }
+            for (const size_type used = used_words(); word < used; ++word)
+            {
+                m_words[word] = ~word_type{0};
+            }
+        }
+        clear_unused();
+    }
+
+    bool operator[](size_type pos) const noexcept
+    {
+        return (m_words[pos / detail::bits_per_word] >> bit(pos)) & 1;
+    }
+
+    bool test(size_type pos) const
+    {
+        check(pos);
+        return (*this)[pos];
+    }
+
+    dynamic_bitset& set(size_type pos) noexcept
+    {
+        m_words[pos / detail::bits_per_word] |= word_type{1} << bit(pos);
+        return *this;
+    }
+
+    dynamic_bitset& set(size_type pos, bool value) noexcept
+    {
+        return value ? set(pos) : reset(pos);
+    }
+
+    dynamic_bitset& reset(size_type pos) noexcept
+    {
+        m_words[pos / detail::bits_per_word] &= ~(word_type{1} << bit(pos));
+        return *this;
+    }
+
+    dynamic_bitset& flip(size_type pos) noexcept
+    {
+        m_words[pos / detail::bits_per_word] ^= word_type{1} << bit(pos);
+        return *this;
+    }
+
+    dynamic_bitset& set() noexcept
+    {
+        for (word_type& word : m_words)
+        {
+            word = ~word_type{0};
+        }
+        clear_unused();
+        return *this;
+    }
+
+    dynamic_bitset& reset() noexcept
+    {
+        for (word_type& word : m_words)
+        {
+            word = 0;
+        }
+        return *this;
+    }
+
+    dynamic_bitset& flip() noexcept
+    {
+        for (word_type& word : m_words)
+        {
+            word = ~word;
+        }
+        clear_unused();
+        return *this;
+    }
+
+    // The bulk operations need bitsets of the same size and throw
+    // std::length_error otherwise.
+    dynamic_bitset& operator&=(const dynamic_bitset& other)
+    {
+        combine(other, [](word_type lhs, word_type rhs) { return lhs & rhs; });
+        return *this;
+    }
+
+    dynamic_bitset& operator|=(const dynamic_bitset& other)
+    {
+        combine(other, [](word_type lhs, word_type rhs) { return lhs | rhs; });
+        return *this;
+    }
+
+    dynamic_bitset& operator^=(const dynamic_bitset& other)
+    {
+        combine(other, [](word_type lhs, word_type rhs) { return lhs ^ rhs; });
+        return *this;
+    }
+
+    // Clears the bits that are set in other.
+    dynamic_bitset& and_not(const dynamic_bitset& other)
+    {
+        combine(other,
+                [](word_type lhs, word_type rhs) { return lhs & ~rhs; });
+        return *this;
+    }
+
+    size_type count() const noexcept
+    {
+        size_type count = 0;
+        for (size_type block = 0; block < m_words.size();
+             block += detail::bitset_block_words)
+        {
+            count += detail::popcount_block(m_words.data() + block);
+        }
+        return count;
+    }
+
+    bool any() const noexcept
+    {
+        for (const word_type word : m_words)
+        {
+            if (word != 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool none() const noexcept
+    {
+        return not any();
+    }
+
+    bool all() const noexcept
+    {
+        return count() == m_size;
+    }
+
+    // The position of the first set bit, or npos.
+    size_type find_first() const noexcept
+    {
+        return find_from(0);
+    }
+
+    // The position of the first set bit after pos, or npos.
+    size_type find_next(size_type pos) const noexcept
+    {
+        return pos + 1 < m_size ? find_from(pos + 1) : npos;
+    }
+
+    set_bit_range ones() const noexcept
+    {
+        return set_bit_range{m_words.data(), used_words()};
+    }
+
+    friend bool operator==(const dynamic_bitset& lhs,
+                           const dynamic_bitset& rhs) noexcept
+    {
+        return lhs.m_size == rhs.m_size and lhs.m_words == rhs.m_words;
+    }
+
+    friend bool operator!=(const dynamic_bitset& lhs,
+                           const dynamic_bitset& rhs) noexcept
+    {
+        return not(lhs == rhs);
+    }
+
+private:
+    static size_type padded_words(size_type size) noexcept
+    {
+        const size_type block_bits =
+            detail::bitset_block_words * detail::bits_per_word;
+        return (size + block_bits - 1) / block_bits *
+               detail::bitset_block_words;
+    }
+
+    static unsigned bit(size_type pos) noexcept
+    {
+        return static_cast<unsigned>(pos % detail::bits_per_word);
+    }
+
+    void check(size_type pos) const
+    {
+        if (pos >= m_size)
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+    }
+
+    size_type used_words() const noexcept
+    {
+        return (m_size + detail::bits_per_word - 1) / detail::bits_per_word;
+    }
+
+    // Clears the bits past size(), which operations on whole words set.
+    void clear_unused() noexcept
+    {
+        const size_type used = used_words();
+        if (m_size % detail::bits_per_word != 0)
+        {
+            m_words[used - 1] &= (word_type{1} << bit(m_size)) - 1;
+        }
+        for (size_type word = used; word < m_words.size(); ++word)
+        {
+            m_words[word] = 0;
+        }
+    }
+
+    template <typename Operation>
+    void combine(const dynamic_bitset& other, Operation operation)
+    {
+        if (other.m_size != m_size)
+            throw std::length_error(__PRETTY_FUNCTION__);
+
+        if (&other == this)
+        {
+            // The words would alias; copy them first.
+            const dynamic_bitset copy = other;
+            detail::combine_words(m_words.data(), copy.m_words.data(),
+                                  m_words.size(), operation);
+        }
+        else
+        {
+            detail::combine_words(m_words.data(), other.m_words.data(),
+                                  m_words.size(), operation);
+        }
+    }
+
+    size_type find_from(size_type pos) const noexcept
+    {
+        if (pos >= m_size)
+            return npos;
+
+        const size_type used = used_words();
+        size_type index = pos / detail::bits_per_word;
+        word_type word = m_words[index] & (~word_type{0} << bit(pos));
+        while (word == 0)
+        {
+            if (++index == used)
+                return npos;
+            word = m_words[index];
+        }
+        return index * detail::bits_per_word +
+               detail::count_trailing_zeros(word);
+    }
+
+    vector<word_type, allocator_type> m_words;
+    size_type m_size = 0;
+};
+
+inline dynamic_bitset operator&(dynamic_bitset lhs, const dynamic_bitset& rhs)
+{
+    return lhs &= rhs;
+}
+
+inline dynamic_bitset operator|(dynamic_bitset lhs, const dynamic_bitset& rhs)
+{
+    return lhs |= rhs;
+}
+
+inline dynamic_bitset operator^(dynamic_bitset lhs, const dynamic_bitset& rhs)
+{
+    return lhs ^= rhs;
+}
+
+inline dynamic_bitset operator~(dynamic_bitset value) noexcept
+{
+    return value.flip();
+}
+
+// Rank and select over a bitset in constant time, from a count of the set
+// bits before every cache line of words (a block) and before every eight
+// blocks (a superblock). Superblock counts are 64 bits and block counts
+// are 16 bits relative to their superblock, which adds 4.7% to the size of
+// the bitset.
+//
+// The tables describe the bitset as it was when they were built; it has
+// to outlive them and not change.
+class rank_select
+{
+public:
+    using size_type = size_t;
+
+    static constexpr size_type npos = dynamic_bitset::npos;
+
+    explicit rank_select(const dynamic_bitset& bits)
+        : m_words{bits.data()}, m_size{bits.size()}
+    {
+        const size_type blocks =
+            bits.word_count() / detail::bitset_block_words;
+        m_superblock_ranks.reserve(blocks / blocks_per_superblock + 2);
+        m_block_ranks.reserve(blocks);
+
+        size_type total = 0;
+        size_type superblock_start = 0;
+        for (size_type block = 0; block < blocks; ++block)
+        {
+            if (block % blocks_per_superblock == 0)
+            {
+                m_superblock_ranks.push_back(total);
+                superblock_start = total;
+            }
+            m_block_ranks.push_back(
+                static_cast<uint16_t>(total - superblock_start));
+            total += detail::popcount_block(
+                m_words + block * detail::bitset_block_words);
+        }
+        m_superblock_ranks.push_back(total);
+        m_count = total;
+    }
+
+    // The number of set bits.
+    size_type count() const noexcept
+    {
+        return m_count;
+    }
+
+    // The number of set bits before pos, for pos up to size().
+    size_type rank(size_type pos) const noexcept
+    {
+        if (pos >= m_size)
+            return m_count;
+
+        const size_type index = pos / detail::bits_per_word;
+        const size_type block = index / detail::bitset_block_words;
+        size_type rank = m_superblock_ranks[block / blocks_per_superblock] +
+                         m_block_ranks[block];
+        for (size_type word = block * detail::bitset_block_words;
+             word < index; ++word)
+        {
+            rank += detail::popcount(m_words[word]);
+        }
+        const uint64_t below =
+            (uint64_t{1} << (pos % detail::bits_per_word)) - 1;
+        return rank + detail::popcount(m_words[index] & below);
+    }
+
+    // The position of the set bit with rank set bits before it, or npos
+    // if there are not that many.
+    size_type select(size_type rank) const noexcept
+    {
+        if (rank >= m_count)
+            return npos;
+
+        // The last superblock that starts at or below rank.
+        size_type first = 0;
+        size_type count = m_superblock_ranks.size() - 1;
+        while (count > 1)
+        {
+            const size_type half = count / 2;
+            first += static_cast<size_type>(
+                         m_superblock_ranks[first + half] <= rank) *
+                     half;
+            count -= half;
+        }
+        rank -= m_superblock_ranks[first];
+
+        size_type block = first * blocks_per_superblock;
+        const size_type last_block =
+            block + blocks_per_superblock < m_block_ranks.size()
+                ? block + blocks_per_superblock
+                : m_block_ranks.size();
+        while (block + 1 < last_block and m_block_ranks[block + 1] <= rank)
+        {
+            ++block;
+        }
+        rank -= m_block_ranks[block];
+
+        size_type word = block * detail::bitset_block_words;
+        for (;; ++word)
+        {
+            const unsigned ones = detail::popcount(m_words[word]);
+            if (rank < ones)
+                break;
+            rank -= ones;
+        }
+        return word * detail::bits_per_word +
+               detail::select_in_word(m_words[word],
+                                      static_cast<unsigned>(rank));
+    }
+
+private:
+    static constexpr size_type blocks_per_superblock = 8;
+
+    const uint64_t* m_words;
+    size_type m_size;
+    size_type m_count = 0;
+    vector<size_type> m_superblock_ranks;
+    vector<uint16_t> m_block_ranks;
+};
+} // namespace ohmy
+
+#endif // OHMY_BITSET_HPP
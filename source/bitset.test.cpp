@@ -0,0 +1,358 @@
+#include <catch/catch.hpp>
+
+#include "bitset.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+// A bitset and the same bits in a vector<bool>, with each bit set with
+// the given probability.
+std::pair<ohmy::dynamic_bitset, std::vector<bool>>
+random_bits(size_t size, double density, std::mt19937_64& generator)
+{
+    std::bernoulli_distribution distribution{density};
+    ohmy::dynamic_bitset bits(size);
+    std::vector<bool> expected(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (distribution(generator))
+        {
+            bits.set(i);
+            expected[i] = true;
+        }
+    }
+    return {std::move(bits), std::move(expected)};
+}
+
+bool matches(const ohmy::dynamic_bitset& bits,
+             const std::vector<bool>& expected)
+{
+    if (bits.size() != expected.size())
+        return false;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        if (bits[i] != expected[i])
+            return false;
+    }
+    return bits.count() == static_cast<size_t>(std::count(
+                               expected.begin(), expected.end(), true));
+}
+} // namespace
+
+TEST_CASE("dynamic_bitset")
+{
+    std::mt19937_64 generator{5};
+
+    SECTION("single bits")
+    {
+        ohmy::dynamic_bitset bits(100);
+        REQUIRE(bits.size() == 100u);
+        REQUIRE(bits.none());
+        REQUIRE(reinterpret_cast<uintptr_t>(bits.data()) % 64 == 0);
+        REQUIRE(bits.word_count() == 8u);
+
+        bits.set(3).set(64).set(99);
+        REQUIRE(bits[3]);
+        REQUIRE(bits.test(64));
+        REQUIRE_FALSE(bits[4]);
+        REQUIRE(bits.count() == 3u);
+
+        bits.reset(64).flip(5).set(6, false).set(7, true);
+        REQUIRE_FALSE(bits[64]);
+        REQUIRE(bits[5]);
+        REQUIRE(bits[7]);
+        REQUIRE(bits.count() == 4u);
+        REQUIRE_THROWS_AS(bits.test(100), std::out_of_range);
+    }
+
+    SECTION("whole-set operations leave the bits past the end clear")
+    {
+        ohmy::dynamic_bitset bits(70);
+        bits.set();
+        REQUIRE(bits.all());
+        REQUIRE(bits.count() == 70u);
+        REQUIRE(bits.data()[1] == (uint64_t{1} << 6) - 1);
+
+        bits.flip();
+        REQUIRE(bits.none());
+        REQUIRE((~bits).count() == 70u);
+
+        bits.set(69);
+        bits.reset();
+        REQUIRE(bits.none());
+    }
+
+    SECTION("resizing")
+    {
+        ohmy::dynamic_bitset bits(10);
+        bits.set(9);
+        bits.resize(200, true);
+        REQUIRE(bits.count() == 191u);
+        REQUIRE_FALSE(bits[8]);
+        REQUIRE(bits[10]);
+        REQUIRE(bits[199]);
+
+        bits.resize(60);
+        REQUIRE(bits.count() == 51u);
+        bits.resize(600);
+        REQUIRE(bits.count() == 51u);
+        REQUIRE(bits.word_count() == 16u);
+        REQUIRE(bits == bits);
+    }
+
+    SECTION("bulk operations agree with vector<bool>")
+    {
+        for (size_t size : {1u, 63u, 64u, 511u, 1000u, 4097u, 70001u})
+        {
+            auto [lhs, lhs_expected] = random_bits(size, 0.5, generator);
+            auto [rhs, rhs_expected] = random_bits(size, 0.3, generator);
+
+            std::vector<bool> expected(size);
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = lhs_expected[i] and rhs_expected[i];
+            REQUIRE(matches(lhs & rhs, expected));
+
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = lhs_expected[i] or rhs_expected[i];
+            REQUIRE(matches(lhs | rhs, expected));
+
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = lhs_expected[i] != rhs_expected[i];
+            REQUIRE(matches(lhs ^ rhs, expected));
+
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = lhs_expected[i] and not rhs_expected[i];
+            REQUIRE(matches(ohmy::dynamic_bitset{lhs}.and_not(rhs), expected));
+
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = not lhs_expected[i];
+            REQUIRE(matches(~lhs, expected));
+        }
+    }
+
+    SECTION("a bitset combined with itself")
+    {
+        auto [bits, expected] = random_bits(1000, 0.5, generator);
+        const size_t count = bits.count();
+        bits &= bits;
+        REQUIRE(bits.count() == count);
+        bits |= bits;
+        REQUIRE(bits.count() == count);
+        bits.and_not(bits);
+        REQUIRE(bits.none());
+    }
+
+    SECTION("sizes have to match")
+    {
+        ohmy::dynamic_bitset lhs(64);
+        ohmy::dynamic_bitset rhs(65);
+        REQUIRE_THROWS_AS(lhs &= rhs, std::length_error);
+        REQUIRE_THROWS_AS(lhs.and_not(rhs), std::length_error);
+        REQUIRE(lhs != rhs);
+    }
+
+    SECTION("finding set bits")
+    {
+        for (double density : {0.0, 0.001, 0.1, 0.9, 1.0})
+        {
+            auto [bits, expected] = random_bits(5000, density, generator);
+            std::vector<size_t> positions;
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                if (expected[i])
+                    positions.push_back(i);
+            }
+
+            std::vector<size_t> found;
+            for (size_t pos : bits.ones())
+                found.push_back(pos);
+            REQUIRE(found == positions);
+
+            found.clear();
+            for (size_t pos = bits.find_first();
+                 pos != ohmy::dynamic_bitset::npos; pos = bits.find_next(pos))
+            {
+                found.push_back(pos);
+            }
+            REQUIRE(found == positions);
+        }
+
+        ohmy::dynamic_bitset empty;
+        REQUIRE(empty.find_first() == ohmy::dynamic_bitset::npos);
+        REQUIRE(empty.ones().begin() == empty.ones().end());
+    }
+}
+
+TEST_CASE("rank_select")
+{
+    std::mt19937_64 generator{6};
+
+    for (double density : {0.0001, 0.01, 0.5, 0.99, 1.0})
+    {
+        auto [bits, expected] = random_bits(40000, density, generator);
+        const ohmy::rank_select index{bits};
+        REQUIRE(index.count() == bits.count());
+
+        size_t rank = 0;
+        bool ranks_match = true;
+        bool selects_match = true;
+        for (size_t pos = 0; pos < expected.size(); ++pos)
+        {
+            ranks_match = ranks_match and index.rank(pos) == rank;
+            if (expected[pos])
+            {
+                selects_match = selects_match and index.select(rank) == pos;
+                ++rank;
+            }
+        }
+        REQUIRE(ranks_match);
+        REQUIRE(selects_match);
+        REQUIRE(index.rank(expected.size()) == rank);
+        REQUIRE(index.select(rank) == ohmy::rank_select::npos);
+    }
+
+    SECTION("long runs of clear bits")
+    {
+        ohmy::dynamic_bitset bits(100000);
+        bits.set(0).set(50000).set(99999);
+        const ohmy::rank_select index{bits};
+        REQUIRE(index.select(0) == 0u);
+        REQUIRE(index.select(1) == 50000u);
+        REQUIRE(index.select(2) == 99999u);
+        REQUIRE(index.rank(50000) == 1u);
+        REQUIRE(index.rank(50001) == 2u);
+    }
+}
+
+namespace
+{
+// Roughly half of the bits, picked by hashing the position.
+bool hashed_bit(size_t pos, uint64_t multiplier)
+{
+    return (pos * multiplier) >> 63;
+}
+
+constexpr uint64_t lhs_multiplier = 0x9e3779b97f4a7c15u;
+constexpr uint64_t rhs_multiplier = 0xc2b2ae3d27d4eb4fu;
+} // namespace
+
+TEST_CASE("dynamic_bitset benchmarks", "[.benchmark]")
+{
+    constexpr size_t size = 1'000'000'000;
+
+    {
+        ohmy::dynamic_bitset lhs(size);
+        ohmy::dynamic_bitset rhs(size);
+        for (size_t pos = 0; pos < size; ++pos)
+        {
+            lhs.set(pos, hashed_bit(pos, lhs_multiplier));
+            rhs.set(pos, hashed_bit(pos, rhs_multiplier));
+        }
+
+        size_t count = 0;
+        BENCHMARK("ohmy::dynamic_bitset &=, 10^9 bits")
+        {
+            lhs &= rhs;
+        }
+        BENCHMARK("ohmy::dynamic_bitset |=, 10^9 bits")
+        {
+            lhs |= rhs;
+        }
+        BENCHMARK("ohmy::dynamic_bitset ^=, 10^9 bits")
+        {
+            lhs ^= rhs;
+        }
+        BENCHMARK("ohmy::dynamic_bitset and_not, 10^9 bits")
+        {
+            lhs.and_not(rhs);
+        }
+        BENCHMARK("ohmy::dynamic_bitset count, 10^9 bits")
+        {
+            count += lhs.count();
+        }
+        REQUIRE(count <= size);
+    }
+
+    {
+        auto lhs = std::make_unique<std::bitset<size>>();
+        auto rhs = std::make_unique<std::bitset<size>>();
+        for (size_t pos = 0; pos < size; ++pos)
+        {
+            lhs->set(pos, hashed_bit(pos, lhs_multiplier));
+            rhs->set(pos, hashed_bit(pos, rhs_multiplier));
+        }
+
+        size_t count = 0;
+        BENCHMARK("std::bitset &=, 10^9 bits")
+        {
+            *lhs &= *rhs;
+        }
+        BENCHMARK("std::bitset |=, 10^9 bits")
+        {
+            *lhs |= *rhs;
+        }
+        BENCHMARK("std::bitset ^=, 10^9 bits")
+        {
+            *lhs ^= *rhs;
+        }
+        // ~ would make a temporary, which at this size does not fit on the
+        // stack, so flip rhs in place and back.
+        BENCHMARK("std::bitset flip, &=, flip, 10^9 bits")
+        {
+            rhs->flip();
+            *lhs &= *rhs;
+            rhs->flip();
+        }
+        BENCHMARK("std::bitset count, 10^9 bits")
+        {
+            count += lhs->count();
+        }
+        REQUIRE(count <= size);
+    }
+
+    {
+        std::vector<bool> lhs(size);
+        std::vector<bool> rhs(size);
+        for (size_t pos = 0; pos < size; ++pos)
+        {
+            lhs[pos] = hashed_bit(pos, lhs_multiplier);
+            rhs[pos] = hashed_bit(pos, rhs_multiplier);
+        }
+
+        size_t count = 0;
+        BENCHMARK("std::vector<bool> &=, 10^9 bits")
+        {
+            for (size_t pos = 0; pos < size; ++pos)
+                lhs[pos] = lhs[pos] and rhs[pos];
+        }
+        BENCHMARK("std::vector<bool> |=, 10^9 bits")
+        {
+            for (size_t pos = 0; pos < size; ++pos)
+                lhs[pos] = lhs[pos] or rhs[pos];
+        }
+        BENCHMARK("std::vector<bool> ^=, 10^9 bits")
+        {
+            for (size_t pos = 0; pos < size; ++pos)
+                lhs[pos] = lhs[pos] != rhs[pos];
+        }
+        BENCHMARK("std::vector<bool> and not, 10^9 bits")
+        {
+            for (size_t pos = 0; pos < size; ++pos)
+                lhs[pos] = lhs[pos] and not rhs[pos];
+        }
+        BENCHMARK("std::vector<bool> count, 10^9 bits")
+        {
+            count += static_cast<size_t>(
+                std::count(lhs.begin(), lhs.end(), true));
+        }
+        REQUIRE(count <= size);
+    }
+}
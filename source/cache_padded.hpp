@@ -0,0 +1,70 @@
+#ifndef OHMY_CACHE_PADDED_HPP
+#define OHMY_CACHE_PADDED_HPP
+
+#include "c++config.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+namespace ohmy
+{
+inline constexpr size_t cache_line_size = 64;
+
+// The distance two objects written by different threads should keep so
+// they do not share a cache line. x86-64 prefetches cache lines in pairs
+// and recent ARM cores use 128-byte lines, so two lines are used there.
+#if defined(__x86_64__) || defined(__aarch64__) || defined(__powerpc64__)
+inline constexpr size_t destructive_interference_size = 2 * cache_line_size;
+#else
+inline constexpr size_t destructive_interference_size = cache_line_size;
+#endif
+
+// Wraps a value so it occupies cache lines of its own, which keeps writes
+// by one thread from invalidating the line another thread is using, for
+// example the head and tail indices of a queue or per-core counters in an
+// array.
+template <typename Type>
+struct alignas(destructive_interference_size) cache_padded
+{
+    constexpr cache_padded() = default;
+
+    // Copies are left to the implicit constructors.
+    template <typename First, typename... Rest,
+              typename = enable_if_t<
+                  not is_same_v<remove_cvref_t<First>, cache_padded>>>
+    constexpr explicit cache_padded(First&& first, Rest&&... rest)
+        : value(ohmy::forward<First>(first), ohmy::forward<Rest>(rest)...)
+    {
+    }
+
+    constexpr Type& get() noexcept
+    {
+        return value;
+    }
+    constexpr const Type& get() const noexcept
+    {
+        return value;
+    }
+
+    constexpr Type& operator*() noexcept
+    {
+        return value;
+    }
+    constexpr const Type& operator*() const noexcept
+    {
+        return value;
+    }
+
+    constexpr Type* operator->() noexcept
+    {
+        return &value;
+    }
+    constexpr const Type* operator->() const noexcept
+    {
+        return &value;
+    }
+
+    Type value{};
+};
+} // namespace ohmy
+
+#endif // OHMY_CACHE_PADDED_HPP
@@ -0,0 +1,111 @@
+#include <catch/catch.hpp>
+
+#include "cache_padded.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Pair
+{
+    Pair(int a, int b) : first{a}, second{b}
+    {
+    }
+
+    int first;
+    int second;
+};
+} // namespace
+
+static_assert(alignof(ohmy::cache_padded<char>) ==
+              ohmy::destructive_interference_size);
+static_assert(sizeof(ohmy::cache_padded<char>) ==
+              ohmy::destructive_interference_size);
+static_assert(sizeof(ohmy::cache_padded<char[200]>) %
+                  ohmy::destructive_interference_size ==
+              0);
+
+TEST_CASE("cache_padded")
+{
+    SECTION("forwards constructor arguments and gives access to the value")
+    {
+        ohmy::cache_padded<Pair> padded{1, 2};
+        REQUIRE(padded->first == 1);
+        REQUIRE((*padded).second == 2);
+        padded.get().first = 3;
+        REQUIRE(padded.value.first == 3);
+    }
+
+    SECTION("copies from lvalues that are not const")
+    {
+        ohmy::cache_padded<int> original{4};
+        ohmy::cache_padded<int> copy(original);
+        ohmy::cache_padded<int> assigned;
+        assigned = original;
+        REQUIRE(*copy == 4);
+        REQUIRE(*assigned == 4);
+    }
+
+    SECTION("array elements start on separate cache lines")
+    {
+        ohmy::cache_padded<std::atomic<int>> counters[4];
+        for (int i = 0; i + 1 < 4; ++i)
+        {
+            auto distance = reinterpret_cast<std::uintptr_t>(&counters[i + 1]) -
+                            reinterpret_cast<std::uintptr_t>(&counters[i]);
+            REQUIRE(distance == ohmy::destructive_interference_size);
+        }
+        REQUIRE(counters[3]->load() == 0);
+    }
+}
+
+TEST_CASE("cache_padded benchmarks", "[.benchmark]")
+{
+    constexpr int increments = 1 << 22;
+    const unsigned threads = std::thread::hardware_concurrency() > 1
+                                 ? std::thread::hardware_concurrency()
+                                 : 2;
+
+    auto run = [&](auto& counters) {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&counters, t] {
+                auto& counter = counters[t];
+                for (int i = 0; i < increments; ++i)
+                {
+                    counter.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    };
+
+    std::vector<std::atomic<long>> packed(threads);
+    BENCHMARK("adjacent per-thread counters")
+    {
+        run(packed);
+    }
+
+    struct padded_counters
+    {
+        std::vector<ohmy::cache_padded<std::atomic<long>>> counters;
+
+        std::atomic<long>& operator[](unsigned index)
+        {
+            return *counters[index];
+        }
+    } padded{std::vector<ohmy::cache_padded<std::atomic<long>>>(threads)};
+    BENCHMARK("cache_padded per-thread counters")
+    {
+        run(padded);
+    }
+
+    REQUIRE(packed[0].load() == padded[0].load());
+}
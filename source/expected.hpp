@@ -0,0 +1,746 @@
+#ifndef OHMY_EXPECTED_HPP
+#define OHMY_EXPECTED_HPP
+
+#include "c++config.hpp"
+#include "functional.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <exception>
+
+// A value or the error that prevented it, for code that reports failures
+// without throwing. The value and the error share their storage, and the
+// flag that tells them apart goes after both, into tail padding where
+// there is some, so expected<char, error_enum> takes two bytes. Copying,
+// moving and destroying are trivial when they are for both types.
+//
+// and_then, transform, or_else and transform_error chain steps that may
+// fail; the first error skips the remaining steps and comes out the end.
+//
+// Switching between the value and the error keeps the old one if building
+// the new one throws, which needs one of the two types to move without
+// throwing.
+namespace ohmy
+{
+template <typename Error>
+class unexpected
+{
+public:
+    template <typename Other = Error,
+              typename = enable_if_t<
+                  is_constructible_v<Error, Other&&> and
+                  not is_same_v<decay_t<Other>, unexpected> and
+                  not is_same_v<decay_t<Other>, in_place_t>>>
+    constexpr explicit unexpected(Other&& error)
+        : m_error(ohmy::forward<Other>(error))
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit unexpected(in_place_t, ArgumentTypes&&... arguments)
+        : m_error(ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    constexpr Error& error() & noexcept
+    {
+        return m_error;
+    }
+
+    constexpr const Error& error() const& noexcept
+    {
+        return m_error;
+    }
+
+    constexpr Error&& error() && noexcept
+    {
+        return ohmy::move(m_error);
+    }
+
+private:
+    Error m_error;
+};
+
+template <typename Error>
+unexpected(Error) -> unexpected<Error>;
+
+struct unexpect_t
+{
+    explicit unexpect_t() = default;
+};
+
+inline constexpr unexpect_t unexpect{};
+
+template <typename Error>
+class bad_expected_access : public std::exception
+{
+public:
+    explicit bad_expected_access(Error error) : m_error(ohmy::move(error))
+    {
+    }
+
+    const char* what() const noexcept override
+    {
+        return "bad expected access";
+    }
+
+    const Error& error() const& noexcept
+    {
+        return m_error;
+    }
+
+private:
+    Error m_error;
+};
+
+template <typename Type, typename Error>
+class expected;
+
+namespace detail
+{
+template <typename Type>
+inline constexpr bool is_expected_v = false;
+
+template <typename Type, typename Error>
+inline constexpr bool is_expected_v<expected<Type, Error>> = true;
+
+template <typename Type, typename Error,
+          bool = is_trivially_destructible_v<Type> and
+                 is_trivially_destructible_v<Error>>
+union expected_union
+{
+    constexpr expected_union() noexcept : m_empty{}
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit expected_union(in_place_t, ArgumentTypes&&... arguments)
+        : m_value(ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit expected_union(unexpect_t,
+                                      ArgumentTypes&&... arguments)
+        : m_error(ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    char m_empty;
+    Type m_value;
+    Error m_error;
+};
+
+template <typename Type, typename Error>
+union expected_union<Type, Error, false>
+{
+    constexpr expected_union() noexcept : m_empty{}
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit expected_union(in_place_t, ArgumentTypes&&... arguments)
+        : m_value(ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit expected_union(unexpect_t,
+                                      ArgumentTypes&&... arguments)
+        : m_error(ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    ~expected_union()
+    {
+    }
+
+    char m_empty;
+    Type m_value;
+    Error m_error;
+};
+
+template <typename Type, typename Error>
+struct expected_base
+{
+    // Holds neither, until construct_from.
+    constexpr expected_base() noexcept : m_union{}, m_has_value{false}
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit expected_base(in_place_t, ArgumentTypes&&... arguments)
+        : m_union{in_place, ohmy::forward<ArgumentTypes>(arguments)...},
+          m_has_value{true}
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit expected_base(unexpect_t, ArgumentTypes&&... arguments)
+        : m_union{unexpect, ohmy::forward<ArgumentTypes>(arguments)...},
+          m_has_value{false}
+    {
+    }
+
+    void destroy() noexcept
+    {
+        if (m_has_value)
+        {
+            ohmy::destroy_at(ohmy::addressof(m_union.m_value));
+        }
+        else
+        {
+            ohmy::destroy_at(ohmy::addressof(m_union.m_error));
+        }
+    }
+
+    template <typename Other>
+    void construct_from(Other&& other)
+    {
+        if (other.m_has_value)
+        {
+            ohmy::construct_at(ohmy::addressof(m_union.m_value),
+                               ohmy::forward<Other>(other).m_union.m_value);
+        }
+        else
+        {
+            ohmy::construct_at(ohmy::addressof(m_union.m_error),
+                               ohmy::forward<Other>(other).m_union.m_error);
+        }
+        m_has_value = other.m_has_value;
+    }
+
+    // Replaces the old member of the union with a new one built from
+    // arguments, leaving the old one in place if that throws.
+    template <typename New, typename Old, typename... ArgumentTypes>
+    void reinitialize(New& replacement, Old& old,
+                      ArgumentTypes&&... arguments)
+    {
+        if constexpr (is_nothrow_constructible<New, ArgumentTypes...>::value)
+        {
+            ohmy::destroy_at(ohmy::addressof(old));
+            ohmy::construct_at(ohmy::addressof(replacement),
+                               ohmy::forward<ArgumentTypes>(arguments)...);
+        }
+        else if constexpr (is_nothrow_move_constructible_v<New>)
+        {
+            New temporary(ohmy::forward<ArgumentTypes>(arguments)...);
+            ohmy::destroy_at(ohmy::addressof(old));
+            ohmy::construct_at(ohmy::addressof(replacement),
+                               ohmy::move(temporary));
+        }
+        else
+        {
+            static_assert(is_nothrow_move_constructible_v<Old>,
+                          "expected needs one of its types to move "
+                          "without throwing");
+            Old backup(ohmy::move(old));
+            ohmy::destroy_at(ohmy::addressof(old));
+            try
+            {
+                ohmy::construct_at(ohmy::addressof(replacement),
+                                   ohmy::forward<ArgumentTypes>(arguments)...);
+            }
+            catch (...)
+            {
+                ohmy::construct_at(ohmy::addressof(old), ohmy::move(backup));
+                throw;
+            }
+        }
+    }
+
+    template <typename... ArgumentTypes>
+    void assign_value(ArgumentTypes&&... arguments)
+    {
+        if (m_has_value)
+        {
+            m_union.m_value = Type(ohmy::forward<ArgumentTypes>(arguments)...);
+        }
+        else
+        {
+            reinitialize(m_union.m_value, m_union.m_error,
+                         ohmy::forward<ArgumentTypes>(arguments)...);
+            m_has_value = true;
+        }
+    }
+
+    template <typename... ArgumentTypes>
+    void assign_error(ArgumentTypes&&... arguments)
+    {
+        if (not m_has_value)
+        {
+            m_union.m_error =
+                Error(ohmy::forward<ArgumentTypes>(arguments)...);
+        }
+        else
+        {
+            reinitialize(m_union.m_error, m_union.m_value,
+                         ohmy::forward<ArgumentTypes>(arguments)...);
+            m_has_value = false;
+        }
+    }
+
+    template <typename Other>
+    void assign_from(Other&& other)
+    {
+        if (other.m_has_value)
+        {
+            assign_value(ohmy::forward<Other>(other).m_union.m_value);
+        }
+        else
+        {
+            assign_error(ohmy::forward<Other>(other).m_union.m_error);
+        }
+    }
+
+    expected_union<Type, Error> m_union;
+    bool m_has_value;
+};
+
+template <typename Type, typename Error,
+          bool = is_trivially_destructible_v<Type> and
+                 is_trivially_destructible_v<Error>>
+struct expected_storage : expected_base<Type, Error>
+{
+    using expected_base<Type, Error>::expected_base;
+};
+
+template <typename Type, typename Error>
+struct expected_storage<Type, Error, false> : expected_base<Type, Error>
+{
+    using expected_base<Type, Error>::expected_base;
+
+    expected_storage() = default;
+    expected_storage(const expected_storage&) = default;
+    expected_storage(expected_storage&&) = default;
+    expected_storage& operator=(const expected_storage&) = default;
+    expected_storage& operator=(expected_storage&&) = default;
+
+    ~expected_storage()
+    {
+        this->destroy();
+    }
+};
+
+// Copies and moves the value or the error where copying the bytes would
+// not do.
+template <typename Type, typename Error,
+          bool = is_trivially_copiable_v<Type> and
+                 is_trivially_copiable_v<Error>>
+struct expected_copy : expected_storage<Type, Error>
+{
+    using expected_storage<Type, Error>::expected_storage;
+};
+
+template <typename Type, typename Error>
+struct expected_copy<Type, Error, false> : expected_storage<Type, Error>
+{
+    using expected_storage<Type, Error>::expected_storage;
+
+    expected_copy() = default;
+
+    expected_copy(const expected_copy& other)
+        : expected_storage<Type, Error>()
+    {
+        this->construct_from(other);
+    }
+
+    expected_copy(expected_copy&& other) noexcept(
+        is_nothrow_move_constructible_v<Type> and
+        is_nothrow_move_constructible_v<Error>)
+        : expected_storage<Type, Error>()
+    {
+        this->construct_from(ohmy::move(other));
+    }
+
+    expected_copy& operator=(const expected_copy& other)
+    {
+        this->assign_from(other);
+        return *this;
+    }
+
+    expected_copy& operator=(expected_copy&& other) noexcept(
+        is_nothrow_move_constructible_v<Type> and
+        is_nothrow_move_assignable_v<Type> and
+        is_nothrow_move_constructible_v<Error> and
+        is_nothrow_move_assignable_v<Error>)
+    {
+        this->assign_from(ohmy::move(other));
+        return *this;
+    }
+};
+} // namespace detail
+
+template <typename Type, typename Error>
+class expected
+    : private detail::expected_copy<Type, Error>,
+      private detail::enable_copy_move<
+          is_copy_constructible_v<Type> and is_copy_constructible_v<Error>,
+          is_copy_constructible_v<Type> and is_copy_assignable_v<Type> and
+              is_copy_constructible_v<Error> and
+              is_copy_assignable_v<Error>,
+          is_move_constructible_v<Type> and is_move_constructible_v<Error>,
+          is_move_constructible_v<Type> and is_move_assignable_v<Type> and
+              is_move_constructible_v<Error> and
+              is_move_assignable_v<Error>,
+          expected<Type, Error>>
+{
+    using base = detail::expected_copy<Type, Error>;
+
+    template <typename Other>
+    static constexpr bool is_value_argument_v =
+        is_constructible_v<Type, Other&&> and
+        not is_same_v<decay_t<Other>, expected> and
+        not is_same_v<decay_t<Other>, in_place_t> and
+        not is_same_v<decay_t<Other>, unexpect_t> and
+        not is_same_v<decay_t<Other>, unexpected<Error>>;
+
+public:
+    using value_type = Type;
+    using error_type = Error;
+    using unexpected_type = unexpected<Error>;
+
+    template <typename Value = Type,
+              typename = enable_if_t<is_default_constructible_v<Value>>>
+    constexpr expected() : base(in_place)
+    {
+    }
+
+    template <typename Other = Type,
+              typename = enable_if_t<is_value_argument_v<Other>>>
+    constexpr expected(Other&& value)
+        : base(in_place, ohmy::forward<Other>(value))
+    {
+    }
+
+    template <typename OtherError>
+    constexpr expected(const unexpected<OtherError>& error)
+        : base(unexpect, error.error())
+    {
+    }
+
+    template <typename OtherError>
+    constexpr expected(unexpected<OtherError>&& error)
+        : base(unexpect, ohmy::move(error).error())
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit expected(in_place_t, ArgumentTypes&&... arguments)
+        : base(in_place, ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit expected(unexpect_t, ArgumentTypes&&... arguments)
+        : base(unexpect, ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    template <typename Other = Type,
+              typename = enable_if_t<is_value_argument_v<Other>>>
+    expected& operator=(Other&& value)
+    {
+        this->assign_value(ohmy::forward<Other>(value));
+        return *this;
+    }
+
+    template <typename OtherError>
+    expected& operator=(const unexpected<OtherError>& error)
+    {
+        this->assign_error(error.error());
+        return *this;
+    }
+
+    template <typename OtherError>
+    expected& operator=(unexpected<OtherError>&& error)
+    {
+        this->assign_error(ohmy::move(error).error());
+        return *this;
+    }
+
+    template <typename... ArgumentTypes>
+    Type& emplace(ArgumentTypes&&... arguments)
+    {
+        this->assign_value(ohmy::forward<ArgumentTypes>(arguments)...);
+        return this->m_union.m_value;
+    }
+
+    constexpr bool has_value() const noexcept
+    {
+        return this->m_has_value;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    constexpr Type& operator*() & noexcept
+    {
+        return this->m_union.m_value;
+    }
+
+    constexpr const Type& operator*() const& noexcept
+    {
+        return this->m_union.m_value;
+    }
+
+    constexpr Type&& operator*() && noexcept
+    {
+        return ohmy::move(this->m_union.m_value);
+    }
+
+    constexpr Type* operator->() noexcept
+    {
+        return ohmy::addressof(this->m_union.m_value);
+    }
+
+    constexpr const Type* operator->() const noexcept
+    {
+        return ohmy::addressof(this->m_union.m_value);
+    }
+
+    constexpr Type& value() &
+    {
+        check();
+        return this->m_union.m_value;
+    }
+
+    constexpr const Type& value() const&
+    {
+        check();
+        return this->m_union.m_value;
+    }
+
+    constexpr Type&& value() &&
+    {
+        check();
+        return ohmy::move(this->m_union.m_value);
+    }
+
+    constexpr Error& error() & noexcept
+    {
+        return this->m_union.m_error;
+    }
+
+    constexpr const Error& error() const& noexcept
+    {
+        return this->m_union.m_error;
+    }
+
+    constexpr Error&& error() && noexcept
+    {
+        return ohmy::move(this->m_union.m_error);
+    }
+
+    template <typename Other>
+    constexpr Type value_or(Other&& fallback) const&
+    {
+        return has_value() ? **this
+                           : static_cast<Type>(ohmy::forward<Other>(fallback));
+    }
+
+    template <typename Other>
+    constexpr Type value_or(Other&& fallback) &&
+    {
+        return has_value() ? ohmy::move(**this)
+                           : static_cast<Type>(ohmy::forward<Other>(fallback));
+    }
+
+    // Calls function with the value, which returns an expected with the
+    // same error type.
+    template <typename Function>
+    constexpr auto and_then(Function&& function) &
+    {
+        return and_then(*this, ohmy::forward<Function>(function));
+    }
+
+    template <typename Function>
+    constexpr auto and_then(Function&& function) const&
+    {
+        return and_then(*this, ohmy::forward<Function>(function));
+    }
+
+    template <typename Function>
+    constexpr auto and_then(Function&& function) &&
+    {
+        return and_then(ohmy::move(*this), ohmy::forward<Function>(function));
+    }
+
+    // Calls function with the value and wraps what it returns.
+    template <typename Function>
+    constexpr auto transform(Function&& function) &
+    {
+        return transform(*this, ohmy::forward<Function>(function));
+    }
+
+    template <typename Function>
+    constexpr auto transform(Function&& function) const&
+    {
+        return transform(*this, ohmy::forward<Function>(function));
+    }
+
+    template <typename Function>
+    constexpr auto transform(Function&& function) &&
+    {
+        return transform(ohmy::move(*this), ohmy::forward<Function>(function));
+    }
+
+    // Calls function with the error, which returns an expected with the
+    // same value type.
+    template <typename Function>
+    constexpr auto or_else(Function&& function) &
+    {
+        return or_else(*this, ohmy::forward<Function>(function));
+    }
+
+    template <typename Function>
+    constexpr auto or_else(Function&& function) const&
+    {
+        return or_else(*this, ohmy::forward<Function>(function));
+    }
+
+    template <typename Function>
+    constexpr auto or_else(Function&& function) &&
+    {
+        return or_else(ohmy::move(*this), ohmy::forward<Function>(function));
+    }
+
+    // Calls function with the error and wraps what it returns.
+    template <typename Function>
+    constexpr auto transform_error(Function&& function) &
+    {
+        return transform_error(*this, ohmy::forward<Function>(function));
+    }
+
+    template <typename Function>
+    constexpr auto transform_error(Function&& function) const&
+    {
+        return transform_error(*this, ohmy::forward<Function>(function));
+    }
+
+    template <typename Function>
+    constexpr auto transform_error(Function&& function) &&
+    {
+        return transform_error(ohmy::move(*this),
+                               ohmy::forward<Function>(function));
+    }
+
+private:
+    constexpr void check() const
+    {
+        if (not has_value())
+            throw bad_expected_access<Error>{error()};
+    }
+
+    template <typename Self, typename Function>
+    static constexpr auto and_then(Self&& self, Function&& function)
+    {
+        using result = remove_cvref_t<
+            invoke_result_t<Function, decltype(*ohmy::forward<Self>(self))>>;
+        static_assert(detail::is_expected_v<result>,
+                      "and_then needs a function that returns an expected");
+        static_assert(is_same_v<typename result::error_type, Error>,
+                      "and_then needs a function with the same error type");
+        if (self.has_value())
+        {
+            return ohmy::invoke(ohmy::forward<Function>(function),
+                                *ohmy::forward<Self>(self));
+        }
+        return result(unexpect, ohmy::forward<Self>(self).error());
+    }
+
+    template <typename Self, typename Function>
+    static constexpr auto transform(Self&& self, Function&& function)
+    {
+        using value = remove_cvref_t<
+            invoke_result_t<Function, decltype(*ohmy::forward<Self>(self))>>;
+        using result = expected<value, Error>;
+        if (self.has_value())
+        {
+            return result(in_place,
+                          ohmy::invoke(ohmy::forward<Function>(function),
+                                       *ohmy::forward<Self>(self)));
+        }
+        return result(unexpect, ohmy::forward<Self>(self).error());
+    }
+
+    template <typename Self, typename Function>
+    static constexpr auto or_else(Self&& self, Function&& function)
+    {
+        using result = remove_cvref_t<invoke_result_t<
+            Function, decltype(ohmy::forward<Self>(self).error())>>;
+        static_assert(detail::is_expected_v<result>,
+                      "or_else needs a function that returns an expected");
+        static_assert(is_same_v<typename result::value_type, Type>,
+                      "or_else needs a function with the same value type");
+        if (self.has_value())
+        {
+            return result(in_place, *ohmy::forward<Self>(self));
+        }
+        return ohmy::invoke(ohmy::forward<Function>(function),
+                            ohmy::forward<Self>(self).error());
+    }
+
+    template <typename Self, typename Function>
+    static constexpr auto transform_error(Self&& self, Function&& function)
+    {
+        using error = remove_cvref_t<invoke_result_t<
+            Function, decltype(ohmy::forward<Self>(self).error())>>;
+        using result = expected<Type, error>;
+        if (self.has_value())
+        {
+            return result(in_place, *ohmy::forward<Self>(self));
+        }
+        return result(unexpect,
+                      ohmy::invoke(ohmy::forward<Function>(function),
+                                   ohmy::forward<Self>(self).error()));
+    }
+};
+
+template <typename Type, typename Error, typename OtherType,
+          typename OtherError>
+constexpr bool operator==(const expected<Type, Error>& lhs,
+                          const expected<OtherType, OtherError>& rhs)
+{
+    if (lhs.has_value() != rhs.has_value())
+    {
+        return false;
+    }
+    return lhs.has_value() ? *lhs == *rhs : lhs.error() == rhs.error();
+}
+
+template <typename Type, typename Error, typename OtherType,
+          typename OtherError>
+constexpr bool operator!=(const expected<Type, Error>& lhs,
+                          const expected<OtherType, OtherError>& rhs)
+{
+    return not(lhs == rhs);
+}
+
+template <typename Type, typename Error, typename OtherType,
+          typename = enable_if_t<not detail::is_expected_v<OtherType>>>
+constexpr bool operator==(const expected<Type, Error>& lhs,
+                          const OtherType& rhs)
+{
+    return lhs.has_value() and *lhs == rhs;
+}
+
+template <typename Type, typename Error, typename OtherError>
+constexpr bool operator==(const expected<Type, Error>& lhs,
+                          const unexpected<OtherError>& rhs)
+{
+    return not lhs.has_value() and lhs.error() == rhs.error();
+}
+
+template <typename Type, typename Error>
+struct is_trivially_relocatable<expected<Type, Error>>
+    : conjunction<is_trivially_relocatable<Type>,
+                  is_trivially_relocatable<Error>>
+{
+};
+} // namespace ohmy
+
+#endif // OHMY_EXPECTED_HPP
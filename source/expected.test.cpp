@@ -0,0 +1,271 @@
+#include <catch/catch.hpp>
+
+#include "expected.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+enum class parse_error : uint8_t
+{
+    empty,
+    not_a_digit,
+    too_large
+};
+
+// Counts its live instances.
+struct Tracked
+{
+    explicit Tracked(int value, int& live) : value{value}, live{&live}
+    {
+        ++*this->live;
+    }
+
+    Tracked(const Tracked& other) : value{other.value}, live{other.live}
+    {
+        ++*live;
+    }
+
+    Tracked& operator=(const Tracked& other)
+    {
+        value = other.value;
+        return *this;
+    }
+
+    ~Tracked()
+    {
+        --*live;
+    }
+
+    int value;
+    int* live;
+};
+
+struct Throwing
+{
+    explicit Throwing(bool fail) : failed{fail}
+    {
+        if (fail)
+            throw std::runtime_error("construction failed");
+    }
+
+    bool failed;
+};
+
+struct MoveOnly
+{
+    std::unique_ptr<int> value;
+};
+
+ohmy::expected<int, parse_error> parse_digit(char c)
+{
+    if (c < '0' or c > '9')
+        return ohmy::unexpected{parse_error::not_a_digit};
+    return c - '0';
+}
+
+ohmy::expected<int, parse_error> parse(const std::string& text)
+{
+    if (text.empty())
+        return ohmy::unexpected{parse_error::empty};
+
+    int result = 0;
+    for (char c : text)
+    {
+        auto digit = parse_digit(c);
+        if (not digit)
+            return ohmy::unexpected{digit.error()};
+        if (result > 9999)
+            return ohmy::unexpected{parse_error::too_large};
+        result = result * 10 + *digit;
+    }
+    return result;
+}
+} // namespace
+
+// The flag goes into tail padding where there is some.
+static_assert(sizeof(ohmy::expected<char, parse_error>) == 2);
+static_assert(sizeof(ohmy::expected<int, parse_error>) == 2 * sizeof(int));
+static_assert(sizeof(ohmy::expected<int*, int>) == 2 * sizeof(int*));
+
+// Triviality follows both types.
+static_assert(ohmy::is_trivially_copiable_v<ohmy::expected<int, parse_error>>);
+static_assert(
+    ohmy::is_trivially_destructible_v<ohmy::expected<double, parse_error>>);
+static_assert(
+    not ohmy::is_trivially_copiable_v<ohmy::expected<std::string, int>>);
+static_assert(
+    not ohmy::is_trivially_destructible_v<ohmy::expected<int, std::string>>);
+
+// Copies and moves exist only where both types have them.
+static_assert(not ohmy::is_copy_constructible_v<
+              ohmy::expected<MoveOnly, parse_error>>);
+static_assert(
+    not ohmy::is_copy_assignable_v<ohmy::expected<MoveOnly, parse_error>>);
+static_assert(not ohmy::is_copy_constructible_v<ohmy::expected<int, MoveOnly>>);
+static_assert(not ohmy::is_copy_assignable_v<ohmy::expected<int, MoveOnly>>);
+static_assert(
+    ohmy::is_move_constructible_v<ohmy::expected<MoveOnly, MoveOnly>>);
+static_assert(ohmy::is_move_assignable_v<ohmy::expected<MoveOnly, MoveOnly>>);
+static_assert(
+    ohmy::is_copy_assignable_v<ohmy::expected<std::string, std::string>>);
+
+static_assert(ohmy::expected<int, parse_error>{3}.value() == 3);
+static_assert(not ohmy::expected<int, parse_error>{
+    ohmy::unexpect, parse_error::empty}.has_value());
+
+TEST_CASE("expected")
+{
+    SECTION("values and errors")
+    {
+        ohmy::expected<int, parse_error> result;
+        REQUIRE(result.has_value());
+        REQUIRE(*result == 0);
+
+        result = ohmy::unexpected{parse_error::too_large};
+        REQUIRE_FALSE(result);
+        REQUIRE(result.error() == parse_error::too_large);
+        REQUIRE(result == ohmy::unexpected{parse_error::too_large});
+        REQUIRE(result.value_or(7) == 7);
+        REQUIRE_THROWS_AS(result.value(),
+                          ohmy::bad_expected_access<parse_error>);
+
+        result = 4;
+        REQUIRE(result.value() == 4);
+        REQUIRE(result == 4);
+        REQUIRE(result != ohmy::expected<int, parse_error>{5});
+    }
+
+    SECTION("the error is carried by the exception")
+    {
+        ohmy::expected<std::string, std::string> result{ohmy::unexpect,
+                                                        "no input"};
+        try
+        {
+            (void)result.value();
+            FAIL("value did not throw");
+        }
+        catch (const ohmy::bad_expected_access<std::string>& error)
+        {
+            REQUIRE(error.error() == "no input");
+        }
+    }
+
+    SECTION("values and errors that are not trivial are destroyed once")
+    {
+        int live = 0;
+        {
+            ohmy::expected<Tracked, std::string> first{ohmy::in_place, 1,
+                                                       live};
+            ohmy::expected<Tracked, std::string> second{ohmy::unexpect,
+                                                        "failed"};
+            REQUIRE(live == 1);
+
+            second = first;
+            REQUIRE(live == 2);
+            second->value = 2;
+            first = second;
+            REQUIRE(first->value == 2);
+
+            first = ohmy::unexpected{std::string(40, 'x')};
+            REQUIRE(live == 1);
+            REQUIRE(first.error().size() == 40u);
+
+            {
+                ohmy::expected<Tracked, std::string> third = first;
+                REQUIRE(third.error() == first.error());
+                third = std::move(second);
+                REQUIRE(live == 2);
+            }
+            REQUIRE(live == 1);
+            first.emplace(3, live);
+            REQUIRE(live == 2);
+        }
+        REQUIRE(live == 0);
+    }
+
+    SECTION("move-only values and errors")
+    {
+        ohmy::expected<MoveOnly, MoveOnly> result{
+            ohmy::unexpect, MoveOnly{std::make_unique<int>(1)}};
+        ohmy::expected<MoveOnly, MoveOnly> other{
+            MoveOnly{std::make_unique<int>(2)}};
+        result = std::move(other);
+        REQUIRE(*result->value == 2);
+        other = ohmy::unexpected{MoveOnly{std::make_unique<int>(3)}};
+        result = std::move(other);
+        REQUIRE(*result.error().value == 3);
+    }
+
+    SECTION("a failed switch to the value keeps the error")
+    {
+        ohmy::expected<Throwing, int> result{ohmy::unexpect, 5};
+        REQUIRE_THROWS_AS(result.emplace(true), std::runtime_error);
+        REQUIRE(result.error() == 5);
+        result.emplace(false);
+        REQUIRE(result.has_value());
+    }
+}
+
+TEST_CASE("expected chains")
+{
+    auto twice = [](int value) { return value * 2; };
+    auto half = [](int value) -> ohmy::expected<int, parse_error> {
+        if (value % 2 != 0)
+            return ohmy::unexpected{parse_error::not_a_digit};
+        return value / 2;
+    };
+
+    SECTION("and_then and transform run on values")
+    {
+        REQUIRE(parse("42").and_then(half).transform(twice) == 42);
+        REQUIRE(parse("7").and_then(half) ==
+                ohmy::unexpected{parse_error::not_a_digit});
+    }
+
+    SECTION("the first error skips the remaining steps")
+    {
+        int calls = 0;
+        auto counted = [&calls](int value) {
+            ++calls;
+            return value;
+        };
+        auto result = parse("4x2").transform(counted).and_then(half);
+        REQUIRE(result.error() == parse_error::not_a_digit);
+        REQUIRE(calls == 0);
+        REQUIRE(parse("").error() == parse_error::empty);
+        REQUIRE(parse("123456").error() == parse_error::too_large);
+    }
+
+    SECTION("or_else and transform_error run on errors")
+    {
+        auto fallback = [](parse_error error)
+            -> ohmy::expected<int, std::string> {
+            if (error == parse_error::empty)
+                return 0;
+            return ohmy::unexpected{std::string{"bad input"}};
+        };
+        auto describe = [](parse_error) { return std::string{"bad input"}; };
+
+        REQUIRE(parse("").transform_error(describe).error() == "bad input");
+        REQUIRE(parse("").or_else(fallback) == 0);
+        REQUIRE(parse("9").or_else(fallback) == 9);
+        REQUIRE(parse("x").or_else(fallback).error() == "bad input");
+    }
+
+    SECTION("values move through rvalue chains")
+    {
+        ohmy::expected<std::string, parse_error> text{std::string(40, 'y')};
+        auto length = std::move(text)
+                          .transform([](std::string value) {
+                              return value + "z";
+                          })
+                          .transform([](const std::string& value) {
+                              return value.size();
+                          });
+        REQUIRE(length == 41u);
+    }
+}
@@ -0,0 +1,1138 @@
+#ifndef OHMY_FLAT_HASH_MAP_HPP
+#define OHMY_FLAT_HASH_MAP_HPP
+
+#include "c++config.hpp"
+#include "hash.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Open-addressing hash tables in the layout of Swiss tables. The elements
+// live in one flat array of slots, and a parallel array holds one control
+// byte per slot: empty, deleted, or the low seven bits of the hash of the
+// element in it. A lookup loads the control bytes of a group of sixteen
+// consecutive slots at once and compares them against those seven bits
+// with SSE2, so it touches the slot array only for likely matches and
+// usually stops at the first group, which has an empty byte.
+//
+// Erasing leaves a deleted marker only when a probe sequence may have
+// passed the slot while the group around it was full; otherwise the slot
+// becomes empty again. When the table grows, entries of trivially
+// relocatable types are moved with memcpy.
+//
+// Like std::unordered_map, but unlike its node-based layout, inserting
+// invalidates iterators and references when the table grows. Hash must
+// not throw while the table is rehashed.
+namespace ohmy
+{
+namespace detail
+{
+using control_byte = signed char;
+
+inline constexpr control_byte control_empty = -128;
+inline constexpr control_byte control_deleted = -2;
+inline constexpr size_t group_width = 16;
+
+// One bit per slot of a group, set for the slots that matched.
+class group_mask
+{
+public:
+    explicit group_mask(uint32_t bits) noexcept : m_bits{bits}
+    {
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_bits != 0;
+    }
+
+    unsigned lowest() const noexcept
+    {
+        return static_cast<unsigned>(__builtin_ctz(m_bits));
+    }
+
+    unsigned trailing_zeros() const noexcept
+    {
+        return m_bits != 0 ? lowest() : group_width;
+    }
+
+    unsigned leading_zeros() const noexcept
+    {
+        return m_bits != 0 ? static_cast<unsigned>(__builtin_clz(m_bits)) - 16
+                           : group_width;
+    }
+
+    // Iterating yields the offsets of the matching slots.
+    group_mask begin() const noexcept
+    {
+        return *this;
+    }
+
+    group_mask end() const noexcept
+    {
+        return group_mask{0};
+    }
+
+    unsigned operator*() const noexcept
+    {
+        return lowest();
+    }
+
+    group_mask& operator++() noexcept
+    {
+        m_bits &= m_bits - 1;
+        return *this;
+    }
+
+    bool operator!=(const group_mask& other) const noexcept
+    {
+        return m_bits != other.m_bits;
+    }
+
+private:
+    uint32_t m_bits;
+};
+
+// The control bytes of group_width consecutive slots.
+class control_group
+{
+public:
+    explicit control_group(const control_byte* control) noexcept
+#if defined(__SSE2__)
+        : m_bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(control))}
+    {
+    }
+#else
+    {
+        __builtin_memcpy(m_bytes, control, group_width);
+    }
+#endif
+
+    group_mask match(control_byte value) const noexcept
+    {
+#if defined(__SSE2__)
+        return group_mask{static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(m_bytes, _mm_set1_epi8(value))))};
+#else
+        uint32_t bits = 0;
+        for (size_t i = 0; i < group_width; ++i)
+        {
+            bits |= static_cast<uint32_t>(m_bytes[i] == value) << i;
+        }
+        return group_mask{bits};
+#endif
+    }
+
+    group_mask match_empty() const noexcept
+    {
+        return match(control_empty);
+    }
+
+    // Full slots hold a non-negative byte.
+    group_mask match_empty_or_deleted() const noexcept
+    {
+#if defined(__SSE2__)
+        return group_mask{static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_cmpgt_epi8(_mm_set1_epi8(-1), m_bytes)))};
+#else
+        uint32_t bits = 0;
+        for (size_t i = 0; i < group_width; ++i)
+        {
+            bits |= static_cast<uint32_t>(m_bytes[i] < -1) << i;
+        }
+        return group_mask{bits};
+#endif
+    }
+
+private:
+#if defined(__SSE2__)
+    __m128i m_bytes;
+#else
+    control_byte m_bytes[group_width];
+#endif
+};
+
+// Visits the groups starting at the slot picked by the hash, advancing by
+// one more group every step. The capacity is a power of two, so the
+// triangular strides reach every group.
+class probe_sequence
+{
+public:
+    probe_sequence(size_t hash, size_t mask) noexcept
+        : m_mask{mask}, m_offset{hash & mask}
+    {
+    }
+
+    size_t offset() const noexcept
+    {
+        return m_offset;
+    }
+
+    size_t offset(unsigned slot) const noexcept
+    {
+        return (m_offset + slot) & m_mask;
+    }
+
+    void next() noexcept
+    {
+        m_index += group_width;
+        m_offset = (m_offset + m_index) & m_mask;
+    }
+
+private:
+    size_t m_mask;
+    size_t m_offset;
+    size_t m_index = 0;
+};
+
+// The high bits of a hash pick the first group, the low seven are kept in
+// the control byte.
+inline size_t probe_hash(size_t hash) noexcept
+{
+    return hash >> 7;
+}
+
+inline control_byte control_hash(size_t hash) noexcept
+{
+    return static_cast<control_byte>(hash & 0x7f);
+}
+
+template <typename Type, typename = void>
+inline constexpr bool is_transparent_v = false;
+
+template <typename Type>
+inline constexpr bool is_transparent_v<Type,
+                                       void_t<typename Type::is_transparent>> =
+    true;
+
+// Lookups take the key type, or any type when both the hash and the key
+// comparison are transparent.
+template <bool Transparent>
+struct key_arg
+{
+    template <typename Lookup, typename Key>
+    using type = Lookup;
+};
+
+template <>
+struct key_arg<false>
+{
+    template <typename Lookup, typename Key>
+    using type = Key;
+};
+
+template <typename Key>
+struct set_policy
+{
+    using key_type = Key;
+    using value_type = Key;
+    using slot_type = Key;
+
+    static const Key& key(const slot_type& slot) noexcept
+    {
+        return slot;
+    }
+
+    static const value_type& element(const slot_type& slot) noexcept
+    {
+        return slot;
+    }
+};
+
+// Slots hold a pair with a mutable key so that they can be moved when
+// the table grows; users see it as a pair with a const key, which has the
+// same layout.
+template <typename Key, typename Value>
+struct map_policy
+{
+    using key_type = Key;
+    using value_type = std::pair<const Key, Value>;
+    using slot_type = std::pair<Key, Value>;
+
+    static const Key& key(const slot_type& slot) noexcept
+    {
+        return slot.first;
+    }
+
+    static value_type& element(slot_type& slot) noexcept
+    {
+        return *std::launder(reinterpret_cast<value_type*>(&slot));
+    }
+
+    static const value_type& element(const slot_type& slot) noexcept
+    {
+        return *std::launder(reinterpret_cast<const value_type*>(&slot));
+    }
+};
+
+template <typename Policy, typename Hash, typename KeyEqual>
+class raw_hash_table
+{
+    using slot_type = typename Policy::slot_type;
+
+    static constexpr bool transparent =
+        is_transparent_v<Hash> and is_transparent_v<KeyEqual>;
+
+protected:
+    template <typename Lookup>
+    using key_arg = typename detail::key_arg<
+        transparent>::template type<Lookup, typename Policy::key_type>;
+
+public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    template <typename Element>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename Policy::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = Element*;
+        using reference = Element&;
+
+        basic_iterator() noexcept = default;
+
+        // An iterator converts to a const_iterator.
+        template <typename Other,
+                  typename = enable_if_t<is_same_v<const Other, Element> and
+                                         not is_same_v<Other, Element>>>
+        basic_iterator(const basic_iterator<Other>& other) noexcept
+            : m_control{other.m_control}, m_slot{other.m_slot},
+              m_end{other.m_end}
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return Policy::element(*m_slot);
+        }
+
+        pointer operator->() const noexcept
+        {
+            return ohmy::addressof(**this);
+        }
+
+        basic_iterator& operator++() noexcept
+        {
+            ++m_control;
+            ++m_slot;
+            skip_free();
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            basic_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const basic_iterator& lhs,
+                               const basic_iterator& rhs) noexcept
+        {
+            return lhs.m_slot == rhs.m_slot;
+        }
+
+        friend bool operator!=(const basic_iterator& lhs,
+                               const basic_iterator& rhs) noexcept
+        {
+            return lhs.m_slot != rhs.m_slot;
+        }
+
+    private:
+        friend class raw_hash_table;
+        template <typename Other>
+        friend class basic_iterator;
+
+        basic_iterator(const control_byte* control, slot_type* slot,
+                       const control_byte* end) noexcept
+            : m_control{control}, m_slot{slot}, m_end{end}
+        {
+            skip_free();
+        }
+
+        void skip_free() noexcept
+        {
+            while (m_control != m_end and *m_control < 0)
+            {
+                ++m_control;
+                ++m_slot;
+            }
+        }
+
+        const control_byte* m_control = nullptr;
+        slot_type* m_slot = nullptr;
+        const control_byte* m_end = nullptr;
+    };
+
+    using iterator = conditional_t<is_same_v<key_type, value_type>,
+                                   basic_iterator<const value_type>,
+                                   basic_iterator<value_type>>;
+    using const_iterator = basic_iterator<const value_type>;
+
+    raw_hash_table() noexcept = default;
+
+    explicit raw_hash_table(size_t capacity, const Hash& hash = Hash(),
+                            const KeyEqual& equal = KeyEqual())
+        : m_hash{hash}, m_equal{equal}
+    {
+        reserve(capacity);
+    }
+
+    raw_hash_table(const raw_hash_table& other)
+        : m_hash{other.m_hash}, m_equal{other.m_equal}
+    {
+        if (other.m_size == 0)
+        {
+            return;
+        }
+
+        // Same capacity, same positions: the control bytes are copied as
+        // they are and every element is copied into its own slot.
+        storage copy = allocate_storage(other.m_capacity);
+        __builtin_memcpy(copy.control, other.m_control,
+                         other.m_capacity + group_width);
+        size_t index = 0;
+        try
+        {
+            for (; index < other.m_capacity; ++index)
+            {
+                if (other.m_control[index] >= 0)
+                {
+                    ohmy::construct_at(copy.slots + index,
+                                       other.m_slots[index]);
+                }
+            }
+        }
+        catch (...)
+        {
+            destroy_slots(copy, index);
+            deallocate_storage(copy);
+            throw;
+        }
+        install(copy);
+        m_size = other.m_size;
+        m_growth_left = other.m_growth_left;
+    }
+
+    raw_hash_table(raw_hash_table&& other) noexcept
+        : m_control{other.m_control}, m_slots{other.m_slots},
+          m_capacity{other.m_capacity}, m_size{other.m_size},
+          m_growth_left{other.m_growth_left}, m_hash{other.m_hash},
+          m_equal{other.m_equal}
+    {
+        other.forget();
+    }
+
+    raw_hash_table& operator=(const raw_hash_table& other)
+    {
+        if (this != ohmy::addressof(other))
+        {
+            raw_hash_table copy{other};
+            swap(copy);
+        }
+        return *this;
+    }
+
+    raw_hash_table& operator=(raw_hash_table&& other) noexcept
+    {
+        if (this != ohmy::addressof(other))
+        {
+            release();
+            m_control = other.m_control;
+            m_slots = other.m_slots;
+            m_capacity = other.m_capacity;
+            m_size = other.m_size;
+            m_growth_left = other.m_growth_left;
+            m_hash = other.m_hash;
+            m_equal = other.m_equal;
+            other.forget();
+        }
+        return *this;
+    }
+
+    ~raw_hash_table()
+    {
+        release();
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator_at(0);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator_at(m_capacity);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator_at(0);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator_at(m_capacity);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    // The number of slots; at most seven eighths of them are used.
+    size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    float load_factor() const noexcept
+    {
+        return m_capacity == 0 ? 0.0f
+                               : static_cast<float>(m_size) / m_capacity;
+    }
+
+    hasher hash_function() const
+    {
+        return m_hash;
+    }
+
+    key_equal key_eq() const
+    {
+        return m_equal;
+    }
+
+    template <typename Lookup = key_type>
+    iterator find(const key_arg<Lookup>& key)
+    {
+        const size_t index = find_index(key, m_hash(key));
+        return index != npos ? iterator_at(index) : end();
+    }
+
+    template <typename Lookup = key_type>
+    const_iterator find(const key_arg<Lookup>& key) const
+    {
+        const size_t index = find_index(key, m_hash(key));
+        return index != npos ? const_iterator_at(index) : end();
+    }
+
+    template <typename Lookup = key_type>
+    bool contains(const key_arg<Lookup>& key) const
+    {
+        return find_index(key, m_hash(key)) != npos;
+    }
+
+    template <typename Lookup = key_type>
+    size_t count(const key_arg<Lookup>& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <typename Lookup = key_type,
+              typename = enable_if_t<
+                  not is_convertible_v<const Lookup&, const_iterator>>>
+    size_t erase(const key_arg<Lookup>& key)
+    {
+        const size_t index = find_index(key, m_hash(key));
+        if (index == npos)
+        {
+            return 0;
+        }
+        erase_at(index);
+        return 1;
+    }
+
+    // Returns the iterator following position.
+    iterator erase(const_iterator position) noexcept
+    {
+        const size_t index = static_cast<size_t>(position.m_slot - m_slots);
+        erase_at(index);
+        return iterator_at(index);
+    }
+
+    template <typename Iterator,
+              typename = enable_if_t<is_same_v<Iterator, iterator> and
+                                     not is_same_v<iterator, const_iterator>>>
+    iterator erase(Iterator position) noexcept
+    {
+        return erase(const_iterator{position});
+    }
+
+    // Keeps the capacity.
+    void clear() noexcept
+    {
+        if (m_capacity == 0)
+        {
+            return;
+        }
+        destroy_slots(storage{m_control, m_slots, m_capacity}, m_capacity);
+        __builtin_memset(m_control, control_empty, m_capacity + group_width);
+        m_size = 0;
+        m_growth_left = max_load(m_capacity);
+    }
+
+    // Makes room for count elements without growing again.
+    void reserve(size_t count)
+    {
+        if (count <= m_size + m_growth_left)
+        {
+            return;
+        }
+        size_t capacity = group_width;
+        while (max_load(capacity) < count)
+        {
+            if (capacity > max_capacity / 2)
+                throw std::length_error(__PRETTY_FUNCTION__);
+            capacity *= 2;
+        }
+        resize(capacity);
+    }
+
+    void swap(raw_hash_table& other) noexcept
+    {
+        ohmy::swap(m_control, other.m_control);
+        ohmy::swap(m_slots, other.m_slots);
+        ohmy::swap(m_capacity, other.m_capacity);
+        ohmy::swap(m_size, other.m_size);
+        ohmy::swap(m_growth_left, other.m_growth_left);
+        ohmy::swap(m_hash, other.m_hash);
+        ohmy::swap(m_equal, other.m_equal);
+    }
+
+protected:
+    // Inserts the element that construct builds in a slot, unless key is
+    // already present; construct receives the uninitialized slot.
+    template <typename Lookup, typename Construct>
+    std::pair<iterator, bool> find_or_insert(const Lookup& key,
+                                             Construct&& construct)
+    {
+        const size_t hash = m_hash(key);
+        size_t index = find_index(key, hash);
+        if (index != npos)
+        {
+            return {iterator_at(index), false};
+        }
+
+        index = prepare_insert(hash);
+        construct(m_slots + index);
+        if (m_control[index] == control_empty)
+        {
+            --m_growth_left;
+        }
+        set_control(m_control, m_capacity, index, control_hash(hash));
+        ++m_size;
+        return {iterator_at(index), true};
+    }
+
+    // Builds the element first, for the emplace overloads whose key is
+    // only known once it exists.
+    template <typename... ArgumentTypes>
+    std::pair<iterator, bool> emplace_slot(ArgumentTypes&&... arguments)
+    {
+        relocation_buffer<slot_type> element{
+            ohmy::forward<ArgumentTypes>(arguments)...};
+        return find_or_insert(Policy::key(*element.get()),
+                              [&element](slot_type* slot) {
+                                  ohmy::relocate_at(element.get(), slot);
+                                  element.release();
+                              });
+    }
+
+private:
+    struct storage
+    {
+        control_byte* control;
+        slot_type* slots;
+        size_t capacity;
+    };
+
+    static constexpr size_t npos = ~size_t{0};
+    static constexpr size_t max_capacity = ~size_t{0} / sizeof(slot_type) / 2;
+
+    static size_t max_load(size_t capacity) noexcept
+    {
+        return capacity - capacity / 8;
+    }
+
+    // The first group_width control bytes are repeated after the last
+    // one, so a group can be loaded at any slot without wrapping.
+    static void set_control(control_byte* control, size_t capacity,
+                            size_t index, control_byte value) noexcept
+    {
+        control[index] = value;
+        if (index < group_width)
+        {
+            control[capacity + index] = value;
+        }
+    }
+
+    static size_t find_free(const control_byte* control, size_t capacity,
+                            size_t hash) noexcept
+    {
+        probe_sequence probe{probe_hash(hash), capacity - 1};
+        while (true)
+        {
+            const control_group group{control + probe.offset()};
+            if (const group_mask free = group.match_empty_or_deleted())
+            {
+                return probe.offset(free.lowest());
+            }
+            probe.next();
+        }
+    }
+
+    static storage allocate_storage(size_t capacity)
+    {
+        allocator<control_byte> control_allocator;
+        allocator<slot_type> slot_allocator;
+        storage result{control_allocator.allocate(capacity + group_width),
+                       nullptr, capacity};
+        try
+        {
+            result.slots = slot_allocator.allocate(capacity);
+        }
+        catch (...)
+        {
+            control_allocator.deallocate(result.control,
+                                         capacity + group_width);
+            throw;
+        }
+        __builtin_memset(result.control, control_empty,
+                         capacity + group_width);
+        return result;
+    }
+
+    static void deallocate_storage(const storage& table) noexcept
+    {
+        allocator<control_byte>{}.deallocate(table.control,
+                                             table.capacity + group_width);
+        allocator<slot_type>{}.deallocate(table.slots, table.capacity);
+    }
+
+    // Destroys the elements in the first count slots.
+    static void destroy_slots(const storage& table, size_t count) noexcept
+    {
+        if constexpr (not is_trivially_destructible_v<slot_type>)
+        {
+            for (size_t index = 0; index < count; ++index)
+            {
+                if (table.control[index] >= 0)
+                {
+                    ohmy::destroy_at(table.slots + index);
+                }
+            }
+        }
+    }
+
+    template <typename Lookup>
+    size_t find_index(const Lookup& key, size_t hash) const
+    {
+        if (m_capacity == 0)
+        {
+            return npos;
+        }
+
+        const control_byte stored_hash = control_hash(hash);
+        probe_sequence probe{probe_hash(hash), m_capacity - 1};
+        while (true)
+        {
+            const control_group group{m_control + probe.offset()};
+            for (const unsigned slot : group.match(stored_hash))
+            {
+                const size_t index = probe.offset(slot);
+                if (m_equal(Policy::key(m_slots[index]), key))
+                {
+                    return index;
+                }
+            }
+            if (group.match_empty())
+            {
+                return npos;
+            }
+            probe.next();
+        }
+    }
+
+    // A deleted slot can be reused without using up growth; an empty one
+    // cannot once the table is at its maximum load.
+    size_t prepare_insert(size_t hash)
+    {
+        if (m_capacity != 0)
+        {
+            const size_t index = find_free(m_control, m_capacity, hash);
+            if (m_growth_left != 0 or m_control[index] == control_deleted)
+            {
+                return index;
+            }
+        }
+        grow();
+        return find_free(m_control, m_capacity, hash);
+    }
+
+    // Doubles the capacity, unless deleted slots take up so much of it
+    // that rehashing at the same capacity frees enough room.
+    void grow()
+    {
+        if (m_capacity == 0)
+        {
+            resize(group_width);
+        }
+        else if (m_size <= max_load(m_capacity) / 2)
+        {
+            resize(m_capacity);
+        }
+        else
+        {
+            if (m_capacity > max_capacity / 2)
+                throw std::length_error(__PRETTY_FUNCTION__);
+            resize(2 * m_capacity);
+        }
+    }
+
+    void resize(size_t capacity)
+    {
+        storage fresh = allocate_storage(capacity);
+        if constexpr (is_nothrow_relocatable_v<slot_type>)
+        {
+            // A memcpy per element for trivially relocatable types.
+            for (size_t index = 0; index < m_capacity; ++index)
+            {
+                if (m_control[index] >= 0)
+                {
+                    transfer(fresh, m_slots + index, [&](slot_type* slot) {
+                        ohmy::relocate_at(m_slots + index, slot);
+                    });
+                }
+            }
+        }
+        else
+        {
+            // Copies, so the table is left intact if a copy throws.
+            try
+            {
+                for (size_t index = 0; index < m_capacity; ++index)
+                {
+                    if (m_control[index] >= 0)
+                    {
+                        transfer(fresh, m_slots + index, [&](slot_type* slot) {
+                            ohmy::construct_at(slot, m_slots[index]);
+                        });
+                    }
+                }
+            }
+            catch (...)
+            {
+                destroy_slots(fresh, fresh.capacity);
+                deallocate_storage(fresh);
+                throw;
+            }
+            destroy_slots(storage{m_control, m_slots, m_capacity},
+                          m_capacity);
+        }
+
+        if (m_capacity != 0)
+        {
+            deallocate_storage(storage{m_control, m_slots, m_capacity});
+        }
+        install(fresh);
+        m_growth_left = max_load(capacity) - m_size;
+    }
+
+    template <typename Move>
+    void transfer(const storage& fresh, const slot_type* source, Move&& move)
+    {
+        const size_t hash = m_hash(Policy::key(*source));
+        const size_t index = find_free(fresh.control, fresh.capacity, hash);
+        move(fresh.slots + index);
+        set_control(fresh.control, fresh.capacity, index, control_hash(hash));
+    }
+
+    // The slot becomes empty again when the group_width slots around it
+    // were never all full at once, since then no probe sequence can have
+    // passed over it to a later group.
+    void erase_at(size_t index) noexcept
+    {
+        ohmy::destroy_at(m_slots + index);
+        --m_size;
+
+        const size_t before = (index - group_width) & (m_capacity - 1);
+        const group_mask empty_after =
+            control_group{m_control + index}.match_empty();
+        const group_mask empty_before =
+            control_group{m_control + before}.match_empty();
+        const bool was_never_full =
+            empty_before and empty_after and
+            empty_after.trailing_zeros() + empty_before.leading_zeros() <
+                group_width;
+
+        set_control(m_control, m_capacity, index,
+                    was_never_full ? control_empty : control_deleted);
+        if (was_never_full)
+        {
+            ++m_growth_left;
+        }
+    }
+
+    iterator iterator_at(size_t index) noexcept
+    {
+        return iterator{m_control + index, m_slots + index,
+                        m_control + m_capacity};
+    }
+
+    const_iterator const_iterator_at(size_t index) const noexcept
+    {
+        return const_iterator{m_control + index, m_slots + index,
+                              m_control + m_capacity};
+    }
+
+    void install(const storage& table) noexcept
+    {
+        m_control = table.control;
+        m_slots = table.slots;
+        m_capacity = table.capacity;
+    }
+
+    void release() noexcept
+    {
+        if (m_capacity != 0)
+        {
+            const storage table{m_control, m_slots, m_capacity};
+            destroy_slots(table, m_capacity);
+            deallocate_storage(table);
+        }
+    }
+
+    void forget() noexcept
+    {
+        m_control = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_growth_left = 0;
+    }
+
+    control_byte* m_control = nullptr;
+    slot_type* m_slots = nullptr;
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+    size_t m_growth_left = 0;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+};
+} // namespace detail
+
+// A hash map storing its elements inline in an open-addressing table.
+// Lookups accept any type that the hash and key comparison accept when
+// both are transparent, as they are by default for std::string and
+// my::string_view keys.
+template <typename Key, typename Value, typename Hash = hash<Key>,
+          typename KeyEqual = equal_to<Key>>
+class flat_hash_map
+    : public detail::raw_hash_table<detail::map_policy<Key, Value>, Hash,
+                                    KeyEqual>
+{
+    using base = detail::raw_hash_table<detail::map_policy<Key, Value>, Hash,
+                                        KeyEqual>;
+
+public:
+    using mapped_type = Value;
+    using typename base::const_iterator;
+    using typename base::iterator;
+    using typename base::key_type;
+    using typename base::value_type;
+
+    using base::base;
+
+    flat_hash_map() noexcept = default;
+
+    flat_hash_map(std::initializer_list<value_type> values)
+    {
+        this->reserve(values.size());
+        insert(values);
+    }
+
+    template <typename... ArgumentTypes>
+    std::pair<iterator, bool> try_emplace(const key_type& key,
+                                          ArgumentTypes&&... arguments)
+    {
+        return this->find_or_insert(key, [&](std::pair<Key, Value>* slot) {
+            ohmy::construct_at(slot, std::piecewise_construct,
+                               std::forward_as_tuple(key),
+                               std::forward_as_tuple(
+                                   ohmy::forward<ArgumentTypes>(arguments)...));
+        });
+    }
+
+    template <typename... ArgumentTypes>
+    std::pair<iterator, bool> try_emplace(key_type&& key,
+                                          ArgumentTypes&&... arguments)
+    {
+        return this->find_or_insert(key, [&](std::pair<Key, Value>* slot) {
+            ohmy::construct_at(slot, std::piecewise_construct,
+                               std::forward_as_tuple(ohmy::move(key)),
+                               std::forward_as_tuple(
+                                   ohmy::forward<ArgumentTypes>(arguments)...));
+        });
+    }
+
+    template <typename... ArgumentTypes>
+    std::pair<iterator, bool> emplace(ArgumentTypes&&... arguments)
+    {
+        return this->emplace_slot(ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return this->find_or_insert(
+            value.first, [&](std::pair<Key, Value>* slot) {
+                ohmy::construct_at(slot, value);
+            });
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        return this->find_or_insert(
+            value.first, [&](std::pair<Key, Value>* slot) {
+                ohmy::construct_at(slot, ohmy::move(value));
+            });
+    }
+
+    void insert(std::initializer_list<value_type> values)
+    {
+        for (const value_type& value : values)
+        {
+            insert(value);
+        }
+    }
+
+    template <typename Mapped>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key,
+                                               Mapped&& mapped)
+    {
+        auto result = try_emplace(key, ohmy::forward<Mapped>(mapped));
+        if (not result.second)
+        {
+            result.first->second = ohmy::forward<Mapped>(mapped);
+        }
+        return result;
+    }
+
+    Value& operator[](const key_type& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    Value& operator[](key_type&& key)
+    {
+        return try_emplace(ohmy::move(key)).first->second;
+    }
+
+    template <typename Lookup = key_type>
+    Value& at(const typename base::template key_arg<Lookup>& key)
+    {
+        const iterator found = this->find(key);
+        if (found == this->end())
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+        return found->second;
+    }
+
+    template <typename Lookup = key_type>
+    const Value& at(const typename base::template key_arg<Lookup>& key) const
+    {
+        const const_iterator found = this->find(key);
+        if (found == this->end())
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+        return found->second;
+    }
+};
+
+// A hash set storing its elements inline in an open-addressing table; see
+// flat_hash_map.
+template <typename Key, typename Hash = hash<Key>,
+          typename KeyEqual = equal_to<Key>>
+class flat_hash_set
+    : public detail::raw_hash_table<detail::set_policy<Key>, Hash, KeyEqual>
+{
+    using base =
+        detail::raw_hash_table<detail::set_policy<Key>, Hash, KeyEqual>;
+
+public:
+    using typename base::const_iterator;
+    using typename base::iterator;
+    using typename base::key_type;
+    using typename base::value_type;
+
+    using base::base;
+
+    flat_hash_set() noexcept = default;
+
+    flat_hash_set(std::initializer_list<Key> values)
+    {
+        this->reserve(values.size());
+        insert(values);
+    }
+
+    template <typename... ArgumentTypes>
+    std::pair<iterator, bool> emplace(ArgumentTypes&&... arguments)
+    {
+        return this->emplace_slot(ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    std::pair<iterator, bool> insert(const Key& key)
+    {
+        return this->find_or_insert(
+            key, [&](Key* slot) { ohmy::construct_at(slot, key); });
+    }
+
+    std::pair<iterator, bool> insert(Key&& key)
+    {
+        return this->find_or_insert(key, [&](Key* slot) {
+            ohmy::construct_at(slot, ohmy::move(key));
+        });
+    }
+
+    void insert(std::initializer_list<Key> values)
+    {
+        for (const Key& key : values)
+        {
+            insert(key);
+        }
+    }
+};
+} // namespace ohmy
+
+#endif // OHMY_FLAT_HASH_MAP_HPP
@@ -0,0 +1,337 @@
+#include <catch/catch.hpp>
+
+#include "allocation_tracking.hpp"
+#include "flat_hash_map.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+// Counts its live instances; not trivially relocatable.
+struct Tracked
+{
+    explicit Tracked(int value, int& live) : value{value}, live{&live}
+    {
+        ++*this->live;
+    }
+
+    Tracked(const Tracked& other) : value{other.value}, live{other.live}
+    {
+        ++*live;
+    }
+
+    Tracked(Tracked&& other) noexcept : value{other.value}, live{other.live}
+    {
+        ++*live;
+    }
+
+    Tracked& operator=(const Tracked& other)
+    {
+        value = other.value;
+        return *this;
+    }
+
+    ~Tracked()
+    {
+        --*live;
+    }
+
+    int value;
+    int* live;
+};
+
+// Sends every key to the same group.
+struct CollidingHash
+{
+    size_t operator()(int key) const noexcept
+    {
+        return static_cast<size_t>(key) & 0x7f;
+    }
+};
+} // namespace
+
+static_assert(ohmy::is_trivially_relocatable_v<std::pair<int, double>>);
+static_assert(not ohmy::is_trivially_relocatable_v<std::pair<int, Tracked>>);
+static_assert(ohmy::detail::is_transparent_v<ohmy::hash<std::string>>);
+static_assert(not ohmy::detail::is_transparent_v<ohmy::hash<int>>);
+
+TEST_CASE("flat_hash_map")
+{
+    SECTION("insert, find and erase")
+    {
+        ohmy::flat_hash_map<int, int> map;
+        REQUIRE(map.empty());
+        REQUIRE(map.find(1) == map.end());
+        REQUIRE(map.capacity() == 0u);
+
+        REQUIRE(map.insert({1, 10}).second);
+        REQUIRE_FALSE(map.insert({1, 11}).second);
+        REQUIRE(map.emplace(2, 20).second);
+        REQUIRE(map.try_emplace(3, 30).second);
+        map[4] = 40;
+
+        REQUIRE(map.size() == 4u);
+        REQUIRE(map.at(1) == 10);
+        REQUIRE(map[2] == 20);
+        REQUIRE(map.find(3)->second == 30);
+        REQUIRE(map.contains(4));
+        REQUIRE(map.count(5) == 0u);
+        REQUIRE_THROWS_AS(map.at(5), std::out_of_range);
+
+        REQUIRE(map.erase(1) == 1u);
+        REQUIRE(map.erase(1) == 0u);
+        REQUIRE_FALSE(map.contains(1));
+        REQUIRE(map.size() == 3u);
+
+        REQUIRE_FALSE(map.insert_or_assign(2, 21).second);
+        REQUIRE(map.at(2) == 21);
+    }
+
+    SECTION("try_emplace leaves its arguments alone when the key exists")
+    {
+        ohmy::flat_hash_map<int, std::string> map{{1, "one"}};
+        std::string text(100, 'x');
+        REQUIRE_FALSE(map.try_emplace(1, std::move(text)).second);
+        REQUIRE(text.size() == 100u);
+        REQUIRE(map.at(1) == "one");
+    }
+
+    SECTION("iteration visits every element once")
+    {
+        ohmy::flat_hash_map<int, int> map;
+        for (int i = 0; i < 1000; ++i)
+        {
+            map[i] = i * i;
+        }
+
+        std::vector<int> keys;
+        for (const auto& [key, value] : map)
+        {
+            REQUIRE(value == key * key);
+            keys.push_back(key);
+        }
+        std::sort(keys.begin(), keys.end());
+        REQUIRE(keys.size() == 1000u);
+        REQUIRE(std::adjacent_find(keys.begin(), keys.end()) == keys.end());
+
+        for (auto it = map.begin(); it != map.end();)
+        {
+            it = it->first % 2 == 0 ? map.erase(it) : std::next(it);
+        }
+        REQUIRE(map.size() == 500u);
+        REQUIRE(std::all_of(map.begin(), map.end(),
+                            [](const auto& entry) { return entry.first % 2; }));
+    }
+
+    SECTION("agrees with std::unordered_map under random operations")
+    {
+        ohmy::flat_hash_map<uint64_t, uint64_t> map;
+        std::unordered_map<uint64_t, uint64_t> reference;
+        std::mt19937_64 generator{42};
+
+        for (int step = 0; step < 200000; ++step)
+        {
+            const uint64_t key = generator() % 5000;
+            switch (generator() % 4)
+            {
+            case 0:
+            case 1:
+                map[key] = step;
+                reference[key] = step;
+                break;
+            case 2:
+                REQUIRE(map.erase(key) == reference.erase(key));
+                break;
+            default:
+                const auto found = map.find(key);
+                const auto expected = reference.find(key);
+                REQUIRE((found == map.end()) == (expected == reference.end()));
+                if (found != map.end())
+                {
+                    REQUIRE(found->second == expected->second);
+                }
+            }
+        }
+        REQUIRE(map.size() == reference.size());
+        for (const auto& [key, value] : reference)
+        {
+            REQUIRE(map.at(key) == value);
+        }
+    }
+
+    SECTION("a long collision chain survives erasing and reinserting")
+    {
+        ohmy::flat_hash_map<int, int, CollidingHash> map;
+        for (int round = 0; round < 20; ++round)
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                map[i * 128] = round;
+            }
+            for (int i = 0; i < 200; i += 2)
+            {
+                REQUIRE(map.erase(i * 128) == 1u);
+            }
+            for (int i = 1; i < 200; i += 2)
+            {
+                REQUIRE(map.at(i * 128) == round);
+            }
+        }
+        REQUIRE(map.size() == 100u);
+    }
+
+    SECTION("elements that are not trivially relocatable survive growth")
+    {
+        int live = 0;
+        {
+            ohmy::flat_hash_map<int, Tracked> map;
+            for (int i = 0; i < 500; ++i)
+            {
+                map.try_emplace(i, i, live);
+            }
+            REQUIRE(live == 500);
+            for (int i = 0; i < 500; ++i)
+            {
+                REQUIRE(map.at(i).value == i);
+            }
+
+            ohmy::flat_hash_map<int, Tracked> copy = map;
+            REQUIRE(live == 1000);
+            copy.clear();
+            REQUIRE(live == 500);
+            REQUIRE(copy.empty());
+
+            ohmy::flat_hash_map<int, Tracked> moved = std::move(map);
+            REQUIRE(live == 500);
+            REQUIRE(moved.size() == 500u);
+            moved.erase(7);
+            REQUIRE(live == 499);
+        }
+        REQUIRE(live == 0);
+    }
+
+    SECTION("reserve avoids growing")
+    {
+        ohmy::flat_hash_map<int, int> map;
+        map.reserve(1000);
+        const size_t capacity = map.capacity();
+        REQUIRE(capacity >= 1000u);
+        for (int i = 0; i < 1000; ++i)
+        {
+            map[i] = i;
+        }
+        REQUIRE(map.capacity() == capacity);
+        REQUIRE(map.load_factor() <= 0.875f);
+    }
+
+    SECTION("string keys are found by string views without allocating")
+    {
+        ohmy::flat_hash_map<std::string, int> map;
+        const std::string long_key(64, 'k');
+        map[long_key] = 1;
+        map["short"] = 2;
+
+        ohmy::allocation_scope scope;
+        const my::string_view view{long_key.data(), long_key.size()};
+        REQUIRE(map.find(view)->second == 1);
+        REQUIRE(map.contains("short"));
+        REQUIRE(map.at(my::string_view{"short"}) == 2);
+        REQUIRE_FALSE(map.contains(my::string_view{"shorter", 6}));
+        REQUIRE(map.erase(my::string_view{"short"}) == 1u);
+        REQUIRE(scope.allocations() == 0u);
+    }
+}
+
+TEST_CASE("flat_hash_set")
+{
+    ohmy::flat_hash_set<std::string> set{"alpha", "beta"};
+    REQUIRE(set.size() == 2u);
+    REQUIRE(set.insert("gamma").second);
+    REQUIRE_FALSE(set.insert(std::string{"alpha"}).second);
+    REQUIRE(set.emplace(3, 'z').second);
+    REQUIRE(set.contains(my::string_view{"zzz"}));
+    REQUIRE(set.erase("beta") == 1u);
+
+    std::vector<std::string> elements(set.begin(), set.end());
+    std::sort(elements.begin(), elements.end());
+    REQUIRE(elements == std::vector<std::string>{"alpha", "gamma", "zzz"});
+}
+
+namespace
+{
+template <typename Map>
+void hash_map_benchmarks(const char* name, const std::vector<uint64_t>& keys,
+                         const std::vector<uint64_t>& missing)
+{
+    const std::string size = std::to_string(keys.size());
+    Map map;
+    uint64_t found = 0;
+
+    const std::string insert = "insert " + size + ", " + name;
+    BENCHMARK(insert)
+    {
+        for (const uint64_t key : keys)
+        {
+            map[key] = key;
+        }
+    }
+
+    const std::string hit = "lookup hit " + size + ", " + name;
+    BENCHMARK(hit)
+    {
+        for (const uint64_t key : keys)
+        {
+            found += map.find(key)->second;
+        }
+    }
+
+    const std::string miss = "lookup miss " + size + ", " + name;
+    BENCHMARK(miss)
+    {
+        for (const uint64_t key : missing)
+        {
+            found += map.find(key) != map.end();
+        }
+    }
+
+    const std::string erase = "erase " + size + ", " + name;
+    BENCHMARK(erase)
+    {
+        for (const uint64_t key : keys)
+        {
+            found += map.erase(key);
+        }
+    }
+    REQUIRE(map.empty());
+    REQUIRE(found != 0);
+}
+} // namespace
+
+// Larger sizes, up to the hundreds of millions, only need more entries in
+// sizes and the memory to hold them.
+TEST_CASE("flat_hash_map benchmarks", "[.benchmark]")
+{
+    const std::vector<size_t> sizes{1 << 10, 1 << 16, 1 << 20};
+    std::mt19937_64 generator{7};
+
+    for (const size_t size : sizes)
+    {
+        std::vector<uint64_t> keys(size);
+        std::vector<uint64_t> missing(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            keys[i] = generator() | 1;
+            missing[i] = generator() & ~uint64_t{1};
+        }
+
+        hash_map_benchmarks<std::unordered_map<uint64_t, uint64_t>>(
+            "std::unordered_map", keys, missing);
+        hash_map_benchmarks<ohmy::flat_hash_map<uint64_t, uint64_t>>(
+            "ohmy::flat_hash_map", keys, missing);
+    }
+}
@@ -0,0 +1,281 @@
+#include <catch/catch.hpp>
+
+#include "flat_map.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST_CASE("flat_map")
+{
+    SECTION("insert, find and erase")
+    {
+        ohmy::flat_map<int, std::string> map;
+        REQUIRE(map.empty());
+        REQUIRE(map.find(1) == map.end());
+
+        REQUIRE(map.insert({3, "three"}).second);
+        REQUIRE_FALSE(map.insert({3, "drei"}).second);
+        REQUIRE(map.try_emplace(1, "one").second);
+        map[2] = "two";
+
+        REQUIRE(map.size() == 3u);
+        REQUIRE(map.at(3) == "three");
+        REQUIRE(map.find(1)->second == "one");
+        REQUIRE(map.contains(2));
+        REQUIRE(map.count(4) == 0u);
+        REQUIRE_THROWS_AS(map.at(4), std::out_of_range);
+        REQUIRE(map.lower_bound(0).key() == 1);
+        REQUIRE(map.lower_bound(4) == map.end());
+
+        REQUIRE(map.keys() == ohmy::vector<int>{1, 2, 3});
+        REQUIRE(map.values()[1] == "two");
+
+        REQUIRE(map.erase(2) == 1u);
+        REQUIRE(map.erase(2) == 0u);
+        REQUIRE(map.erase(map.begin())->first == 3);
+        REQUIRE(map.size() == 1u);
+    }
+
+    SECTION("bulk building sorts and keeps the first of equal keys")
+    {
+        const std::vector<std::pair<int, int>> elements{
+            {5, 0}, {1, 1}, {5, 2}, {3, 3}, {1, 4}};
+        const ohmy::flat_map<int, int> map(elements.begin(), elements.end());
+
+        REQUIRE(map.keys() == ohmy::vector<int>{1, 3, 5});
+        REQUIRE(map.values() == ohmy::vector<int>{1, 3, 0});
+
+        std::vector<int> visited;
+        for (const auto& [key, value] : map)
+        {
+            visited.push_back(key * 10 + value);
+        }
+        REQUIRE(visited == std::vector<int>{11, 33, 50});
+    }
+
+    SECTION("sorted input is adopted as it is")
+    {
+        ohmy::flat_map<int, char> map(ohmy::sorted_unique,
+                                      ohmy::vector<int>{2, 4, 6},
+                                      ohmy::vector<char>{'a', 'b', 'c'});
+        REQUIRE(map.at(4) == 'b');
+        REQUIRE_THROWS_AS((ohmy::flat_map<int, char>(ohmy::sorted_unique,
+                                                     ohmy::vector<int>{1},
+                                                     ohmy::vector<char>{})),
+                          std::length_error);
+    }
+
+    SECTION("a failed insertion leaves the map as it was")
+    {
+        struct Throwing
+        {
+            explicit Throwing(bool fail) : failed{fail}
+            {
+                if (fail)
+                    throw std::runtime_error("construction failed");
+            }
+
+            bool failed;
+        };
+
+        ohmy::flat_map<int, Throwing> map;
+        map.try_emplace(1, false);
+        map.try_emplace(3, false);
+        REQUIRE_THROWS_AS(map.try_emplace(2, true), std::runtime_error);
+        REQUIRE(map.keys() == ohmy::vector<int>{1, 3});
+        REQUIRE(map.values().size() == 2u);
+    }
+
+    SECTION("agrees with std::map under random operations")
+    {
+        ohmy::flat_map<uint32_t, uint32_t> map;
+        std::map<uint32_t, uint32_t> reference;
+        std::mt19937 generator{42};
+
+        for (uint32_t step = 0; step < 20000; ++step)
+        {
+            const uint32_t key = generator() % 1000;
+            switch (generator() % 4)
+            {
+            case 0:
+            case 1:
+                map[key] = step;
+                reference[key] = step;
+                break;
+            case 2:
+                REQUIRE(map.erase(key) == reference.erase(key));
+                break;
+            default:
+                const auto found = map.lower_bound(key);
+                const auto expected = reference.lower_bound(key);
+                REQUIRE((found == map.end()) == (expected == reference.end()));
+                if (found != map.end())
+                {
+                    REQUIRE(found->first == expected->first);
+                    REQUIRE(found->second == expected->second);
+                }
+            }
+        }
+        REQUIRE(map.size() == reference.size());
+        REQUIRE(std::equal(map.begin(), map.end(), reference.begin(),
+                           [](const auto& lhs, const auto& rhs) {
+                               return lhs.first == rhs.first and
+                                      lhs.second == rhs.second;
+                           }));
+    }
+}
+
+TEST_CASE("flat_set")
+{
+    ohmy::flat_set<std::string> set{"beta", "alpha", "beta"};
+    REQUIRE(set.size() == 2u);
+    REQUIRE(set.insert("gamma").second);
+    REQUIRE_FALSE(set.insert("alpha").second);
+    REQUIRE(set.contains("beta"));
+    REQUIRE(set.erase("beta") == 1u);
+    REQUIRE(set.count("beta") == 0u);
+    REQUIRE(*set.lower_bound("b") == "gamma");
+    REQUIRE(std::vector<std::string>(set.begin(), set.end()) ==
+            std::vector<std::string>{"alpha", "gamma"});
+
+    const ohmy::flat_set<int, std::greater<int>> descending{1, 3, 2};
+    REQUIRE(descending.keys() == ohmy::vector<int>{3, 2, 1});
+    REQUIRE(*descending.lower_bound(4) == 3);
+}
+
+TEST_CASE("eytzinger_map")
+{
+    SECTION("agrees with the sorted layout at every size")
+    {
+        for (int size = 0; size <= 130; ++size)
+        {
+            ohmy::flat_map<int, int> sorted;
+            for (int i = 0; i < size; ++i)
+            {
+                sorted[2 * i] = -i;
+            }
+            const ohmy::eytzinger_map<int, int> map(sorted);
+            REQUIRE(map.size() == sorted.size());
+
+            for (int key = -1; key <= 2 * size; ++key)
+            {
+                const int* found = map.find(key);
+                REQUIRE((found != nullptr) == sorted.contains(key));
+                if (found != nullptr)
+                {
+                    REQUIRE(*found == sorted.at(key));
+                }
+            }
+        }
+    }
+
+    SECTION("lookup by initializer list")
+    {
+        const ohmy::eytzinger_map<std::string, int> map{
+            {"one", 1}, {"two", 2}, {"three", 3}, {"one", 4}};
+        REQUIRE(map.size() == 3u);
+        REQUIRE(map.at("one") == 1);
+        REQUIRE(map.contains("three"));
+        REQUIRE(map.find("four") == nullptr);
+        REQUIRE_THROWS_AS(map.at("four"), std::out_of_range);
+    }
+}
+
+namespace
+{
+constexpr size_t lookups = 1 << 20;
+
+void sorted_search_benchmarks(const char* level, size_t size,
+                              std::mt19937_64& generator)
+{
+    std::vector<std::pair<uint64_t, uint64_t>> elements(size);
+    for (auto& element : elements)
+    {
+        element = {generator() | 1, generator()};
+    }
+    std::vector<uint64_t> probes(lookups);
+    for (uint64_t& probe : probes)
+    {
+        // Half of the lookups hit.
+        probe = generator() % 2 ? elements[generator() % size].first
+                                : generator() & ~uint64_t{1};
+    }
+
+    const std::map<uint64_t, uint64_t> tree(elements.begin(), elements.end());
+    const ohmy::flat_map<uint64_t, uint64_t> flat(elements.begin(),
+                                                  elements.end());
+    const ohmy::eytzinger_map<uint64_t, uint64_t> eytzinger(flat);
+    std::vector<std::pair<uint64_t, uint64_t>> sorted(tree.begin(),
+                                                      tree.end());
+
+    const std::string suffix =
+        ", " + std::to_string(size) + " entries (" + level + ")";
+    uint64_t tree_sum = 0;
+    uint64_t vector_sum = 0;
+    uint64_t flat_sum = 0;
+    uint64_t eytzinger_sum = 0;
+
+    const std::string tree_name = "std::map" + suffix;
+    BENCHMARK(tree_name)
+    {
+        for (const uint64_t probe : probes)
+        {
+            const auto found = tree.find(probe);
+            tree_sum += found != tree.end() ? found->second : 0;
+        }
+    }
+
+    const std::string vector_name = "std::lower_bound" + suffix;
+    BENCHMARK(vector_name)
+    {
+        for (const uint64_t probe : probes)
+        {
+            const auto found = std::lower_bound(
+                sorted.begin(), sorted.end(), probe,
+                [](const std::pair<uint64_t, uint64_t>& element,
+                   uint64_t key) { return element.first < key; });
+            vector_sum += found != sorted.end() and found->first == probe
+                              ? found->second
+                              : 0;
+        }
+    }
+
+    const std::string flat_name = "ohmy::flat_map" + suffix;
+    BENCHMARK(flat_name)
+    {
+        for (const uint64_t probe : probes)
+        {
+            const auto found = flat.find(probe);
+            flat_sum += found != flat.end() ? found.value() : 0;
+        }
+    }
+
+    const std::string eytzinger_name = "ohmy::eytzinger_map" + suffix;
+    BENCHMARK(eytzinger_name)
+    {
+        for (const uint64_t probe : probes)
+        {
+            const uint64_t* found = eytzinger.find(probe);
+            eytzinger_sum += found != nullptr ? *found : 0;
+        }
+    }
+
+    REQUIRE(vector_sum == tree_sum);
+    REQUIRE(flat_sum == tree_sum);
+    REQUIRE(eytzinger_sum == tree_sum);
+}
+} // namespace
+
+// The sizes aim at 16 bytes an entry fitting in a 32 KiB L1 cache, in a
+// 1 MiB L2 cache, and in neither.
+TEST_CASE("flat_map benchmarks", "[.benchmark]")
+{
+    std::mt19937_64 generator{11};
+    sorted_search_benchmarks("L1", 1 << 10, generator);
+    sorted_search_benchmarks("L2", 1 << 15, generator);
+    sorted_search_benchmarks("DRAM", 1 << 22, generator);
+}
@@ -6,6 +6,8 @@
 #include "type_traits.hpp"
 #include "utility.hpp"
 
+#include <exception>
+
 #ifdef __cpp_rtti
 #include <typeinfo>
 #endif
@@ -13,6 +15,196 @@
 namespace ohmy
 {
 
+template <typename Signature>
+class function;
+
+namespace detail
+{
+
+template <typename Type, typename OtherType = ohmy::detail::inv_unwrap_t<Type>>
+constexpr OtherType&& invfwd(ohmy::remove_reference_t<Type>& t) noexcept
+{
+    return static_cast<OtherType&&>(t);
+}
+
+template <typename Result, typename Callable, typename... ArgumentTypes>
+constexpr Result invoke_impl(invoke_other, Callable&& f,
+                             ArgumentTypes&&... args) noexcept(
+    noexcept(ohmy::forward<Callable>(f)(ohmy::forward<ArgumentTypes>(args)...)))
+{
+    return ohmy::forward<Callable>(f)(ohmy::forward<ArgumentTypes>(args)...);
+}
+
+template <typename Result, typename MemberFunction, typename Type,
+          typename... ArgumentTypes>
+constexpr Result invoke_impl(invoke_memfun_ref, MemberFunction&& f, Type&& t,
+                             ArgumentTypes&&... args) noexcept(
+    noexcept((invfwd<Type>(t).*f)(ohmy::forward<ArgumentTypes>(args)...)))
+{
+    return (invfwd<Type>(t).*f)(ohmy::forward<ArgumentTypes>(args)...);
+}
+
+template <typename Result, typename MemberFunction, typename Type,
+          typename... ArgumentTypes>
+constexpr Result invoke_impl(invoke_memfun_deref, MemberFunction&& f, Type&& t,
+                             ArgumentTypes&&... args) noexcept(
+    noexcept(((*ohmy::forward<Type>(t)).*
+              f)(ohmy::forward<ArgumentTypes>(args)...)))
+{
+    return ((*ohmy::forward<Type>(t)).*
+            f)(ohmy::forward<ArgumentTypes>(args)...);
+}
+
+template <typename Result, typename MemberPointer, typename Type>
+constexpr Result invoke_impl(invoke_memobj_ref, MemberPointer&& f,
+                             Type&& t) noexcept
+{
+    return invfwd<Type>(t).*f;
+}
+
+template <typename Result, typename MemberPointer, typename Type>
+constexpr Result
+invoke_impl(invoke_memobj_deref, MemberPointer&& f,
+            Type&& t) noexcept(noexcept(*ohmy::forward<Type>(t)))
+{
+    return (*ohmy::forward<Type>(t).*f);
+}
+
+template <typename Callable, typename... ArgumentTypes>
+using invoke_tag_t =
+    typename invoke_result<Callable, ArgumentTypes...>::invoke_type;
+
+// Only instantiated for well-formed calls.
+template <typename Callable, typename... ArgumentTypes>
+inline constexpr bool is_nothrow_invoke_v =
+    noexcept(detail::invoke_impl<invoke_result_t<Callable, ArgumentTypes...>>(
+        invoke_tag_t<Callable, ArgumentTypes...>{}, declval<Callable>(),
+        declval<ArgumentTypes>()...));
+
+// The tag selects the invoke_impl overload at compile time, so a call
+// through invoke compiles to the plain call expression.
+template <typename Callable, typename... ArgumentTypes>
+constexpr invoke_result_t<Callable, ArgumentTypes...>
+invoke(Callable&& f, ArgumentTypes&&... args) noexcept(
+    is_nothrow_invoke_v<Callable, ArgumentTypes...>)
+{
+    using type = invoke_result_t<Callable, ArgumentTypes...>;
+    using tag = invoke_tag_t<Callable, ArgumentTypes...>;
+    return detail::invoke_impl<type>(tag{}, ohmy::forward<Callable>(f),
+                                     ohmy::forward<ArgumentTypes>(args)...);
+}
+
+template <typename Callable, typename... ArgumentTypes>
+struct is_nothrow_invocable_impl
+    : bool_constant<is_nothrow_invoke_v<Callable, ArgumentTypes...>>
+{
+};
+
+template <typename Result, typename Callable, typename... ArgumentTypes>
+struct is_nothrow_invocable_r_impl
+    : bool_constant<
+          is_nothrow_invoke_v<Callable, ArgumentTypes...> and
+          (is_void_v<Result> or
+           is_nothrow_convertible_v<invoke_result_t<Callable, ArgumentTypes...>,
+                                    Result>)>
+{
+};
+} // namespace detail
+
+// Calls f with args the way the standard's INVOKE does: member function
+// and data member pointers are applied to an object given by reference, by
+// pointer or through a reference_wrapper, and anything else is called
+// directly. Usable in constant expressions and noexcept whenever the call
+// is.
+template <typename Callable, typename... ArgumentTypes>
+constexpr invoke_result_t<Callable, ArgumentTypes...>
+invoke(Callable&& f, ArgumentTypes&&... args) noexcept(
+    detail::is_nothrow_invoke_v<Callable, ArgumentTypes...>)
+{
+    return detail::invoke(ohmy::forward<Callable>(f),
+                          ohmy::forward<ArgumentTypes>(args)...);
+}
+
+// Invokes f and converts the result to Result, or discards it when Result
+// is void.
+template <typename Result, typename Callable, typename... ArgumentTypes,
+          typename = enable_if_t<
+              is_invocable_r_v<Result, Callable, ArgumentTypes...>>>
+constexpr Result invoke_r(Callable&& f, ArgumentTypes&&... args) noexcept(
+    detail::is_nothrow_invocable_r_impl<Result, Callable,
+                                        ArgumentTypes...>::value)
+{
+    if constexpr (is_void_v<Result>)
+    {
+        detail::invoke(ohmy::forward<Callable>(f),
+                       ohmy::forward<ArgumentTypes>(args)...);
+    }
+    else
+    {
+        return detail::invoke(ohmy::forward<Callable>(f),
+                              ohmy::forward<ArgumentTypes>(args)...);
+    }
+}
+
+template <typename Callable, typename... ArgumentTypes>
+struct is_nothrow_invocable
+    : conjunction<is_invocable<Callable, ArgumentTypes...>,
+                  detail::is_nothrow_invocable_impl<Callable, ArgumentTypes...>>
+{
+};
+
+template <typename Callable, typename... ArgumentTypes>
+inline constexpr bool is_nothrow_invocable_v =
+    is_nothrow_invocable<Callable, ArgumentTypes...>::value;
+
+template <typename Result, typename Callable, typename... ArgumentTypes>
+struct is_nothrow_invocable_r
+    : conjunction<is_invocable_r<Result, Callable, ArgumentTypes...>,
+                  detail::is_nothrow_invocable_r_impl<Result, Callable,
+                                                      ArgumentTypes...>>
+{
+};
+
+template <typename Result, typename Callable, typename... ArgumentTypes>
+inline constexpr bool is_nothrow_invocable_r_v =
+    is_nothrow_invocable_r<Result, Callable, ArgumentTypes...>::value;
+
+template <typename Type>
+class reference_wrapper
+{
+public:
+    using type = Type;
+
+    reference_wrapper(Type& ref) noexcept : data{ohmy::addressof(ref)}
+    {
+    }
+    reference_wrapper(Type&&) = delete;
+    reference_wrapper(const reference_wrapper&) noexcept = default;
+
+    reference_wrapper& operator=(const reference_wrapper& x) noexcept = default;
+
+    operator Type&() const noexcept
+    {
+        return *data;
+    }
+
+    Type& get() const noexcept
+    {
+        return *data;
+    }
+
+    template <typename... ArgumentTypes>
+    ohmy::invoke_result_t<Type&, ArgumentTypes...>
+    operator()(ArgumentTypes&&... args) const
+        noexcept(is_nothrow_invocable_v<Type&, ArgumentTypes...>)
+    {
+        return ohmy::invoke(get(), ohmy::forward<ArgumentTypes>(args)...);
+    }
+
+private:
+    Type* data;
+};
+
 template <typename Type>
 inline constexpr bool is_location_invariant_v = is_trivially_copiable_v<Type>;
 
@@ -55,14 +247,6 @@ union [[gnu::may_alias]] any_data
     char pod_data[sizeof(nocopy_types)];
 };
 
-enum class manager_operation
-{
-    get_type_info,
-    get_function_ptr,
-    clone_functor,
-    destroy_functor
-};
-
 template <typename Type>
 struct simple_type_wrapper
 {
@@ -73,8 +257,26 @@ struct simple_type_wrapper
     Type value;
 };
 
-template <typename Signature>
-class function;
+// Type-erased operations of the functor held by a function. A null clone
+// means the storage can be copied bitwise and a null destroy that there is
+// nothing to destroy; both hold for every locally stored functor, which
+// has to be trivially copyable. Moving a function always copies the
+// storage, since the other functors live on the heap.
+struct function_vtable
+{
+    void (*clone)(any_data& dest, const any_data& source);
+    void (*destroy)(any_data& victim) noexcept;
+#if __cpp_rtti
+    const std::type_info* type;
+#endif
+};
+
+#if __cpp_rtti
+inline constexpr function_vtable empty_function_vtable{nullptr, nullptr,
+                                                       &typeid(void)};
+#else
+inline constexpr function_vtable empty_function_vtable{nullptr, nullptr};
+#endif
 
 class function_base
 {
@@ -90,65 +292,37 @@ public:
                                            sizeof(Functor) <= max_size and
                                            __alignof__(Functor) <= max_align and
                                            max_align % __alignof(Functor) == 0;
-        using local_storage = integral_constant<bool, stored_locally>;
-
-        static Functor* get_pointer(const any_data& source)
-        {
-            const Functor* ptr =
-                stored_locally ? addressof(source) : source.access<Functor*>();
-            return const_cast<Functor*>(ptr);
-        }
-
-        // Clone a location-invariant function object that fits within
-        // an any_data structure.
-        static void clone(any_data& dest, const any_data& source, true_type)
-        {
-            ::new (dest.access()) Functor(source.access<Functor>());
-        }
 
-        // Clone a function object that is not location-invariant or that cannot
-        // fit into an any_data structure.
-        static void clone(any_data& dest, const any_data& source, false_type)
+        // Clone a function object that is not location-invariant or that
+        // cannot fit into an any_data structure.
+        static void clone(any_data& dest, const any_data& source)
         {
             dest.access<Functor*>() = new Functor(*source.access<Functor*>());
         }
 
-        // Destroying a location-invariant object may still require destruction.
-        static void destroy(any_data& victim, true_type)
-        {
-            victim.access<Functor>().~Functor();
-        }
-
-        static void destroy(any_data& victim, false_type)
+        static void destroy(any_data& victim) noexcept
         {
             delete victim.access<Functor*>();
         }
 
     public:
-        static bool manager(any_data& dest, const any_data& source,
-                            manager_operation op)
+        static Functor* get_pointer(const any_data& source)
         {
-            switch (op)
-            {
+            const Functor* ptr = stored_locally
+                                     ? ohmy::addressof(source.access<Functor>())
+                                     : source.access<Functor*>();
+            return const_cast<Functor*>(ptr);
+        }
+
 #if __cpp_rtti
-            case manager_operation::get_type_info:
-                dest.access<const std::type_info*>() = &typeid(Functor);
-                break;
+        static constexpr function_vtable table{
+            stored_locally ? nullptr : &clone,
+            stored_locally ? nullptr : &destroy, &typeid(Functor)};
+#else
+        static constexpr function_vtable table{
+            stored_locally ? nullptr : &clone,
+            stored_locally ? nullptr : &destroy};
 #endif
-            case manager_operation::get_function_ptr:
-                dest.access<Functor*>() = get_pointer(source);
-                break;
-
-            case manager_operation::clone_functor:
-                clone(dest, source, local_storage());
-                break;
-
-            case manager_operation::destroy_functor:
-                destroy(dest, local_storage());
-                break;
-            }
-            return false;
-        }
 
         static void init_functor(any_data& functor, Functor&& f)
         {
@@ -187,28 +361,23 @@ public:
         }
     };
 
-    function_base() : manager(nullptr)
-    {
-    }
+    function_base() = default;
 
     ~function_base()
     {
-        if (manager)
+        if (vtable->destroy != nullptr)
         {
-            manager(functor, functor, manager_operation::destroy_functor);
+            vtable->destroy(functor);
         }
     }
 
     bool empty() const
     {
-        return manager == nullptr;
+        return vtable == &empty_function_vtable;
     }
 
-    using manager_type = bool (*)(any_data&, const any_data&,
-                                  manager_operation);
-
     any_data functor;
-    manager_type manager;
+    const function_vtable* vtable = &empty_function_vtable;
 };
 
 template <typename Signature, typename Functor>
@@ -223,177 +392,487 @@ class function_handler<Result(ArgumentTypes...), Functor>
 public:
     static Result invoke(const any_data& functor, ArgumentTypes&&... arguments)
     {
-        return (*base::get_pointer(functor))(
+        return ohmy::invoke_r<Result>(
+            *base::get_pointer(functor),
             ohmy::forward<ArgumentTypes>(arguments)...);
     }
 };
 
-template <typename Functor, typename... ArgumentTypes>
-class function_handler<void(ArgumentTypes...), Functor>
-    : public function_base::base_manager<Functor>
-{
-    using base = function_base::base_manager<Functor>;
+} // namespace detail
+
+template <typename From, typename To>
+using check_func_return_type =
+    disjunction<is_void<To>, is_same<From, To>, is_convertible<From, To>>;
 
+class bad_function_call : public std::exception
+{
 public:
-    static void invoke(const any_data& functor, ArgumentTypes&&... arguments)
+    const char* what() const noexcept override
     {
-        (*base::get_pointer(functor))(
-            ohmy::forward<ArgumentTypes>(arguments)...);
+        return "bad function call";
     }
 };
 
-template <typename Class, typename Member, typename Result,
-          typename... ArgumentTypes>
-class function_handler<Result(ArgumentTypes...), Member Class::*>
-    : public function_handler<void(ArgumentTypes...), Member Class::*>
+// Primary class template for ohmy::function.
+template <typename Result, typename... ArgumentTypes>
+class function<Result(ArgumentTypes...)> : private detail::function_base
 {
-    using base = function_handler<void(ArgumentTypes...), Member Class::*>;
+    using invoker_type = Result (*)(const detail::any_data&,
+                                    ArgumentTypes&&...);
+
+    template <typename Functor>
+    using callable = enable_if_t<
+        not is_same_v<decay_t<Functor>, function> and
+        is_invocable_r_v<Result, decay_t<Functor>&, ArgumentTypes...>>;
 
 public:
-    static Result invoke(const any_data& functor, ArgumentTypes&&... arguments)
+    using result_type = Result;
+
+    function() noexcept : m_invoker{nullptr}
     {
+    }
 
-        return Result();
+    function(nullptr_t) noexcept : function()
+    {
     }
-}
 
-} // namespace detail
+    function(const function& other)
+    {
+        if (other.vtable->clone != nullptr)
+        {
+            other.vtable->clone(functor, other.functor);
+        }
+        else
+        {
+            functor = other.functor;
+        }
+        vtable = other.vtable;
+        m_invoker = other.m_invoker;
+    }
 
-template <typename From, typename To>
-using check_func_return_type =
-    disjunction<is_void<To>, is_same<From, To>, is_convertible<From, To>>;
-} // namespace ohmy
+    // Functors are either stored locally, which requires them to be
+    // trivially copyable, or on the heap, so moving copies the storage.
+    function(function&& other) noexcept : m_invoker{other.m_invoker}
+    {
+        functor = other.functor;
+        vtable = other.vtable;
+        other.vtable = &detail::empty_function_vtable;
+        other.m_invoker = nullptr;
+    }
 
-// Primary class template for ohmy::function.
-template <typename Result, typename... ArgumentTypes>
-class function<Result(ArgumentTypes...)>
-    : public MaybeUnaryOrBinaryFunction<Result, ArgumentTypes...>,
-      private detail::function_base
-{
-    template <typename Function,
-              typename ResultActual = typename result_of<Function(
-                  ArgumentTypes...)::type> struct Callable : detail::
-                  check_func_return_type<ResultActual, Result>
+    template <typename Functor, typename = callable<Functor>>
+    function(Functor f) : m_invoker{nullptr}
     {
-    };
-};
+        using handler =
+            detail::function_handler<Result(ArgumentTypes...), Functor>;
 
-template <typename Callable, typename... ArgumentTypes>
-class invoke_result;
+        if (handler::non_empty_function(f))
+        {
+            handler::init_functor(functor, ohmy::move(f));
+            m_invoker = &handler::invoke;
+            vtable = &handler::table;
+        }
+    }
 
-template <typename Callable, typename... ArgumentTypes>
-using invoke_result_t =
-    typename invoke_result<Callable, ArgumentTypes...>::type;
+    function& operator=(const function& other)
+    {
+        function(other).swap(*this);
+        return *this;
+    }
 
-template <class F, class... Args>
-invoke_result_t<F, Args...> invoke(F&& f, Args&&... args) noexcept;
+    function& operator=(function&& other) noexcept
+    {
+        function(ohmy::move(other)).swap(*this);
+        return *this;
+    }
 
-template <typename Type>
-class reference_wrapper
-{
-public:
-    using type = Type;
+    function& operator=(nullptr_t) noexcept
+    {
+        function().swap(*this);
+        return *this;
+    }
 
-    reference_wrapper(Type& ref) noexcept : data{ohmy::addressof(ref)}
+    template <typename Functor, typename = callable<Functor>>
+    function& operator=(Functor&& f)
     {
+        function(ohmy::forward<Functor>(f)).swap(*this);
+        return *this;
     }
-    reference_wrapper(Type&&) = delete;
-    reference_wrapper(const reference_wrapper&) noexcept = default;
 
-    reference_wrapper& operator=(const reference_wrapper& x) noexcept = default;
+    void swap(function& other) noexcept
+    {
+        ohmy::swap(functor, other.functor);
+        ohmy::swap(vtable, other.vtable);
+        ohmy::swap(m_invoker, other.m_invoker);
+    }
 
-    operator Type&() const noexcept
+    explicit operator bool() const noexcept
     {
-        return *data;
+        return not empty();
     }
 
-    Type& get() const noexcept
+    Result operator()(ArgumentTypes... arguments) const
     {
-        return *data;
+        if (empty())
+            throw bad_function_call{};
+        return m_invoker(functor, ohmy::forward<ArgumentTypes>(arguments)...);
     }
 
-    template <typename... ArgumentTypes>
-    ohmy::invoke_result_t<Type&, ArgumentTypes>
-    operator()(ArgumentTypes... args) const
+#if __cpp_rtti
+    const std::type_info& target_type() const noexcept
     {
-        return ohmy::invoke(get(), ohmy::forward<ArgumentTypes>(args)...);
+        return *vtable->type;
+    }
+#endif
+
+    template <typename Functor>
+    Functor* target() noexcept
+    {
+        const function& self = *this;
+        return const_cast<Functor*>(self.template target<Functor>());
+    }
+
+    template <typename Functor>
+    const Functor* target() const noexcept
+    {
+        using manager = detail::function_base::base_manager<Functor>;
+        if (vtable != &manager::table)
+        {
+            return nullptr;
+        }
+        return manager::get_pointer(functor);
     }
 
 private:
-    Type* data;
+    invoker_type m_invoker;
 };
 
-namespace detail
+template <typename Signature>
+bool operator==(const function<Signature>& f, nullptr_t) noexcept
 {
+    return not f;
+}
 
-template <typename Type, typename OtherType = ohmy::detail::inv_unwrap_t<Type>>
-constexpr OtherType&& invfwd(ohmy::remove_reference_t<Type>& t) noexcept
+template <typename Signature>
+bool operator!=(const function<Signature>& f, nullptr_t) noexcept
 {
-    return static_cast<OtherType&&>(t);
+    return static_cast<bool>(f);
 }
 
-template <typename Result, typename Callable, typename... ArgumentTypes>
-constexpr Result invoke_impl(invoke_other, Callable&& f,
-                             ArgumentTypes&&... args)
+namespace detail
 {
-    return ohmy::forward<Callable>(f)(ohmy::forward<ArgumentTypes>(args)...);
-}
+// Type-erased operations of the functor held by a move_only_function. A
+// null relocate means the storage can be moved with memcpy, and a null
+// destroy that there is nothing to destroy.
+struct move_only_vtable
+{
+    void (*relocate)(void* destination, void* source) noexcept;
+    void (*destroy)(void* storage) noexcept;
+};
 
-template <typename Result, typename MemberFunction, typename Type,
-          typename... ArgumentTypes>
-constexpr Result invoke_impl(invoke_memfun_ref, MemberFunction&& f, Type&& t,
-                             ArgumentTypes&&... args)
+inline constexpr move_only_vtable empty_move_only_vtable{nullptr, nullptr};
+
+template <typename Functor, bool Inline>
+struct move_only_operations
 {
-    return (invfwd<Type>(t).*f)(ohmy::forward<ArgumentTypes>(args)...);
-}
+    static Functor* get(void* storage) noexcept
+    {
+        if constexpr (Inline)
+        {
+            return static_cast<Functor*>(storage);
+        }
+        else
+        {
+            return *static_cast<Functor**>(storage);
+        }
+    }
 
-template <typename Result, typename MemberFunction, typename Type,
-          typename... ArgumentTypes>
-constexpr Result invoke_impl(invoke_memfun_deref, MemberFunction&& f, Type&& t,
-                             ArgumentTypes&&... args)
+    template <typename Result, typename... ArgumentTypes>
+    static Result invoke(void* storage, ArgumentTypes&&... arguments)
+    {
+        return ohmy::invoke_r<Result>(
+            *get(storage), ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    static void relocate(void* destination, void* source) noexcept
+    {
+        Functor* from = static_cast<Functor*>(source);
+        ohmy::construct_at(static_cast<Functor*>(destination),
+                           ohmy::move(*from));
+        ohmy::destroy_at(from);
+    }
+
+    static void destroy(void* storage) noexcept
+    {
+        if constexpr (Inline)
+        {
+            ohmy::destroy_at(get(storage));
+        }
+        else
+        {
+            delete get(storage);
+        }
+    }
+
+    // Heap-allocated functors are moved by copying the pointer.
+    static constexpr move_only_vtable table{
+        Inline and not is_trivially_relocatable_v<Functor> ? &relocate
+                                                           : nullptr,
+        Inline and is_trivially_destructible_v<Functor> ? nullptr : &destroy};
+};
+} // namespace detail
+
+template <typename Signature, size_t InlineCapacity = 48>
+class move_only_function;
+
+// A callable wrapper that owns its target but cannot be copied, so it can
+// hold lambdas that capture move-only state such as a unique_ptr. Functors
+// of up to InlineCapacity bytes whose move constructor does not throw are
+// stored in the object itself; only larger ones are allocated. With the
+// default capacity the wrapper fills exactly one 64-byte cache line.
+//
+// Invoking an empty move_only_function is undefined.
+template <typename Result, typename... ArgumentTypes, size_t InlineCapacity>
+class move_only_function<Result(ArgumentTypes...), InlineCapacity>
 {
-    return ((*ohmy::forward<Type>(t)).*
-            f)(ohmy::forward<ArgumentTypes>(args)...);
-}
+    static_assert(InlineCapacity >= sizeof(void*),
+                  "the inline buffer has to hold at least a pointer");
 
-template <typename Result, typename MemberPointer, typename Type>
-constexpr Result invoke_impl(invoke_memobj_ref, MemberPointer&& f, Type&& t)
+    static constexpr size_t storage_align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    using invoker_type = Result (*)(void*, ArgumentTypes&&...);
+
+    template <typename Functor>
+    using callable = enable_if_t<
+        not is_same_v<decay_t<Functor>, move_only_function> and
+        is_invocable_r_v<Result, decay_t<Functor>&, ArgumentTypes...>>;
+
+public:
+    using result_type = Result;
+
+    template <typename Functor>
+    static constexpr bool stored_inline =
+        sizeof(Functor) <= InlineCapacity and
+        alignof(Functor) <= storage_align and
+        is_nothrow_move_constructible_v<Functor>;
+
+    move_only_function() noexcept = default;
+
+    move_only_function(nullptr_t) noexcept
+    {
+    }
+
+    move_only_function(move_only_function&& other) noexcept
+    {
+        take(other);
+    }
+
+    template <typename Functor, typename = callable<Functor>>
+    move_only_function(Functor&& f)
+    {
+        using functor_type = decay_t<Functor>;
+        using manager = detail::function_base::base_manager<functor_type>;
+        constexpr bool is_inline = stored_inline<functor_type>;
+        using operations =
+            detail::move_only_operations<functor_type, is_inline>;
+
+        if (not manager::non_empty_function(f))
+            return;
+
+        if constexpr (is_inline)
+        {
+            ohmy::construct_at(reinterpret_cast<functor_type*>(m_storage),
+                               ohmy::forward<Functor>(f));
+        }
+        else
+        {
+            *reinterpret_cast<functor_type**>(m_storage) =
+                new functor_type(ohmy::forward<Functor>(f));
+        }
+        m_invoker = &operations::template invoke<Result, ArgumentTypes...>;
+        m_vtable = &operations::table;
+    }
+
+    move_only_function& operator=(move_only_function&& other) noexcept
+    {
+        if (this != ohmy::addressof(other))
+        {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    move_only_function& operator=(nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    template <typename Functor, typename = callable<Functor>>
+    move_only_function& operator=(Functor&& f)
+    {
+        move_only_function(ohmy::forward<Functor>(f)).swap(*this);
+        return *this;
+    }
+
+    ~move_only_function()
+    {
+        reset();
+    }
+
+    move_only_function(const move_only_function&) = delete;
+    move_only_function& operator=(const move_only_function&) = delete;
+
+    void swap(move_only_function& other) noexcept
+    {
+        move_only_function temporary{ohmy::move(other)};
+        other = ohmy::move(*this);
+        *this = ohmy::move(temporary);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_invoker != nullptr;
+    }
+
+    Result operator()(ArgumentTypes... arguments)
+    {
+        return m_invoker(m_storage, ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+private:
+    void reset() noexcept
+    {
+        if (m_vtable->destroy != nullptr)
+        {
+            m_vtable->destroy(m_storage);
+        }
+        m_invoker = nullptr;
+        m_vtable = &detail::empty_move_only_vtable;
+    }
+
+    void take(move_only_function& other) noexcept
+    {
+        if (other.m_vtable->relocate != nullptr)
+        {
+            other.m_vtable->relocate(m_storage, other.m_storage);
+        }
+        else
+        {
+            // The bytes past a small functor are indeterminate, which is
+            // fine to copy as unsigned char, but GCC warns once the source
+            // is a temporary it can see through.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+            __builtin_memcpy(m_storage, other.m_storage, InlineCapacity);
+#pragma GCC diagnostic pop
+        }
+        m_invoker = other.m_invoker;
+        m_vtable = other.m_vtable;
+        other.m_invoker = nullptr;
+        other.m_vtable = &detail::empty_move_only_vtable;
+    }
+
+    alignas(storage_align) unsigned char m_storage[InlineCapacity];
+    invoker_type m_invoker = nullptr;
+    const detail::move_only_vtable* m_vtable = &detail::empty_move_only_vtable;
+};
+
+template <typename Signature, size_t InlineCapacity>
+bool operator==(const move_only_function<Signature, InlineCapacity>& f,
+                nullptr_t) noexcept
 {
-    return invfwd<Type>(t).*f;
+    return not f;
 }
 
-template <typename Result, typename MemberPointer, typename Type>
-constexpr Result invoke_impl(invoke_memobj_deref, MemberPointer&& f, Type&& t)
+template <typename Signature, size_t InlineCapacity>
+bool operator!=(const move_only_function<Signature, InlineCapacity>& f,
+                nullptr_t) noexcept
 {
-    return (*ohmy::forward<Type>(t).*f);
+    return static_cast<bool>(f);
 }
 
-template <typename Callable, typename... ArgumentTypes>
-constexpr invoke_result_t<Callable, ArgumentTypes>
-invoke(Callable&& f, ArgumentTypes&&... args) noexcept(
-    is_nothrow_invocable_v<Callable, ArgumentTypes...>)
+template <typename Signature>
+class function_ref;
+
+// A non-owning reference to a callable, meant for callback parameters. It
+// is two pointers wide, trivially copyable and never allocates, and a call
+// costs a single indirect call. Like string_view it does not extend the
+// lifetime of what it refers to, so a function_ref bound to a lambda or a
+// member pointer must not outlive it. Functions are stored by address and
+// do not dangle.
+template <typename Result, typename... ArgumentTypes>
+class function_ref<Result(ArgumentTypes...)>
 {
-    using result = invoke_result<Callable, ArgumentTypes...>;
-    using type = typename result::type;
-    using tag =typename result::invoke_type;
-    return detail::invoke_impl(tag{}, ohmy::forward<Callable>(f),
-                               ohmy::forward<ArgumentTypes>(args)....);
-}
+    union bound_entity
+    {
+        void* object;
+        void (*function)();
+    };
 
-} // namespace detail
+    using trampoline_type = Result (*)(bound_entity, ArgumentTypes&&...);
+
+    template <typename Callable>
+    static constexpr bool is_bindable =
+        is_invocable_r_v<Result, Callable, ArgumentTypes...>;
 
-template <typename Callable, typename... ArgumentTypes>
-class invoke_result
-{
 public:
-    using type = void;
-};
+    template <typename Function,
+              typename = enable_if_t<is_function_v<Function> and
+                                     is_bindable<Function*>>>
+    function_ref(Function* f) noexcept
+        : m_trampoline{&call_function<Function>}
+    {
+        m_bound.function = reinterpret_cast<void (*)()>(f);
+    }
 
-template <typename Callable, typename... ArgumentTypes>
-ohmy::invoke_result_t<Callable, ArgumentTypes...>
-invoke(Callable&& f, ArgumentTypes&&... args) noexcept
-{
-}
+    template <typename Callable,
+              typename Object = remove_reference_t<Callable>,
+              typename = enable_if_t<
+                  not is_same_v<remove_cv_t<Object>, function_ref> and
+                  not is_function_v<Object> and is_bindable<Object&>>>
+    function_ref(Callable&& f) noexcept : m_trampoline{&call_object<Object>}
+    {
+        m_bound.object =
+            const_cast<void*>(static_cast<const void*>(ohmy::addressof(f)));
+    }
+
+    function_ref(const function_ref&) noexcept = default;
+    function_ref& operator=(const function_ref&) noexcept = default;
+
+    Result operator()(ArgumentTypes... arguments) const
+    {
+        return m_trampoline(m_bound,
+                            ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+private:
+    template <typename Callable>
+    static Result call(Callable& f, ArgumentTypes&&... arguments)
+    {
+        return ohmy::invoke_r<Result>(
+            f, ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    template <typename Function>
+    static Result call_function(bound_entity bound,
+                                ArgumentTypes&&... arguments)
+    {
+        auto* f = reinterpret_cast<Function*>(bound.function);
+        return call(f, ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    template <typename Object>
+    static Result call_object(bound_entity bound, ArgumentTypes&&... arguments)
+    {
+        return call(*static_cast<Object*>(bound.object),
+                    ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    bound_entity m_bound;
+    trampoline_type m_trampoline;
+};
 
 } // namespace ohmy
 
@@ -0,0 +1,553 @@
+#include <catch/catch.hpp>
+
+#include "allocation_tracking.hpp"
+#include "functional.hpp"
+#include "memory.hpp"
+
+#include <functional>
+
+namespace
+{
+int twice(int x)
+{
+    return 2 * x;
+}
+
+struct Counter
+{
+    static int live;
+
+    Counter() noexcept
+    {
+        ++live;
+    }
+    Counter(const Counter&) noexcept
+    {
+        ++live;
+    }
+    Counter(Counter&&) noexcept
+    {
+        ++live;
+    }
+    ~Counter()
+    {
+        --live;
+    }
+
+    int operator()(int x) const
+    {
+        return x + live;
+    }
+};
+
+int Counter::live = 0;
+
+struct Point
+{
+    int x;
+    int y;
+
+    int sum() const
+    {
+        return x + y;
+    }
+
+    int scaled(int factor) const
+    {
+        return factor * (x + y);
+    }
+};
+
+int apply(ohmy::function_ref<int(int)> f, int value)
+{
+    return f(value);
+}
+
+// A functor with a throwing move constructor is never stored inline.
+struct ThrowingMove
+{
+    ThrowingMove() = default;
+    ThrowingMove(ThrowingMove&&) noexcept(false)
+    {
+    }
+
+    int operator()() const
+    {
+        return 7;
+    }
+};
+} // namespace
+
+static_assert(sizeof(ohmy::move_only_function<void()>) == 64);
+static_assert(
+    sizeof(ohmy::move_only_function<void(), 16>) == 16 + 2 * sizeof(void*));
+static_assert(ohmy::move_only_function<void()>::stored_inline<
+              ohmy::unique_ptr<int>>);
+static_assert(
+    not ohmy::move_only_function<void()>::stored_inline<ThrowingMove>);
+static_assert(
+    not std::is_copy_constructible_v<ohmy::move_only_function<void()>>);
+
+static_assert(sizeof(ohmy::function_ref<void()>) == 2 * sizeof(void*));
+static_assert(
+    ohmy::is_trivially_copiable_v<ohmy::function_ref<int(int, int)>>);
+static_assert(
+    std::is_convertible_v<int (*)(int), ohmy::function_ref<int(int)>>);
+static_assert(
+    not std::is_convertible_v<int (*)(int), ohmy::function_ref<int(Point)>>);
+static_assert(std::is_same_v<ohmy::invoke_result_t<int (Point::*)() const,
+                                                   const Point&>,
+                             int>);
+static_assert(std::is_same_v<ohmy::invoke_result_t<int Point::*, Point*>,
+                             int&>);
+
+namespace
+{
+struct Accumulator
+{
+    int total = 0;
+
+    constexpr int add(int x) noexcept
+    {
+        return total += x;
+    }
+
+    int checked_add(int x)
+    {
+        return total += x;
+    }
+};
+
+constexpr int invoke_in_constant_expression()
+{
+    Accumulator a;
+    ohmy::invoke(&Accumulator::add, a, 2);
+    ohmy::invoke(&Accumulator::add, &a, 3);
+    return ohmy::invoke(&Accumulator::total, a) +
+           ohmy::invoke([](int x) { return x; }, 10);
+}
+} // namespace
+
+static_assert(invoke_in_constant_expression() == 15);
+
+static_assert(ohmy::is_nothrow_invocable_v<decltype(&Accumulator::add),
+                                           Accumulator&, int>);
+static_assert(not ohmy::is_nothrow_invocable_v<
+              decltype(&Accumulator::checked_add), Accumulator*, int>);
+static_assert(ohmy::is_invocable_v<decltype(&Accumulator::checked_add),
+                                   Accumulator*, int>);
+static_assert(ohmy::is_nothrow_invocable_v<int Accumulator::*,
+                                           const Accumulator&>);
+static_assert(not ohmy::is_nothrow_invocable_v<int (*)(int), int>);
+static_assert(not ohmy::is_nothrow_invocable_v<int (*)(int), Point>);
+static_assert(ohmy::is_nothrow_invocable_r_v<long, int (*)(int) noexcept, int>);
+static_assert(
+    not ohmy::is_nothrow_invocable_r_v<Point, int (*)(int) noexcept, int>);
+static_assert(
+    noexcept(ohmy::invoke(ohmy::declval<int (*)(int) noexcept>(), 1)));
+static_assert(not noexcept(ohmy::invoke(twice, 1)));
+static_assert(std::is_same_v<ohmy::invoke_result_t<
+                                 int Point::*,
+                                 ohmy::reference_wrapper<const Point>>,
+                             const int&>);
+
+TEST_CASE("invoke")
+{
+    Point p{1, 2};
+    const Point& cp = p;
+    ohmy::reference_wrapper<Point> ref{p};
+
+    SECTION("member function pointers")
+    {
+        REQUIRE(ohmy::invoke(&Point::scaled, p, 2) == 6);
+        REQUIRE(ohmy::invoke(&Point::scaled, &cp, 3) == 9);
+        REQUIRE(ohmy::invoke(&Point::sum, ref) == 3);
+    }
+
+    SECTION("data member pointers yield references")
+    {
+        ohmy::invoke(&Point::x, p) = 5;
+        ohmy::invoke(&Point::y, &p) = 6;
+        ohmy::invoke(&Point::x, ref) += 1;
+        REQUIRE(p.x == 6);
+        REQUIRE(p.y == 6);
+        REQUIRE(&ohmy::invoke(&Point::y, cp) == &p.y);
+    }
+
+    SECTION("reference_wrapper forwards calls")
+    {
+        auto negate = [](int x) { return -x; };
+        ohmy::reference_wrapper<decltype(negate)> wrapped{negate};
+        REQUIRE(wrapped(4) == -4);
+        REQUIRE(ohmy::invoke(wrapped, 5) == -5);
+    }
+
+    SECTION("invoke_r converts or discards the result")
+    {
+        REQUIRE(ohmy::invoke_r<long>(twice, 21) == 42L);
+        ohmy::invoke_r<void>(&Point::x, p);
+    }
+
+    SECTION("owning wrappers accept member pointers")
+    {
+        ohmy::function<int(const Point&, int)> f = &Point::scaled;
+        ohmy::move_only_function<int&(Point*)> g = &Point::y;
+        REQUIRE(f(p, 2) == 6);
+        g(&p) = 7;
+        REQUIRE(p.y == 7);
+    }
+}
+
+TEST_CASE("function")
+{
+    SECTION("holds function pointers and functors")
+    {
+        ohmy::function<int(int)> f = twice;
+        REQUIRE(f(4) == 8);
+        REQUIRE(f.target<int (*)(int)>() != nullptr);
+        REQUIRE(f.target<Counter>() == nullptr);
+
+        f = [offset = 3](int x) { return x + offset; };
+        REQUIRE(f(4) == 7);
+    }
+
+    SECTION("copies and moves share no state")
+    {
+        int calls = 0;
+        ohmy::function<void()> f = [&calls] { ++calls; };
+        ohmy::function<void()> g = f;
+        ohmy::function<void()> h = ohmy::move(f);
+
+        REQUIRE_FALSE(f);
+        g();
+        h();
+        REQUIRE(calls == 2);
+    }
+
+    SECTION("large functors are copied and destroyed")
+    {
+        Counter::live = 0;
+        {
+            ohmy::function<int(int)> f = Counter{};
+            ohmy::function<int(int)> g = f;
+            REQUIRE(Counter::live == 2);
+            REQUIRE(g(1) == 3);
+        }
+        REQUIRE(Counter::live == 0);
+    }
+
+    SECTION("target_type follows the stored functor")
+    {
+        ohmy::function<int(int)> f;
+        REQUIRE(f.target_type() == typeid(void));
+
+        f = Counter{};
+        REQUIRE(f.target_type() == typeid(Counter));
+        REQUIRE(f.target<Counter>() != nullptr);
+
+        ohmy::function<int(int)> g = ohmy::move(f);
+        REQUIRE(f.target_type() == typeid(void));
+        REQUIRE(g.target_type() == typeid(Counter));
+        REQUIRE(f.target<Counter>() == nullptr);
+    }
+
+    SECTION("empty functions")
+    {
+        ohmy::function<void()> f;
+        REQUIRE(f == nullptr);
+        REQUIRE_THROWS_AS(f(), ohmy::bad_function_call);
+
+        int (*null)(int) = nullptr;
+        ohmy::function<int(int)> g = null;
+        REQUIRE_FALSE(g);
+    }
+}
+
+TEST_CASE("move_only_function")
+{
+    SECTION("move-only captures are stored without allocating")
+    {
+        auto value = ohmy::make_unique<int>(41);
+        ohmy::allocation_scope scope;
+
+        ohmy::move_only_function<int()> f =
+            [p = ohmy::move(value), q = static_cast<int*>(nullptr)] {
+                return *p + (q == nullptr ? 1 : 0);
+            };
+        REQUIRE(scope.allocations() == 0u);
+        REQUIRE(f() == 42);
+
+        ohmy::move_only_function<int()> g = ohmy::move(f);
+        REQUIRE_FALSE(f);
+        REQUIRE(g() == 42);
+        REQUIRE(scope.allocations() == 0u);
+    }
+
+    SECTION("functors that do not fit are allocated")
+    {
+        char padding[100] = {1};
+        ohmy::allocation_scope scope;
+        ohmy::move_only_function<int()> f = [padding] { return padding[0]; };
+        REQUIRE(scope.allocations() == 1u);
+        REQUIRE(f() == 1);
+
+        ohmy::move_only_function<int()> g = ThrowingMove{};
+        REQUIRE(scope.allocations() == 2u);
+        REQUIRE(g() == 7);
+
+        f.swap(g);
+        REQUIRE(f() == 7);
+        REQUIRE(g() == 1);
+        REQUIRE(scope.allocations() == 2u);
+    }
+
+    SECTION("destroys its target exactly once")
+    {
+        Counter::live = 0;
+        {
+            ohmy::move_only_function<int(int)> f = Counter{};
+            ohmy::move_only_function<int(int)> g = ohmy::move(f);
+            REQUIRE(Counter::live == 1);
+            REQUIRE(g(1) == 2);
+
+            g = nullptr;
+            REQUIRE(Counter::live == 0);
+            g = Counter{};
+        }
+        REQUIRE(Counter::live == 0);
+    }
+
+    SECTION("return values are converted to the declared result")
+    {
+        ohmy::move_only_function<long(int)> f = twice;
+        REQUIRE(f(21) == 42L);
+
+        int calls = 0;
+        ohmy::move_only_function<void()> g = [&calls] { return ++calls; };
+        g();
+        REQUIRE(calls == 1);
+    }
+}
+
+TEST_CASE("function_ref")
+{
+    SECTION("binds functions, lambdas and functors without allocating")
+    {
+        ohmy::allocation_scope scope;
+        int offset = 10;
+        auto add = [&offset](int x) { return x + offset; };
+
+        REQUIRE(apply(twice, 4) == 8);
+        REQUIRE(apply(&twice, 5) == 10);
+        REQUIRE(apply(add, 1) == 11);
+        REQUIRE(apply([](int x) { return -x; }, 3) == -3);
+        REQUIRE(scope.allocations() == 0u);
+
+        const Counter counter;
+        REQUIRE(apply(counter, 1) == 1 + Counter::live);
+    }
+
+    SECTION("refers to the callable rather than copying it")
+    {
+        int calls = 0;
+        auto count = [&calls]() mutable { ++calls; };
+        ohmy::function_ref<void()> f = count;
+        ohmy::function_ref<void()> g = f;
+        f();
+        g();
+        REQUIRE(calls == 2);
+    }
+
+    SECTION("member pointers through references, pointers and wrappers")
+    {
+        Point p{1, 2};
+        auto sum = &Point::sum;
+        auto scaled = &Point::scaled;
+        auto x = &Point::x;
+
+        ohmy::function_ref<int(const Point&)> by_reference = sum;
+        ohmy::function_ref<int(Point*, int)> by_pointer = scaled;
+        ohmy::function_ref<int(ohmy::reference_wrapper<Point>)> by_wrapper = x;
+
+        REQUIRE(by_reference(p) == 3);
+        REQUIRE(by_pointer(&p, 2) == 6);
+        REQUIRE(by_wrapper(ohmy::reference_wrapper<Point>{p}) == 1);
+    }
+
+    SECTION("owning wrappers can be passed on")
+    {
+        ohmy::function<int(int)> owned = twice;
+        ohmy::move_only_function<int(int)> move_only = twice;
+        REQUIRE(apply(owned, 3) == 6);
+        REQUIRE(apply(move_only, 4) == 8);
+    }
+}
+
+namespace
+{
+constexpr int callback_count = 1 << 24;
+
+template <typename Callback>
+[[gnu::noinline]] long sum_with_template(Callback callback)
+{
+    long sum = 0;
+    for (int i = 0; i < callback_count; ++i)
+    {
+        sum += callback(i);
+    }
+    return sum;
+}
+
+[[gnu::noinline]] long sum_with_function(const ohmy::function<int(int)>& f)
+{
+    long sum = 0;
+    for (int i = 0; i < callback_count; ++i)
+    {
+        sum += f(i);
+    }
+    return sum;
+}
+
+[[gnu::noinline]] long sum_with_function_ref(ohmy::function_ref<int(int)> f)
+{
+    long sum = 0;
+    for (int i = 0; i < callback_count; ++i)
+    {
+        sum += f(i);
+    }
+    return sum;
+}
+} // namespace
+
+TEST_CASE("callback benchmarks", "[.benchmark]")
+{
+    int bias = 1;
+    auto callback = [&bias](int x) { return x & bias; };
+    const long expected = callback_count / 2;
+
+    BENCHMARK("template parameter callback")
+    {
+        REQUIRE(sum_with_template(callback) == expected);
+    }
+
+    BENCHMARK("ohmy::function callback")
+    {
+        REQUIRE(sum_with_function(callback) == expected);
+    }
+
+    BENCHMARK("ohmy::function_ref callback")
+    {
+        REQUIRE(sum_with_function_ref(callback) == expected);
+    }
+}
+
+TEST_CASE("function benchmarks", "[.benchmark]")
+{
+    constexpr int count = 1 << 20;
+    int a = 1, b = 2, c = 3;
+
+    BENCHMARK("std::function with three captured pointers")
+    {
+        long sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            std::function<int()> f = [pa = &a, pb = &b, pc = &c] {
+                return *pa + *pb + *pc;
+            };
+            sum += f();
+        }
+        REQUIRE(sum == 6L * count);
+    }
+
+    BENCHMARK("ohmy::function with three captured pointers")
+    {
+        long sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            ohmy::function<int()> f = [pa = &a, pb = &b, pc = &c] {
+                return *pa + *pb + *pc;
+            };
+            sum += f();
+        }
+        REQUIRE(sum == 6L * count);
+    }
+
+    BENCHMARK("ohmy::move_only_function with three captured pointers")
+    {
+        long sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            ohmy::move_only_function<int()> f = [pa = &a, pb = &b, pc = &c] {
+                return *pa + *pb + *pc;
+            };
+            sum += f();
+        }
+        REQUIRE(sum == 6L * count);
+    }
+}
+
+TEST_CASE("function lifecycle benchmarks", "[.benchmark]")
+{
+    constexpr int count = 1 << 20;
+    int a = 1, b = 2, c = 3;
+    auto small = [pa = &a](int x) { return x + *pa; };
+    auto large = [pa = &a, pb = &b, pc = &c](int x) {
+        return x + *pa + *pb + *pc;
+    };
+
+    BENCHMARK("ohmy::function construct and destroy, inline")
+    {
+        long sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            ohmy::function<int(int)> f = small;
+            sum += f(i);
+        }
+        REQUIRE(sum > 0);
+    }
+
+    BENCHMARK("ohmy::function construct and destroy, heap")
+    {
+        long sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            ohmy::function<int(int)> f = large;
+            sum += f(i);
+        }
+        REQUIRE(sum > 0);
+    }
+
+    ohmy::function<int(int)> inline_source = small;
+    BENCHMARK("ohmy::function copy, inline")
+    {
+        long sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            ohmy::function<int(int)> f = inline_source;
+            sum += f(i);
+        }
+        REQUIRE(sum > 0);
+    }
+
+    ohmy::function<int(int)> heap_source = large;
+    BENCHMARK("ohmy::function copy, heap")
+    {
+        long sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            ohmy::function<int(int)> f = heap_source;
+            sum += f(i);
+        }
+        REQUIRE(sum > 0);
+    }
+
+    BENCHMARK("ohmy::function invoke")
+    {
+        long sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            sum += inline_source(i);
+        }
+        REQUIRE(sum > 0);
+    }
+}
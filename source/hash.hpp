@@ -0,0 +1,160 @@
+#ifndef OHMY_HASH_HPP
+#define OHMY_HASH_HPP
+
+#include "c++config.hpp"
+#include "string_view.hpp"
+#include "type_traits.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Hash functions for the library's hash tables. Tables index buckets with
+// the low bits of a hash and keep some of its high bits alongside, so
+// every bit has to depend on the whole key; std::hash makes no such
+// promise and returns integers unchanged, so its results are mixed.
+//
+// Strings of every kind hash and compare alike through string_hash and
+// string_equal, which are transparent: a table keyed on std::string can be
+// searched with a my::string_view or a string literal without building a
+// std::string.
+namespace ohmy
+{
+namespace detail
+{
+// The finalizer of MurmurHash3.
+inline uint64_t mix_hash(uint64_t hash) noexcept
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+inline size_t hash_combine(size_t seed, size_t hash) noexcept
+{
+    return seed ^ (hash + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+inline uint64_t load_word(const unsigned char* bytes) noexcept
+{
+    uint64_t word;
+    __builtin_memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+// Hashes eight bytes at a time; the tail is read as one word padded with
+// zeros, and the length is mixed in so that the padding cannot collide.
+inline size_t hash_bytes(const void* data, size_t size) noexcept
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 0x9e3779b97f4a7c15ULL ^ (size * 0xff51afd7ed558ccdULL);
+    while (size >= 8)
+    {
+        hash ^= mix_hash(load_word(bytes));
+        hash = ((hash << 27) | (hash >> 37)) * 0x9e3779b97f4a7c15ULL;
+        bytes += 8;
+        size -= 8;
+    }
+    if (size != 0)
+    {
+        unsigned char tail[8] = {};
+        __builtin_memcpy(tail, bytes, size);
+        hash ^= mix_hash(load_word(tail));
+    }
+    return static_cast<size_t>(mix_hash(hash));
+}
+
+inline my::string_view as_string_view(my::string_view text) noexcept
+{
+    return text;
+}
+
+inline my::string_view as_string_view(const std::string& text) noexcept
+{
+    return my::string_view{text.data(), text.size()};
+}
+
+inline my::string_view as_string_view(const char* text) noexcept
+{
+    return my::string_view{text};
+}
+} // namespace detail
+
+struct string_hash
+{
+    using is_transparent = void;
+
+    size_t operator()(my::string_view text) const noexcept
+    {
+        return detail::hash_bytes(text.data(), text.size());
+    }
+
+    size_t operator()(const std::string& text) const noexcept
+    {
+        return detail::hash_bytes(text.data(), text.size());
+    }
+
+    size_t operator()(const char* text) const noexcept
+    {
+        return (*this)(my::string_view{text});
+    }
+};
+
+struct string_equal
+{
+    using is_transparent = void;
+
+    template <typename Text, typename OtherText>
+    bool operator()(const Text& lhs, const OtherText& rhs) const noexcept
+    {
+        const my::string_view left = detail::as_string_view(lhs);
+        const my::string_view right = detail::as_string_view(rhs);
+        return left.size() == right.size() and
+               (left.size() == 0 or
+                __builtin_memcmp(left.data(), right.data(), left.size()) ==
+                    0);
+    }
+};
+
+// The default hash of the library's hash tables.
+template <typename Key>
+struct hash
+{
+    size_t operator()(const Key& key) const
+        noexcept(noexcept(std::hash<Key>{}(key)))
+    {
+        return static_cast<size_t>(detail::mix_hash(std::hash<Key>{}(key)));
+    }
+};
+
+template <>
+struct hash<std::string> : string_hash
+{
+};
+
+template <>
+struct hash<my::string_view> : string_hash
+{
+};
+
+// The default key comparison of the library's hash tables.
+template <typename Key>
+struct equal_to : std::equal_to<Key>
+{
+};
+
+template <>
+struct equal_to<std::string> : string_equal
+{
+};
+
+template <>
+struct equal_to<my::string_view> : string_equal
+{
+};
+} // namespace ohmy
+
+#endif // OHMY_HASH_HPP
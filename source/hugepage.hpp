@@ -0,0 +1,209 @@
+#ifndef OHMY_HUGEPAGE_HPP
+#define OHMY_HUGEPAGE_HPP
+
+#include "c++config.hpp"
+#include "utility.hpp"
+
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace ohmy
+{
+inline constexpr size_t huge_page_size = size_t{2} << 20;
+
+enum class hugepage_policy
+{
+    // Explicit huge pages, failing with std::bad_alloc if none are reserved.
+    required,
+    // Explicit huge pages if reserved, otherwise transparent ones.
+    preferred,
+    // Transparent huge pages only.
+    transparent,
+    // Regular pages; transparent huge pages are disabled for the mapping.
+    none,
+};
+
+enum class hugepage_backing
+{
+    none,
+    explicit_pages,
+    transparent_pages,
+    regular_pages,
+};
+
+// A zero-filled anonymous mapping for large tables that are accessed at
+// random, where regular 4 KiB pages cost a TLB miss on almost every
+// lookup. The size is rounded up to whole huge pages.
+//
+// Explicit huge pages (MAP_HUGETLB) have to be reserved by the
+// administrator, so by default the buffer falls back to a mapping aligned
+// to the huge page size and marked with madvise(MADV_HUGEPAGE), which lets
+// the kernel back it with transparent huge pages when it can.
+class hugepage_buffer
+{
+public:
+    hugepage_buffer() noexcept = default;
+
+    explicit hugepage_buffer(
+        size_t bytes, hugepage_policy policy = hugepage_policy::preferred)
+    {
+        if (bytes == 0)
+        {
+            return;
+        }
+        if (__builtin_add_overflow(bytes, huge_page_size - 1, &m_size))
+        {
+            throw std::bad_alloc{};
+        }
+        m_size &= ~(huge_page_size - 1);
+
+        if (policy == hugepage_policy::required or
+            policy == hugepage_policy::preferred)
+        {
+            if (map_explicit())
+            {
+                return;
+            }
+            if (policy == hugepage_policy::required)
+            {
+                m_size = 0;
+                throw std::bad_alloc{};
+            }
+        }
+        map_aligned(policy);
+    }
+
+    hugepage_buffer(hugepage_buffer&& other) noexcept
+        : m_data{other.m_data}, m_size{other.m_size}, m_backing{other.m_backing}
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_backing = hugepage_backing::none;
+    }
+
+    hugepage_buffer& operator=(hugepage_buffer&& other) noexcept
+    {
+        hugepage_buffer moved{ohmy::move(other)};
+        swap(moved);
+        return *this;
+    }
+
+    ~hugepage_buffer()
+    {
+        if (m_data != nullptr)
+        {
+            ::munmap(m_data, m_size);
+        }
+    }
+
+    hugepage_buffer(const hugepage_buffer&) = delete;
+    hugepage_buffer& operator=(const hugepage_buffer&) = delete;
+
+    void* data() noexcept
+    {
+        return m_data;
+    }
+    const void* data() const noexcept
+    {
+        return m_data;
+    }
+
+    // The buffer viewed as an array of trivially copyable Type; the mapping
+    // is zero-filled, which is a valid value for such types.
+    template <typename Type>
+    Type* as() noexcept
+    {
+        return static_cast<Type*>(m_data);
+    }
+    template <typename Type>
+    const Type* as() const noexcept
+    {
+        return static_cast<const Type*>(m_data);
+    }
+
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    hugepage_backing backing() const noexcept
+    {
+        return m_backing;
+    }
+
+    void swap(hugepage_buffer& other) noexcept
+    {
+        ohmy::swap(m_data, other.m_data);
+        ohmy::swap(m_size, other.m_size);
+        ohmy::swap(m_backing, other.m_backing);
+    }
+
+private:
+    bool map_explicit() noexcept
+    {
+#ifdef MAP_HUGETLB
+        const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+        void* mapping =
+            ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (mapping != MAP_FAILED)
+        {
+            m_data = mapping;
+            m_backing = hugepage_backing::explicit_pages;
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    // Transparent huge pages can only back huge-page-aligned ranges, so map
+    // one huge page more than needed and trim the unaligned ends.
+    void map_aligned(hugepage_policy policy)
+    {
+        const size_t padded = m_size + huge_page_size;
+        void* mapping = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED)
+        {
+            m_size = 0;
+            throw std::bad_alloc{};
+        }
+
+        auto* first = static_cast<unsigned char*>(mapping);
+        auto* aligned = reinterpret_cast<unsigned char*>(
+            (reinterpret_cast<uintptr_t>(first) + huge_page_size - 1) &
+            ~(huge_page_size - 1));
+        const size_t head = static_cast<size_t>(aligned - first);
+        if (head != 0)
+        {
+            ::munmap(first, head);
+        }
+        ::munmap(aligned + m_size, padded - head - m_size);
+        m_data = aligned;
+        m_backing = hugepage_backing::regular_pages;
+
+#ifdef MADV_HUGEPAGE
+        if (policy != hugepage_policy::none)
+        {
+            if (::madvise(m_data, m_size, MADV_HUGEPAGE) == 0)
+            {
+                m_backing = hugepage_backing::transparent_pages;
+            }
+        }
+#endif
+#ifdef MADV_NOHUGEPAGE
+        if (policy == hugepage_policy::none)
+        {
+            ::madvise(m_data, m_size, MADV_NOHUGEPAGE);
+        }
+#endif
+    }
+
+    void* m_data = nullptr;
+    size_t m_size = 0;
+    hugepage_backing m_backing = hugepage_backing::none;
+};
+} // namespace ohmy
+
+#endif // OHMY_HUGEPAGE_HPP
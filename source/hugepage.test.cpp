@@ -0,0 +1,105 @@
+#include <catch/catch.hpp>
+
+#include "hugepage.hpp"
+
+#include <cstdint>
+
+TEST_CASE("hugepage_buffer")
+{
+    SECTION("default-constructed buffer is empty")
+    {
+        ohmy::hugepage_buffer buffer;
+        REQUIRE(buffer.data() == nullptr);
+        REQUIRE(buffer.size() == 0u);
+        REQUIRE(buffer.backing() == ohmy::hugepage_backing::none);
+    }
+
+    SECTION("size is rounded to huge pages and the mapping is aligned")
+    {
+        ohmy::hugepage_buffer buffer{ohmy::huge_page_size + 1};
+        REQUIRE(buffer.size() == 2 * ohmy::huge_page_size);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(buffer.data()) %
+                    ohmy::huge_page_size ==
+                0u);
+        REQUIRE(buffer.backing() != ohmy::hugepage_backing::none);
+
+        auto* words = buffer.as<std::uint64_t>();
+        const std::size_t count = buffer.size() / sizeof(std::uint64_t);
+        REQUIRE(words[0] == 0u);
+        REQUIRE(words[count - 1] == 0u);
+        words[count - 1] = 42;
+        REQUIRE(words[count - 1] == 42u);
+    }
+
+    SECTION("regular pages can be requested explicitly")
+    {
+        ohmy::hugepage_buffer buffer{4096, ohmy::hugepage_policy::none};
+        REQUIRE(buffer.backing() == ohmy::hugepage_backing::regular_pages);
+        REQUIRE(buffer.size() == ohmy::huge_page_size);
+    }
+
+    SECTION("moving transfers the mapping")
+    {
+        ohmy::hugepage_buffer first{1, ohmy::hugepage_policy::transparent};
+        void* data = first.data();
+
+        ohmy::hugepage_buffer second{ohmy::move(first)};
+        REQUIRE(first.data() == nullptr);
+        REQUIRE(second.data() == data);
+
+        first = ohmy::move(second);
+        REQUIRE(first.data() == data);
+        REQUIRE(second.data() == nullptr);
+    }
+}
+
+TEST_CASE("hugepage benchmarks", "[.benchmark]")
+{
+    // Random lookups over a table much larger than the TLB reach of 4 KiB
+    // pages; the index sequence is the same for both runs.
+    constexpr std::size_t table_bytes = std::size_t{512} << 20;
+    constexpr std::size_t count = table_bytes / sizeof(std::uint64_t);
+    constexpr int lookups = 1 << 24;
+
+    // Touches every page up front, so page faults are not measured.
+    auto fill = [&](ohmy::hugepage_buffer& buffer) {
+        auto* table = buffer.as<std::uint64_t>();
+        for (std::size_t i = 0; i < count; i += 512)
+        {
+            table[i] = i;
+        }
+    };
+
+    auto run = [&](const ohmy::hugepage_buffer& buffer) {
+        const auto* table = buffer.as<std::uint64_t>();
+        std::uint64_t state = 0x9e3779b97f4a7c15u;
+        std::uint64_t sum = 0;
+        for (int i = 0; i < lookups; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            sum += table[state % count];
+        }
+        return sum;
+    };
+
+    std::uint64_t regular_sum = 0;
+    std::uint64_t huge_sum = 0;
+
+    ohmy::hugepage_buffer regular{table_bytes, ohmy::hugepage_policy::none};
+    fill(regular);
+    BENCHMARK("random lookups on regular pages")
+    {
+        regular_sum = run(regular);
+    }
+
+    ohmy::hugepage_buffer huge{table_bytes, ohmy::hugepage_policy::preferred};
+    fill(huge);
+    BENCHMARK("random lookups on huge pages")
+    {
+        huge_sum = run(huge);
+    }
+
+    REQUIRE(regular_sum == huge_sum);
+}
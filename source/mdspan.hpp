@@ -0,0 +1,453 @@
+#ifndef OHMY_MDSPAN_HPP
+#define OHMY_MDSPAN_HPP
+
+#include "c++config.hpp"
+#include "span.hpp"
+#include "type_traits.hpp"
+
+#include <stdexcept>
+
+// A multidimensional view of contiguous memory. The layout policy maps
+// indices to an offset into that memory:
+//
+//     layout_right       row-major, the last index varies fastest
+//     layout_left        column-major, the first index varies fastest
+//     layout_stride      a stride per dimension, as left by slice
+//     layout_blocked<B>  B elements along every dimension form a block
+//                        that is contiguous, and blocks are row-major
+//
+// Blocked layouts keep neighbours in every dimension close in memory, so
+// walking a matrix by columns touches as few cache lines as walking it by
+// rows. Their memory is padded to whole blocks; required_span_size gives
+// how much there has to be.
+//
+// Extents are all dynamic. operator() is unchecked and at throws
+// std::out_of_range.
+namespace ohmy
+{
+template <size_t Rank>
+class extents
+{
+public:
+    static_assert(Rank > 0, "a view needs at least one dimension");
+
+    template <typename... Sizes,
+              typename = enable_if_t<sizeof...(Sizes) == Rank>>
+    constexpr explicit extents(Sizes... sizes) noexcept
+        : m_extents{static_cast<size_t>(sizes)...}
+    {
+    }
+
+    static constexpr size_t rank() noexcept
+    {
+        return Rank;
+    }
+
+    constexpr size_t extent(size_t dimension) const noexcept
+    {
+        return m_extents[dimension];
+    }
+
+    // The number of elements.
+    constexpr size_t size() const noexcept
+    {
+        size_t size = 1;
+        for (size_t dimension = 0; dimension < Rank; ++dimension)
+            size *= m_extents[dimension];
+        return size;
+    }
+
+private:
+    size_t m_extents[Rank];
+};
+
+template <typename... Sizes>
+extents(Sizes...) -> extents<sizeof...(Sizes)>;
+
+template <size_t Rank>
+constexpr bool operator==(const extents<Rank>& lhs, const extents<Rank>& rhs)
+{
+    for (size_t dimension = 0; dimension < Rank; ++dimension)
+    {
+        if (lhs.extent(dimension) != rhs.extent(dimension))
+            return false;
+    }
+    return true;
+}
+
+template <size_t Rank>
+constexpr bool operator!=(const extents<Rank>& lhs, const extents<Rank>& rhs)
+{
+    return not(lhs == rhs);
+}
+
+struct layout_right
+{
+    template <size_t Rank>
+    class mapping
+    {
+    public:
+        using extents_type = ohmy::extents<Rank>;
+
+        constexpr explicit mapping(const extents_type& extents) noexcept
+            : m_extents{extents}
+        {
+        }
+
+        template <typename... Indices>
+        constexpr size_t operator()(Indices... indices) const noexcept
+        {
+            const size_t index[] = {static_cast<size_t>(indices)...};
+            size_t offset = 0;
+            for (size_t dimension = 0; dimension < Rank; ++dimension)
+            {
+                offset = offset * m_extents.extent(dimension) +
+                         index[dimension];
+            }
+            return offset;
+        }
+
+        constexpr const extents_type& extents() const noexcept
+        {
+            return m_extents;
+        }
+
+        constexpr size_t required_span_size() const noexcept
+        {
+            return m_extents.size();
+        }
+
+        constexpr size_t stride(size_t dimension) const noexcept
+        {
+            size_t stride = 1;
+            for (size_t inner = dimension + 1; inner < Rank; ++inner)
+                stride *= m_extents.extent(inner);
+            return stride;
+        }
+
+    private:
+        extents_type m_extents;
+    };
+};
+
+struct layout_left
+{
+    template <size_t Rank>
+    class mapping
+    {
+    public:
+        using extents_type = ohmy::extents<Rank>;
+
+        constexpr explicit mapping(const extents_type& extents) noexcept
+            : m_extents{extents}
+        {
+        }
+
+        template <typename... Indices>
+        constexpr size_t operator()(Indices... indices) const noexcept
+        {
+            const size_t index[] = {static_cast<size_t>(indices)...};
+            size_t offset = 0;
+            for (size_t dimension = Rank; dimension-- > 0;)
+            {
+                offset = offset * m_extents.extent(dimension) +
+                         index[dimension];
+            }
+            return offset;
+        }
+
+        constexpr const extents_type& extents() const noexcept
+        {
+            return m_extents;
+        }
+
+        constexpr size_t required_span_size() const noexcept
+        {
+            return m_extents.size();
+        }
+
+        constexpr size_t stride(size_t dimension) const noexcept
+        {
+            size_t stride = 1;
+            for (size_t inner = 0; inner < dimension; ++inner)
+                stride *= m_extents.extent(inner);
+            return stride;
+        }
+
+    private:
+        extents_type m_extents;
+    };
+};
+
+struct layout_stride
+{
+    template <size_t Rank>
+    class mapping
+    {
+    public:
+        using extents_type = ohmy::extents<Rank>;
+
+        constexpr mapping(const extents_type& extents,
+                          const size_t (&strides)[Rank]) noexcept
+            : m_extents{extents}, m_strides{}
+        {
+            for (size_t dimension = 0; dimension < Rank; ++dimension)
+                m_strides[dimension] = strides[dimension];
+        }
+
+        // The same mapping as another layout with strides.
+        template <typename Mapping,
+                  typename = decltype(declval<const Mapping&>().stride(0))>
+        constexpr mapping(const Mapping& other) noexcept
+            : m_extents{other.extents()}, m_strides{}
+        {
+            for (size_t dimension = 0; dimension < Rank; ++dimension)
+                m_strides[dimension] = other.stride(dimension);
+        }
+
+        template <typename... Indices>
+        constexpr size_t operator()(Indices... indices) const noexcept
+        {
+            const size_t index[] = {static_cast<size_t>(indices)...};
+            size_t offset = 0;
+            for (size_t dimension = 0; dimension < Rank; ++dimension)
+                offset += index[dimension] * m_strides[dimension];
+            return offset;
+        }
+
+        constexpr const extents_type& extents() const noexcept
+        {
+            return m_extents;
+        }
+
+        // One past the offset of the last element.
+        constexpr size_t required_span_size() const noexcept
+        {
+            size_t last = 0;
+            for (size_t dimension = 0; dimension < Rank; ++dimension)
+            {
+                if (m_extents.extent(dimension) == 0)
+                    return 0;
+                last += (m_extents.extent(dimension) - 1) *
+                        m_strides[dimension];
+            }
+            return last + 1;
+        }
+
+        constexpr size_t stride(size_t dimension) const noexcept
+        {
+            return m_strides[dimension];
+        }
+
+    private:
+        extents_type m_extents;
+        size_t m_strides[Rank];
+    };
+};
+
+template <size_t Block>
+struct layout_blocked
+{
+    static_assert(Block > 0, "blocks need at least one element");
+
+    template <size_t Rank>
+    class mapping
+    {
+    public:
+        using extents_type = ohmy::extents<Rank>;
+
+        constexpr explicit mapping(const extents_type& extents) noexcept
+            : m_extents{extents}
+        {
+        }
+
+        template <typename... Indices>
+        constexpr size_t operator()(Indices... indices) const noexcept
+        {
+            const size_t index[] = {static_cast<size_t>(indices)...};
+            size_t block = 0;
+            size_t inner = 0;
+            for (size_t dimension = 0; dimension < Rank; ++dimension)
+            {
+                block = block * blocks(dimension) + index[dimension] / Block;
+                inner = inner * Block + index[dimension] % Block;
+            }
+            return block * block_size() + inner;
+        }
+
+        constexpr const extents_type& extents() const noexcept
+        {
+            return m_extents;
+        }
+
+        constexpr size_t required_span_size() const noexcept
+        {
+            size_t count = 1;
+            for (size_t dimension = 0; dimension < Rank; ++dimension)
+                count *= blocks(dimension);
+            return count * block_size();
+        }
+
+        // The number of elements in a block.
+        static constexpr size_t block_size() noexcept
+        {
+            size_t size = 1;
+            for (size_t dimension = 0; dimension < Rank; ++dimension)
+                size *= Block;
+            return size;
+        }
+
+    private:
+        constexpr size_t blocks(size_t dimension) const noexcept
+        {
+            return (m_extents.extent(dimension) + Block - 1) / Block;
+        }
+
+        extents_type m_extents;
+    };
+};
+
+template <typename Type, size_t Rank, typename Layout = layout_right>
+class mdspan
+{
+public:
+    using element_type = Type;
+    using value_type = remove_cv_t<Type>;
+    using size_type = size_t;
+    using pointer = Type*;
+    using reference = Type&;
+    using layout_type = Layout;
+    using extents_type = ohmy::extents<Rank>;
+    using mapping_type = typename Layout::template mapping<Rank>;
+
+    template <typename... Sizes,
+              typename = enable_if_t<sizeof...(Sizes) == Rank>>
+    constexpr mdspan(pointer data, Sizes... sizes) noexcept
+        : m_data{data}, m_mapping{extents_type(sizes...)}
+    {
+    }
+
+    constexpr mdspan(pointer data, const mapping_type& mapping) noexcept
+        : m_data{data}, m_mapping{mapping}
+    {
+    }
+
+    // Throws std::length_error if memory is too short for the layout.
+    template <size_t Extent, typename... Sizes,
+              typename = enable_if_t<sizeof...(Sizes) == Rank>>
+    constexpr mdspan(span<Type, Extent> memory, Sizes... sizes)
+        : mdspan(memory.data(), sizes...)
+    {
+        if (memory.size() < required_span_size())
+            throw std::length_error(__PRETTY_FUNCTION__);
+    }
+
+    template <typename Other,
+              typename = enable_if_t<is_convertible_v<Other (*)[], Type (*)[]>>>
+    constexpr mdspan(const mdspan<Other, Rank, Layout>& other) noexcept
+        : m_data{other.data()}, m_mapping{other.mapping()}
+    {
+    }
+
+    template <typename... Indices,
+              typename = enable_if_t<sizeof...(Indices) == Rank>>
+    constexpr reference operator()(Indices... indices) const noexcept
+    {
+        return m_data[m_mapping(indices...)];
+    }
+
+    template <typename... Indices,
+              typename = enable_if_t<sizeof...(Indices) == Rank>>
+    constexpr reference at(Indices... indices) const
+    {
+        const size_t index[] = {static_cast<size_t>(indices)...};
+        for (size_t dimension = 0; dimension < Rank; ++dimension)
+        {
+            if (index[dimension] >= extent(dimension))
+                throw std::out_of_range(__PRETTY_FUNCTION__);
+        }
+        return m_data[m_mapping(indices...)];
+    }
+
+    static constexpr size_t rank() noexcept
+    {
+        return Rank;
+    }
+
+    constexpr size_type extent(size_t dimension) const noexcept
+    {
+        return m_mapping.extents().extent(dimension);
+    }
+
+    constexpr const extents_type& extents() const noexcept
+    {
+        return m_mapping.extents();
+    }
+
+    // The number of elements, which padding can make smaller than
+    // required_span_size.
+    constexpr size_type size() const noexcept
+    {
+        return m_mapping.extents().size();
+    }
+
+    constexpr size_type required_span_size() const noexcept
+    {
+        return m_mapping.required_span_size();
+    }
+
+    constexpr size_type stride(size_t dimension) const noexcept
+    {
+        return m_mapping.stride(dimension);
+    }
+
+    constexpr pointer data() const noexcept
+    {
+        return m_data;
+    }
+
+    constexpr const mapping_type& mapping() const noexcept
+    {
+        return m_mapping;
+    }
+
+    // The view of one less dimension that fixes dimension at index, such
+    // as a row or a column of a matrix. Needs a layout with strides. Throws
+    // std::out_of_range unless dimension < Rank and index < extent of it.
+    template <size_t Fewer = Rank - 1, typename = enable_if_t<(Fewer > 0)>>
+    constexpr mdspan<Type, Fewer, layout_stride> slice(size_t dimension,
+                                                       size_t index) const
+    {
+        if (dimension >= Rank or index >= extent(dimension))
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+
+        size_t sizes[Fewer] = {};
+        size_t strides[Fewer] = {};
+        for (size_t from = 0, to = 0; from < Rank; ++from)
+        {
+            if (from == dimension)
+                continue;
+            sizes[to] = extent(from);
+            strides[to] = stride(from);
+            ++to;
+        }
+        return mdspan<Type, Fewer, layout_stride>(
+            m_data + index * stride(dimension),
+            layout_stride::mapping<Fewer>(
+                make_extents(sizes, make_index_sequence<Fewer>{}), strides));
+    }
+
+private:
+    template <size_t Count, size_t... Indices>
+    static constexpr ohmy::extents<Count>
+    make_extents(const size_t (&sizes)[Count], index_sequence<Indices...>)
+    {
+        return ohmy::extents<Count>(sizes[Indices]...);
+    }
+
+    pointer m_data;
+    mapping_type m_mapping;
+};
+} // namespace ohmy
+
+#endif // OHMY_MDSPAN_HPP
@@ -0,0 +1,134 @@
+#include <catch/catch.hpp>
+
+#include "mdspan.hpp"
+#include "vector.hpp"
+
+#include <stdexcept>
+
+namespace
+{
+// Checks that a mapping sends every index pair of a rows x columns matrix
+// to a different offset below required_span_size.
+template <typename Mapping>
+bool is_one_to_one(const Mapping& mapping, size_t rows, size_t columns)
+{
+    ohmy::vector<int> hits(mapping.required_span_size(), 0);
+    for (size_t row = 0; row < rows; ++row)
+    {
+        for (size_t column = 0; column < columns; ++column)
+        {
+            const size_t offset = mapping(row, column);
+            if (offset >= hits.size() or hits[offset]++ != 0)
+                return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+static_assert(ohmy::layout_right::mapping<3>{ohmy::extents{2, 3, 4}}(1, 2, 3) ==
+              23);
+static_assert(ohmy::layout_left::mapping<3>{ohmy::extents{2, 3, 4}}(1, 2, 3) ==
+              1 + 2 * 2 + 3 * 6);
+
+TEST_CASE("mdspan")
+{
+    int values[12];
+    for (int i = 0; i < 12; ++i)
+        values[i] = i;
+
+    SECTION("row-major")
+    {
+        ohmy::mdspan<int, 2> matrix{values, 3, 4};
+        REQUIRE(matrix.rank() == 2u);
+        REQUIRE(matrix.extent(0) == 3u);
+        REQUIRE(matrix.extent(1) == 4u);
+        REQUIRE(matrix(1, 2) == 6);
+        REQUIRE(matrix.stride(0) == 4u);
+        REQUIRE(matrix.stride(1) == 1u);
+        REQUIRE(matrix.size() == 12u);
+        REQUIRE(matrix.at(2, 3) == 11);
+        REQUIRE_THROWS_AS(matrix.at(3, 0), std::out_of_range);
+        REQUIRE_THROWS_AS(matrix.at(0, 4), std::out_of_range);
+    }
+
+    SECTION("column-major")
+    {
+        ohmy::mdspan<int, 2, ohmy::layout_left> matrix{values, 3, 4};
+        REQUIRE(matrix(1, 2) == 7);
+        REQUIRE(matrix(2, 0) == 2);
+        REQUIRE(matrix.stride(1) == 3u);
+        matrix(0, 1) = 100;
+        REQUIRE(values[3] == 100);
+    }
+
+    SECTION("slices are strided views of the same memory")
+    {
+        ohmy::mdspan<int, 2> matrix{values, 3, 4};
+        auto column = matrix.slice(1, 2);
+        REQUIRE(column.extent(0) == 3u);
+        REQUIRE(column.stride(0) == 4u);
+        REQUIRE(column(0) == 2);
+        REQUIRE(column(2) == 10);
+        REQUIRE(column.required_span_size() == 9u);
+
+        auto row = matrix.slice(0, 1);
+        REQUIRE(row(3) == 7);
+        row(0) = -1;
+        REQUIRE(matrix(1, 0) == -1);
+
+        ohmy::mdspan<int, 3> cube{values, 2, 3, 2};
+        auto face = cube.slice(2, 1);
+        REQUIRE(face.extent(0) == 2u);
+        REQUIRE(face.extent(1) == 3u);
+        REQUIRE(face(1, 2) == cube(1, 2, 1));
+
+        REQUIRE_THROWS_AS(matrix.slice(2, 0), std::out_of_range);
+        REQUIRE_THROWS_AS(matrix.slice(0, 3), std::out_of_range);
+        REQUIRE_THROWS_AS(cube.slice(2, 2), std::out_of_range);
+    }
+
+    SECTION("over a span that has to be long enough")
+    {
+        ohmy::span<int> memory{values};
+        ohmy::mdspan<int, 2> matrix{memory, 4, 3};
+        REQUIRE(matrix(3, 2) == 11);
+        REQUIRE_THROWS_AS((ohmy::mdspan<int, 2>{memory, 4, 4}),
+                          std::length_error);
+
+        ohmy::mdspan<const int, 2> readonly = matrix;
+        REQUIRE(readonly(0, 1) == 1);
+    }
+
+    SECTION("blocked")
+    {
+        using layout = ohmy::layout_blocked<4>;
+        layout::mapping<2> mapping{ohmy::extents{6, 7}};
+        REQUIRE(layout::mapping<2>::block_size() == 16u);
+        REQUIRE(mapping.required_span_size() == 4u * 16u);
+        REQUIRE(is_one_to_one(mapping, 6, 7));
+
+        // A 4 x 4 block is contiguous, and the next block follows it.
+        REQUIRE(mapping(0, 0) == 0u);
+        REQUIRE(mapping(0, 3) == 3u);
+        REQUIRE(mapping(1, 0) == 4u);
+        REQUIRE(mapping(3, 3) == 15u);
+        REQUIRE(mapping(0, 4) == 16u);
+        REQUIRE(mapping(4, 0) == 32u);
+
+        ohmy::vector<double> memory(mapping.required_span_size());
+        ohmy::mdspan<double, 2, layout> matrix{memory.data(), mapping};
+        matrix(5, 6) = 1.5;
+        REQUIRE(memory[mapping(5, 6)] == 1.5);
+    }
+
+    SECTION("row- and column-major cover the matrix once")
+    {
+        REQUIRE(is_one_to_one(ohmy::layout_right::mapping<2>{
+                                  ohmy::extents{5, 3}},
+                              5, 3));
+        REQUIRE(is_one_to_one(ohmy::layout_left::mapping<2>{
+                                  ohmy::extents{5, 3}},
+                              5, 3));
+    }
+}
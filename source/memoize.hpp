@@ -0,0 +1,537 @@
+#ifndef OHMY_MEMOIZE_HPP
+#define OHMY_MEMOIZE_HPP
+
+#include "c++config.hpp"
+#include "cache_padded.hpp"
+#include "functional.hpp"
+#include "hash.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+
+// Caches the results of a pure callable by its arguments. The arguments are
+// copied into a tuple key, whose elements are hashed with std::hash and
+// combined. The results live in a table of fixed capacity, found through an
+// open-addressing index with linear probing; once the table is full, CLOCK
+// eviction replaces an entry that was not used since the clock hand last
+// passed it, which approximates evicting the least recently used one
+// without reordering anything on a hit.
+namespace ohmy
+{
+namespace detail
+{
+template <typename Key>
+struct tuple_hash;
+
+template <typename... Types>
+struct tuple_hash<std::tuple<Types...>>
+{
+    size_t operator()(const std::tuple<Types...>& key) const
+    {
+        return std::apply(
+            [](const Types&... values) {
+                size_t seed = 0;
+                ((seed = hash_combine(seed, std::hash<Types>{}(values))), ...);
+                return static_cast<size_t>(mix_hash(seed));
+            },
+            key);
+    }
+};
+
+// The signature a callable is memoized under when none is given: that of
+// a function pointer or of the single call operator of a class.
+template <typename Callable, typename = void>
+struct call_signature
+{
+};
+
+template <typename Result, typename... ArgumentTypes>
+struct call_signature<Result (*)(ArgumentTypes...)>
+{
+    using type = Result(ArgumentTypes...);
+};
+
+template <typename Result, typename... ArgumentTypes>
+struct call_signature<Result (*)(ArgumentTypes...) noexcept>
+{
+    using type = Result(ArgumentTypes...);
+};
+
+template <typename MemberPointer>
+struct call_operator_signature;
+
+template <typename Result, typename Class, typename... ArgumentTypes>
+struct call_operator_signature<Result (Class::*)(ArgumentTypes...)>
+{
+    using type = Result(ArgumentTypes...);
+};
+
+template <typename Result, typename Class, typename... ArgumentTypes>
+struct call_operator_signature<Result (Class::*)(ArgumentTypes...) const>
+{
+    using type = Result(ArgumentTypes...);
+};
+
+template <typename Result, typename Class, typename... ArgumentTypes>
+struct call_operator_signature<Result (Class::*)(ArgumentTypes...) noexcept>
+{
+    using type = Result(ArgumentTypes...);
+};
+
+template <typename Result, typename Class, typename... ArgumentTypes>
+struct call_operator_signature<Result (Class::*)(ArgumentTypes...)
+                                   const noexcept>
+{
+    using type = Result(ArgumentTypes...);
+};
+
+template <typename Callable>
+struct call_signature<Callable, void_t<decltype(&Callable::operator())>>
+    : call_operator_signature<decltype(&Callable::operator())>
+{
+};
+
+template <typename Callable>
+using call_signature_t = typename call_signature<decay_t<Callable>>::type;
+
+// The entries of a memoization cache and the open-addressing index over
+// them. The index has at least twice as many buckets as there are
+// entries, each holding one plus the position of its entry, or zero.
+template <typename Key, typename Value>
+class memo_table
+{
+public:
+    explicit memo_table(size_t capacity)
+        : m_capacity{capacity}, m_buckets(bucket_count(capacity))
+    {
+        m_entries.reserve(capacity);
+    }
+
+    // Returns the cached value of key, or nullptr, and counts a hit or a
+    // miss.
+    Value* find(const Key& key, size_t hash)
+    {
+        entry* found = lookup(key, hash);
+        if (found == nullptr)
+        {
+            ++m_misses;
+            return nullptr;
+        }
+        found->referenced = true;
+        ++m_hits;
+        return &found->value;
+    }
+
+    bool contains(const Key& key, size_t hash)
+    {
+        return lookup(key, hash) != nullptr;
+    }
+
+    // Caches value under key, which must not be cached yet.
+    void insert(Key&& key, Value&& value, size_t hash)
+    {
+        size_t position;
+        if (m_vacant != no_entry)
+        {
+            position = m_vacant;
+        }
+        else if (m_entries.size() < m_capacity)
+        {
+            m_entries.push_back(
+                entry{ohmy::move(key), ohmy::move(value), hash, false});
+            link(m_entries.size() - 1);
+            return;
+        }
+        else
+        {
+            position = evict();
+        }
+
+        // The entry stays vacant, and is taken by the next insertion, if
+        // assigning to it throws.
+        m_vacant = position;
+        entry& replaced = m_entries[position];
+        replaced.key = ohmy::move(key);
+        replaced.value = ohmy::move(value);
+        replaced.hash = hash;
+        replaced.referenced = false;
+        m_vacant = no_entry;
+        link(position);
+    }
+
+    size_t size() const noexcept
+    {
+        return m_entries.size() - (m_vacant != no_entry ? 1 : 0);
+    }
+
+    size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    size_t hits() const noexcept
+    {
+        return m_hits;
+    }
+
+    size_t misses() const noexcept
+    {
+        return m_misses;
+    }
+
+    size_t evictions() const noexcept
+    {
+        return m_evictions;
+    }
+
+private:
+    struct entry
+    {
+        Key key;
+        Value value;
+        size_t hash;
+        bool referenced;
+    };
+
+    static size_t bucket_count(size_t capacity)
+    {
+        if (capacity == 0 or capacity > max_capacity)
+            throw std::length_error(__PRETTY_FUNCTION__);
+
+        size_t buckets = 2;
+        while (buckets < 2 * capacity)
+        {
+            buckets *= 2;
+        }
+        return buckets;
+    }
+
+    static constexpr size_t max_capacity = ~size_t{0} / 4;
+    static constexpr size_t no_entry = ~size_t{0};
+
+    entry* lookup(const Key& key, size_t hash)
+    {
+        const size_t mask = m_buckets.size() - 1;
+        for (size_t bucket = hash & mask; m_buckets[bucket] != 0;
+             bucket = (bucket + 1) & mask)
+        {
+            entry& candidate = m_entries[m_buckets[bucket] - 1];
+            if (candidate.hash == hash and candidate.key == key)
+            {
+                return &candidate;
+            }
+        }
+        return nullptr;
+    }
+
+    void link(size_t position) noexcept
+    {
+        const size_t mask = m_buckets.size() - 1;
+        size_t bucket = m_entries[position].hash & mask;
+        while (m_buckets[bucket] != 0)
+        {
+            bucket = (bucket + 1) & mask;
+        }
+        m_buckets[bucket] = position + 1;
+    }
+
+    // Advances the clock hand, clearing reference bits, to the first entry
+    // that was not referenced, and unlinks that entry from the index.
+    size_t evict() noexcept
+    {
+        while (m_entries[m_hand].referenced)
+        {
+            m_entries[m_hand].referenced = false;
+            m_hand = m_hand + 1 == m_capacity ? 0 : m_hand + 1;
+        }
+        const size_t victim = m_hand;
+        m_hand = m_hand + 1 == m_capacity ? 0 : m_hand + 1;
+        unlink(victim);
+        ++m_evictions;
+        return victim;
+    }
+
+    // Backward-shift deletion: the entries probed past the freed bucket are
+    // moved up, so lookups never need tombstones.
+    void unlink(size_t position) noexcept
+    {
+        const size_t mask = m_buckets.size() - 1;
+        size_t hole = m_entries[position].hash & mask;
+        while (m_buckets[hole] != position + 1)
+        {
+            hole = (hole + 1) & mask;
+        }
+
+        for (size_t bucket = (hole + 1) & mask; m_buckets[bucket] != 0;
+             bucket = (bucket + 1) & mask)
+        {
+            const size_t home = m_entries[m_buckets[bucket] - 1].hash & mask;
+            // Moves the entry unless its home lies cyclically in
+            // (hole, bucket], in which case it may not precede it.
+            const bool stays = hole <= bucket
+                                   ? hole < home and home <= bucket
+                                   : hole < home or home <= bucket;
+            if (not stays)
+            {
+                m_buckets[hole] = m_buckets[bucket];
+                hole = bucket;
+            }
+        }
+        m_buckets[hole] = 0;
+    }
+
+    size_t m_capacity;
+    vector<entry> m_entries;
+    vector<size_t> m_buckets;
+    size_t m_hand = 0;
+    size_t m_vacant = no_entry;
+    size_t m_hits = 0;
+    size_t m_misses = 0;
+    size_t m_evictions = 0;
+};
+} // namespace detail
+
+inline size_t default_memo_shards() noexcept
+{
+    const size_t threads = std::thread::hardware_concurrency();
+    return threads != 0 ? 4 * threads : 16;
+}
+
+struct memo_stats
+{
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+
+    double hit_ratio() const noexcept
+    {
+        const size_t calls = hits + misses;
+        return calls == 0 ? 0.0 : static_cast<double>(hits) / calls;
+    }
+};
+
+template <typename Signature, typename Function>
+class memoized;
+
+// A callable caching the results of Function for at most capacity
+// argument lists. Results are returned by value, so a cached result stays
+// valid after it was evicted. Not safe to call concurrently; see
+// sharded_memoized.
+template <typename Result, typename... ArgumentTypes, typename Function>
+class memoized<Result(ArgumentTypes...), Function>
+{
+    static_assert(not is_void_v<Result>, "memoized results cannot be void");
+
+public:
+    using key_type = std::tuple<decay_t<ArgumentTypes>...>;
+    using result_type = decay_t<Result>;
+
+    memoized(Function f, size_t capacity)
+        : m_function(ohmy::move(f)), m_table{capacity}
+    {
+    }
+
+    result_type operator()(ArgumentTypes... arguments)
+    {
+        key_type key{arguments...};
+        const size_t hash = detail::tuple_hash<key_type>{}(key);
+        if (const result_type* cached = m_table.find(key, hash))
+        {
+            return *cached;
+        }
+
+        result_type result = ohmy::invoke(m_function, arguments...);
+        m_table.insert(ohmy::move(key), result_type(result), hash);
+        return result;
+    }
+
+    memo_stats stats() const noexcept
+    {
+        return memo_stats{m_table.hits(), m_table.misses(),
+                          m_table.evictions()};
+    }
+
+    size_t size() const noexcept
+    {
+        return m_table.size();
+    }
+
+    size_t capacity() const noexcept
+    {
+        return m_table.capacity();
+    }
+
+private:
+    using table_type = detail::memo_table<key_type, result_type>;
+
+    Function m_function;
+    table_type m_table;
+};
+
+template <typename Signature, typename Function>
+class sharded_memoized;
+
+// A memoized callable for concurrent callers. The cache is split into
+// shards by the hash of the arguments, each behind its own lock on its
+// own cache lines, so callers contend only when their arguments land on
+// the same shard. Function runs outside the lock and has to be safe to
+// call concurrently; two threads missing on the same arguments at the
+// same time may both compute the result.
+template <typename Result, typename... ArgumentTypes, typename Function>
+class sharded_memoized<Result(ArgumentTypes...), Function>
+{
+    static_assert(not is_void_v<Result>, "memoized results cannot be void");
+
+public:
+    using key_type = std::tuple<decay_t<ArgumentTypes>...>;
+    using result_type = decay_t<Result>;
+
+    // The capacity is divided between the shards, the remainder going one
+    // entry each to the first ones. There are no more shards than entries.
+    sharded_memoized(Function f, size_t capacity, size_t shards)
+        : m_function(ohmy::move(f)),
+          m_shard_count{round_shards(shards, capacity)},
+          m_shards{make_unique<cache_padded<shard>[]>(m_shard_count)}
+    {
+        const size_t per_shard = capacity / m_shard_count;
+        const size_t remainder = capacity % m_shard_count;
+        for (size_t i = 0; i < m_shard_count; ++i)
+        {
+            m_shards[i]->table =
+                make_unique<table_type>(per_shard + (i < remainder ? 1 : 0));
+        }
+    }
+
+    result_type operator()(ArgumentTypes... arguments) const
+    {
+        key_type key{arguments...};
+        const size_t hash = detail::tuple_hash<key_type>{}(key);
+        // The high bits pick the shard, the low ones the bucket within it.
+        shard& owner = *m_shards[(hash >> 48) & (m_shard_count - 1)];
+        {
+            std::lock_guard<std::mutex> lock{owner.mutex};
+            if (const result_type* cached = owner.table->find(key, hash))
+            {
+                return *cached;
+            }
+        }
+
+        result_type result = ohmy::invoke(m_function, arguments...);
+        std::lock_guard<std::mutex> lock{owner.mutex};
+        if (not owner.table->contains(key, hash))
+        {
+            owner.table->insert(ohmy::move(key), result_type(result), hash);
+        }
+        return result;
+    }
+
+    // Summed over the shards, each read under its lock. A result computed
+    // by two racing callers counts two misses and one hit here.
+    memo_stats stats() const
+    {
+        memo_stats total;
+        for (size_t i = 0; i < m_shard_count; ++i)
+        {
+            const shard& counted = *m_shards[i];
+            std::lock_guard<std::mutex> lock{counted.mutex};
+            total.hits += counted.table->hits();
+            total.misses += counted.table->misses();
+            total.evictions += counted.table->evictions();
+        }
+        return total;
+    }
+
+    // Summed over the shards, each read under its lock.
+    size_t size() const
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < m_shard_count; ++i)
+        {
+            const shard& counted = *m_shards[i];
+            std::lock_guard<std::mutex> lock{counted.mutex};
+            total += counted.table->size();
+        }
+        return total;
+    }
+
+    size_t capacity() const noexcept
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < m_shard_count; ++i)
+        {
+            total += m_shards[i]->table->capacity();
+        }
+        return total;
+    }
+
+    size_t shards() const noexcept
+    {
+        return m_shard_count;
+    }
+
+private:
+    using table_type = detail::memo_table<key_type, result_type>;
+
+    struct shard
+    {
+        mutable std::mutex mutex;
+        unique_ptr<table_type> table;
+    };
+
+    static size_t round_shards(size_t shards, size_t capacity) noexcept
+    {
+        size_t rounded = 1;
+        while (rounded < shards and rounded < 1024 and 2 * rounded <= capacity)
+        {
+            rounded *= 2;
+        }
+        return rounded;
+    }
+
+    Function m_function;
+    size_t m_shard_count;
+    unique_ptr<cache_padded<shard>[]> m_shards;
+};
+
+// Wraps f in a cache of the results of up to capacity argument lists. The
+// signature is deduced from a function pointer or a class with a single
+// call operator, or can be given explicitly as in memoize<double(int)>(f).
+template <typename Signature, typename Function>
+memoized<Signature, decay_t<Function>> memoize(Function&& f, size_t capacity)
+{
+    return {ohmy::forward<Function>(f), capacity};
+}
+
+template <typename Function>
+memoized<detail::call_signature_t<Function>, decay_t<Function>>
+memoize(Function&& f, size_t capacity)
+{
+    return {ohmy::forward<Function>(f), capacity};
+}
+
+template <typename Signature, typename Function>
+sharded_memoized<Signature, decay_t<Function>>
+memoize_sharded(Function&& f, size_t capacity,
+                size_t shards = default_memo_shards())
+{
+    return {ohmy::forward<Function>(f), capacity, shards};
+}
+
+template <typename Function>
+sharded_memoized<detail::call_signature_t<Function>, decay_t<Function>>
+memoize_sharded(Function&& f, size_t capacity,
+                size_t shards = default_memo_shards())
+{
+    return {ohmy::forward<Function>(f), capacity, shards};
+}
+} // namespace ohmy
+
+#endif // OHMY_MEMOIZE_HPP
@@ -0,0 +1,233 @@
+#include <catch/catch.hpp>
+
+#include "memoize.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+int square(int value)
+{
+    return value * value;
+}
+
+// A stand-in for an expensive pure pricing function.
+double price(double spot, double strike, int steps)
+{
+    double value = 0;
+    for (int step = 1; step <= steps; ++step)
+    {
+        value += std::exp(-step * 1e-3) * std::fmax(spot - strike, 0.0);
+    }
+    return value / steps;
+}
+} // namespace
+
+TEST_CASE("memoize")
+{
+    SECTION("repeated arguments are served from the cache")
+    {
+        int calls = 0;
+        auto cached = ohmy::memoize(
+            [&calls](int a, int b) {
+                ++calls;
+                return a * 10 + b;
+            },
+            16);
+
+        REQUIRE(cached(1, 2) == 12);
+        REQUIRE(cached(2, 1) == 21);
+        REQUIRE(cached(1, 2) == 12);
+        REQUIRE(calls == 2);
+
+        const ohmy::memo_stats stats = cached.stats();
+        REQUIRE(stats.hits == 1u);
+        REQUIRE(stats.misses == 2u);
+        REQUIRE(stats.evictions == 0u);
+        REQUIRE(stats.hit_ratio() == Approx(1.0 / 3));
+    }
+
+    SECTION("function pointers and explicit signatures")
+    {
+        auto squares = ohmy::memoize(&square, 4);
+        REQUIRE(squares(3) == 9);
+        REQUIRE(squares(3) == 9);
+        REQUIRE(squares.stats().hits == 1u);
+
+        auto lengths = ohmy::memoize<size_t(const std::string&)>(
+            [](const std::string& text) { return text.size(); }, 4);
+        REQUIRE(lengths("four") == 4u);
+        REQUIRE(lengths(std::string{"four"}) == 4u);
+        REQUIRE(lengths.stats().hits == 1u);
+    }
+
+    SECTION("a full cache evicts entries that were not used recently")
+    {
+        int calls = 0;
+        auto cached = ohmy::memoize(
+            [&calls](int value) {
+                ++calls;
+                return -value;
+            },
+            4);
+        for (int value = 0; value < 4; ++value)
+        {
+            cached(value);
+        }
+        REQUIRE(cached.size() == 4u);
+
+        // The clock hand clears every reference bit, then evicts 0.
+        REQUIRE(cached(4) == -4);
+        REQUIRE(cached.size() == 4u);
+        REQUIRE(cached.stats().evictions == 1u);
+
+        // 1 was used since, so 2 goes next.
+        cached(1);
+        cached(5);
+        calls = 0;
+        cached(1);
+        cached(3);
+        cached(4);
+        cached(5);
+        REQUIRE(calls == 0);
+        cached(0);
+        cached(2);
+        REQUIRE(calls == 2);
+    }
+
+    SECTION("results stay correct under heavy eviction")
+    {
+        auto cached = ohmy::memoize(
+            [](int a, long b) { return static_cast<long>(a) * 1000 + b; },
+            37);
+        for (int round = 0; round < 20; ++round)
+        {
+            for (int a = 0; a < 50; ++a)
+            {
+                const long b = (a * 7 + round) % 13;
+                REQUIRE(cached(a, b) == a * 1000 + b);
+            }
+        }
+        REQUIRE(cached.size() == 37u);
+        REQUIRE(cached.stats().evictions > 0u);
+    }
+
+    SECTION("capacity has to be positive")
+    {
+        REQUIRE_THROWS_AS(ohmy::memoize(&square, 0), std::length_error);
+    }
+}
+
+TEST_CASE("memoize_sharded")
+{
+    SECTION("shards are a power of two")
+    {
+        auto cached = ohmy::memoize_sharded(&square, 64, 5);
+        REQUIRE(cached.shards() == 8u);
+        REQUIRE(cached(7) == 49);
+        REQUIRE(cached(7) == 49);
+        REQUIRE(cached.stats().hits == 1u);
+        REQUIRE(cached.stats().misses == 1u);
+    }
+
+    SECTION("the shards together hold at most capacity entries")
+    {
+        auto cached = ohmy::memoize_sharded(&square, 10, 64);
+        REQUIRE(cached.shards() == 8u);
+        REQUIRE(cached.capacity() == 10u);
+        for (int value = 0; value < 1000; ++value)
+        {
+            REQUIRE(cached(value) == value * value);
+            REQUIRE(cached.size() <= 10u);
+        }
+
+        REQUIRE(ohmy::memoize_sharded(&square, 100, 8).capacity() == 100u);
+        REQUIRE_THROWS_AS(ohmy::memoize_sharded(&square, 0), std::length_error);
+    }
+
+    SECTION("concurrent callers share the cache")
+    {
+        std::atomic<int> calls{0};
+        auto cached = ohmy::memoize_sharded(
+            [&calls](int value) {
+                ++calls;
+                return value * 3;
+            },
+            1024, 4);
+
+        std::vector<std::thread> callers;
+        std::atomic<bool> correct{true};
+        for (int t = 0; t < 4; ++t)
+        {
+            callers.emplace_back([&] {
+                for (int round = 0; round < 50; ++round)
+                {
+                    for (int value = 0; value < 100; ++value)
+                    {
+                        if (cached(value) != value * 3)
+                        {
+                            correct = false;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& caller : callers)
+        {
+            caller.join();
+        }
+
+        REQUIRE(correct);
+        const ohmy::memo_stats stats = cached.stats();
+        REQUIRE(stats.hits + stats.misses == 4u * 50 * 100);
+        REQUIRE(stats.misses == static_cast<size_t>(calls.load()));
+        REQUIRE(calls >= 100);
+        REQUIRE(calls <= 400);
+    }
+}
+
+TEST_CASE("memoize benchmarks", "[.benchmark]")
+{
+    constexpr int calls = 200000;
+    std::vector<double> spots;
+    for (int i = 0; i < calls; ++i)
+    {
+        spots.push_back(90 + (i * 7919) % 64 * 0.5);
+    }
+
+    double uncached_total = 0;
+    BENCHMARK("price, 64 distinct spots, uncached")
+    {
+        for (double spot : spots)
+        {
+            uncached_total += price(spot, 100, 50);
+        }
+    }
+
+    auto cached = ohmy::memoize(&price, 128);
+    double cached_total = 0;
+    BENCHMARK("price, 64 distinct spots, memoized")
+    {
+        for (double spot : spots)
+        {
+            cached_total += cached(spot, 100, 50);
+        }
+    }
+    REQUIRE(cached_total == Approx(uncached_total));
+    WARN("hit ratio " << cached.stats().hit_ratio());
+
+    auto sharded = ohmy::memoize_sharded(&price, 128);
+    double sharded_total = 0;
+    BENCHMARK("price, 64 distinct spots, sharded memoized")
+    {
+        for (double spot : spots)
+        {
+            sharded_total += sharded(spot, 100, 50);
+        }
+    }
+    REQUIRE(sharded_total == Approx(uncached_total));
+}
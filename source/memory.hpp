@@ -1,9 +1,13 @@
 #ifndef MY_MEMORY_HPP
 #define MY_MEMORY_HPP
 
+#include "c++config.hpp"
 #include "type_traits.hpp"
 #include "utility.hpp"
 
+#include <cstdlib>
+#include <new>
+
 namespace ohmy
 {
 template <typename Type>
@@ -68,8 +72,8 @@ class unique_ptr_impl
     };
 
 public:
-    using DeleterConstraint = enable_if_t<not is_pointer_v<Deleter> and
-                                          is_default_constructible_v<Deleter>>;
+    using DeleterConstraint = enable_if<not is_pointer_v<Deleter> and
+                                        is_default_constructible_v<Deleter>>;
 
     using pointer = typename PointerTypeDeductionHelper<Type, Deleter>::type;
 
@@ -80,7 +84,7 @@ public:
 
     template <typename OtherDeleter>
     unique_ptr_impl(pointer ptr, OtherDeleter&& deleter)
-        : m_ptr{ptr}, m_deleter{forward<OtherDeleter>(deleter)}
+        : m_ptr{ptr}, m_deleter{ohmy::forward<OtherDeleter>(deleter)}
     {
     }
 
@@ -103,7 +107,7 @@ public:
 
 private:
     pointer m_ptr;
-    Deleter m_deleter;
+    [[no_unique_address]] Deleter m_deleter;
 };
 } // namespace detail
 
@@ -157,7 +161,7 @@ public:
     }
 
     unique_ptr(pointer ptr, remove_reference_t<deleter_type>&& deleter) noexcept
-        : m_impl{move(ptr), move(deleter)}
+        : m_impl{ohmy::move(ptr), ohmy::move(deleter)}
     {
 
         static_assert(not is_reference_v<deleter_type>,
@@ -170,7 +174,7 @@ public:
     }
 
     unique_ptr(unique_ptr&& up) noexcept
-        : m_impl{up.release(), forward<deleter_type>(up.get_deleter())}
+        : m_impl{up.release(), ohmy::forward<deleter_type>(up.get_deleter())}
     {
     }
 
@@ -181,7 +185,7 @@ public:
             typename conditional<is_reference_v<Deleter>, is_same<E, Deleter>,
                                  is_convertible<E, Deleter>>::type>>
     unique_ptr(unique_ptr<U, E>&& up) noexcept
-        : m_impl{up.release(), forward<E>(up.get_deleter())}
+        : m_impl{up.release(), ohmy::forward<E>(up.get_deleter())}
     {
     }
 
@@ -198,7 +202,7 @@ public:
     unique_ptr& operator=(unique_ptr&& up) noexcept
     {
         reset(up.release());
-        get_deleter() = forward<deleter_type>(up.get_deleter());
+        get_deleter() = ohmy::forward<deleter_type>(up.get_deleter());
         return *this;
     }
 
@@ -208,7 +212,7 @@ public:
     operator=(unique_ptr<U, E> up) noexcept
     {
         reset(up.release());
-        get_deleter() = forward<E>(up.get_deleter());
+        get_deleter() = ohmy::forward<E>(up.get_deleter());
         return *this;
     }
 
@@ -220,7 +224,7 @@ public:
 
     add_lvalue_reference_t<element_type> operator*() const
     {
-        *get();
+        return *get();
     }
 
     pointer operator->() const noexcept
@@ -251,30 +255,164 @@ public:
     pointer release() noexcept
     {
         pointer p = get();
-        m_impl.m_ptr() = pointer{};
+        m_impl.get_ptr() = pointer{};
+        return p;
+    }
+
+    void reset(pointer p = pointer{}) noexcept
+    {
+        ohmy::swap(m_impl.get_ptr(), p);
+        if (p != pointer{})
+        {
+            get_deleter()(p);
+        }
+    }
+
+    void swap(unique_ptr& up) noexcept
+    {
+        ohmy::swap(m_impl, up.m_impl);
+    }
+
+    unique_ptr(const unique_ptr&) = delete;
+    unique_ptr& operator=(const unique_ptr&) = delete;
+};
+
+template <typename Type, typename Deleter>
+class unique_ptr<Type[], Deleter>
+{
+    template <typename U>
+    using DeleterConstraint =
+        typename detail::unique_ptr_impl<Type, U>::DeleterConstraint::type;
+
+    detail::unique_ptr_impl<Type, Deleter> m_impl;
+
+public:
+    using pointer = typename detail::unique_ptr_impl<Type, Deleter>::pointer;
+    using element_type = Type;
+    using deleter_type = Deleter;
+
+    template <typename U = Deleter, typename = DeleterConstraint<U>>
+    constexpr unique_ptr() noexcept : m_impl{}
+    {
+    }
+
+    template <typename U = Deleter, typename = DeleterConstraint<U>>
+    explicit unique_ptr(pointer ptr) noexcept : m_impl{ptr}
+    {
+    }
+
+    unique_ptr(pointer ptr, conditional_t<is_reference_v<deleter_type>,
+                                          deleter_type, const deleter_type&>
+                                deleter) noexcept
+        : m_impl{ptr, deleter}
+    {
+    }
+
+    unique_ptr(pointer ptr, remove_reference_t<deleter_type>&& deleter) noexcept
+        : m_impl{ohmy::move(ptr), ohmy::move(deleter)}
+    {
+        static_assert(not is_reference_v<deleter_type>,
+                      "rvalue deleter bound to reference");
+    }
+
+    template <typename U = Deleter, typename = DeleterConstraint<U>>
+    constexpr unique_ptr(nullptr_t) noexcept : unique_ptr()
+    {
+    }
+
+    unique_ptr(unique_ptr&& up) noexcept
+        : m_impl{up.release(), ohmy::forward<deleter_type>(up.get_deleter())}
+    {
+    }
+
+    ~unique_ptr() noexcept
+    {
+        auto& ptr = m_impl.get_ptr();
+        if (ptr != nullptr)
+        {
+            get_deleter()(ptr);
+            ptr = pointer{};
+        }
+    }
+
+    unique_ptr& operator=(unique_ptr&& up) noexcept
+    {
+        reset(up.release());
+        get_deleter() = ohmy::forward<deleter_type>(up.get_deleter());
+        return *this;
+    }
+
+    unique_ptr& operator=(nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    add_lvalue_reference_t<element_type> operator[](size_t index) const
+    {
+        return get()[index];
+    }
+
+    pointer get() const noexcept
+    {
+        return m_impl.get_ptr();
+    }
+
+    deleter_type& get_deleter() noexcept
+    {
+        return m_impl.get_deleter();
+    }
+
+    const deleter_type& get_deleter() const noexcept
+    {
+        return m_impl.get_deleter();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return (get() != pointer{});
+    }
+
+    pointer release() noexcept
+    {
+        pointer p = get();
+        m_impl.get_ptr() = pointer{};
         return p;
     }
 
     void reset(pointer p = pointer{}) noexcept
     {
-        using ohmy::swap;
-        swap(m_impl.get_ptr(), p);
+        ohmy::swap(m_impl.get_ptr(), p);
         if (p != pointer{})
         {
             get_deleter()(p);
         }
     }
 
+    void reset(nullptr_t) noexcept
+    {
+        reset(pointer{});
+    }
+
     void swap(unique_ptr& up) noexcept
     {
-        using ohmy::swap;
-        swap(m_impl, up.m_impl);
+        ohmy::swap(m_impl, up.m_impl);
     }
 
     unique_ptr(const unique_ptr&) = delete;
     unique_ptr& operator=(const unique_ptr&) = delete;
 };
 
+// unique_ptr is a pointer and a deleter; moving it to a new address and
+// dropping the source is a byte copy whenever both of those are.
+template <typename Type, typename Deleter>
+struct is_trivially_relocatable<unique_ptr<Type, Deleter>>
+    : detail::operator_and<
+          is_trivially_relocatable<typename unique_ptr<Type, Deleter>::pointer>,
+          is_trivially_relocatable<Deleter>>
+{
+};
+
 template <typename Type>
 inline constexpr Type* addressof(Type& r) noexcept
 {
@@ -284,5 +422,857 @@ inline constexpr Type* addressof(Type& r) noexcept
 template <typename Type>
 const Type* addressof(const Type&&) = delete;
 
+template <typename Type, typename... ArgumentTypes>
+Type* construct_at(Type* location, ArgumentTypes&&... arguments)
+{
+    return ::new (static_cast<void*>(location))
+        Type(ohmy::forward<ArgumentTypes>(arguments)...);
+}
+
+template <typename Type>
+void destroy_at(Type* location) noexcept
+{
+    if constexpr (not is_trivially_destructible_v<Type>)
+    {
+        location->~Type();
+    }
+}
+
+template <typename Type>
+void destroy(Type* first, Type* last) noexcept
+{
+    if constexpr (not is_trivially_destructible_v<Type>)
+    {
+        for (; first != last; ++first)
+        {
+            ohmy::destroy_at(first);
+        }
+    }
+}
+
+template <typename InputIterator, typename Type>
+Type* uninitialized_copy(InputIterator first, InputIterator last,
+                         Type* destination)
+{
+    using source_type = remove_cv_t<remove_reference_t<decltype(*first)>>;
+    if constexpr (is_trivially_copiable_v<Type> and
+                  is_pointer_v<InputIterator> and is_same_v<source_type, Type>)
+    {
+        const auto count = static_cast<size_t>(last - first);
+        if (count != 0)
+        {
+            __builtin_memcpy(static_cast<void*>(destination),
+                             static_cast<const void*>(first),
+                             count * sizeof(Type));
+        }
+        return destination + count;
+    }
+    else
+    {
+        Type* current = destination;
+        try
+        {
+            for (; first != last; ++first, ++current)
+            {
+                ohmy::construct_at(current, *first);
+            }
+        }
+        catch (...)
+        {
+            ohmy::destroy(destination, current);
+            throw;
+        }
+        return current;
+    }
+}
+
+template <typename Type>
+Type* uninitialized_fill_n(Type* destination, size_t count, const Type& value)
+{
+    Type* current = destination;
+    try
+    {
+        for (; count > 0; --count, ++current)
+        {
+            ohmy::construct_at(current, value);
+        }
+    }
+    catch (...)
+    {
+        ohmy::destroy(destination, current);
+        throw;
+    }
+    return current;
+}
+
+template <typename Type>
+Type* uninitialized_value_construct_n(Type* destination, size_t count)
+{
+    if constexpr (is_arithmetic_v<Type> or is_pointer_v<Type>)
+    {
+        if (count != 0)
+        {
+            __builtin_memset(static_cast<void*>(destination), 0,
+                             count * sizeof(Type));
+        }
+        return destination + count;
+    }
+    else
+    {
+        Type* current = destination;
+        try
+        {
+            for (; count > 0; --count, ++current)
+            {
+                ohmy::construct_at(current);
+            }
+        }
+        catch (...)
+        {
+            ohmy::destroy(destination, current);
+            throw;
+        }
+        return current;
+    }
+}
+
+// Default-initializes the objects, which leaves trivial types uninitialized.
+template <typename Type>
+Type* uninitialized_default_construct_n(Type* destination, size_t count)
+{
+    if constexpr (is_trivial_v<Type>)
+    {
+        return destination + count;
+    }
+    else
+    {
+        Type* current = destination;
+        try
+        {
+            for (; count > 0; --count, ++current)
+            {
+                ::new (static_cast<void*>(current)) Type;
+            }
+        }
+        catch (...)
+        {
+            ohmy::destroy(destination, current);
+            throw;
+        }
+        return current;
+    }
+}
+
+namespace detail
+{
+// Builds copies of [first, last) at destination, moving only when that cannot
+// throw. The source range is left untouched, so on failure the caller still
+// owns every original element.
+template <typename Type>
+Type* uninitialized_move_if_noexcept(Type* first, Type* last,
+                                     Type* destination)
+{
+    Type* current = destination;
+    try
+    {
+        for (; first != last; ++first, ++current)
+        {
+            ohmy::construct_at(current, ohmy::move_if_noexcept(*first));
+        }
+    }
+    catch (...)
+    {
+        ohmy::destroy(destination, current);
+        throw;
+    }
+    return current;
+}
+} // namespace detail
+
+namespace detail
+{
+// Keeps a temporary in raw storage so that it can be relocated into a
+// container without its destructor running a second time.
+template <typename Type>
+class relocation_buffer
+{
+public:
+    template <typename... ArgumentTypes>
+    explicit relocation_buffer(ArgumentTypes&&... arguments)
+    {
+        ohmy::construct_at(get(),
+                           ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    ~relocation_buffer()
+    {
+        if (m_owns_value)
+        {
+            ohmy::destroy_at(get());
+        }
+    }
+
+    relocation_buffer(const relocation_buffer&) = delete;
+    relocation_buffer& operator=(const relocation_buffer&) = delete;
+
+    Type* get() noexcept
+    {
+        return reinterpret_cast<Type*>(m_storage);
+    }
+
+    // The caller becomes responsible for ending the lifetime of the value.
+    Type* release() noexcept
+    {
+        m_owns_value = false;
+        return get();
+    }
+
+private:
+    alignas(Type) unsigned char m_storage[sizeof(Type)];
+    bool m_owns_value = true;
+};
+} // namespace detail
+
+// Moves the object at source into the uninitialized storage at destination
+// and ends the lifetime of the source object.
+template <typename Type>
+Type* relocate_at(Type* source,
+                  Type* destination) noexcept(is_nothrow_relocatable_v<Type>)
+{
+    if constexpr (is_trivially_relocatable_v<Type>)
+    {
+        __builtin_memcpy(static_cast<void*>(destination),
+                         static_cast<const void*>(source), sizeof(Type));
+        return destination;
+    }
+    else
+    {
+        Type* result =
+            ohmy::construct_at(destination, ohmy::move_if_noexcept(*source));
+        ohmy::destroy_at(source);
+        return result;
+    }
+}
+
+// Relocates [first, last) into the uninitialized storage starting at
+// destination and returns the end of the destination range. Trivially
+// relocatable types are moved with a single memmove, so the ranges may
+// overlap; other types are relocated element by element and the ranges must
+// be disjoint. If a constructor throws, the elements built so far are
+// destroyed and the source range is left intact.
+template <typename Type>
+Type* uninitialized_relocate(
+    Type* first, Type* last,
+    Type* destination) noexcept(is_nothrow_relocatable_v<Type>)
+{
+    if constexpr (is_trivially_relocatable_v<Type>)
+    {
+        const auto count = static_cast<size_t>(last - first);
+        if (count != 0)
+        {
+            __builtin_memmove(static_cast<void*>(destination),
+                              static_cast<const void*>(first),
+                              count * sizeof(Type));
+        }
+        return destination + count;
+    }
+    else if constexpr (is_nothrow_move_constructible_v<Type>)
+    {
+        for (; first != last; ++first, ++destination)
+        {
+            ohmy::relocate_at(first, destination);
+        }
+        return destination;
+    }
+    else
+    {
+        Type* result =
+            detail::uninitialized_move_if_noexcept(first, last, destination);
+        ohmy::destroy(first, last);
+        return result;
+    }
+}
+
+template <typename Type>
+Type* uninitialized_relocate_n(
+    Type* first, size_t count,
+    Type* destination) noexcept(is_nothrow_relocatable_v<Type>)
+{
+    return ohmy::uninitialized_relocate(first, first + count, destination);
+}
+
+namespace detail
+{
+// aligned_alloc wants the size to be a multiple of the alignment.
+inline void* aligned_malloc(size_t bytes, size_t alignment) noexcept
+{
+    size_t rounded;
+    if (__builtin_add_overflow(bytes, alignment - 1, &rounded))
+    {
+        return nullptr;
+    }
+    return std::aligned_alloc(alignment, rounded & ~(alignment - 1));
+}
+
+template <size_t Alignment>
+inline constexpr bool is_valid_alignment_v =
+    Alignment != 0 and (Alignment & (Alignment - 1)) == 0;
+} // namespace detail
+
+// The default allocator of the library's containers. Storage comes from
+// malloc rather than operator new so that a buffer of trivially relocatable
+// elements can be grown with realloc, which may extend it in place (glibc
+// remaps large blocks with mremap instead of copying them).
+//
+// Containers accept any type with value_type, allocate(count) and
+// deallocate(pointer, count); reallocate(pointer, old_count, new_count) is
+// optional and only ever used for trivially relocatable elements.
+template <typename Type>
+class allocator
+{
+    static constexpr bool over_aligned =
+        alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+public:
+    using value_type = Type;
+
+    constexpr allocator() noexcept = default;
+
+    template <typename Other>
+    constexpr allocator(const allocator<Other>&) noexcept
+    {
+    }
+
+    Type* allocate(size_t count)
+    {
+        const size_t bytes = byte_count(count);
+        void* result;
+        if constexpr (over_aligned)
+        {
+            result = detail::aligned_malloc(bytes, alignof(Type));
+        }
+        else
+        {
+            result = std::malloc(bytes);
+        }
+
+        if (result == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+        return static_cast<Type*>(result);
+    }
+
+    void deallocate(Type* ptr, size_t) noexcept
+    {
+        std::free(ptr);
+    }
+
+    template <bool Enable = not over_aligned, typename = enable_if_t<Enable>>
+    Type* reallocate(Type* ptr, size_t, size_t new_count)
+    {
+        void* result = std::realloc(static_cast<void*>(ptr),
+                                    byte_count(new_count));
+        if (result == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+        return static_cast<Type*>(result);
+    }
+
+    template <typename Other>
+    constexpr bool operator==(const allocator<Other>&) const noexcept
+    {
+        return true;
+    }
+
+    template <typename Other>
+    constexpr bool operator!=(const allocator<Other>&) const noexcept
+    {
+        return false;
+    }
+
+private:
+    static size_t byte_count(size_t count)
+    {
+        size_t bytes;
+        if (__builtin_mul_overflow(count, sizeof(Type), &bytes))
+        {
+            throw std::bad_alloc{};
+        }
+        return bytes != 0 ? bytes : 1;
+    }
+};
+
+// Allocator whose blocks are aligned to at least Alignment bytes, for SIMD
+// loads and for data that has to start on a cache line. There is no
+// reallocate, since realloc does not preserve the alignment.
+template <typename Type, size_t Alignment>
+class aligned_allocator
+{
+public:
+    static_assert(detail::is_valid_alignment_v<Alignment>,
+                  "alignment must be a power of two");
+
+    using value_type = Type;
+
+    static constexpr size_t alignment =
+        Alignment > alignof(Type) ? Alignment : alignof(Type);
+
+    template <typename Other>
+    struct rebind
+    {
+        using other = aligned_allocator<Other, Alignment>;
+    };
+
+    constexpr aligned_allocator() noexcept = default;
+
+    template <typename Other>
+    constexpr aligned_allocator(
+        const aligned_allocator<Other, Alignment>&) noexcept
+    {
+    }
+
+    Type* allocate(size_t count)
+    {
+        size_t bytes;
+        if (__builtin_mul_overflow(count, sizeof(Type), &bytes))
+        {
+            throw std::bad_alloc{};
+        }
+
+        void* result = detail::aligned_malloc(bytes != 0 ? bytes : 1,
+                                              alignment);
+        if (result == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+        return static_cast<Type*>(result);
+    }
+
+    void deallocate(Type* ptr, size_t) noexcept
+    {
+        std::free(ptr);
+    }
+
+    template <typename Other>
+    constexpr bool operator==(
+        const aligned_allocator<Other, Alignment>&) const noexcept
+    {
+        return true;
+    }
+
+    template <typename Other>
+    constexpr bool operator!=(
+        const aligned_allocator<Other, Alignment>&) const noexcept
+    {
+        return false;
+    }
+};
+
+// Deleter for single objects created by make_unique_aligned.
+template <size_t Alignment>
+struct aligned_delete
+{
+    static_assert(detail::is_valid_alignment_v<Alignment>,
+                  "alignment must be a power of two");
+
+    constexpr aligned_delete() noexcept = default;
+
+    template <typename Type>
+    void operator()(Type* ptr) const noexcept
+    {
+        static_assert(sizeof(Type) > 0,
+                      "cannot delete pointer to incomplete type");
+        ohmy::destroy_at(ptr);
+        std::free(static_cast<void*>(const_cast<remove_cv_t<Type>*>(ptr)));
+    }
+};
+
+// Creates an object on a block aligned to at least Alignment bytes, for
+// instance a per-core counter that must not share its cache line.
+template <typename Type, size_t Alignment, typename... ArgumentTypes>
+enable_if_t<not is_array_v<Type>, unique_ptr<Type, aligned_delete<Alignment>>>
+make_unique_aligned(ArgumentTypes&&... arguments)
+{
+    aligned_allocator<Type, Alignment> alloc;
+    Type* storage = alloc.allocate(1);
+    try
+    {
+        ohmy::construct_at(storage, ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+    catch (...)
+    {
+        alloc.deallocate(storage, 1);
+        throw;
+    }
+    return unique_ptr<Type, aligned_delete<Alignment>>(storage);
+}
+
+namespace detail
+{
+template <typename Allocator, typename = void>
+inline constexpr bool has_reallocate_v = false;
+
+template <typename Allocator>
+inline constexpr bool has_reallocate_v<
+    Allocator,
+    void_t<decltype(declval<Allocator&>().reallocate(
+        declval<typename Allocator::value_type*>(), size_t{}, size_t{}))>> =
+    true;
+} // namespace detail
+
+template <typename Type>
+class sized_delete;
+
+namespace detail
+{
+template <typename Type>
+struct make_unique_selector
+{
+    using single_object = unique_ptr<Type>;
+};
+
+template <typename Type>
+struct make_unique_selector<Type[]>
+{
+    using array = unique_ptr<Type[]>;
+    using sized_array = unique_ptr<Type[], sized_delete<Type[]>>;
+};
+
+template <typename Type, size_t Size>
+struct make_unique_selector<Type[Size]>
+{
+    struct invalid_type
+    {
+    };
+};
+
+template <typename Allocator, typename Other>
+struct rebind_first_argument
+{
+};
+
+template <template <typename, typename...> class Template, typename Type,
+          typename... Rest, typename Other>
+struct rebind_first_argument<Template<Type, Rest...>, Other>
+{
+    using type = Template<Other, Rest...>;
+};
+
+// Allocator::rebind<Other>::other if present, otherwise the allocator
+// template instantiated with Other as its first argument.
+template <typename Allocator, typename Other, typename = void>
+struct rebind_alloc : rebind_first_argument<Allocator, Other>
+{
+};
+
+template <typename Allocator, typename Other>
+struct rebind_alloc<
+    Allocator, Other,
+    void_t<typename Allocator::template rebind<Other>::other>>
+{
+    using type = typename Allocator::template rebind<Other>::other;
+};
+
+template <typename Allocator, typename Other>
+using rebind_alloc_t = typename rebind_alloc<Allocator, Other>::type;
+} // namespace detail
+
+template <typename Type, typename... ArgumentTypes>
+typename detail::make_unique_selector<Type>::single_object
+make_unique(ArgumentTypes&&... arguments)
+{
+    return unique_ptr<Type>(
+        new Type(ohmy::forward<ArgumentTypes>(arguments)...));
+}
+
+// The elements are value-initialized, i.e. zeroed for trivial types.
+template <typename Type>
+typename detail::make_unique_selector<Type>::array make_unique(size_t count)
+{
+    return unique_ptr<Type>(new remove_extent_t<Type>[count]());
+}
+
+template <typename Type, typename... ArgumentTypes>
+typename detail::make_unique_selector<Type>::invalid_type
+make_unique(ArgumentTypes&&...) = delete;
+
+// Default-initializes the object, which leaves trivial types uninitialized.
+// Meant for buffers that are about to be overwritten anyway.
+template <typename Type>
+typename detail::make_unique_selector<Type>::single_object
+make_unique_for_overwrite()
+{
+    return unique_ptr<Type>(new Type);
+}
+
+template <typename Type>
+typename detail::make_unique_selector<Type>::array
+make_unique_for_overwrite(size_t count)
+{
+    return unique_ptr<Type>(new remove_extent_t<Type>[count]);
+}
+
+template <typename Type, typename... ArgumentTypes>
+typename detail::make_unique_selector<Type>::invalid_type
+make_unique_for_overwrite(ArgumentTypes&&...) = delete;
+
+namespace detail
+{
+template <typename Type>
+Type* allocate_for_sized_delete(size_t count)
+{
+    size_t bytes;
+    if (__builtin_mul_overflow(count, sizeof(Type), &bytes))
+    {
+        throw std::bad_array_new_length{};
+    }
+
+    if constexpr (alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        return static_cast<Type*>(
+            ::operator new(bytes, std::align_val_t{alignof(Type)}));
+    }
+    else
+    {
+        return static_cast<Type*>(::operator new(bytes));
+    }
+}
+
+template <typename Type>
+void deallocate_for_sized_delete(Type* ptr, size_t count) noexcept
+{
+    if constexpr (alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        ::operator delete(static_cast<void*>(ptr), count * sizeof(Type),
+                          std::align_val_t{alignof(Type)});
+    }
+    else
+    {
+        ::operator delete(static_cast<void*>(ptr), count * sizeof(Type));
+    }
+}
+} // namespace detail
+
+// Deleter for arrays that remembers the element count, so the storage can
+// be returned with sized operator delete instead of relying on an array
+// cookie. Produced by make_unique_sized and make_unique_sized_for_overwrite.
+template <typename Type>
+class sized_delete<Type[]>
+{
+public:
+    constexpr sized_delete() noexcept = default;
+
+    constexpr explicit sized_delete(size_t count) noexcept : m_count{count}
+    {
+    }
+
+    void operator()(Type* ptr) const noexcept
+    {
+        static_assert(sizeof(Type) > 0,
+                      "cannot delete pointer to incomplete type");
+        ohmy::destroy(ptr, ptr + m_count);
+        detail::deallocate_for_sized_delete(ptr, m_count);
+    }
+
+    size_t size() const noexcept
+    {
+        return m_count;
+    }
+
+private:
+    size_t m_count = 0;
+};
+
+namespace detail
+{
+template <typename Type, typename Initializer>
+unique_ptr<Type[], sized_delete<Type[]>> make_unique_sized(size_t count,
+                                                           Initializer init)
+{
+    Type* storage = allocate_for_sized_delete<Type>(count);
+    try
+    {
+        init(storage, count);
+    }
+    catch (...)
+    {
+        deallocate_for_sized_delete(storage, count);
+        throw;
+    }
+    return unique_ptr<Type[], sized_delete<Type[]>>(
+        storage, sized_delete<Type[]>{count});
+}
+} // namespace detail
+
+template <typename Type>
+typename detail::make_unique_selector<Type>::sized_array
+make_unique_sized(size_t count)
+{
+    using element_type = remove_extent_t<Type>;
+    return detail::make_unique_sized<element_type>(
+        count, [](element_type* storage, size_t n) {
+            ohmy::uninitialized_value_construct_n(storage, n);
+        });
+}
+
+template <typename Type>
+typename detail::make_unique_selector<Type>::sized_array
+make_unique_sized_for_overwrite(size_t count)
+{
+    using element_type = remove_extent_t<Type>;
+    return detail::make_unique_sized<element_type>(
+        count, [](element_type* storage, size_t n) {
+            ohmy::uninitialized_default_construct_n(storage, n);
+        });
+}
+
+// Deleter that destroys a single object and hands its storage back to the
+// allocator it came from. The allocator is stored in the deleter, so a
+// stateless allocator adds nothing to the size of the unique_ptr.
+template <typename Allocator>
+class allocator_delete
+{
+public:
+    using value_type = typename Allocator::value_type;
+
+    explicit allocator_delete(const Allocator& alloc) : m_allocator{alloc}
+    {
+    }
+
+    void operator()(value_type* ptr)
+    {
+        ohmy::destroy_at(ptr);
+        m_allocator.deallocate(ptr, 1);
+    }
+
+    const Allocator& get_allocator() const noexcept
+    {
+        return m_allocator;
+    }
+
+private:
+    [[no_unique_address]] Allocator m_allocator;
+};
+
+// Array counterpart of allocator_delete. It remembers the element count so
+// that the allocator receives the size of the block on deallocation.
+template <typename Allocator>
+class array_allocator_delete
+{
+public:
+    using value_type = typename Allocator::value_type;
+
+    array_allocator_delete(const Allocator& alloc, size_t count)
+        : m_allocator{alloc}, m_count{count}
+    {
+    }
+
+    void operator()(value_type* ptr)
+    {
+        ohmy::destroy(ptr, ptr + m_count);
+        m_allocator.deallocate(ptr, m_count);
+    }
+
+    size_t size() const noexcept
+    {
+        return m_count;
+    }
+
+    const Allocator& get_allocator() const noexcept
+    {
+        return m_allocator;
+    }
+
+private:
+    [[no_unique_address]] Allocator m_allocator;
+    size_t m_count;
+};
+
+namespace detail
+{
+template <typename Type, typename Allocator>
+struct allocate_unique_selector
+{
+    using allocator_type = rebind_alloc_t<Allocator, Type>;
+    using single_object = unique_ptr<Type, allocator_delete<allocator_type>>;
+};
+
+template <typename Type, typename Allocator>
+struct allocate_unique_selector<Type[], Allocator>
+{
+    using allocator_type = rebind_alloc_t<Allocator, Type>;
+    using array = unique_ptr<Type[], array_allocator_delete<allocator_type>>;
+};
+
+template <typename Type, typename Allocator, typename Initializer>
+auto allocate_unique_array(const Allocator& alloc, size_t count,
+                           Initializer init)
+{
+    using allocator_type = rebind_alloc_t<Allocator, Type>;
+    using deleter = array_allocator_delete<allocator_type>;
+
+    allocator_type rebound(alloc);
+    Type* storage = rebound.allocate(count);
+    try
+    {
+        init(storage, count);
+    }
+    catch (...)
+    {
+        rebound.deallocate(storage, count);
+        throw;
+    }
+    return unique_ptr<Type[], deleter>(storage, deleter{rebound, count});
+}
+} // namespace detail
+
+template <typename Type, typename Allocator, typename... ArgumentTypes>
+typename detail::allocate_unique_selector<Type, Allocator>::single_object
+allocate_unique(const Allocator& alloc, ArgumentTypes&&... arguments)
+{
+    using allocator_type =
+        typename detail::allocate_unique_selector<Type,
+                                                  Allocator>::allocator_type;
+    using deleter = allocator_delete<allocator_type>;
+
+    allocator_type rebound(alloc);
+    Type* storage = rebound.allocate(1);
+    try
+    {
+        ohmy::construct_at(storage,
+                           ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+    catch (...)
+    {
+        rebound.deallocate(storage, 1);
+        throw;
+    }
+    return unique_ptr<Type, deleter>(storage, deleter{rebound});
+}
+
+template <typename Type, typename Allocator>
+typename detail::allocate_unique_selector<Type, Allocator>::array
+allocate_unique(const Allocator& alloc, size_t count)
+{
+    using element_type = remove_extent_t<Type>;
+    return detail::allocate_unique_array<element_type>(
+        alloc, count, [](element_type* storage, size_t n) {
+            ohmy::uninitialized_value_construct_n(storage, n);
+        });
+}
+
+template <typename Type, typename Allocator>
+typename detail::allocate_unique_selector<Type, Allocator>::array
+allocate_unique_for_overwrite(const Allocator& alloc, size_t count)
+{
+    using element_type = remove_extent_t<Type>;
+    return detail::allocate_unique_array<element_type>(
+        alloc, count, [](element_type* storage, size_t n) {
+            ohmy::uninitialized_default_construct_n(storage, n);
+        });
+}
+
 } // namespace ohmy
 #endif // MY_MEMORY_HPP
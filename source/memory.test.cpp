@@ -1,3 +1,305 @@
 #include <catch/catch.hpp>
 
 #include "memory.hpp"
+
+#include <cstdint>
+
+namespace
+{
+struct Tracked
+{
+    static int live;
+    static int moves;
+
+    explicit Tracked(int v) : value{v}
+    {
+        ++live;
+    }
+    Tracked(Tracked&& other) noexcept : value{other.value}
+    {
+        other.value = -1;
+        ++live;
+        ++moves;
+    }
+    ~Tracked()
+    {
+        --live;
+    }
+
+    int value;
+};
+
+int Tracked::live = 0;
+int Tracked::moves = 0;
+
+struct StatefulDeleter
+{
+    StatefulDeleter() = default;
+    StatefulDeleter(const StatefulDeleter&)
+    {
+    }
+
+    void operator()(int* p) const
+    {
+        delete p;
+    }
+};
+} // namespace
+
+static_assert(ohmy::is_trivially_relocatable_v<ohmy::unique_ptr<int>>);
+static_assert(ohmy::is_trivially_relocatable_v<ohmy::unique_ptr<Tracked>>);
+static_assert(
+    not ohmy::is_trivially_relocatable_v<ohmy::unique_ptr<int, StatefulDeleter>>);
+static_assert(not ohmy::is_trivially_relocatable_v<Tracked>);
+
+TEST_CASE("unique_ptr basic ownership")
+{
+    ohmy::unique_ptr<int> p{new int{42}};
+    REQUIRE(static_cast<bool>(p));
+    REQUIRE(*p == 42);
+
+    ohmy::unique_ptr<int> q{ohmy::move(p)};
+    REQUIRE_FALSE(static_cast<bool>(p));
+    REQUIRE(*q == 42);
+
+    int* raw = q.release();
+    REQUIRE_FALSE(static_cast<bool>(q));
+    delete raw;
+}
+
+TEST_CASE("uninitialized_relocate")
+{
+    SECTION("trivially relocatable unique_ptrs are moved bytewise")
+    {
+        alignas(ohmy::unique_ptr<int>) unsigned char
+            source_storage[3 * sizeof(ohmy::unique_ptr<int>)];
+        alignas(ohmy::unique_ptr<int>) unsigned char
+            destination_storage[3 * sizeof(ohmy::unique_ptr<int>)];
+        auto* source = reinterpret_cast<ohmy::unique_ptr<int>*>(source_storage);
+        auto* destination =
+            reinterpret_cast<ohmy::unique_ptr<int>*>(destination_storage);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            ohmy::construct_at(source + i, new int{i});
+        }
+
+        auto* end = ohmy::uninitialized_relocate(source, source + 3, destination);
+
+        REQUIRE(end == destination + 3);
+        for (int i = 0; i < 3; ++i)
+        {
+            REQUIRE(*destination[i] == i);
+        }
+        ohmy::destroy(destination, end);
+    }
+
+    SECTION("other types are move-constructed and the source destroyed")
+    {
+        Tracked::live = 0;
+        Tracked::moves = 0;
+
+        alignas(Tracked) unsigned char source_storage[2 * sizeof(Tracked)];
+        alignas(Tracked) unsigned char destination_storage[2 * sizeof(Tracked)];
+        auto* source = reinterpret_cast<Tracked*>(source_storage);
+        auto* destination = reinterpret_cast<Tracked*>(destination_storage);
+
+        ohmy::construct_at(source, 7);
+        ohmy::construct_at(source + 1, 8);
+
+        auto* end = ohmy::uninitialized_relocate_n(source, 2, destination);
+
+        REQUIRE(end == destination + 2);
+        REQUIRE(destination[0].value == 7);
+        REQUIRE(destination[1].value == 8);
+        REQUIRE(Tracked::live == 2);
+        REQUIRE(Tracked::moves == 2);
+        ohmy::destroy(destination, end);
+        REQUIRE(Tracked::live == 0);
+    }
+
+    SECTION("relocate_at moves a single object")
+    {
+        alignas(ohmy::unique_ptr<int>) unsigned char
+            source_storage[sizeof(ohmy::unique_ptr<int>)];
+        alignas(ohmy::unique_ptr<int>) unsigned char
+            destination_storage[sizeof(ohmy::unique_ptr<int>)];
+        auto* source = ohmy::construct_at(
+            reinterpret_cast<ohmy::unique_ptr<int>*>(source_storage), new int{5});
+
+        auto* destination = ohmy::relocate_at(
+            source, reinterpret_cast<ohmy::unique_ptr<int>*>(destination_storage));
+
+        REQUIRE(**destination == 5);
+        ohmy::destroy_at(destination);
+    }
+}
+
+namespace
+{
+struct Allocations
+{
+    int allocations = 0;
+    int deallocations = 0;
+    std::size_t last_deallocated_count = 0;
+};
+
+template <typename Type>
+struct recording_allocator
+{
+    using value_type = Type;
+
+    explicit recording_allocator(Allocations& record) : record{&record}
+    {
+    }
+
+    template <typename Other>
+    recording_allocator(const recording_allocator<Other>& other)
+        : record{other.record}
+    {
+    }
+
+    Type* allocate(std::size_t count)
+    {
+        ++record->allocations;
+        return static_cast<Type*>(::operator new(count * sizeof(Type)));
+    }
+
+    void deallocate(Type* ptr, std::size_t count)
+    {
+        ++record->deallocations;
+        record->last_deallocated_count = count;
+        ::operator delete(ptr);
+    }
+
+    Allocations* record;
+};
+} // namespace
+
+static_assert(sizeof(ohmy::unique_ptr<int[]>) == sizeof(int*));
+static_assert(sizeof(decltype(ohmy::allocate_unique<int>(
+                  ohmy::allocator<int>{}))) == sizeof(int*));
+static_assert(ohmy::is_trivially_relocatable_v<
+              ohmy::unique_ptr<int[], ohmy::sized_delete<int[]>>>);
+
+TEST_CASE("make_unique")
+{
+    SECTION("single objects are constructed from the arguments")
+    {
+        auto p = ohmy::make_unique<std::pair<int, char>>(1, 'x');
+        REQUIRE(p->first == 1);
+        REQUIRE(p->second == 'x');
+    }
+
+    SECTION("arrays are value-initialized")
+    {
+        auto a = ohmy::make_unique<int[]>(16);
+        for (int i = 0; i < 16; ++i)
+        {
+            REQUIRE(a[i] == 0);
+        }
+        a[3] = 7;
+        REQUIRE(a.get()[3] == 7);
+    }
+
+    SECTION("for_overwrite allocations can be written through")
+    {
+        auto a = ohmy::make_unique_for_overwrite<unsigned char[]>(4096);
+        a[4095] = 1;
+        REQUIRE(a[4095] == 1);
+
+        auto p = ohmy::make_unique_for_overwrite<int>();
+        *p = 3;
+        REQUIRE(*p == 3);
+    }
+
+    SECTION("sized arrays remember their length")
+    {
+        auto a = ohmy::make_unique_sized<int[]>(10);
+        REQUIRE(a.get_deleter().size() == 10u);
+        REQUIRE(a[9] == 0);
+
+        {
+            auto t = ohmy::make_unique_sized_for_overwrite<
+                ohmy::unique_ptr<int>[]>(3);
+            t[1].reset(new int{5});
+            REQUIRE(*t[1] == 5);
+        }
+
+        auto b = ohmy::make_unique_sized_for_overwrite<char[]>(1 << 20);
+        REQUIRE(b.get_deleter().size() == std::size_t{1} << 20);
+    }
+}
+
+TEST_CASE("allocate_unique")
+{
+    Allocations record;
+
+    SECTION("single object is returned to its allocator")
+    {
+        {
+            auto p = ohmy::allocate_unique<Tracked>(
+                recording_allocator<char>{record}, 11);
+            REQUIRE(p->value == 11);
+            REQUIRE(record.allocations == 1);
+        }
+        REQUIRE(record.deallocations == 1);
+        REQUIRE(record.last_deallocated_count == 1u);
+    }
+
+    SECTION("arrays are deallocated with their element count")
+    {
+        {
+            auto a = ohmy::allocate_unique<int[]>(
+                recording_allocator<int>{record}, 32);
+            REQUIRE(a.get_deleter().size() == 32u);
+            REQUIRE(a[31] == 0);
+        }
+        REQUIRE(record.deallocations == 1);
+        REQUIRE(record.last_deallocated_count == 32u);
+
+        {
+            auto a = ohmy::allocate_unique_for_overwrite<char[]>(
+                recording_allocator<char>{record}, 64);
+            a[63] = 'z';
+        }
+        REQUIRE(record.last_deallocated_count == 64u);
+    }
+}
+
+TEST_CASE("aligned allocation")
+{
+    SECTION("aligned_allocator honours the requested alignment")
+    {
+        ohmy::aligned_allocator<float, 64> alloc;
+        static_assert(alloc.alignment == 64u);
+
+        float* block = alloc.allocate(3);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(block) % 64 == 0u);
+        alloc.deallocate(block, 3);
+
+        ohmy::aligned_allocator<double, 64> rebound{alloc};
+        REQUIRE(rebound == alloc);
+        double* other = rebound.allocate(1);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(other) % 64 == 0u);
+        rebound.deallocate(other, 1);
+
+        ohmy::aligned_allocator<double, 4096> page;
+        double* paged = page.allocate(1);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(paged) % 4096 == 0u);
+        page.deallocate(paged, 1);
+    }
+
+    SECTION("make_unique_aligned destroys and frees through aligned_delete")
+    {
+        Tracked::live = 0;
+        {
+            auto p = ohmy::make_unique_aligned<Tracked, 256>(5);
+            static_assert(sizeof(p) == sizeof(Tracked*));
+            REQUIRE(reinterpret_cast<std::uintptr_t>(p.get()) % 256 == 0u);
+            REQUIRE(p->value == 5);
+            REQUIRE(Tracked::live == 1);
+        }
+        REQUIRE(Tracked::live == 0);
+    }
+}
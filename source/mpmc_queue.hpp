@@ -0,0 +1,215 @@
+#ifndef OHMY_MPMC_QUEUE_HPP
+#define OHMY_MPMC_QUEUE_HPP
+
+#include "c++config.hpp"
+#include "cache_padded.hpp"
+#include "memory.hpp"
+#include "spsc_queue.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <atomic>
+
+namespace ohmy
+{
+namespace detail
+{
+// A slot stores its element in place next to a sequence number that says
+// whose turn it is: position for the producer that will fill it on lap
+// position / capacity, and position + 1 for the consumer that will empty
+// it.
+template <typename Type>
+struct mpmc_slot
+{
+    Type* get() noexcept
+    {
+        return reinterpret_cast<Type*>(storage);
+    }
+
+    std::atomic<size_t> sequence;
+    alignas(Type) unsigned char storage[sizeof(Type)];
+};
+} // namespace detail
+
+// A bounded lock-free queue for any number of producers and consumers,
+// after Dmitry Vyukov's bounded MPMC queue. Producers and consumers each
+// claim a position with one compare-and-swap on their own index and then
+// synchronise only through the sequence number of the slot they claimed,
+// so a push and a pop never contend unless the ring is full or empty.
+// Elements live in the slots, so no node is allocated per element.
+//
+// Claimed slots must be completed, so moving an element in or out must not
+// throw. A throwing constructor is run before a slot is claimed.
+template <typename Type>
+class mpmc_queue
+{
+    static_assert(is_nothrow_move_constructible_v<Type> and
+                      is_nothrow_move_assignable_v<Type>,
+                  "mpmc_queue elements need nothrow moves");
+
+    using slot_type = detail::mpmc_slot<Type>;
+
+public:
+    using value_type = Type;
+
+    explicit mpmc_queue(size_t capacity)
+        : m_capacity{detail::ring_capacity(capacity)},
+          m_slots{allocator<slot_type>{}.allocate(m_capacity)}
+    {
+        for (size_t position = 0; position < m_capacity; ++position)
+        {
+            ohmy::construct_at(&m_slots[position].sequence, position);
+        }
+    }
+
+    ~mpmc_queue()
+    {
+        const size_t head = m_dequeue->load(std::memory_order_relaxed);
+        const size_t tail = m_enqueue->load(std::memory_order_relaxed);
+        for (size_t position = head; position != tail; ++position)
+        {
+            ohmy::destroy_at(slot(position).get());
+        }
+        allocator<slot_type>{}.deallocate(m_slots, m_capacity);
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    template <typename... ArgumentTypes>
+    bool try_emplace(ArgumentTypes&&... arguments) noexcept(
+        is_nothrow_constructible<Type, ArgumentTypes...>::value)
+    {
+        if constexpr (is_nothrow_constructible<Type, ArgumentTypes...>::value)
+        {
+            slot_type* target = claim_for_push();
+            if (target == nullptr)
+            {
+                return false;
+            }
+            ohmy::construct_at(target->get(),
+                               ohmy::forward<ArgumentTypes>(arguments)...);
+            publish(target);
+            return true;
+        }
+        else
+        {
+            return try_emplace(
+                Type(ohmy::forward<ArgumentTypes>(arguments)...));
+        }
+    }
+
+    bool try_push(const Type& value) noexcept(
+        is_nothrow_constructible<Type, const Type&>::value)
+    {
+        return try_emplace(value);
+    }
+
+    bool try_push(Type&& value) noexcept
+    {
+        return try_emplace(ohmy::move(value));
+    }
+
+    // Moves the oldest available element into destination.
+    bool try_pop(Type& destination) noexcept
+    {
+        size_t position = m_dequeue->load(std::memory_order_relaxed);
+        for (;;)
+        {
+            slot_type& source = slot(position);
+            const size_t sequence =
+                source.sequence.load(std::memory_order_acquire);
+            const auto lag =
+                static_cast<ptrdiff_t>(sequence - (position + 1));
+            if (lag == 0)
+            {
+                if (m_dequeue->compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed))
+                {
+                    destination = ohmy::move(*source.get());
+                    ohmy::destroy_at(source.get());
+                    source.sequence.store(position + m_capacity,
+                                          std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_dequeue->load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Snapshots that may be stale by the time they are used.
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    size_t size() const noexcept
+    {
+        const size_t head = m_dequeue->load(std::memory_order_acquire);
+        const size_t tail = m_enqueue->load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+private:
+    slot_type& slot(size_t position) const noexcept
+    {
+        return m_slots[position & (m_capacity - 1)];
+    }
+
+    slot_type* claim_for_push() noexcept
+    {
+        size_t position = m_enqueue->load(std::memory_order_relaxed);
+        for (;;)
+        {
+            slot_type& target = slot(position);
+            const size_t sequence =
+                target.sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<ptrdiff_t>(sequence - position);
+            if (lag == 0)
+            {
+                if (m_enqueue->compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed))
+                {
+                    return &target;
+                }
+            }
+            else if (lag < 0)
+            {
+                return nullptr;
+            }
+            else
+            {
+                position = m_enqueue->load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // The slot's position is recovered from its sequence, which still holds
+    // the value the producer claimed it with.
+    static void publish(slot_type* target) noexcept
+    {
+        const size_t position =
+            target->sequence.load(std::memory_order_relaxed);
+        target->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    const size_t m_capacity;
+    slot_type* const m_slots;
+    cache_padded<std::atomic<size_t>> m_enqueue;
+    cache_padded<std::atomic<size_t>> m_dequeue;
+};
+} // namespace ohmy
+
+#endif // OHMY_MPMC_QUEUE_HPP
@@ -0,0 +1,293 @@
+#include <catch/catch.hpp>
+
+#include "functional.hpp"
+#include "mpmc_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct ThrowingCopy
+{
+    ThrowingCopy() = default;
+    ThrowingCopy(const ThrowingCopy&)
+    {
+        throw 1;
+    }
+    ThrowingCopy(ThrowingCopy&&) noexcept = default;
+
+    int operator()() const
+    {
+        return 4;
+    }
+};
+} // namespace
+
+TEST_CASE("mpmc_queue")
+{
+    SECTION("elements come out in order on a single thread")
+    {
+        ohmy::mpmc_queue<int> queue{4};
+        REQUIRE(queue.capacity() == 4u);
+        for (int lap = 0; lap < 3; ++lap)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                REQUIRE(queue.try_push(lap * 10 + i));
+            }
+            REQUIRE_FALSE(queue.try_push(99));
+            REQUIRE(queue.size() == 4u);
+
+            int value = -1;
+            for (int i = 0; i < 4; ++i)
+            {
+                REQUIRE(queue.try_pop(value));
+                REQUIRE(value == lap * 10 + i);
+            }
+            REQUIRE_FALSE(queue.try_pop(value));
+            REQUIRE(queue.empty());
+        }
+    }
+
+    SECTION("throwing constructors run before a slot is claimed")
+    {
+        ohmy::mpmc_queue<ohmy::move_only_function<int()>> queue{2};
+        const ThrowingCopy functor;
+
+        REQUIRE_THROWS(queue.try_emplace(functor));
+        REQUIRE(queue.empty());
+        REQUIRE(queue.try_emplace(ThrowingCopy{}));
+
+        ohmy::move_only_function<int()> task;
+        REQUIRE(queue.try_pop(task));
+        REQUIRE(task() == 4);
+        REQUIRE_FALSE(queue.try_pop(task));
+    }
+
+    SECTION("elements left in the queue are destroyed with it")
+    {
+        auto value = std::make_shared<int>(1);
+        {
+            ohmy::mpmc_queue<std::shared_ptr<int>> queue{8};
+            queue.try_push(value);
+            queue.try_push(value);
+            REQUIRE(value.use_count() == 3);
+        }
+        REQUIRE(value.use_count() == 1);
+    }
+
+    SECTION("every element is delivered exactly once")
+    {
+        constexpr int producers = 4;
+        constexpr int consumers = 4;
+        constexpr int per_producer = 20000;
+        ohmy::mpmc_queue<int> queue{16};
+        std::vector<std::atomic<int>> seen(producers * per_producer);
+        std::atomic<int> received{0};
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p] {
+                for (int i = 0; i < per_producer; ++i)
+                {
+                    while (not queue.try_push(p * per_producer + i))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (int c = 0; c < consumers; ++c)
+        {
+            threads.emplace_back([&] {
+                while (received.load() < producers * per_producer)
+                {
+                    int value;
+                    if (queue.try_pop(value))
+                    {
+                        seen[value].fetch_add(1);
+                        received.fetch_add(1);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        REQUIRE(std::all_of(seen.begin(), seen.end(),
+                            [](const std::atomic<int>& n) { return n == 1; }));
+        REQUIRE(queue.empty());
+    }
+}
+
+namespace
+{
+using benchmark_clock = std::chrono::steady_clock;
+
+// Runs producers threads that push per_producer items each into a single
+// consumer, using push(thread, i) and pop(), which returns whether it
+// received something.
+template <typename Push, typename Pop>
+void run_producers(int producers, int per_producer, Push push, Pop pop)
+{
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < per_producer; ++i)
+            {
+                while (not push(p, i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int received = 0; received < producers * per_producer;)
+    {
+        if (pop())
+        {
+            ++received;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+int benchmark_producers()
+{
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? static_cast<int>(hardware - 1) : 1;
+}
+} // namespace
+
+TEST_CASE("mpmc_queue benchmarks", "[.benchmark]")
+{
+    constexpr int total = 1 << 20;
+    const int max_producers = benchmark_producers();
+
+    for (int producers = 1; producers <= max_producers; producers *= 2)
+    {
+        const int per_producer = total / producers;
+        const std::string suffix =
+            " with " + std::to_string(producers) + " producers";
+        const std::string locked_name =
+            "mutex-protected std::deque<std::function>" + suffix;
+        const std::string lock_free_name =
+            "mpmc_queue<move_only_function>" + suffix;
+
+        BENCHMARK(locked_name)
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> queue;
+            std::atomic<long long> sum{0};
+            run_producers(
+                producers, per_producer,
+                [&](int, int i) {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    queue.emplace_back([&sum, i] { sum += i; });
+                    return true;
+                },
+                [&] {
+                    std::function<void()> task;
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        if (queue.empty())
+                        {
+                            return false;
+                        }
+                        task = std::move(queue.front());
+                        queue.pop_front();
+                    }
+                    task();
+                    return true;
+                });
+        }
+
+        BENCHMARK(lock_free_name)
+        {
+            ohmy::mpmc_queue<ohmy::move_only_function<void()>> queue{1024};
+            std::atomic<long long> sum{0};
+            run_producers(
+                producers, per_producer,
+                [&](int, int i) {
+                    return queue.try_emplace([&sum, i] { sum += i; });
+                },
+                [&] {
+                    ohmy::move_only_function<void()> task;
+                    if (not queue.try_pop(task))
+                    {
+                        return false;
+                    }
+                    task();
+                    return true;
+                });
+        }
+    }
+}
+
+// Reports the time from push to pop, measured on the consumer, as
+// percentiles; the producers push as fast as the ring allows, so this is
+// the latency under saturation.
+TEST_CASE("mpmc_queue latency", "[.benchmark]")
+{
+    constexpr int total = 1 << 18;
+    const int max_producers = benchmark_producers();
+
+    for (int producers = 1; producers <= max_producers; producers *= 2)
+    {
+        const int per_producer = total / producers;
+        ohmy::mpmc_queue<benchmark_clock::time_point> queue{1024};
+        std::vector<long long> latencies;
+        latencies.reserve(static_cast<std::size_t>(producers * per_producer));
+
+        run_producers(
+            producers, per_producer,
+            [&](int, int) { return queue.try_push(benchmark_clock::now()); },
+            [&] {
+                benchmark_clock::time_point pushed;
+                if (not queue.try_pop(pushed))
+                {
+                    return false;
+                }
+                latencies.push_back(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        benchmark_clock::now() - pushed)
+                        .count());
+                return true;
+            });
+
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p) {
+            return latencies[static_cast<std::size_t>(
+                p * static_cast<double>(latencies.size() - 1))];
+        };
+        WARN("mpmc_queue latency with "
+             << producers << " producers: p50 " << percentile(0.5)
+             << " ns, p99 " << percentile(0.99) << " ns, p99.9 "
+             << percentile(0.999) << " ns, max " << latencies.back()
+             << " ns");
+    }
+}
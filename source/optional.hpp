@@ -0,0 +1,581 @@
+#ifndef OHMY_OPTIONAL_HPP
+#define OHMY_OPTIONAL_HPP
+
+#include "c++config.hpp"
+#include "memory.hpp"
+#include "string_view.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <exception>
+
+// An optional value that costs no space when it does not have to. Most
+// types that get wrapped in an optional have a state no real value is ever
+// in, such as a null owning pointer; niche_traits names that state, and
+// optional<Type> marks its own empty state with it instead of a flag, so
+// sizeof(optional<Type>) == sizeof(Type).
+//
+// An optional of a trivially copyable or trivially destructible type is
+// trivially copyable or trivially destructible itself, and can be copied
+// with memcpy and stored in the library's relocating containers.
+namespace ohmy
+{
+struct nullopt_t
+{
+    explicit constexpr nullopt_t(int) noexcept
+    {
+    }
+};
+
+inline constexpr nullopt_t nullopt{0};
+
+class bad_optional_access : public std::exception
+{
+public:
+    const char* what() const noexcept override
+    {
+        return "bad optional access";
+    }
+};
+
+// Describes a niche of Type: a state that no value held by an optional
+// ever takes. A specialization sets has_niche and provides
+//
+//     static Type empty() noexcept;
+//     static bool is_empty(const Type& value) noexcept;
+//
+// The niche value is copied, assigned and destroyed like any other value,
+// and an optional that is given a value in the niche is empty.
+template <typename Type, typename = void>
+struct niche_traits
+{
+    static constexpr bool has_niche = false;
+};
+
+// Makes Sentinel the niche of an integral, enumeration or pointer type:
+//
+//     enum class handle : uint32_t {};
+//     template <>
+//     struct niche_traits<handle> : sentinel_niche<handle, handle{~0u}> {};
+template <typename Type, Type Sentinel>
+struct sentinel_niche
+{
+    static constexpr bool has_niche = true;
+
+    static constexpr Type empty() noexcept
+    {
+        return Sentinel;
+    }
+
+    static constexpr bool is_empty(Type value) noexcept
+    {
+        return value == Sentinel;
+    }
+};
+
+// A null unique_ptr owns nothing, so an optional unique_ptr is empty when
+// it is null: moving a null pointer into one leaves it empty.
+template <typename Type, typename Deleter>
+struct niche_traits<unique_ptr<Type, Deleter>,
+                    enable_if_t<is_default_constructible_v<Deleter>>>
+{
+    static constexpr bool has_niche = true;
+
+    static unique_ptr<Type, Deleter> empty() noexcept
+    {
+        return unique_ptr<Type, Deleter>{};
+    }
+
+    static bool is_empty(const unique_ptr<Type, Deleter>& value) noexcept
+    {
+        return not value;
+    }
+};
+
+// No view of npos characters starts at a null pointer, whereas a null
+// empty view is the default and has to remain a value.
+template <typename CharT, typename Traits>
+struct niche_traits<my::basic_string_view<CharT, Traits>>
+{
+    using view_type = my::basic_string_view<CharT, Traits>;
+
+    static constexpr bool has_niche = true;
+
+    static constexpr view_type empty() noexcept
+    {
+        return view_type{nullptr, view_type::npos};
+    }
+
+    static constexpr bool is_empty(const view_type& value) noexcept
+    {
+        return value.data() == nullptr and value.size() == view_type::npos;
+    }
+};
+
+namespace detail
+{
+// Holds a value at all times, which is the niche while it is empty.
+template <typename Type>
+struct optional_niche_storage
+{
+    using traits = niche_traits<Type>;
+
+    constexpr optional_niche_storage() noexcept : m_value(traits::empty())
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit optional_niche_storage(in_place_t,
+                                              ArgumentTypes&&... arguments)
+        : m_value(ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    constexpr bool has_value() const noexcept
+    {
+        return not traits::is_empty(m_value);
+    }
+
+    constexpr Type& get() noexcept
+    {
+        return m_value;
+    }
+
+    constexpr const Type& get() const noexcept
+    {
+        return m_value;
+    }
+
+    template <typename... ArgumentTypes>
+    void construct(ArgumentTypes&&... arguments)
+    {
+        ohmy::destroy_at(ohmy::addressof(m_value));
+        try
+        {
+            ohmy::construct_at(ohmy::addressof(m_value),
+                               ohmy::forward<ArgumentTypes>(arguments)...);
+        }
+        catch (...)
+        {
+            ohmy::construct_at(ohmy::addressof(m_value), traits::empty());
+            throw;
+        }
+    }
+
+    void destroy() noexcept
+    {
+        ohmy::destroy_at(ohmy::addressof(m_value));
+        ohmy::construct_at(ohmy::addressof(m_value), traits::empty());
+    }
+
+    Type m_value;
+};
+
+// Uninitialized space for a value. The union is trivially destructible
+// exactly when the value is, and trivially copyable exactly when it is.
+template <typename Type, bool = is_trivially_destructible_v<Type>>
+union optional_slot
+{
+    constexpr optional_slot() noexcept : m_empty{}
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit optional_slot(in_place_t, ArgumentTypes&&... arguments)
+        : m_value(ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    char m_empty;
+    Type m_value;
+};
+
+template <typename Type>
+union optional_slot<Type, false>
+{
+    constexpr optional_slot() noexcept : m_empty{}
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit optional_slot(in_place_t, ArgumentTypes&&... arguments)
+        : m_value(ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    ~optional_slot()
+    {
+    }
+
+    char m_empty;
+    Type m_value;
+};
+
+template <typename Type>
+struct optional_flag_base
+{
+    constexpr optional_flag_base() noexcept : m_slot{}, m_engaged{false}
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit optional_flag_base(in_place_t,
+                                          ArgumentTypes&&... arguments)
+        : m_slot{in_place, ohmy::forward<ArgumentTypes>(arguments)...},
+          m_engaged{true}
+    {
+    }
+
+    constexpr bool has_value() const noexcept
+    {
+        return m_engaged;
+    }
+
+    constexpr Type& get() noexcept
+    {
+        return m_slot.m_value;
+    }
+
+    constexpr const Type& get() const noexcept
+    {
+        return m_slot.m_value;
+    }
+
+    template <typename... ArgumentTypes>
+    void construct(ArgumentTypes&&... arguments)
+    {
+        ohmy::construct_at(ohmy::addressof(m_slot.m_value),
+                           ohmy::forward<ArgumentTypes>(arguments)...);
+        m_engaged = true;
+    }
+
+    void destroy() noexcept
+    {
+        m_engaged = false;
+        ohmy::destroy_at(ohmy::addressof(m_slot.m_value));
+    }
+
+    // Copies or moves the state of other, an optional storage.
+    template <typename Other>
+    void assign(Other&& other)
+    {
+        if (m_engaged and other.m_engaged)
+        {
+            get() = ohmy::forward<Other>(other).m_slot.m_value;
+        }
+        else if (other.m_engaged)
+        {
+            construct(ohmy::forward<Other>(other).m_slot.m_value);
+        }
+        else if (m_engaged)
+        {
+            destroy();
+        }
+    }
+
+    optional_slot<Type> m_slot;
+    bool m_engaged;
+};
+
+// Keeps a flag next to the value.
+template <typename Type, bool = is_trivially_destructible_v<Type>>
+struct optional_flag_storage : optional_flag_base<Type>
+{
+    using optional_flag_base<Type>::optional_flag_base;
+};
+
+template <typename Type>
+struct optional_flag_storage<Type, false> : optional_flag_base<Type>
+{
+    using optional_flag_base<Type>::optional_flag_base;
+
+    optional_flag_storage() = default;
+    optional_flag_storage(const optional_flag_storage&) = default;
+    optional_flag_storage(optional_flag_storage&&) = default;
+    optional_flag_storage& operator=(const optional_flag_storage&) = default;
+    optional_flag_storage& operator=(optional_flag_storage&&) = default;
+
+    ~optional_flag_storage()
+    {
+        if (this->m_engaged)
+        {
+            this->destroy();
+        }
+    }
+};
+
+// Copies and moves the value where copying the bytes would not do.
+template <typename Type, bool = is_trivially_copiable_v<Type>>
+struct optional_flag_copy : optional_flag_storage<Type>
+{
+    using optional_flag_storage<Type>::optional_flag_storage;
+};
+
+template <typename Type>
+struct optional_flag_copy<Type, false> : optional_flag_storage<Type>
+{
+    using optional_flag_storage<Type>::optional_flag_storage;
+
+    optional_flag_copy() = default;
+
+    optional_flag_copy(const optional_flag_copy& other)
+        : optional_flag_storage<Type>()
+    {
+        if (other.m_engaged)
+        {
+            this->construct(other.get());
+        }
+    }
+
+    optional_flag_copy(optional_flag_copy&& other) noexcept(
+        is_nothrow_move_constructible_v<Type>)
+        : optional_flag_storage<Type>()
+    {
+        if (other.m_engaged)
+        {
+            this->construct(ohmy::move(other.get()));
+        }
+    }
+
+    optional_flag_copy& operator=(const optional_flag_copy& other)
+    {
+        this->assign(other);
+        return *this;
+    }
+
+    optional_flag_copy& operator=(optional_flag_copy&& other) noexcept(
+        is_nothrow_move_constructible_v<Type> and
+        is_nothrow_move_assignable_v<Type>)
+    {
+        this->assign(ohmy::move(other));
+        return *this;
+    }
+};
+
+template <typename Type>
+using optional_storage_t =
+    conditional_t<niche_traits<Type>::has_niche, optional_niche_storage<Type>,
+                  optional_flag_copy<Type>>;
+
+template <typename Type>
+inline constexpr bool is_optional_v = false;
+} // namespace detail
+
+template <typename Type>
+class optional
+    : private detail::optional_storage_t<Type>,
+      private detail::enable_copy_move<
+          is_copy_constructible_v<Type>,
+          is_copy_constructible_v<Type> and is_copy_assignable_v<Type>,
+          is_move_constructible_v<Type>,
+          is_move_constructible_v<Type> and is_move_assignable_v<Type>,
+          optional<Type>>
+{
+    using base = detail::optional_storage_t<Type>;
+
+    template <typename Other>
+    static constexpr bool is_value_argument_v =
+        is_constructible_v<Type, Other&&> and
+        not is_same_v<decay_t<Other>, optional> and
+        not is_same_v<decay_t<Other>, in_place_t> and
+        not is_same_v<decay_t<Other>, nullopt_t>;
+
+public:
+    using value_type = Type;
+
+    constexpr optional() noexcept = default;
+
+    constexpr optional(nullopt_t) noexcept
+    {
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr explicit optional(in_place_t, ArgumentTypes&&... arguments)
+        : base(in_place, ohmy::forward<ArgumentTypes>(arguments)...)
+    {
+    }
+
+    template <typename Other = Type,
+              typename = enable_if_t<is_value_argument_v<Other>>>
+    constexpr optional(Other&& value)
+        : base(in_place, ohmy::forward<Other>(value))
+    {
+    }
+
+    optional& operator=(nullopt_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    template <typename Other = Type,
+              typename = enable_if_t<is_value_argument_v<Other>>>
+    optional& operator=(Other&& value)
+    {
+        if (has_value())
+        {
+            this->get() = ohmy::forward<Other>(value);
+        }
+        else
+        {
+            this->construct(ohmy::forward<Other>(value));
+        }
+        return *this;
+    }
+
+    template <typename... ArgumentTypes>
+    Type& emplace(ArgumentTypes&&... arguments)
+    {
+        reset();
+        this->construct(ohmy::forward<ArgumentTypes>(arguments)...);
+        return this->get();
+    }
+
+    void reset() noexcept
+    {
+        if (has_value())
+        {
+            this->destroy();
+        }
+    }
+
+    constexpr bool has_value() const noexcept
+    {
+        return base::has_value();
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    constexpr Type& operator*() & noexcept
+    {
+        return this->get();
+    }
+
+    constexpr const Type& operator*() const& noexcept
+    {
+        return this->get();
+    }
+
+    constexpr Type&& operator*() && noexcept
+    {
+        return ohmy::move(this->get());
+    }
+
+    constexpr Type* operator->() noexcept
+    {
+        return ohmy::addressof(this->get());
+    }
+
+    constexpr const Type* operator->() const noexcept
+    {
+        return ohmy::addressof(this->get());
+    }
+
+    constexpr Type& value() &
+    {
+        check();
+        return this->get();
+    }
+
+    constexpr const Type& value() const&
+    {
+        check();
+        return this->get();
+    }
+
+    constexpr Type&& value() &&
+    {
+        check();
+        return ohmy::move(this->get());
+    }
+
+    template <typename Other>
+    constexpr Type value_or(Other&& fallback) const&
+    {
+        return has_value() ? this->get()
+                           : static_cast<Type>(ohmy::forward<Other>(fallback));
+    }
+
+    template <typename Other>
+    constexpr Type value_or(Other&& fallback) &&
+    {
+        return has_value() ? ohmy::move(this->get())
+                           : static_cast<Type>(ohmy::forward<Other>(fallback));
+    }
+
+private:
+    constexpr void check() const
+    {
+        if (not has_value())
+            throw bad_optional_access{};
+    }
+};
+
+template <typename Type>
+optional(Type) -> optional<Type>;
+
+namespace detail
+{
+template <typename Type>
+inline constexpr bool is_optional_v<optional<Type>> = true;
+} // namespace detail
+
+template <typename Type, typename... ArgumentTypes>
+constexpr optional<Type> make_optional(ArgumentTypes&&... arguments)
+{
+    return optional<Type>{in_place,
+                          ohmy::forward<ArgumentTypes>(arguments)...};
+}
+
+template <typename Type, typename OtherType>
+constexpr bool operator==(const optional<Type>& lhs,
+                          const optional<OtherType>& rhs)
+{
+    return lhs.has_value() == rhs.has_value() and
+           (not lhs.has_value() or *lhs == *rhs);
+}
+
+template <typename Type, typename OtherType>
+constexpr bool operator!=(const optional<Type>& lhs,
+                          const optional<OtherType>& rhs)
+{
+    return not(lhs == rhs);
+}
+
+template <typename Type>
+constexpr bool operator==(const optional<Type>& lhs, nullopt_t) noexcept
+{
+    return not lhs.has_value();
+}
+
+template <typename Type>
+constexpr bool operator!=(const optional<Type>& lhs, nullopt_t) noexcept
+{
+    return lhs.has_value();
+}
+
+template <typename Type, typename OtherType,
+          typename = enable_if_t<not detail::is_optional_v<OtherType>>>
+constexpr bool operator==(const optional<Type>& lhs, const OtherType& rhs)
+{
+    return lhs.has_value() and *lhs == rhs;
+}
+
+template <typename Type, typename OtherType,
+          typename = enable_if_t<not detail::is_optional_v<OtherType>>>
+constexpr bool operator!=(const optional<Type>& lhs, const OtherType& rhs)
+{
+    return not(lhs == rhs);
+}
+
+// Either a value or nothing; moving an optional copies whichever it is.
+template <typename Type>
+struct is_trivially_relocatable<optional<Type>> : is_trivially_relocatable<Type>
+{
+};
+} // namespace ohmy
+
+#endif // OHMY_OPTIONAL_HPP
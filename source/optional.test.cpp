@@ -0,0 +1,319 @@
+#include <catch/catch.hpp>
+
+#include "optional.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+enum class handle : uint32_t
+{
+};
+
+// An index into a table, where the largest index means none.
+struct slot_index
+{
+    uint32_t value;
+};
+
+// Counts its live instances.
+struct Tracked
+{
+    explicit Tracked(int value, int& live) : value{value}, live{&live}
+    {
+        ++*this->live;
+    }
+
+    Tracked(const Tracked& other) : value{other.value}, live{other.live}
+    {
+        ++*live;
+    }
+
+    Tracked& operator=(const Tracked& other)
+    {
+        value = other.value;
+        return *this;
+    }
+
+    ~Tracked()
+    {
+        --*live;
+    }
+
+    int value;
+    int* live;
+};
+
+struct Throwing
+{
+    explicit Throwing(bool fail) : failed{fail}
+    {
+        if (fail)
+            throw std::runtime_error("construction failed");
+    }
+
+    bool failed;
+};
+
+// A non-negative code; the default, -1, is no code.
+struct code
+{
+    code() noexcept = default;
+
+    explicit code(int value) : value{value}
+    {
+        if (value < 0)
+            throw std::invalid_argument("negative code");
+    }
+
+    int value = -1;
+};
+
+// Move-only, and without a niche.
+struct MoveOnly
+{
+    std::unique_ptr<int> value;
+};
+
+int deleted = 0;
+
+struct counting_delete
+{
+    void operator()(int* pointer) const noexcept
+    {
+        ++deleted;
+        delete pointer;
+    }
+};
+} // namespace
+
+template <>
+struct ohmy::niche_traits<handle>
+    : ohmy::sentinel_niche<handle, handle{~0u}>
+{
+};
+
+template <>
+struct ohmy::niche_traits<slot_index>
+{
+    static constexpr bool has_niche = true;
+
+    static constexpr slot_index empty() noexcept
+    {
+        return slot_index{~0u};
+    }
+
+    static constexpr bool is_empty(slot_index index) noexcept
+    {
+        return index.value == ~0u;
+    }
+};
+
+template <>
+struct ohmy::niche_traits<code>
+{
+    static constexpr bool has_niche = true;
+
+    static code empty() noexcept
+    {
+        return code{};
+    }
+
+    static bool is_empty(const code& value) noexcept
+    {
+        return value.value == -1;
+    }
+};
+
+// Types with a niche take no extra space.
+static_assert(sizeof(ohmy::optional<ohmy::unique_ptr<int>>) == sizeof(int*));
+static_assert(sizeof(ohmy::optional<my::string_view>) ==
+              sizeof(my::string_view));
+static_assert(sizeof(ohmy::optional<handle>) == sizeof(handle));
+static_assert(sizeof(ohmy::optional<slot_index>) == sizeof(slot_index));
+static_assert(sizeof(ohmy::optional<int>) == 2 * sizeof(int));
+
+// Triviality follows the value type.
+static_assert(ohmy::is_trivially_copiable_v<ohmy::optional<int>>);
+static_assert(ohmy::is_trivially_copiable_v<ohmy::optional<my::string_view>>);
+static_assert(ohmy::is_trivially_copiable_v<ohmy::optional<slot_index>>);
+static_assert(ohmy::is_trivially_destructible_v<ohmy::optional<double>>);
+static_assert(not ohmy::is_trivially_copiable_v<ohmy::optional<std::string>>);
+static_assert(
+    not ohmy::is_trivially_destructible_v<ohmy::optional<std::string>>);
+static_assert(
+    ohmy::is_trivially_relocatable_v<ohmy::optional<ohmy::unique_ptr<int>>>);
+static_assert(not ohmy::is_copy_constructible_v<
+              ohmy::optional<ohmy::unique_ptr<int>>>);
+
+// Copies and moves exist only where the value type has them, with or
+// without a niche.
+static_assert(not ohmy::is_copy_constructible_v<ohmy::optional<MoveOnly>>);
+static_assert(not ohmy::is_copy_assignable_v<ohmy::optional<MoveOnly>>);
+static_assert(ohmy::is_move_constructible_v<ohmy::optional<MoveOnly>>);
+static_assert(ohmy::is_move_assignable_v<ohmy::optional<MoveOnly>>);
+static_assert(not ohmy::is_move_constructible_v<ohmy::optional<std::mutex>>);
+static_assert(not ohmy::is_move_assignable_v<ohmy::optional<std::mutex>>);
+static_assert(ohmy::is_copy_constructible_v<ohmy::optional<std::string>>);
+static_assert(ohmy::is_copy_assignable_v<ohmy::optional<std::string>>);
+static_assert(sizeof(ohmy::optional<ohmy::optional<int>>) == 3 * sizeof(int));
+
+// Empty views are values; only the niche is not.
+static_assert(ohmy::optional<my::string_view>{my::string_view{}}.has_value());
+static_assert(not ohmy::optional<my::string_view>{}.has_value());
+
+TEST_CASE("optional")
+{
+    SECTION("values and empty optionals")
+    {
+        ohmy::optional<int> value;
+        REQUIRE_FALSE(value);
+        REQUIRE(value == ohmy::nullopt);
+        REQUIRE_THROWS_AS(value.value(), ohmy::bad_optional_access);
+        REQUIRE(value.value_or(7) == 7);
+
+        value = 3;
+        REQUIRE(value.has_value());
+        REQUIRE(*value == 3);
+        REQUIRE(value == 3);
+        REQUIRE(value != 4);
+        REQUIRE(value.value_or(7) == 3);
+
+        value.emplace(5);
+        REQUIRE(value.value() == 5);
+        value = ohmy::nullopt;
+        REQUIRE(value != ohmy::optional<int>{5});
+        REQUIRE(value == ohmy::optional<int>{});
+    }
+
+    SECTION("values that are not trivial are constructed and destroyed once")
+    {
+        int live = 0;
+        {
+            ohmy::optional<Tracked> first{ohmy::in_place, 1, live};
+            ohmy::optional<Tracked> second;
+            REQUIRE(live == 1);
+
+            second = first;
+            REQUIRE(live == 2);
+            second->value = 2;
+            first = second;
+            REQUIRE(first->value == 2);
+            REQUIRE(live == 2);
+
+            {
+                ohmy::optional<Tracked> third = std::move(first);
+                REQUIRE(live == 3);
+                REQUIRE(third->value == 2);
+            }
+            REQUIRE(live == 2);
+            second = ohmy::optional<Tracked>{};
+            REQUIRE(live == 1);
+            first.reset();
+            REQUIRE(live == 0);
+            first.emplace(4, live);
+            REQUIRE(live == 1);
+        }
+        REQUIRE(live == 0);
+    }
+
+    SECTION("strings")
+    {
+        ohmy::optional<std::string> text{std::string(40, 'x')};
+        ohmy::optional<std::string> copy = text;
+        REQUIRE(copy->size() == 40u);
+        REQUIRE(std::move(text).value_or("none").size() == 40u);
+        text.reset();
+        REQUIRE(text.value_or("none") == "none");
+    }
+
+    SECTION("move-only values without a niche")
+    {
+        ohmy::optional<MoveOnly> owner{MoveOnly{std::make_unique<int>(5)}};
+        ohmy::optional<MoveOnly> other = std::move(owner);
+        REQUIRE(*other->value == 5);
+        owner = std::move(other);
+        REQUIRE(*owner->value == 5);
+        REQUIRE(other.has_value());
+        REQUIRE(other->value == nullptr);
+    }
+
+    SECTION("a failed emplace leaves the optional empty")
+    {
+        ohmy::optional<Throwing> value{ohmy::in_place, false};
+        REQUIRE_THROWS_AS(value.emplace(true), std::runtime_error);
+        REQUIRE_FALSE(value.has_value());
+    }
+}
+
+TEST_CASE("optional with a niche")
+{
+    SECTION("unique_ptr is empty when null")
+    {
+        using pointer = ohmy::unique_ptr<int, counting_delete>;
+        deleted = 0;
+        {
+            ohmy::optional<pointer> owner{pointer{new int{42}}};
+            REQUIRE(owner.has_value());
+            REQUIRE(**owner == 42);
+
+            ohmy::optional<pointer> other = std::move(owner);
+            REQUIRE_FALSE(owner.has_value());
+            REQUIRE(**other == 42);
+
+            other = pointer{new int{43}};
+            REQUIRE(deleted == 1);
+            REQUIRE(**other == 43);
+
+            other.reset();
+            REQUIRE(deleted == 2);
+            REQUIRE_FALSE(other.has_value());
+
+            other = pointer{};
+            REQUIRE_FALSE(other.has_value());
+            other.emplace(new int{44});
+        }
+        REQUIRE(deleted == 3);
+    }
+
+    SECTION("string views")
+    {
+        ohmy::optional<my::string_view> view{my::string_view{"text"}};
+        REQUIRE(view->size() == 4u);
+        view = my::string_view{};
+        REQUIRE(view.has_value());
+        REQUIRE(view->empty());
+        view.reset();
+        REQUIRE_FALSE(view.has_value());
+    }
+
+    SECTION("sentinel values")
+    {
+        ohmy::optional<handle> none;
+        REQUIRE_FALSE(none.has_value());
+        ohmy::optional<handle> some{handle{3}};
+        REQUIRE(*some == handle{3});
+        none = some;
+        REQUIRE(none == handle{3});
+
+        ohmy::optional<slot_index> index{slot_index{0}};
+        REQUIRE(index.has_value());
+        REQUIRE(index->value == 0u);
+        index.reset();
+        REQUIRE_FALSE(index.has_value());
+        REQUIRE(index.value_or(slot_index{9}).value == 9u);
+    }
+
+    SECTION("a failed emplace leaves the niche in place")
+    {
+        ohmy::optional<code> value{ohmy::in_place, 1};
+        REQUIRE_THROWS_AS(value.emplace(-1), std::invalid_argument);
+        REQUIRE_FALSE(value.has_value());
+        value.emplace(2);
+        REQUIRE(value->value == 2);
+    }
+}
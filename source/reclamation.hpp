@@ -0,0 +1,698 @@
+#ifndef OHMY_RECLAMATION_HPP
+#define OHMY_RECLAMATION_HPP
+
+#include "c++config.hpp"
+#include "cache_padded.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+// Safe memory reclamation for lock-free data structures. An object that has
+// been unlinked from a shared structure may still be read by threads that
+// loaded a pointer to it earlier, so instead of deleting it the remover
+// retires it, and a domain frees it once no reader can reach it any more.
+//
+// Two schemes are provided:
+//  - hazard pointers: a reader publishes the exact pointer it is about to
+//    dereference, and a retired object is freed once no hazard pointer
+//    holds it. Bounded garbage, one fence per protected load.
+//  - epochs: a reader pins the domain for the duration of a critical
+//    section, and retired objects are freed in batches two epochs later.
+//    Cheaper for readers, but a stalled reader delays all reclamation.
+//
+// Retirable objects derive from hazard_pointer_obj_base or epoch_obj_base,
+// which embed the retirement bookkeeping. Retiring never allocates: the
+// hazard pointer scan it may trigger works in a buffer that grows when hazard
+// pointers are created. Objects are freed through a Deleter, the way
+// unique_ptr frees its pointee.
+namespace ohmy
+{
+namespace detail
+{
+struct retired_node
+{
+    retired_node* m_next = nullptr;
+    void (*m_reclaim)(retired_node*) = nullptr;
+    // The address hazard pointers compare against; for epoch reclamation
+    // the epoch the node was retired in.
+    uintptr_t m_tag = 0;
+};
+
+inline void reclaim_list(retired_node* node) noexcept
+{
+    while (node != nullptr)
+    {
+        retired_node* next = node->m_next;
+        node->m_reclaim(node);
+        node = next;
+    }
+}
+
+template <typename Type, typename Deleter, typename Base>
+void reclaim_as(retired_node* node) noexcept
+{
+    auto* base = static_cast<Base*>(node);
+    Deleter deleter = ohmy::move(base->m_deleter);
+    deleter(static_cast<Type*>(base));
+}
+
+struct hazard_record
+{
+    std::atomic<const void*> m_pointer{nullptr};
+    std::atomic<bool> m_in_use{false};
+    hazard_record* m_next = nullptr;
+};
+} // namespace detail
+
+class hazard_pointer;
+
+class hazard_pointer_domain
+{
+public:
+    hazard_pointer_domain() noexcept = default;
+
+    // No hazard pointer may still be protecting an object of this domain.
+    ~hazard_pointer_domain()
+    {
+        detail::reclaim_list(m_retired.exchange(nullptr));
+
+        detail::hazard_record* record = m_records.load();
+        while (record != nullptr)
+        {
+            detail::hazard_record* next = record->m_next;
+            delete record;
+            record = next;
+        }
+    }
+
+    hazard_pointer_domain(const hazard_pointer_domain&) = delete;
+    hazard_pointer_domain& operator=(const hazard_pointer_domain&) = delete;
+
+    // Frees every retired object that no hazard pointer protects.
+    void reclaim() noexcept
+    {
+        while (not try_reclaim())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    size_t retired_count() const noexcept
+    {
+        return m_retired_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend hazard_pointer make_hazard_pointer(hazard_pointer_domain&);
+    template <typename Type, typename Deleter>
+    friend class hazard_pointer_obj_base;
+
+    // Scans unless another thread is already scanning, which returns false.
+    bool try_reclaim() noexcept
+    {
+        if (m_scanning.exchange(true, std::memory_order_acquire))
+            return false;
+
+        detail::retired_node* batch =
+            m_retired.exchange(nullptr, std::memory_order_acquire);
+        if (batch == nullptr)
+        {
+            m_scanning.store(false, std::memory_order_release);
+            return true;
+        }
+
+        // Pairs with the fence in hazard_pointer::try_protect: either the
+        // reader sees the node unlinked, or we see its hazard.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // Records are only added while nobody scans, and m_hazards has room
+        // for all of them.
+        const void** hazards = m_hazards.get();
+        const void** hazards_end = hazards;
+        for (auto* record = m_records.load(std::memory_order_acquire);
+             record != nullptr; record = record->m_next)
+        {
+            if (auto* pointer =
+                    record->m_pointer.load(std::memory_order_acquire))
+            {
+                *hazards_end++ = pointer;
+            }
+        }
+        std::sort(hazards, hazards_end);
+
+        detail::retired_node* kept = nullptr;
+        detail::retired_node* kept_tail = nullptr;
+        detail::retired_node* freed = nullptr;
+        size_t freed_count = 0;
+        while (batch != nullptr)
+        {
+            detail::retired_node* next = batch->m_next;
+            if (std::binary_search(
+                    hazards, hazards_end,
+                    reinterpret_cast<const void*>(batch->m_tag)))
+            {
+                batch->m_next = kept;
+                kept = batch;
+                kept_tail = kept_tail != nullptr ? kept_tail : batch;
+            }
+            else
+            {
+                batch->m_next = freed;
+                freed = batch;
+                ++freed_count;
+            }
+            batch = next;
+        }
+        m_scanning.store(false, std::memory_order_release);
+
+        // Deleters run after the scan, so they may retire objects too.
+        if (kept != nullptr)
+        {
+            push_retired(kept, kept_tail);
+        }
+        m_retired_count.fetch_sub(freed_count, std::memory_order_relaxed);
+        detail::reclaim_list(freed);
+        return true;
+    }
+
+
+    detail::hazard_record* acquire_record()
+    {
+        for (auto* record = m_records.load(std::memory_order_acquire);
+             record != nullptr; record = record->m_next)
+        {
+            bool expected = false;
+            if (not record->m_in_use.load(std::memory_order_relaxed) and
+                record->m_in_use.compare_exchange_strong(
+                    expected, true, std::memory_order_acquire))
+            {
+                return record;
+            }
+        }
+
+        auto record = make_unique<detail::hazard_record>();
+        record->m_in_use.store(true, std::memory_order_relaxed);
+
+        // Adding a record excludes scans, so the buffer they collect hazards
+        // in can grow first.
+        while (m_scanning.exchange(true, std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+        const size_t records = m_record_count.load(std::memory_order_relaxed);
+        if (records == m_hazard_capacity)
+        {
+            try
+            {
+                m_hazards = make_unique_for_overwrite<const void*[]>(
+                    2 * records + 8);
+            }
+            catch (...)
+            {
+                m_scanning.store(false, std::memory_order_release);
+                throw;
+            }
+            m_hazard_capacity = 2 * records + 8;
+        }
+        record->m_next = m_records.load(std::memory_order_relaxed);
+        m_records.store(record.get(), std::memory_order_release);
+        m_record_count.store(records + 1, std::memory_order_relaxed);
+        m_scanning.store(false, std::memory_order_release);
+        return record.release();
+    }
+
+    // A thread that finds another one scanning leaves its objects to a
+    // later scan.
+    void retire(detail::retired_node* node) noexcept
+    {
+        push_retired(node, node);
+        const size_t retired =
+            m_retired_count.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (retired >= reclaim_threshold())
+        {
+            try_reclaim();
+        }
+    }
+
+    void push_retired(detail::retired_node* first,
+                      detail::retired_node* last) noexcept
+    {
+        last->m_next = m_retired.load(std::memory_order_relaxed);
+        while (not m_retired.compare_exchange_weak(last->m_next, first,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Scanning costs a pass over all hazard records, so it is amortized over
+    // a batch proportional to their number.
+    size_t reclaim_threshold() const noexcept
+    {
+        const size_t records = m_record_count.load(std::memory_order_relaxed);
+        return 64 + 2 * records;
+    }
+
+    std::atomic<detail::hazard_record*> m_records{nullptr};
+    std::atomic<detail::retired_node*> m_retired{nullptr};
+    std::atomic<size_t> m_retired_count{0};
+    std::atomic<size_t> m_record_count{0};
+    // Held by a scan, or by a thread adding a record.
+    std::atomic<bool> m_scanning{false};
+    unique_ptr<const void*[]> m_hazards;
+    size_t m_hazard_capacity = 0;
+};
+
+inline hazard_pointer_domain& default_hazard_pointer_domain() noexcept
+{
+    static hazard_pointer_domain domain;
+    return domain;
+}
+
+// Base class of objects that can be retired to a hazard_pointer_domain.
+template <typename Type, typename Deleter = default_delete<Type>>
+class hazard_pointer_obj_base : private detail::retired_node
+{
+public:
+    // Hands the object over to the domain, which invokes deleter on it once
+    // no hazard pointer protects it.
+    void retire(Deleter deleter = Deleter(),
+                hazard_pointer_domain& domain =
+                    default_hazard_pointer_domain()) noexcept
+    {
+        m_deleter = ohmy::move(deleter);
+        m_reclaim = &detail::reclaim_as<Type, Deleter, hazard_pointer_obj_base>;
+        m_tag = reinterpret_cast<uintptr_t>(static_cast<Type*>(this));
+        domain.retire(this);
+    }
+
+protected:
+    hazard_pointer_obj_base() = default;
+    hazard_pointer_obj_base(const hazard_pointer_obj_base&)
+        : detail::retired_node{}
+    {
+    }
+    hazard_pointer_obj_base& operator=(const hazard_pointer_obj_base&)
+    {
+        return *this;
+    }
+    ~hazard_pointer_obj_base() = default;
+
+private:
+    template <typename, typename, typename>
+    friend void detail::reclaim_as(detail::retired_node*) noexcept;
+
+    [[no_unique_address]] Deleter m_deleter;
+};
+
+// Owns a single hazard record of a domain. protect() publishes the pointer
+// it returns, so the object stays alive until the protection is reset or
+// moved to another object.
+class hazard_pointer
+{
+public:
+    hazard_pointer() noexcept = default;
+
+    hazard_pointer(hazard_pointer&& other) noexcept
+        : m_record{other.m_record}
+    {
+        other.m_record = nullptr;
+    }
+
+    hazard_pointer& operator=(hazard_pointer&& other) noexcept
+    {
+        if (this != ohmy::addressof(other))
+        {
+            release();
+            m_record = other.m_record;
+            other.m_record = nullptr;
+        }
+        return *this;
+    }
+
+    ~hazard_pointer()
+    {
+        release();
+    }
+
+    hazard_pointer(const hazard_pointer&) = delete;
+    hazard_pointer& operator=(const hazard_pointer&) = delete;
+
+    bool empty() const noexcept
+    {
+        return m_record == nullptr;
+    }
+
+    // Loads src and protects the result, retrying until the value is
+    // stable. The returned pointer may be dereferenced until the protection
+    // is reset.
+    template <typename Type>
+    Type* protect(const std::atomic<Type*>& src) noexcept
+    {
+        Type* pointer = src.load(std::memory_order_relaxed);
+        while (not try_protect(pointer, src))
+        {
+        }
+        return pointer;
+    }
+
+    // Protects pointer if src still holds it. Otherwise clears the
+    // protection, stores the current value of src in pointer and returns
+    // false.
+    template <typename Type>
+    bool try_protect(Type*& pointer, const std::atomic<Type*>& src) noexcept
+    {
+        Type* expected = pointer;
+        reset_protection(expected);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        pointer = src.load(std::memory_order_acquire);
+        if (pointer != expected)
+        {
+            reset_protection();
+            return false;
+        }
+        return true;
+    }
+
+    template <typename Type>
+    void reset_protection(const Type* pointer) noexcept
+    {
+        m_record->m_pointer.store(static_cast<const void*>(pointer),
+                                  std::memory_order_release);
+    }
+
+    void reset_protection(nullptr_t = nullptr) noexcept
+    {
+        m_record->m_pointer.store(nullptr, std::memory_order_release);
+    }
+
+    void swap(hazard_pointer& other) noexcept
+    {
+        ohmy::swap(m_record, other.m_record);
+    }
+
+private:
+    friend hazard_pointer make_hazard_pointer(hazard_pointer_domain&);
+
+    explicit hazard_pointer(detail::hazard_record* record) noexcept
+        : m_record{record}
+    {
+    }
+
+    void release() noexcept
+    {
+        if (m_record != nullptr)
+        {
+            m_record->m_pointer.store(nullptr, std::memory_order_release);
+            m_record->m_in_use.store(false, std::memory_order_release);
+            m_record = nullptr;
+        }
+    }
+
+    detail::hazard_record* m_record = nullptr;
+};
+
+inline hazard_pointer
+make_hazard_pointer(hazard_pointer_domain& domain =
+                        default_hazard_pointer_domain())
+{
+    return hazard_pointer{domain.acquire_record()};
+}
+
+namespace detail
+{
+// A participant slot of an epoch_domain. A thread owns a slot for the
+// duration of a critical section or a retire call; the retired list stays
+// with the slot and is picked up by whichever thread owns it next.
+struct alignas(destructive_interference_size) epoch_record
+{
+    // (epoch << 1) | 1 while a reader is inside a critical section.
+    std::atomic<uint64_t> m_state{0};
+    std::atomic<bool> m_in_use{false};
+    retired_node* m_retired = nullptr;
+    size_t m_retired_count = 0;
+};
+
+inline size_t& epoch_record_hint() noexcept
+{
+    thread_local size_t hint =
+        std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return hint;
+}
+} // namespace detail
+
+class epoch_domain;
+
+// Keeps the objects reachable from an epoch_domain alive while it exists.
+class epoch_guard
+{
+public:
+    epoch_guard(epoch_guard&& other) noexcept : m_record{other.m_record}
+    {
+        other.m_record = nullptr;
+    }
+
+    ~epoch_guard()
+    {
+        if (m_record != nullptr)
+        {
+            m_record->m_state.store(0, std::memory_order_release);
+            m_record->m_in_use.store(false, std::memory_order_release);
+        }
+    }
+
+    epoch_guard(const epoch_guard&) = delete;
+    epoch_guard& operator=(const epoch_guard&) = delete;
+    epoch_guard& operator=(epoch_guard&&) = delete;
+
+private:
+    friend class epoch_domain;
+
+    explicit epoch_guard(detail::epoch_record* record) noexcept
+        : m_record{record}
+    {
+    }
+
+    detail::epoch_record* m_record;
+};
+
+class epoch_domain
+{
+public:
+    // At most max_participants threads can be inside a critical section or
+    // retiring at the same time; further threads spin until a slot frees up.
+    explicit epoch_domain(size_t max_participants = default_participants())
+        : m_records{make_unique<detail::epoch_record[]>(max_participants)},
+          m_record_count{max_participants}
+    {
+    }
+
+    // No thread may be pinned or retiring while the domain is destroyed.
+    ~epoch_domain()
+    {
+        for (size_t i = 0; i < m_record_count; ++i)
+        {
+            detail::reclaim_list(m_records[i].m_retired);
+        }
+    }
+
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+
+    // Enters a critical section. Pointers loaded from structures of this
+    // domain stay valid until the guard is destroyed.
+    epoch_guard pin() noexcept
+    {
+        detail::epoch_record* record = acquire_record();
+        const uint64_t epoch = m_epoch.load(std::memory_order_relaxed);
+        record->m_state.store((epoch << 1) | 1, std::memory_order_seq_cst);
+        // Pairs with the fence in try_advance, as the one in
+        // hazard_pointer::try_protect does with reclaim: the store alone
+        // does not keep the caller's later loads from being satisfied
+        // before the announcement is visible.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch_guard{record};
+    }
+
+    // Waits until every critical section that was open when the call
+    // started has ended, then frees everything retired before the call.
+    // Must not be called from inside a critical section.
+    void synchronize() noexcept
+    {
+        const uint64_t target = m_epoch.load(std::memory_order_seq_cst) + 2;
+        while (m_epoch.load(std::memory_order_seq_cst) < target)
+        {
+            if (not try_advance())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        for (size_t i = 0; i < m_record_count; ++i)
+        {
+            detail::epoch_record& record = m_records[i];
+            bool expected = false;
+            while (not record.m_in_use.compare_exchange_weak(
+                expected, true, std::memory_order_acquire))
+            {
+                expected = false;
+                std::this_thread::yield();
+            }
+            reclaim(record);
+            record.m_in_use.store(false, std::memory_order_release);
+        }
+    }
+
+    uint64_t epoch() const noexcept
+    {
+        return m_epoch.load(std::memory_order_acquire);
+    }
+
+    size_t participants() const noexcept
+    {
+        return m_record_count;
+    }
+
+    // Number of objects retired at least this many retirements before a
+    // batch is reclaimed.
+    static constexpr size_t batch_size = 64;
+
+private:
+    template <typename Type, typename Deleter>
+    friend class epoch_obj_base;
+
+    static size_t default_participants() noexcept
+    {
+        const size_t threads = std::thread::hardware_concurrency();
+        return threads != 0 ? 4 * threads : 64;
+    }
+
+    detail::epoch_record* acquire_record() noexcept
+    {
+        size_t& hint = detail::epoch_record_hint();
+        for (size_t attempt = 0;; ++attempt)
+        {
+            detail::epoch_record& record =
+                m_records[(hint + attempt) % m_record_count];
+            bool expected = false;
+            if (not record.m_in_use.load(std::memory_order_relaxed) and
+                record.m_in_use.compare_exchange_strong(
+                    expected, true, std::memory_order_acquire))
+            {
+                hint = (hint + attempt) % m_record_count;
+                return &record;
+            }
+            if (attempt != 0 and attempt % m_record_count == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // The global epoch moves forward once every reader inside a critical
+    // section has observed the current one.
+    bool try_advance() noexcept
+    {
+        // Pairs with the fence in pin: either the reader sees the object
+        // unlinked, or we see its announcement.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+        for (size_t i = 0; i < m_record_count; ++i)
+        {
+            const uint64_t state =
+                m_records[i].m_state.load(std::memory_order_seq_cst);
+            if ((state & 1) != 0 and (state >> 1) != epoch)
+                return false;
+        }
+        return m_epoch.compare_exchange_strong(epoch, epoch + 1,
+                                               std::memory_order_seq_cst);
+    }
+
+    // Objects retired in epoch e may still be in use by readers that pinned
+    // e or e - 1, and are safe to free once the global epoch reaches e + 2.
+    void reclaim(detail::epoch_record& record) noexcept
+    {
+        const uint64_t epoch = m_epoch.load(std::memory_order_acquire);
+        detail::retired_node** link = &record.m_retired;
+        while (*link != nullptr)
+        {
+            detail::retired_node* node = *link;
+            if (node->m_tag + 2 <= epoch)
+            {
+                *link = node->m_next;
+                node->m_reclaim(node);
+                --record.m_retired_count;
+            }
+            else
+            {
+                link = &node->m_next;
+            }
+        }
+    }
+
+    void retire(detail::retired_node* node) noexcept
+    {
+        detail::epoch_record* record = acquire_record();
+        node->m_tag = m_epoch.load(std::memory_order_seq_cst);
+        node->m_next = record->m_retired;
+        record->m_retired = node;
+        if (++record->m_retired_count >= batch_size)
+        {
+            try_advance();
+            reclaim(*record);
+        }
+        record->m_in_use.store(false, std::memory_order_release);
+    }
+
+    std::atomic<uint64_t> m_epoch{2};
+    unique_ptr<detail::epoch_record[]> m_records;
+    size_t m_record_count;
+};
+
+inline epoch_domain& default_epoch_domain()
+{
+    static epoch_domain domain;
+    return domain;
+}
+
+// Base class of objects that can be retired to an epoch_domain.
+template <typename Type, typename Deleter = default_delete<Type>>
+class epoch_obj_base : private detail::retired_node
+{
+public:
+    // Hands the object over to the domain, which invokes deleter on it once
+    // every critical section that might still see it has ended.
+    void retire(Deleter deleter = Deleter(),
+                epoch_domain& domain = default_epoch_domain()) noexcept
+    {
+        m_deleter = ohmy::move(deleter);
+        m_reclaim = &detail::reclaim_as<Type, Deleter, epoch_obj_base>;
+        domain.retire(this);
+    }
+
+protected:
+    epoch_obj_base() = default;
+    epoch_obj_base(const epoch_obj_base&) : detail::retired_node{}
+    {
+    }
+    epoch_obj_base& operator=(const epoch_obj_base&)
+    {
+        return *this;
+    }
+    ~epoch_obj_base() = default;
+
+private:
+    template <typename, typename, typename>
+    friend void detail::reclaim_as(detail::retired_node*) noexcept;
+
+    [[no_unique_address]] Deleter m_deleter;
+};
+} // namespace ohmy
+
+#endif // OHMY_RECLAMATION_HPP
@@ -0,0 +1,414 @@
+#include <catch/catch.hpp>
+
+#include "reclamation.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+std::atomic<int> live_nodes{0};
+
+struct HazardNode : ohmy::hazard_pointer_obj_base<HazardNode>
+{
+    explicit HazardNode(int v) : value{v}
+    {
+        ++live_nodes;
+    }
+    ~HazardNode()
+    {
+        --live_nodes;
+        value = -1;
+    }
+
+    int value;
+    HazardNode* next = nullptr;
+};
+
+struct EpochNode : ohmy::epoch_obj_base<EpochNode>
+{
+    explicit EpochNode(int v) : value{v}
+    {
+        ++live_nodes;
+    }
+    ~EpochNode()
+    {
+        --live_nodes;
+        value = -1;
+    }
+
+    int value;
+};
+
+struct counting_delete
+{
+    int* calls;
+
+    template <typename Type>
+    void operator()(Type* pointer) const
+    {
+        ++*calls;
+        delete pointer;
+    }
+};
+
+struct CustomNode : ohmy::hazard_pointer_obj_base<CustomNode, counting_delete>
+{
+};
+
+// Treiber stack whose pop protects the top node with a hazard pointer.
+class hazard_stack
+{
+public:
+    explicit hazard_stack(ohmy::hazard_pointer_domain& domain)
+        : m_domain{domain}
+    {
+    }
+
+    ~hazard_stack()
+    {
+        while (HazardNode* node = m_top.load())
+        {
+            m_top.store(node->next);
+            delete node;
+        }
+    }
+
+    void push(int value)
+    {
+        auto* node = new HazardNode{value};
+        node->next = m_top.load(std::memory_order_relaxed);
+        while (not m_top.compare_exchange_weak(node->next, node,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed))
+        {
+        }
+    }
+
+    bool pop(int& value)
+    {
+        ohmy::hazard_pointer hazard = ohmy::make_hazard_pointer(m_domain);
+        for (;;)
+        {
+            HazardNode* node = hazard.protect(m_top);
+            if (node == nullptr)
+                return false;
+
+            HazardNode* next = node->next;
+            if (m_top.compare_exchange_strong(node, next))
+            {
+                value = node->value;
+                hazard.reset_protection();
+                node->retire({}, m_domain);
+                return true;
+            }
+        }
+    }
+
+private:
+    ohmy::hazard_pointer_domain& m_domain;
+    std::atomic<HazardNode*> m_top{nullptr};
+};
+
+unsigned stress_threads()
+{
+    const unsigned threads = std::thread::hardware_concurrency();
+    return threads < 4 ? 4 : (threads > 16 ? 16 : threads);
+}
+} // namespace
+
+// Retiring does not allocate, so it cannot fail.
+static_assert(noexcept(ohmy::declval<HazardNode&>().retire(
+    {}, ohmy::declval<ohmy::hazard_pointer_domain&>())));
+static_assert(noexcept(ohmy::declval<EpochNode&>().retire(
+    {}, ohmy::declval<ohmy::epoch_domain&>())));
+
+TEST_CASE("hazard pointers")
+{
+    live_nodes = 0;
+
+    SECTION("protected objects survive reclamation")
+    {
+        ohmy::hazard_pointer_domain domain;
+        std::atomic<HazardNode*> shared{new HazardNode{1}};
+
+        ohmy::hazard_pointer hazard = ohmy::make_hazard_pointer(domain);
+        REQUIRE_FALSE(hazard.empty());
+        HazardNode* node = hazard.protect(shared);
+        REQUIRE(node->value == 1);
+
+        shared.store(new HazardNode{2});
+        node->retire({}, domain);
+        domain.reclaim();
+        REQUIRE(domain.retired_count() == 1u);
+        REQUIRE(node->value == 1);
+
+        hazard.reset_protection();
+        domain.reclaim();
+        REQUIRE(domain.retired_count() == 0u);
+        REQUIRE(live_nodes == 1);
+
+        delete shared.load();
+    }
+
+    SECTION("try_protect fails when the source changed")
+    {
+        ohmy::hazard_pointer_domain domain;
+        HazardNode first{1};
+        HazardNode second{2};
+        std::atomic<HazardNode*> shared{&first};
+
+        ohmy::hazard_pointer hazard = ohmy::make_hazard_pointer(domain);
+        HazardNode* node = &second;
+        REQUIRE_FALSE(hazard.try_protect(node, shared));
+        REQUIRE(node == &first);
+        REQUIRE(hazard.try_protect(node, shared));
+    }
+
+    SECTION("hazard records are reused once released")
+    {
+        ohmy::hazard_pointer_domain domain;
+        ohmy::hazard_pointer first = ohmy::make_hazard_pointer(domain);
+        ohmy::hazard_pointer moved{ohmy::move(first)};
+        REQUIRE(first.empty());
+        REQUIRE_FALSE(moved.empty());
+
+        moved = ohmy::hazard_pointer{};
+        ohmy::hazard_pointer second = ohmy::make_hazard_pointer(domain);
+        REQUIRE_FALSE(second.empty());
+    }
+
+    SECTION("scans see every hazard record")
+    {
+        ohmy::hazard_pointer_domain domain;
+        std::vector<ohmy::hazard_pointer> hazards;
+        std::vector<std::atomic<HazardNode*>> shared(40);
+        for (auto& source : shared)
+        {
+            source.store(new HazardNode{1});
+            hazards.push_back(ohmy::make_hazard_pointer(domain));
+            hazards.back().protect(source);
+        }
+
+        for (auto& source : shared)
+            source.load()->retire({}, domain);
+        domain.reclaim();
+        REQUIRE(domain.retired_count() == shared.size());
+        REQUIRE(live_nodes == 40);
+
+        hazards.clear();
+        domain.reclaim();
+        REQUIRE(live_nodes == 0);
+    }
+
+    SECTION("retired objects are freed through their deleter")
+    {
+        int calls = 0;
+        {
+            ohmy::hazard_pointer_domain domain;
+            (new CustomNode)->retire(counting_delete{&calls}, domain);
+            (new CustomNode)->retire(counting_delete{&calls}, domain);
+            domain.reclaim();
+            REQUIRE(calls == 2);
+            (new CustomNode)->retire(counting_delete{&calls}, domain);
+        }
+        REQUIRE(calls == 3);
+    }
+
+    SECTION("concurrent stack reclaims every popped node")
+    {
+        constexpr int per_thread = 20000;
+        const unsigned threads = stress_threads();
+        std::atomic<long long> popped_sum{0};
+        {
+            ohmy::hazard_pointer_domain domain;
+            hazard_stack stack{domain};
+
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t)
+            {
+                workers.emplace_back([&] {
+                    long long sum = 0;
+                    for (int i = 1; i <= per_thread; ++i)
+                    {
+                        stack.push(i);
+                        int value = 0;
+                        if (stack.pop(value))
+                        {
+                            sum += value;
+                        }
+                    }
+                    popped_sum += sum;
+                });
+            }
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+
+            int value = 0;
+            while (stack.pop(value))
+            {
+                popped_sum += value;
+            }
+        }
+
+        const long long expected =
+            static_cast<long long>(per_thread) * (per_thread + 1) / 2 * threads;
+        REQUIRE(popped_sum == expected);
+        REQUIRE(live_nodes == 0);
+    }
+}
+
+TEST_CASE("epoch reclamation")
+{
+    live_nodes = 0;
+
+    SECTION("a pinned reader holds back reclamation")
+    {
+        ohmy::epoch_domain domain{4};
+        auto* first = new EpochNode{1};
+        {
+            ohmy::epoch_guard guard = domain.pin();
+            first->retire({}, domain);
+            for (std::size_t i = 0; i < 4 * ohmy::epoch_domain::batch_size;
+                 ++i)
+            {
+                (new EpochNode{2})->retire({}, domain);
+            }
+            REQUIRE(first->value == 1);
+            REQUIRE(live_nodes > 1);
+        }
+
+        domain.synchronize();
+        REQUIRE(live_nodes == 0);
+    }
+
+    SECTION("retired objects are freed with the domain")
+    {
+        {
+            ohmy::epoch_domain domain{2};
+            (new EpochNode{1})->retire({}, domain);
+            REQUIRE(live_nodes == 1);
+        }
+        REQUIRE(live_nodes == 0);
+    }
+
+    SECTION("readers never observe freed objects")
+    {
+        constexpr int updates = 20000;
+        const unsigned readers = stress_threads() - 1;
+        {
+            ohmy::epoch_domain domain;
+            std::atomic<EpochNode*> shared{new EpochNode{0}};
+            std::atomic<bool> done{false};
+            std::atomic<int> bad_reads{0};
+
+            std::vector<std::thread> threads;
+            for (unsigned t = 0; t < readers; ++t)
+            {
+                threads.emplace_back([&] {
+                    while (not done.load(std::memory_order_relaxed))
+                    {
+                        ohmy::epoch_guard guard = domain.pin();
+                        EpochNode* node =
+                            shared.load(std::memory_order_acquire);
+                        if (node->value < 0)
+                        {
+                            ++bad_reads;
+                        }
+                    }
+                });
+            }
+
+            for (int i = 1; i <= updates; ++i)
+            {
+                EpochNode* old = shared.exchange(new EpochNode{i});
+                old->retire({}, domain);
+            }
+            done = true;
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            REQUIRE(bad_reads == 0);
+            domain.synchronize();
+            REQUIRE(live_nodes == 1);
+            delete shared.load();
+        }
+        REQUIRE(live_nodes == 0);
+    }
+}
+
+TEST_CASE("reclamation benchmarks", "[.benchmark]")
+{
+    constexpr int reads_per_thread = 1 << 20;
+    const unsigned threads = std::thread::hardware_concurrency() != 0
+                                 ? std::thread::hardware_concurrency()
+                                 : 4;
+
+    std::atomic<long long> total{0};
+    auto run_readers = [&](auto read) {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&] {
+                long long sum = 0;
+                for (int i = 0; i < reads_per_thread; ++i)
+                {
+                    sum += read();
+                }
+                total += sum;
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    };
+
+    std::mutex mutex;
+    auto locked = std::make_shared<int>(1);
+    BENCHMARK("mutex-protected std::shared_ptr read")
+    {
+        run_readers([&] {
+            std::shared_ptr<int> copy;
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                copy = locked;
+            }
+            return *copy;
+        });
+    }
+
+    ohmy::hazard_pointer_domain hazard_domain;
+    std::atomic<HazardNode*> hazard_shared{new HazardNode{1}};
+    BENCHMARK("hazard pointer protected read")
+    {
+        run_readers([&] {
+            thread_local ohmy::hazard_pointer hazard =
+                ohmy::make_hazard_pointer(hazard_domain);
+            int value = hazard.protect(hazard_shared)->value;
+            hazard.reset_protection();
+            return value;
+        });
+    }
+    delete hazard_shared.load();
+
+    ohmy::epoch_domain epoch_domain;
+    std::atomic<EpochNode*> epoch_shared{new EpochNode{1}};
+    BENCHMARK("epoch pinned read")
+    {
+        run_readers([&] {
+            ohmy::epoch_guard guard = epoch_domain.pin();
+            return epoch_shared.load(std::memory_order_acquire)->value;
+        });
+    }
+    delete epoch_shared.load();
+
+    REQUIRE(total > 0);
+}
@@ -0,0 +1,615 @@
+#ifndef OHMY_SIGNAL_HPP
+#define OHMY_SIGNAL_HPP
+
+#include "c++config.hpp"
+#include "functional.hpp"
+#include "reclamation.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// Signals fan an event out to a list of connected slots. The slots of a
+// signal are stored the way function stores its target, in an any_data
+// with a function_vtable, but field by field in parallel arrays: emitting
+// walks the invoker and functor arrays as a loop of indirect calls, and
+// neither emitting nor disconnecting allocates.
+//
+// Slots are called with the emitted arguments as const lvalues, in the
+// order they were connected, and have to be copy constructible like the
+// targets of function.
+namespace ohmy
+{
+namespace detail
+{
+template <typename Functor, typename... ArgumentTypes>
+void invoke_slot(const any_data& functor, const ArgumentTypes&... arguments)
+{
+    ohmy::invoke(*function_base::base_manager<Functor>::get_pointer(functor),
+                 arguments...);
+}
+
+// Stands in for a slot disconnected while the signal is being emitted,
+// until the emission is over and the slot can be destroyed.
+template <typename... ArgumentTypes>
+void skip_slot(const any_data&, const ArgumentTypes&...) noexcept
+{
+}
+
+template <typename Vector>
+void reserve_for(Vector& values, size_t required)
+{
+    if (required > values.capacity())
+    {
+        const size_t doubled = 2 * values.capacity();
+        values.reserve(doubled < required ? required : doubled);
+    }
+}
+
+template <typename... ArgumentTypes>
+class slot_table
+{
+public:
+    using invoker_type = void (*)(const any_data&, const ArgumentTypes&...);
+
+    slot_table() = default;
+
+    slot_table(const slot_table& other)
+    {
+        reserve_for_more(other.size());
+        for (size_t i = 0; i < other.size(); ++i)
+        {
+            any_data copy;
+            if (other.m_vtables[i]->clone != nullptr)
+            {
+                other.m_vtables[i]->clone(copy, other.m_functors[i]);
+            }
+            else
+            {
+                copy = other.m_functors[i];
+            }
+            append(other.m_invokers[i], copy, other.m_vtables[i],
+                   other.m_ids[i]);
+        }
+    }
+
+    slot_table& operator=(const slot_table&) = delete;
+
+    ~slot_table()
+    {
+        for (size_t i = 0; i < size(); ++i)
+        {
+            destroy(i);
+        }
+    }
+
+    size_t size() const noexcept
+    {
+        return m_ids.size();
+    }
+
+    // The four arrays are grown together ahead of an append, which then
+    // cannot fail halfway.
+    void reserve_for_more(size_t count)
+    {
+        const size_t required = size() + count;
+        reserve_for(m_invokers, required);
+        reserve_for(m_functors, required);
+        reserve_for(m_vtables, required);
+        reserve_for(m_ids, required);
+    }
+
+    template <typename Functor>
+    void emplace(Functor f, uint64_t id)
+    {
+        using manager = function_base::base_manager<Functor>;
+
+        reserve_for_more(1);
+        any_data functor;
+        manager::init_functor(functor, ohmy::move(f));
+        append(&invoke_slot<Functor, ArgumentTypes...>, functor,
+               &manager::table, id);
+    }
+
+    // Transfers the slots of other, which is left empty. The functors are
+    // moved bitwise, as function moves its target.
+    void splice(slot_table& other)
+    {
+        reserve_for_more(other.size());
+        for (size_t i = 0; i < other.size(); ++i)
+        {
+            append(other.m_invokers[i], other.m_functors[i],
+                   other.m_vtables[i], other.m_ids[i]);
+        }
+        other.m_invokers.clear();
+        other.m_functors.clear();
+        other.m_vtables.clear();
+        other.m_ids.clear();
+    }
+
+    // Index of the slot connected under id, or size() if there is none.
+    size_t find(uint64_t id) const noexcept
+    {
+        size_t i = 0;
+        while (i < size() and m_ids[i] != id)
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    // Keeps the slot in place, so an emission walking the table is not
+    // disturbed, but makes it a no-op that erase_skipped will remove.
+    void skip(size_t index) noexcept
+    {
+        m_invokers[index] = &skip_slot<ArgumentTypes...>;
+        m_ids[index] = 0;
+    }
+
+    void erase(size_t index) noexcept
+    {
+        destroy(index);
+        m_invokers.erase(m_invokers.begin() + index);
+        m_functors.erase(m_functors.begin() + index);
+        m_vtables.erase(m_vtables.begin() + index);
+        m_ids.erase(m_ids.begin() + index);
+    }
+
+    void erase_skipped() noexcept
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < size(); ++i)
+        {
+            if (m_ids[i] == 0)
+            {
+                destroy(i);
+                continue;
+            }
+            m_invokers[kept] = m_invokers[i];
+            m_functors[kept] = m_functors[i];
+            m_vtables[kept] = m_vtables[i];
+            m_ids[kept] = m_ids[i];
+            ++kept;
+        }
+        m_invokers.resize(kept);
+        m_functors.resize(kept);
+        m_vtables.resize(kept);
+        m_ids.resize(kept);
+    }
+
+    // Calls the first count slots. The arrays are indexed afresh on every
+    // iteration, since a slot may disconnect others.
+    void call(size_t count, const ArgumentTypes&... arguments) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_invokers[i](m_functors[i], arguments...);
+        }
+    }
+
+private:
+    void append(invoker_type invoker, const any_data& functor,
+                const function_vtable* vtable, uint64_t id) noexcept
+    {
+        m_invokers.push_back(invoker);
+        m_functors.push_back(functor);
+        m_vtables.push_back(vtable);
+        m_ids.push_back(id);
+    }
+
+    void destroy(size_t index) noexcept
+    {
+        if (m_vtables[index]->destroy != nullptr)
+        {
+            m_vtables[index]->destroy(m_functors[index]);
+        }
+    }
+
+    vector<invoker_type> m_invokers;
+    vector<any_data> m_functors;
+    vector<const function_vtable*> m_vtables;
+    vector<uint64_t> m_ids;
+};
+
+struct connection_operations
+{
+    bool (*disconnect)(void* owner, uint64_t id) noexcept;
+    bool (*connected)(const void* owner, uint64_t id) noexcept;
+};
+
+template <typename Signal>
+struct signal_connection_operations
+{
+    static bool disconnect(void* owner, uint64_t id) noexcept
+    {
+        return static_cast<Signal*>(owner)->disconnect(id);
+    }
+
+    static bool connected(const void* owner, uint64_t id) noexcept
+    {
+        return static_cast<const Signal*>(owner)->connected(id);
+    }
+
+    static constexpr connection_operations table{&disconnect, &connected};
+};
+} // namespace detail
+
+// Refers to a slot connected to a signal, which has to outlive it.
+class connection
+{
+public:
+    connection() noexcept = default;
+
+    // Returns whether the slot was still connected.
+    bool disconnect() const noexcept
+    {
+        return m_operations != nullptr and
+               m_operations->disconnect(m_owner, m_id);
+    }
+
+    bool connected() const noexcept
+    {
+        return m_operations != nullptr and
+               m_operations->connected(m_owner, m_id);
+    }
+
+private:
+    template <typename Signature>
+    friend class signal;
+    template <typename Signature>
+    friend class concurrent_signal;
+
+    connection(void* owner, const detail::connection_operations& operations,
+               uint64_t id) noexcept
+        : m_owner{owner}, m_operations{&operations}, m_id{id}
+    {
+    }
+
+    void* m_owner = nullptr;
+    const detail::connection_operations* m_operations = nullptr;
+    uint64_t m_id = 0;
+};
+
+// Disconnects its slot when it goes out of scope.
+class scoped_connection
+{
+public:
+    scoped_connection() noexcept = default;
+
+    scoped_connection(const connection& slot) noexcept : m_connection{slot}
+    {
+    }
+
+    scoped_connection(scoped_connection&& other) noexcept
+        : m_connection{other.release()}
+    {
+    }
+
+    scoped_connection& operator=(scoped_connection&& other) noexcept
+    {
+        if (this != ohmy::addressof(other))
+        {
+            m_connection.disconnect();
+            m_connection = other.release();
+        }
+        return *this;
+    }
+
+    ~scoped_connection()
+    {
+        m_connection.disconnect();
+    }
+
+    scoped_connection(const scoped_connection&) = delete;
+    scoped_connection& operator=(const scoped_connection&) = delete;
+
+    // Gives up ownership without disconnecting.
+    connection release() noexcept
+    {
+        connection slot = m_connection;
+        m_connection = connection{};
+        return slot;
+    }
+
+    bool disconnect() noexcept
+    {
+        return release().disconnect();
+    }
+
+    bool connected() const noexcept
+    {
+        return m_connection.connected();
+    }
+
+private:
+    connection m_connection;
+};
+
+template <typename Signature>
+class signal;
+
+// A signal for a single thread. Slots may connect and disconnect any slot,
+// including themselves, while the signal is being emitted: a disconnected
+// slot is not called again, even later in the same emission, and a slot
+// connected during an emission is first called by the next one.
+template <typename... ArgumentTypes>
+class signal<void(ArgumentTypes...)>
+{
+    using table_type = detail::slot_table<ArgumentTypes...>;
+
+    template <typename Functor>
+    using slot = enable_if_t<
+        is_invocable_v<decay_t<Functor>&, const ArgumentTypes&...>>;
+
+public:
+    signal() = default;
+
+    // No emission may be in progress.
+    ~signal() = default;
+
+    signal(const signal&) = delete;
+    signal& operator=(const signal&) = delete;
+
+    template <typename Functor, typename = slot<Functor>>
+    connection connect(Functor f)
+    {
+        table_type& slots = m_emissions == 0 ? m_slots : m_connected_late;
+        slots.emplace(ohmy::move(f), m_next_id);
+        return connection{this, operations::table, m_next_id++};
+    }
+
+    void operator()(const ArgumentTypes&... arguments)
+    {
+        emission_scope scope{*this};
+        m_slots.call(m_slots.size(), arguments...);
+    }
+
+    bool disconnect(const connection& slot) noexcept
+    {
+        return slot.m_owner == this and disconnect(slot.m_id);
+    }
+
+    // Slots connected during an emission are only counted once it is over.
+    size_t size() const noexcept
+    {
+        return m_slots.size() - m_skipped;
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+private:
+    friend struct detail::signal_connection_operations<signal>;
+    using operations = detail::signal_connection_operations<signal>;
+
+    // Slots disconnected during an emission are destroyed, and slots
+    // connected during it joined, once the outermost emission is over.
+    class emission_scope
+    {
+    public:
+        explicit emission_scope(signal& emitted) noexcept : m_signal{emitted}
+        {
+            ++m_signal.m_emissions;
+        }
+
+        ~emission_scope()
+        {
+            if (--m_signal.m_emissions == 0)
+            {
+                m_signal.settle();
+            }
+        }
+
+        emission_scope(const emission_scope&) = delete;
+        emission_scope& operator=(const emission_scope&) = delete;
+
+    private:
+        signal& m_signal;
+    };
+
+    bool disconnect(uint64_t id) noexcept
+    {
+        size_t index = m_slots.find(id);
+        if (index != m_slots.size())
+        {
+            if (m_emissions == 0)
+            {
+                m_slots.erase(index);
+            }
+            else
+            {
+                m_slots.skip(index);
+                ++m_skipped;
+            }
+            return true;
+        }
+
+        index = m_connected_late.find(id);
+        if (index != m_connected_late.size())
+        {
+            m_connected_late.erase(index);
+            return true;
+        }
+        return false;
+    }
+
+    bool connected(uint64_t id) const noexcept
+    {
+        return m_slots.find(id) != m_slots.size() or
+               m_connected_late.find(id) != m_connected_late.size();
+    }
+
+    void settle() noexcept
+    {
+        if (m_skipped != 0)
+        {
+            m_slots.erase_skipped();
+            m_skipped = 0;
+        }
+        if (m_connected_late.size() != 0)
+        {
+            // Leaves the late slots where they are if the table cannot
+            // grow; they join with the next emission that can.
+            try
+            {
+                m_slots.splice(m_connected_late);
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+    table_type m_slots;
+    table_type m_connected_late;
+    size_t m_skipped = 0;
+    unsigned m_emissions = 0;
+    uint64_t m_next_id = 1;
+};
+
+template <typename Signature>
+class concurrent_signal;
+
+// A signal that any number of threads may emit at the same time, without
+// locking, while others connect and disconnect slots. Emitting pins an
+// epoch_domain and calls the slots of the current immutable table.
+// Connecting and disconnecting serialize on a mutex, publish a copy of the
+// table with the slot added or removed, and retire the old one, so they
+// cost a copy of every slot and suit subscriber lists that change rarely.
+//
+// An emission calls the slots that were connected when it started: a slot
+// may still be called by emissions that were already running when it was
+// disconnected. Slots run concurrently with themselves and have to be
+// safe to.
+template <typename... ArgumentTypes>
+class concurrent_signal<void(ArgumentTypes...)>
+{
+    using table_type = detail::slot_table<ArgumentTypes...>;
+
+    template <typename Functor>
+    using slot = enable_if_t<
+        is_invocable_v<decay_t<Functor>&, const ArgumentTypes&...>>;
+
+public:
+    explicit concurrent_signal(epoch_domain& domain = default_epoch_domain())
+        : m_domain{domain}, m_snapshot{new snapshot}
+    {
+    }
+
+    // No thread may be emitting or connecting.
+    ~concurrent_signal()
+    {
+        delete m_snapshot.load(std::memory_order_relaxed);
+    }
+
+    concurrent_signal(const concurrent_signal&) = delete;
+    concurrent_signal& operator=(const concurrent_signal&) = delete;
+
+    template <typename Functor, typename = slot<Functor>>
+    connection connect(Functor f)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        auto* next = new snapshot{current()};
+        try
+        {
+            next->slots.emplace(ohmy::move(f), m_next_id);
+        }
+        catch (...)
+        {
+            delete next;
+            throw;
+        }
+        publish(next);
+        return connection{this, operations::table, m_next_id++};
+    }
+
+    void operator()(const ArgumentTypes&... arguments) const
+    {
+        const epoch_guard guard = m_domain.pin();
+        const table_type& slots =
+            m_snapshot.load(std::memory_order_acquire)->slots;
+        slots.call(slots.size(), arguments...);
+    }
+
+    bool disconnect(const connection& slot) noexcept
+    {
+        return slot.m_owner == this and disconnect(slot.m_id);
+    }
+
+    size_t size() const noexcept
+    {
+        const epoch_guard guard = m_domain.pin();
+        return m_snapshot.load(std::memory_order_acquire)->slots.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+private:
+    friend struct detail::signal_connection_operations<concurrent_signal>;
+    using operations =
+        detail::signal_connection_operations<concurrent_signal>;
+
+    struct snapshot : epoch_obj_base<snapshot>
+    {
+        snapshot() = default;
+
+        explicit snapshot(const snapshot& other)
+            : epoch_obj_base<snapshot>{}, slots{other.slots}
+        {
+        }
+
+        table_type slots;
+    };
+
+    // Only called with the mutex held, which keeps the snapshot alive.
+    const snapshot& current() const noexcept
+    {
+        return *m_snapshot.load(std::memory_order_relaxed);
+    }
+
+    void publish(snapshot* next) noexcept
+    {
+        snapshot* previous =
+            m_snapshot.exchange(next, std::memory_order_acq_rel);
+        previous->retire(default_delete<snapshot>(), m_domain);
+    }
+
+    // Publishing the smaller table allocates, and running out of memory
+    // here terminates like any other failure inside a noexcept function.
+    bool disconnect(uint64_t id) noexcept
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        const size_t index = current().slots.find(id);
+        if (index == current().slots.size())
+        {
+            return false;
+        }
+
+        auto* next = new snapshot{current()};
+        next->slots.erase(index);
+        publish(next);
+        return true;
+    }
+
+    bool connected(uint64_t id) const noexcept
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return current().slots.find(id) != current().slots.size();
+    }
+
+    epoch_domain& m_domain;
+    std::atomic<snapshot*> m_snapshot;
+    mutable std::mutex m_mutex;
+    uint64_t m_next_id = 1;
+};
+} // namespace ohmy
+
+#endif // OHMY_SIGNAL_HPP
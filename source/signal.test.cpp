@@ -0,0 +1,298 @@
+#include <catch/catch.hpp>
+
+#include "allocation_tracking.hpp"
+#include "signal.hpp"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Tick
+{
+    int instrument;
+    double price;
+};
+
+// Too large to be stored locally, and counts its live copies.
+struct LargeSlot
+{
+    explicit LargeSlot(int& live) : live{&live}
+    {
+        ++*this->live;
+    }
+
+    LargeSlot(const LargeSlot& other) : live{other.live}, padding{}
+    {
+        ++*live;
+    }
+
+    ~LargeSlot()
+    {
+        --*live;
+    }
+
+    void operator()(const Tick&) const
+    {
+    }
+
+    int* live;
+    std::array<char, 64> padding{};
+};
+} // namespace
+
+TEST_CASE("signal")
+{
+    ohmy::signal<void(const Tick&)> ticks;
+    std::vector<int> calls;
+
+    SECTION("slots are called in connection order")
+    {
+        REQUIRE(ticks.empty());
+        ticks.connect([&](const Tick&) { calls.push_back(1); });
+        ticks.connect([&](const Tick& tick) {
+            calls.push_back(tick.instrument);
+        });
+        REQUIRE(ticks.size() == 2u);
+
+        ticks(Tick{7, 1.5});
+        REQUIRE(calls == std::vector<int>{1, 7});
+    }
+
+    SECTION("connections disconnect their slot once")
+    {
+        ohmy::connection first =
+            ticks.connect([&](const Tick&) { calls.push_back(1); });
+        ticks.connect([&](const Tick&) { calls.push_back(2); });
+
+        REQUIRE(first.connected());
+        REQUIRE(first.disconnect());
+        REQUIRE_FALSE(first.connected());
+        REQUIRE_FALSE(first.disconnect());
+        REQUIRE_FALSE(ohmy::connection{}.disconnect());
+
+        ticks(Tick{});
+        REQUIRE(calls == std::vector<int>{2});
+    }
+
+    SECTION("scoped connections disconnect when they go out of scope")
+    {
+        {
+            ohmy::scoped_connection scoped =
+                ticks.connect([&](const Tick&) { calls.push_back(1); });
+            ticks(Tick{});
+        }
+        ticks(Tick{});
+        REQUIRE(calls == std::vector<int>{1});
+        REQUIRE(ticks.empty());
+    }
+
+    SECTION("slots may disconnect themselves and others while emitting")
+    {
+        ohmy::connection self;
+        ohmy::connection later;
+        self = ticks.connect([&](const Tick&) {
+            calls.push_back(1);
+            self.disconnect();
+            later.disconnect();
+        });
+        later = ticks.connect([&](const Tick&) { calls.push_back(2); });
+        ticks.connect([&](const Tick&) { calls.push_back(3); });
+
+        ticks(Tick{});
+        REQUIRE(calls == std::vector<int>{1, 3});
+        REQUIRE(ticks.size() == 1u);
+
+        ticks(Tick{});
+        REQUIRE(calls == std::vector<int>{1, 3, 3});
+    }
+
+    SECTION("slots connected while emitting are called from the next emission")
+    {
+        ohmy::connection late;
+        ticks.connect([&](const Tick&) {
+            calls.push_back(1);
+            if (not late.connected())
+            {
+                late = ticks.connect([&](const Tick&) { calls.push_back(2); });
+            }
+        });
+
+        ticks(Tick{});
+        REQUIRE(calls == std::vector<int>{1});
+        REQUIRE(late.connected());
+
+        ticks(Tick{});
+        REQUIRE(calls == std::vector<int>{1, 1, 2});
+    }
+
+    SECTION("emissions nest")
+    {
+        ticks.connect([&](const Tick& tick) {
+            calls.push_back(tick.instrument);
+            if (tick.instrument > 0)
+            {
+                ticks(Tick{tick.instrument - 1, 0});
+            }
+        });
+        ticks(Tick{2, 0});
+        REQUIRE(calls == std::vector<int>{2, 1, 0});
+    }
+
+    SECTION("emitting and disconnecting do not allocate")
+    {
+        int sum = 0;
+        std::vector<ohmy::connection> connections;
+        for (int i = 0; i < 32; ++i)
+        {
+            connections.push_back(
+                ticks.connect([&sum, i](const Tick&) { sum += i; }));
+        }
+
+        ohmy::allocation_scope scope;
+        ticks(Tick{});
+        for (const ohmy::connection& slot : connections)
+        {
+            slot.disconnect();
+        }
+        ticks(Tick{});
+        REQUIRE(scope.allocations() == 0u);
+        REQUIRE(sum == 31 * 32 / 2);
+    }
+
+    SECTION("large slots are destroyed once")
+    {
+        int live = 0;
+        {
+            ohmy::signal<void(const Tick&)> owner;
+            ohmy::connection slot = owner.connect(LargeSlot{live});
+            owner.connect(LargeSlot{live});
+            REQUIRE(live == 2);
+
+            owner.connect([&](const Tick&) { slot.disconnect(); });
+            owner(Tick{});
+            REQUIRE(live == 1);
+        }
+        REQUIRE(live == 0);
+    }
+}
+
+TEST_CASE("concurrent_signal")
+{
+    SECTION("slots and connections behave as for signal")
+    {
+        ohmy::concurrent_signal<void(int)> values;
+        std::vector<int> calls;
+        ohmy::connection first =
+            values.connect([&](int value) { calls.push_back(value); });
+        values.connect([&](int value) { calls.push_back(-value); });
+        values(3);
+
+        REQUIRE(first.disconnect());
+        REQUIRE_FALSE(first.connected());
+        values(4);
+        REQUIRE(calls == std::vector<int>{3, -3, -4});
+        REQUIRE(values.size() == 1u);
+    }
+
+    SECTION("large slots are destroyed once the domain reclaims them")
+    {
+        int live = 0;
+        ohmy::epoch_domain domain;
+        {
+            ohmy::concurrent_signal<void(const Tick&)> owner{domain};
+            ohmy::scoped_connection slot = owner.connect(LargeSlot{live});
+            owner(Tick{});
+        }
+        domain.synchronize();
+        REQUIRE(live == 0);
+    }
+
+    SECTION("emitters run while slots come and go")
+    {
+        ohmy::concurrent_signal<void(int)> values;
+        std::atomic<long> permanent{0};
+        std::atomic<long> transient{0};
+        values.connect([&](int value) { permanent += value; });
+
+        constexpr int emissions = 20000;
+        std::vector<std::thread> emitters;
+        for (int t = 0; t < 3; ++t)
+        {
+            emitters.emplace_back([&] {
+                for (int i = 0; i < emissions; ++i)
+                {
+                    values(1);
+                }
+            });
+        }
+
+        for (int i = 0; i < 200; ++i)
+        {
+            ohmy::scoped_connection slot =
+                values.connect([&](int value) { transient += value; });
+            std::this_thread::yield();
+        }
+        for (auto& emitter : emitters)
+        {
+            emitter.join();
+        }
+
+        REQUIRE(permanent == 3 * emissions);
+        REQUIRE(values.size() == 1u);
+    }
+}
+
+TEST_CASE("signal benchmarks", "[.benchmark]")
+{
+    constexpr int subscribers = 32;
+    constexpr int events = 100000;
+    std::array<long, subscribers> totals{};
+
+    std::vector<std::function<void(const Tick&)>> handlers;
+    ohmy::signal<void(const Tick&)> ticks;
+    ohmy::concurrent_signal<void(const Tick&)> shared_ticks;
+    for (int i = 0; i < subscribers; ++i)
+    {
+        auto handler = [&totals, i](const Tick& tick) {
+            totals[i] += tick.instrument;
+        };
+        handlers.push_back(handler);
+        ticks.connect(handler);
+        shared_ticks.connect(handler);
+    }
+
+    BENCHMARK("32 subscribers, vector of std::function")
+    {
+        for (int event = 0; event < events; ++event)
+        {
+            const Tick tick{event, 0};
+            for (const auto& handler : handlers)
+            {
+                handler(tick);
+            }
+        }
+    }
+
+    BENCHMARK("32 subscribers, ohmy::signal")
+    {
+        for (int event = 0; event < events; ++event)
+        {
+            ticks(Tick{event, 0});
+        }
+    }
+
+    BENCHMARK("32 subscribers, ohmy::concurrent_signal")
+    {
+        for (int event = 0; event < events; ++event)
+        {
+            shared_ticks(Tick{event, 0});
+        }
+    }
+
+    const long expected = 3L * events * (events - 1) / 2;
+    REQUIRE(totals[0] == expected);
+}
@@ -0,0 +1,528 @@
+#ifndef OHMY_SMALL_VECTOR_HPP
+#define OHMY_SMALL_VECTOR_HPP
+
+#include "c++config.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <initializer_list>
+#include <stdexcept>
+
+namespace ohmy
+{
+// A vector that keeps up to InlineCapacity elements inside the object and
+// only allocates once it grows past that. Moving between the inline buffer
+// and the heap relocates the elements, so for trivially relocatable types
+// (unique_ptr included) a spill or a move of an inline vector is a memcpy.
+template <typename Type, size_t InlineCapacity,
+          typename Allocator = allocator<Type>>
+class small_vector
+{
+    static constexpr bool reallocates_in_place =
+        is_trivially_relocatable_v<Type> and
+        detail::has_reallocate_v<Allocator>;
+
+public:
+    static constexpr size_t inline_size = InlineCapacity * sizeof(Type);
+    static constexpr size_t inline_align = __alignof__(Type);
+
+    using value_type = Type;
+    using allocator_type = Allocator;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = Type&;
+    using const_reference = const Type&;
+    using pointer = Type*;
+    using const_pointer = const Type*;
+    using iterator = Type*;
+    using const_iterator = const Type*;
+
+    static_assert(InlineCapacity > 0, "use ohmy::vector for no inline storage");
+    static_assert(is_same_v<typename Allocator::value_type, Type>,
+                  "allocator value_type must match the element type");
+
+    small_vector() noexcept(noexcept(Allocator())) : small_vector(Allocator())
+    {
+    }
+
+    explicit small_vector(const Allocator& alloc) noexcept
+        : m_allocator{alloc}, m_begin{inline_data()}, m_end{inline_data()},
+          m_capacity{inline_data() + InlineCapacity}
+    {
+    }
+
+    explicit small_vector(size_type count,
+                          const Allocator& alloc = Allocator())
+        : small_vector(alloc)
+    {
+        reserve(count);
+        m_end = ohmy::uninitialized_value_construct_n(m_begin, count);
+    }
+
+    small_vector(size_type count, const Type& value,
+                 const Allocator& alloc = Allocator())
+        : small_vector(alloc)
+    {
+        reserve(count);
+        m_end = ohmy::uninitialized_fill_n(m_begin, count, value);
+    }
+
+    small_vector(std::initializer_list<Type> values,
+                 const Allocator& alloc = Allocator())
+        : small_vector(alloc)
+    {
+        reserve(values.size());
+        m_end = ohmy::uninitialized_copy(values.begin(), values.end(), m_begin);
+    }
+
+    small_vector(const small_vector& other) : small_vector(other.m_allocator)
+    {
+        reserve(other.size());
+        m_end = ohmy::uninitialized_copy(other.cbegin(), other.cend(), m_begin);
+    }
+
+    small_vector(small_vector&& other) noexcept(is_nothrow_relocatable_v<Type>)
+        : small_vector(other.m_allocator)
+    {
+        take_elements(other);
+    }
+
+    ~small_vector()
+    {
+        ohmy::destroy(m_begin, m_end);
+        deallocate_storage();
+    }
+
+    small_vector& operator=(const small_vector& other)
+    {
+        if (this != ohmy::addressof(other))
+        {
+            small_vector copy(other);
+            *this = ohmy::move(copy);
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(
+        is_nothrow_relocatable_v<Type>)
+    {
+        if (this != ohmy::addressof(other))
+        {
+            ohmy::destroy(m_begin, m_end);
+            deallocate_storage();
+            m_begin = m_end = inline_data();
+            m_capacity = inline_data() + InlineCapacity;
+            m_allocator = other.m_allocator;
+            take_elements(other);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return m_allocator;
+    }
+
+    // True while the elements live in the inline buffer, i.e. nothing has
+    // been allocated.
+    bool uses_inline_storage() const noexcept
+    {
+        return m_begin == inline_data();
+    }
+
+    iterator begin() noexcept
+    {
+        return m_begin;
+    }
+    const_iterator begin() const noexcept
+    {
+        return m_begin;
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return m_begin;
+    }
+    iterator end() noexcept
+    {
+        return m_end;
+    }
+    const_iterator end() const noexcept
+    {
+        return m_end;
+    }
+    const_iterator cend() const noexcept
+    {
+        return m_end;
+    }
+
+    pointer data() noexcept
+    {
+        return m_begin;
+    }
+    const_pointer data() const noexcept
+    {
+        return m_begin;
+    }
+
+    size_type size() const noexcept
+    {
+        return static_cast<size_type>(m_end - m_begin);
+    }
+    size_type capacity() const noexcept
+    {
+        return static_cast<size_type>(m_capacity - m_begin);
+    }
+    size_type max_size() const noexcept
+    {
+        return size_type(-1) / sizeof(Type);
+    }
+    bool empty() const noexcept
+    {
+        return m_begin == m_end;
+    }
+
+    reference operator[](size_type pos)
+    {
+        return m_begin[pos];
+    }
+    const_reference operator[](size_type pos) const
+    {
+        return m_begin[pos];
+    }
+
+    reference at(size_type pos)
+    {
+        if (pos >= size())
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+        return m_begin[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+        return m_begin[pos];
+    }
+
+    reference front()
+    {
+        return *m_begin;
+    }
+    const_reference front() const
+    {
+        return *m_begin;
+    }
+    reference back()
+    {
+        return *(m_end - 1);
+    }
+    const_reference back() const
+    {
+        return *(m_end - 1);
+    }
+
+    void reserve(size_type new_capacity)
+    {
+        if (new_capacity > capacity())
+        {
+            reallocate_storage(new_capacity);
+        }
+    }
+
+    // Moves the elements back into the inline buffer when they fit there.
+    void shrink_to_fit()
+    {
+        if (uses_inline_storage() or m_end == m_capacity)
+            return;
+
+        if (size() <= InlineCapacity)
+        {
+            const size_type count = size();
+            const size_type old_capacity = capacity();
+            ohmy::uninitialized_relocate(m_begin, m_end, inline_data());
+            m_allocator.deallocate(m_begin, old_capacity);
+            m_begin = inline_data();
+            m_end = m_begin + count;
+            m_capacity = m_begin + InlineCapacity;
+        }
+        else
+        {
+            reallocate_storage(size());
+        }
+    }
+
+    void clear() noexcept
+    {
+        ohmy::destroy(m_begin, m_end);
+        m_end = m_begin;
+    }
+
+    void resize(size_type count)
+    {
+        if (count <= size())
+        {
+            erase(m_begin + count, m_end);
+            return;
+        }
+        if (count > capacity())
+        {
+            reserve(grown_capacity(count));
+        }
+        m_end = ohmy::uninitialized_value_construct_n(m_end, count - size());
+    }
+
+    void resize(size_type count, const Type& value)
+    {
+        if (count <= size())
+        {
+            erase(m_begin + count, m_end);
+            return;
+        }
+        if (count > capacity())
+        {
+            // value may live in the buffer that is about to be released.
+            const Type copy(value);
+            reserve(grown_capacity(count));
+            m_end = ohmy::uninitialized_fill_n(m_end, count - size(), copy);
+            return;
+        }
+        m_end = ohmy::uninitialized_fill_n(m_end, count - size(), value);
+    }
+
+    void push_back(const Type& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(Type&& value)
+    {
+        emplace_back(ohmy::move(value));
+    }
+
+    template <typename... ArgumentTypes>
+    reference emplace_back(ArgumentTypes&&... arguments)
+    {
+        if (m_end == m_capacity)
+        {
+            // The arguments may refer to elements that growth moves away.
+            detail::relocation_buffer<Type> value(
+                ohmy::forward<ArgumentTypes>(arguments)...);
+            reallocate_storage(grown_capacity(size() + 1));
+            ohmy::relocate_at(value.release(), m_end);
+            return *m_end++;
+        }
+        ohmy::construct_at(m_end, ohmy::forward<ArgumentTypes>(arguments)...);
+        return *m_end++;
+    }
+
+    void pop_back() noexcept
+    {
+        ohmy::destroy_at(--m_end);
+    }
+
+    iterator insert(const_iterator pos, const Type& value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, Type&& value)
+    {
+        return emplace(pos, ohmy::move(value));
+    }
+
+    template <typename... ArgumentTypes>
+    iterator emplace(const_iterator pos, ArgumentTypes&&... arguments)
+    {
+        const auto index = static_cast<size_type>(pos - m_begin);
+        detail::relocation_buffer<Type> value(
+            ohmy::forward<ArgumentTypes>(arguments)...);
+        if (m_end == m_capacity)
+        {
+            reallocate_storage(grown_capacity(size() + 1));
+        }
+
+        iterator position = m_begin + index;
+        if constexpr (is_trivially_relocatable_v<Type>)
+        {
+            ohmy::uninitialized_relocate(position, m_end, position + 1);
+            ohmy::relocate_at(value.release(), position);
+        }
+        else if (position == m_end)
+        {
+            ohmy::relocate_at(value.release(), position);
+        }
+        else
+        {
+            ohmy::construct_at(m_end, ohmy::move(*(m_end - 1)));
+            for (iterator it = m_end - 1; it != position; --it)
+            {
+                *it = ohmy::move(*(it - 1));
+            }
+            *position = ohmy::move(*value.get());
+        }
+        ++m_end;
+        return position;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator begin = m_begin + (first - m_begin);
+        iterator end = m_begin + (last - m_begin);
+        if (begin == end)
+        {
+            return begin;
+        }
+
+        if constexpr (is_trivially_relocatable_v<Type>)
+        {
+            ohmy::destroy(begin, end);
+            ohmy::uninitialized_relocate(end, m_end, begin);
+            m_end -= (end - begin);
+        }
+        else
+        {
+            iterator new_end = begin;
+            for (iterator it = end; it != m_end; ++it, ++new_end)
+            {
+                *new_end = ohmy::move(*it);
+            }
+            ohmy::destroy(new_end, m_end);
+            m_end = new_end;
+        }
+        return begin;
+    }
+
+    void swap(small_vector& other) noexcept(is_nothrow_relocatable_v<Type>)
+    {
+        small_vector tmp(ohmy::move(other));
+        other = ohmy::move(*this);
+        *this = ohmy::move(tmp);
+    }
+
+private:
+    pointer inline_data() noexcept
+    {
+        return reinterpret_cast<pointer>(m_inline);
+    }
+    const_pointer inline_data() const noexcept
+    {
+        return reinterpret_cast<const_pointer>(m_inline);
+    }
+
+    size_type grown_capacity(size_type required) const
+    {
+        if (required > max_size())
+            throw std::length_error(__PRETTY_FUNCTION__);
+
+        const size_type current = capacity();
+        if (current >= max_size() / 2)
+            return max_size();
+
+        const size_type doubled = 2 * current;
+        return doubled < required ? required : doubled;
+    }
+
+    void deallocate_storage() noexcept
+    {
+        if (not uses_inline_storage())
+        {
+            m_allocator.deallocate(m_begin, capacity());
+        }
+    }
+
+    // Steals other's heap buffer, or relocates its inline elements into ours.
+    // Expects this vector to be empty and inline.
+    void take_elements(small_vector& other) noexcept(
+        is_nothrow_relocatable_v<Type>)
+    {
+        if (other.uses_inline_storage())
+        {
+            m_end = ohmy::uninitialized_relocate(other.m_begin, other.m_end,
+                                                 m_begin);
+            other.m_end = other.m_begin;
+        }
+        else
+        {
+            m_begin = other.m_begin;
+            m_end = other.m_end;
+            m_capacity = other.m_capacity;
+            other.m_begin = other.m_end = other.inline_data();
+            other.m_capacity = other.inline_data() + InlineCapacity;
+        }
+    }
+
+    void reallocate_storage(size_type new_capacity)
+    {
+        const size_type count = size();
+        if constexpr (reallocates_in_place)
+        {
+            if (not uses_inline_storage())
+            {
+                m_begin =
+                    m_allocator.reallocate(m_begin, capacity(), new_capacity);
+                m_end = m_begin + count;
+                m_capacity = m_begin + new_capacity;
+                return;
+            }
+        }
+
+        pointer new_begin = m_allocator.allocate(new_capacity);
+        try
+        {
+            ohmy::uninitialized_relocate(m_begin, m_end, new_begin);
+        }
+        catch (...)
+        {
+            m_allocator.deallocate(new_begin, new_capacity);
+            throw;
+        }
+        deallocate_storage();
+        m_begin = new_begin;
+        m_end = new_begin + count;
+        m_capacity = new_begin + new_capacity;
+    }
+
+    [[no_unique_address]] Allocator m_allocator;
+    pointer m_begin;
+    pointer m_end;
+    pointer m_capacity;
+    alignas(inline_align) unsigned char m_inline[inline_size];
+};
+
+template <typename Type, size_t InlineCapacity, typename Allocator>
+bool operator==(const small_vector<Type, InlineCapacity, Allocator>& lhs,
+                const small_vector<Type, InlineCapacity, Allocator>& rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        if (not(lhs[i] == rhs[i]))
+            return false;
+    }
+    return true;
+}
+
+template <typename Type, size_t InlineCapacity, typename Allocator>
+bool operator!=(const small_vector<Type, InlineCapacity, Allocator>& lhs,
+                const small_vector<Type, InlineCapacity, Allocator>& rhs)
+{
+    return not(lhs == rhs);
+}
+
+template <typename Type, size_t InlineCapacity, typename Allocator>
+void swap(small_vector<Type, InlineCapacity, Allocator>& lhs,
+          small_vector<Type, InlineCapacity, Allocator>& rhs) noexcept(
+    is_nothrow_relocatable_v<Type>)
+{
+    lhs.swap(rhs);
+}
+} // namespace ohmy
+
+#endif // OHMY_SMALL_VECTOR_HPP
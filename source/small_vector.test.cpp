@@ -0,0 +1,133 @@
+#include <catch/catch.hpp>
+
+#include "small_vector.hpp"
+
+#include <string>
+
+namespace
+{
+std::size_t allocation_count = 0;
+
+template <typename Type>
+struct counting_allocator : ohmy::allocator<Type>
+{
+    using value_type = Type;
+
+    Type* allocate(std::size_t count)
+    {
+        ++allocation_count;
+        return ohmy::allocator<Type>::allocate(count);
+    }
+};
+} // namespace
+
+TEST_CASE("small_vector inline storage")
+{
+    SECTION("inline buffer is sized for the requested capacity")
+    {
+        using small = ohmy::small_vector<double, 3>;
+
+        REQUIRE(small::inline_size == 3 * sizeof(double));
+        REQUIRE(small::inline_align == alignof(double));
+        REQUIRE(small{}.capacity() == 3u);
+    }
+
+    SECTION("unique_ptrs up to the inline capacity do not allocate")
+    {
+        allocation_count = 0;
+        using pointer = ohmy::unique_ptr<int>;
+        ohmy::small_vector<pointer, 4, counting_allocator<pointer>> v;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            v.emplace_back(new int{i});
+        }
+
+        REQUIRE(allocation_count == 0u);
+        REQUIRE(v.uses_inline_storage());
+        for (int i = 0; i < 4; ++i)
+        {
+            REQUIRE(*v[i] == i);
+        }
+    }
+
+    SECTION("growing past the inline capacity spills to the heap")
+    {
+        allocation_count = 0;
+        ohmy::small_vector<std::string, 2, counting_allocator<std::string>> v{
+            "a", "b"};
+        v.push_back(v.front());
+
+        REQUIRE(allocation_count == 1u);
+        REQUIRE_FALSE(v.uses_inline_storage());
+        REQUIRE(v.size() == 3u);
+        REQUIRE(v[0] == "a");
+        REQUIRE(v[1] == "b");
+        REQUIRE(v[2] == "a");
+
+        v.pop_back();
+        v.shrink_to_fit();
+        REQUIRE(v.uses_inline_storage());
+        REQUIRE(v[1] == "b");
+    }
+}
+
+TEST_CASE("small_vector moves")
+{
+    SECTION("moving an inline vector relocates its elements")
+    {
+        ohmy::small_vector<ohmy::unique_ptr<int>, 4> a;
+        a.emplace_back(new int{1});
+        a.emplace_back(new int{2});
+
+        ohmy::small_vector<ohmy::unique_ptr<int>, 4> b{ohmy::move(a)};
+
+        REQUIRE(a.empty());
+        REQUIRE(b.uses_inline_storage());
+        REQUIRE(*b[0] == 1);
+        REQUIRE(*b[1] == 2);
+    }
+
+    SECTION("moving a heap vector steals the buffer")
+    {
+        ohmy::small_vector<int, 2> a{1, 2, 3, 4};
+        const int* data = a.data();
+
+        ohmy::small_vector<int, 2> b;
+        b = ohmy::move(a);
+
+        REQUIRE(b.data() == data);
+        REQUIRE(a.empty());
+        REQUIRE(a.uses_inline_storage());
+        REQUIRE(b == ohmy::small_vector<int, 2>{1, 2, 3, 4});
+    }
+
+    SECTION("swap exchanges inline and heap contents")
+    {
+        ohmy::small_vector<std::string, 2> a{"x"};
+        ohmy::small_vector<std::string, 2> b{"1", "2", "3"};
+
+        swap(a, b);
+
+        REQUIRE(a == ohmy::small_vector<std::string, 2>{"1", "2", "3"});
+        REQUIRE(b == ohmy::small_vector<std::string, 2>{"x"});
+    }
+}
+
+TEST_CASE("small_vector insert and erase")
+{
+    ohmy::small_vector<std::string, 3> v{"b", "d"};
+    v.insert(v.begin(), "a");
+    v.insert(v.begin() + 2, "c");
+    v.insert(v.end(), v.front());
+
+    REQUIRE(v == ohmy::small_vector<std::string, 3>{"a", "b", "c", "d", "a"});
+
+    v.erase(v.begin() + 1, v.begin() + 3);
+    REQUIRE(v == ohmy::small_vector<std::string, 3>{"a", "d", "a"});
+
+    ohmy::small_vector<int, 3> w{1, 3};
+    w.insert(w.begin() + 1, 2);
+    w.erase(w.begin());
+    REQUIRE(w == ohmy::small_vector<int, 3>{2, 3});
+}
@@ -0,0 +1,322 @@
+#ifndef OHMY_SPAN_HPP
+#define OHMY_SPAN_HPP
+
+#include "c++config.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+
+// A pointer and a count of the elements after it, for passing contiguous
+// memory around without the container it lives in. A static Extent makes
+// the count part of the type, so span<float, 4> is a single pointer.
+//
+// Anything with data() and size() converts implicitly to a span of the
+// same elements, which includes vectors, strings and string views, and
+// costs a copy of the two members. operator[] is unchecked; at, first,
+// last and subspan check their arguments against size() and throw
+// std::out_of_range.
+namespace ohmy
+{
+inline constexpr size_t dynamic_extent = static_cast<size_t>(-1);
+
+template <typename Type, size_t Extent = dynamic_extent>
+class span;
+
+namespace detail
+{
+template <size_t Extent>
+struct span_extent
+{
+    constexpr explicit span_extent(size_t) noexcept
+    {
+    }
+
+    static constexpr size_t size() noexcept
+    {
+        return Extent;
+    }
+};
+
+template <>
+struct span_extent<dynamic_extent>
+{
+    constexpr explicit span_extent(size_t size) noexcept : m_size{size}
+    {
+    }
+
+    constexpr size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    size_t m_size;
+};
+
+template <typename From, typename To>
+inline constexpr bool is_span_convertible_v = is_convertible_v<From (*)[],
+                                                               To (*)[]>;
+
+template <typename Type>
+inline constexpr bool is_span_v = false;
+
+template <typename Type, size_t Extent>
+inline constexpr bool is_span_v<span<Type, Extent>> = true;
+
+template <typename Container, typename = void>
+struct container_element
+{
+};
+
+template <typename Container>
+struct container_element<
+    Container, void_t<decltype(declval<Container&>().data()),
+                      decltype(declval<Container&>().size())>>
+{
+    using type =
+        remove_pointer_t<decltype(declval<Container&>().data())>;
+};
+
+// Whether Container is contiguous memory that a span of Type can view.
+template <typename Container, typename Type, typename = void>
+inline constexpr bool is_span_container_v = false;
+
+template <typename Container, typename Type>
+inline constexpr bool is_span_container_v<
+    Container, Type,
+    void_t<typename container_element<Container>::type>> =
+    not is_span_v<remove_cv_t<Container>> and
+    not is_array_v<remove_cv_t<Container>> and
+    is_span_convertible_v<typename container_element<Container>::type, Type>;
+
+template <size_t Extent, size_t Offset, size_t Count>
+inline constexpr size_t subspan_extent_v =
+    Count != dynamic_extent
+        ? Count
+        : (Extent != dynamic_extent ? Extent - Offset : dynamic_extent);
+} // namespace detail
+
+template <typename Type, size_t Extent>
+class span
+{
+public:
+    using element_type = Type;
+    using value_type = remove_cv_t<Type>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = Type*;
+    using const_pointer = const Type*;
+    using reference = Type&;
+    using const_reference = const Type&;
+    using iterator = Type*;
+
+    static constexpr size_t extent = Extent;
+
+    template <size_t Size = Extent,
+              typename = enable_if_t<Size == 0 or Size == dynamic_extent>>
+    constexpr span() noexcept : m_data{nullptr}, m_extent{0}
+    {
+    }
+
+    // A static extent has to match count, or this throws
+    // std::length_error.
+    constexpr span(pointer first, size_type count)
+        : m_data{first}, m_extent{count}
+    {
+        if (Extent != dynamic_extent and count != Extent)
+            throw std::length_error(__PRETTY_FUNCTION__);
+    }
+
+    constexpr span(pointer first, pointer last)
+        : span(first, static_cast<size_type>(last - first))
+    {
+    }
+
+    template <typename Other, size_t Size,
+              typename = enable_if_t<(Extent == dynamic_extent or
+                                      Extent == Size) and
+                                     detail::is_span_convertible_v<Other,
+                                                                   Type>>>
+    constexpr span(Other (&array)[Size]) noexcept
+        : m_data{array}, m_extent{Size}
+    {
+    }
+
+    // Temporaries convert only to spans of const elements, for passing
+    // them on to a function.
+    template <typename Container,
+              typename = enable_if_t<
+                  Extent == dynamic_extent and
+                  (is_lvalue_reference_v<Container> or is_const_v<Type>) and
+                  detail::is_span_container_v<remove_reference_t<Container>,
+                                              Type>>>
+    constexpr span(Container&& container) noexcept(
+        noexcept(container.data()) and noexcept(container.size()))
+        : m_data{container.data()}, m_extent{container.size()}
+    {
+    }
+
+    template <typename Other, size_t OtherExtent,
+              typename = enable_if_t<
+                  (Extent == dynamic_extent or Extent == OtherExtent) and
+                  detail::is_span_convertible_v<Other, Type>>>
+    constexpr span(const span<Other, OtherExtent>& other) noexcept
+        : m_data{other.data()}, m_extent{other.size()}
+    {
+    }
+
+    constexpr span(const span&) noexcept = default;
+    constexpr span& operator=(const span&) noexcept = default;
+
+    constexpr iterator begin() const noexcept
+    {
+        return m_data;
+    }
+
+    constexpr iterator end() const noexcept
+    {
+        return m_data + size();
+    }
+
+    constexpr reference operator[](size_type pos) const
+    {
+        return m_data[pos];
+    }
+
+    constexpr reference at(size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+        return m_data[pos];
+    }
+
+    constexpr reference front() const
+    {
+        return m_data[0];
+    }
+
+    constexpr reference back() const
+    {
+        return m_data[size() - 1];
+    }
+
+    constexpr pointer data() const noexcept
+    {
+        return m_data;
+    }
+
+    constexpr size_type size() const noexcept
+    {
+        return m_extent.size();
+    }
+
+    constexpr size_type size_bytes() const noexcept
+    {
+        return size() * sizeof(Type);
+    }
+
+    constexpr bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    template <size_t Count>
+    constexpr span<Type, Count> first() const
+    {
+        static_assert(Extent == dynamic_extent or Count <= Extent);
+        check(Count);
+        return span<Type, Count>(m_data, Count);
+    }
+
+    constexpr span<Type> first(size_type count) const
+    {
+        check(count);
+        return span<Type>(m_data, count);
+    }
+
+    template <size_t Count>
+    constexpr span<Type, Count> last() const
+    {
+        static_assert(Extent == dynamic_extent or Count <= Extent);
+        check(Count);
+        return span<Type, Count>(m_data + (size() - Count), Count);
+    }
+
+    constexpr span<Type> last(size_type count) const
+    {
+        check(count);
+        return span<Type>(m_data + (size() - count), count);
+    }
+
+    template <size_t Offset, size_t Count = dynamic_extent>
+    constexpr span<Type, detail::subspan_extent_v<Extent, Offset, Count>>
+    subspan() const
+    {
+        static_assert(Extent == dynamic_extent or
+                      (Offset <= Extent and
+                       (Count == dynamic_extent or Count <= Extent - Offset)));
+        check(Offset);
+        const size_type count = Count != dynamic_extent ? Count
+                                                        : size() - Offset;
+        check(Offset, count);
+        return span<Type, detail::subspan_extent_v<Extent, Offset, Count>>(
+            m_data + Offset, count);
+    }
+
+    constexpr span<Type> subspan(size_type offset,
+                                 size_type count = dynamic_extent) const
+    {
+        check(offset);
+        if (count == dynamic_extent)
+            count = size() - offset;
+        else
+            check(offset, count);
+        return span<Type>(m_data + offset, count);
+    }
+
+private:
+    constexpr void check(size_type end) const
+    {
+        if (end > size())
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+    }
+
+    // Written so that offset + count cannot wrap around.
+    constexpr void check(size_type offset, size_type count) const
+    {
+        if (offset > size() or count > size() - offset)
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+    }
+
+    pointer m_data;
+    [[no_unique_address]] detail::span_extent<Extent> m_extent;
+};
+
+template <typename Type, size_t Size>
+span(Type (&)[Size]) -> span<Type, Size>;
+
+template <typename Container>
+span(Container&&) -> span<typename detail::container_element<
+    remove_reference_t<Container>>::type>;
+
+template <typename Type, size_t Extent>
+span<const std::byte,
+     Extent == dynamic_extent ? dynamic_extent : sizeof(Type) * Extent>
+as_bytes(span<Type, Extent> values) noexcept
+{
+    return {reinterpret_cast<const std::byte*>(values.data()),
+            values.size_bytes()};
+}
+
+template <typename Type, size_t Extent,
+          typename = enable_if_t<not is_const_v<Type>>>
+span<std::byte,
+     Extent == dynamic_extent ? dynamic_extent : sizeof(Type) * Extent>
+as_writable_bytes(span<Type, Extent> values) noexcept
+{
+    return {reinterpret_cast<std::byte*>(values.data()), values.size_bytes()};
+}
+} // namespace ohmy
+
+#endif // OHMY_SPAN_HPP
@@ -0,0 +1,124 @@
+#include <catch/catch.hpp>
+
+#include "span.hpp"
+#include "string_view.hpp"
+#include "vector.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+float sum(ohmy::span<const float> values)
+{
+    float total = 0;
+    for (float value : values)
+        total += value;
+    return total;
+}
+
+size_t length(ohmy::span<const char> text)
+{
+    return text.size();
+}
+} // namespace
+
+// Static extents are only a pointer.
+static_assert(sizeof(ohmy::span<float, 4>) == sizeof(float*));
+static_assert(sizeof(ohmy::span<float>) == 2 * sizeof(float*));
+static_assert(ohmy::is_trivially_copiable_v<ohmy::span<int>>);
+
+static_assert(
+    ohmy::is_convertible_v<my::string_view, ohmy::span<const char>>);
+static_assert(not ohmy::is_convertible_v<my::string_view, ohmy::span<char>>);
+static_assert(
+    not ohmy::is_convertible_v<ohmy::span<const int>, ohmy::span<int>>);
+static_assert(not ohmy::is_convertible_v<ohmy::span<int>,
+                                         ohmy::span<int, 3>>);
+
+TEST_CASE("span")
+{
+    SECTION("views arrays, containers and string views")
+    {
+        float fixed[] = {1, 2, 3, 4};
+        ohmy::span view{fixed};
+        static_assert(decltype(view)::extent == 4);
+        REQUIRE(view.size() == 4u);
+        REQUIRE(sum(view) == 10.0f);
+
+        ohmy::vector<float> values{0.5f, 0.25f};
+        REQUIRE(sum(values) == 0.75f);
+
+        my::string_view text{"hello"};
+        ohmy::span<const char> chars = text;
+        REQUIRE(chars.data() == text.data());
+        REQUIRE(chars.size() == text.size());
+        REQUIRE(length(std::string{"four"}) == 4u);
+    }
+
+    SECTION("writes through to the memory it views")
+    {
+        int values[] = {1, 2, 3};
+        ohmy::span<int> view = values;
+        view[1] = 20;
+        view.back() = 30;
+        REQUIRE(values[1] == 20);
+        REQUIRE(values[2] == 30);
+        REQUIRE(view.at(0) == 1);
+        REQUIRE_THROWS_AS(view.at(3), std::out_of_range);
+    }
+
+    SECTION("first, last and subspan")
+    {
+        int values[] = {0, 1, 2, 3, 4, 5, 6, 7};
+        ohmy::span<int, 8> view{values};
+
+        auto head = view.first<3>();
+        static_assert(decltype(head)::extent == 3);
+        REQUIRE(head.back() == 2);
+
+        auto tail = view.last<2>();
+        REQUIRE(tail.front() == 6);
+
+        auto middle = view.subspan<2, 4>();
+        static_assert(decltype(middle)::extent == 4);
+        REQUIRE(middle.front() == 2);
+        REQUIRE(middle.back() == 5);
+
+        auto rest = view.subspan<5>();
+        static_assert(decltype(rest)::extent == 3);
+        REQUIRE(rest.front() == 5);
+
+        ohmy::span<int> dynamic = view;
+        REQUIRE(dynamic.first(2).back() == 1);
+        REQUIRE(dynamic.last(3).front() == 5);
+        REQUIRE(dynamic.subspan(3, 2).back() == 4);
+        REQUIRE(dynamic.subspan(8).empty());
+        REQUIRE_THROWS_AS(dynamic.subspan(9), std::out_of_range);
+        REQUIRE_THROWS_AS(dynamic.subspan(4, 5), std::out_of_range);
+        REQUIRE_THROWS_AS(dynamic.subspan(4, ohmy::dynamic_extent - 1),
+                          std::out_of_range);
+        REQUIRE_THROWS_AS(dynamic.first(9), std::out_of_range);
+    }
+
+    SECTION("static extents have to match")
+    {
+        int values[] = {1, 2, 3};
+        REQUIRE_THROWS_AS((ohmy::span<int, 2>{values, 3}), std::length_error);
+        REQUIRE((ohmy::span<int, 3>{values, values + 3}).back() == 3);
+    }
+
+    SECTION("bytes")
+    {
+        uint32_t values[] = {0x01020304u, 0u};
+        auto bytes = ohmy::as_bytes(ohmy::span{values});
+        static_assert(decltype(bytes)::extent == 8);
+        REQUIRE(bytes.size() == 8u);
+
+        auto writable = ohmy::as_writable_bytes(ohmy::span<uint32_t>{values});
+        writable[4] = std::byte{0xff};
+        REQUIRE(values[1] != 0u);
+        REQUIRE(ohmy::as_bytes(ohmy::span<const uint32_t>{values}).size() ==
+                8u);
+    }
+}
@@ -0,0 +1,173 @@
+#ifndef OHMY_SPSC_QUEUE_HPP
+#define OHMY_SPSC_QUEUE_HPP
+
+#include "c++config.hpp"
+#include "cache_padded.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <atomic>
+#include <stdexcept>
+
+namespace ohmy
+{
+namespace detail
+{
+// One side of a ring buffer: the index the side owns and its last
+// observation of the other side's index. Consulting the cached copy first
+// means the cache line holding the other index is only pulled over when
+// the ring looks full (or empty), not on every operation.
+struct ring_cursor
+{
+    std::atomic<size_t> position{0};
+    size_t cached_peer = 0;
+};
+
+// The smallest power of two no less than requested and no less than two.
+inline size_t ring_capacity(size_t requested)
+{
+    constexpr size_t largest = ~(~size_t{0} >> 1);
+    if (requested > largest)
+    {
+        throw std::length_error(__PRETTY_FUNCTION__);
+    }
+
+    size_t capacity = 2;
+    while (capacity < requested)
+    {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+} // namespace detail
+
+// A bounded lock-free queue for exactly one producer thread and one
+// consumer thread. Elements are constructed in place in a ring of slots
+// allocated up front, so handing over a move_only_function or a small
+// payload does not allocate. The indices grow monotonically and are
+// reduced modulo the capacity, which is rounded up to a power of two.
+//
+// try_push and try_emplace may only be called by the producer, try_pop by
+// the consumer.
+template <typename Type>
+class spsc_queue
+{
+public:
+    using value_type = Type;
+
+    explicit spsc_queue(size_t capacity)
+        : m_capacity{detail::ring_capacity(capacity)},
+          m_slots{allocator<Type>{}.allocate(m_capacity)}
+    {
+    }
+
+    ~spsc_queue()
+    {
+        const size_t head =
+            m_consumer->position.load(std::memory_order_relaxed);
+        const size_t tail =
+            m_producer->position.load(std::memory_order_relaxed);
+        for (size_t position = head; position != tail; ++position)
+        {
+            ohmy::destroy_at(slot(position));
+        }
+        allocator<Type>{}.deallocate(m_slots, m_capacity);
+    }
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    template <typename... ArgumentTypes>
+    bool try_emplace(ArgumentTypes&&... arguments) noexcept(
+        is_nothrow_constructible<Type, ArgumentTypes...>::value)
+    {
+        detail::ring_cursor& producer = m_producer.get();
+        const size_t tail = producer.position.load(std::memory_order_relaxed);
+        if (tail - producer.cached_peer == m_capacity)
+        {
+            producer.cached_peer =
+                m_consumer->position.load(std::memory_order_acquire);
+            if (tail - producer.cached_peer == m_capacity)
+            {
+                return false;
+            }
+        }
+
+        ohmy::construct_at(slot(tail),
+                           ohmy::forward<ArgumentTypes>(arguments)...);
+        producer.position.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const Type& value) noexcept(
+        is_nothrow_constructible<Type, const Type&>::value)
+    {
+        return try_emplace(value);
+    }
+
+    bool try_push(Type&& value) noexcept(
+        is_nothrow_move_constructible_v<Type>)
+    {
+        return try_emplace(ohmy::move(value));
+    }
+
+    // Moves the oldest element into destination. If the assignment throws
+    // the element stays in the queue.
+    bool try_pop(Type& destination) noexcept(
+        is_nothrow_move_assignable_v<Type>)
+    {
+        detail::ring_cursor& consumer = m_consumer.get();
+        const size_t head = consumer.position.load(std::memory_order_relaxed);
+        if (head == consumer.cached_peer)
+        {
+            consumer.cached_peer =
+                m_producer->position.load(std::memory_order_acquire);
+            if (head == consumer.cached_peer)
+            {
+                return false;
+            }
+        }
+
+        Type* source = slot(head);
+        destination = ohmy::move(*source);
+        ohmy::destroy_at(source);
+        consumer.position.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Snapshots that may be stale by the time they are used while the other
+    // thread is active.
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    size_t size() const noexcept
+    {
+        const size_t head =
+            m_consumer->position.load(std::memory_order_acquire);
+        const size_t tail =
+            m_producer->position.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+private:
+    Type* slot(size_t position) const noexcept
+    {
+        return m_slots + (position & (m_capacity - 1));
+    }
+
+    const size_t m_capacity;
+    Type* const m_slots;
+    cache_padded<detail::ring_cursor> m_producer;
+    cache_padded<detail::ring_cursor> m_consumer;
+};
+} // namespace ohmy
+
+#endif // OHMY_SPSC_QUEUE_HPP
@@ -0,0 +1,235 @@
+#include <catch/catch.hpp>
+
+#include "allocation_tracking.hpp"
+#include "functional.hpp"
+#include "memory.hpp"
+#include "spsc_queue.hpp"
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+struct Tracked
+{
+    static int live;
+
+    explicit Tracked(int v) noexcept : value{v}
+    {
+        ++live;
+    }
+    Tracked(Tracked&& other) noexcept : value{other.value}
+    {
+        ++live;
+    }
+    Tracked& operator=(Tracked&& other) noexcept
+    {
+        value = other.value;
+        return *this;
+    }
+    ~Tracked()
+    {
+        --live;
+    }
+
+    int value;
+};
+
+int Tracked::live = 0;
+} // namespace
+
+TEST_CASE("spsc_queue")
+{
+    SECTION("capacity is rounded up to a power of two")
+    {
+        REQUIRE(ohmy::spsc_queue<int>{0}.capacity() == 2u);
+        REQUIRE(ohmy::spsc_queue<int>{5}.capacity() == 8u);
+        REQUIRE(ohmy::spsc_queue<int>{64}.capacity() == 64u);
+        REQUIRE_THROWS_AS(ohmy::spsc_queue<int>{~std::size_t{0}},
+                          std::length_error);
+    }
+
+    SECTION("elements come out in order until the ring is empty")
+    {
+        ohmy::spsc_queue<int> queue{4};
+        for (int lap = 0; lap < 3; ++lap)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                REQUIRE(queue.try_push(lap * 10 + i));
+            }
+            REQUIRE_FALSE(queue.try_push(99));
+            REQUIRE(queue.size() == 4u);
+
+            int value = -1;
+            for (int i = 0; i < 4; ++i)
+            {
+                REQUIRE(queue.try_pop(value));
+                REQUIRE(value == lap * 10 + i);
+            }
+            REQUIRE_FALSE(queue.try_pop(value));
+            REQUIRE(queue.empty());
+        }
+    }
+
+    SECTION("move-only callables are handed over without allocating")
+    {
+        ohmy::spsc_queue<ohmy::move_only_function<int()>> queue{8};
+        auto payload = ohmy::make_unique<int>(5);
+
+        ohmy::allocation_scope scope;
+        REQUIRE(queue.try_emplace([p = ohmy::move(payload)] { return *p; }));
+        REQUIRE(queue.try_push([] { return 6; }));
+
+        ohmy::move_only_function<int()> task;
+        REQUIRE(queue.try_pop(task));
+        REQUIRE(task() == 5);
+        REQUIRE(queue.try_pop(task));
+        REQUIRE(task() == 6);
+        REQUIRE(scope.allocations() == 0u);
+    }
+
+    SECTION("elements left in the queue are destroyed with it")
+    {
+        Tracked::live = 0;
+        {
+            ohmy::spsc_queue<Tracked> queue{4};
+            queue.try_emplace(1);
+            queue.try_emplace(2);
+            queue.try_emplace(3);
+            Tracked out{0};
+            REQUIRE(queue.try_pop(out));
+            REQUIRE(out.value == 1);
+            REQUIRE(Tracked::live == 3);
+        }
+        REQUIRE(Tracked::live == 0);
+    }
+
+    SECTION("a producer and a consumer thread")
+    {
+        constexpr int count = 100000;
+        ohmy::spsc_queue<int> queue{64};
+
+        std::thread producer{[&] {
+            for (int i = 0; i < count; ++i)
+            {
+                while (not queue.try_push(i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }};
+
+        bool in_order = true;
+        for (int expected = 0; expected < count;)
+        {
+            int value;
+            if (queue.try_pop(value))
+            {
+                in_order = in_order and value == expected;
+                ++expected;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+
+        REQUIRE(in_order);
+        REQUIRE(queue.empty());
+    }
+}
+
+TEST_CASE("spsc_queue benchmarks", "[.benchmark]")
+{
+    constexpr int count = 1 << 20;
+
+    auto run = [](auto push, auto pop) {
+        std::thread producer{[&] {
+            for (int i = 0; i < count; ++i)
+            {
+                while (not push(i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }};
+        long long sum = 0;
+        for (int received = 0; received < count;)
+        {
+            if (pop(sum))
+            {
+                ++received;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        REQUIRE(sum == static_cast<long long>(count) * (count - 1) / 2);
+    };
+
+    BENCHMARK("mutex-protected std::deque<std::function>")
+    {
+        std::mutex mutex;
+        std::deque<std::function<void(long long&)>> queue;
+        run(
+            [&](int i) {
+                std::lock_guard<std::mutex> lock{mutex};
+                queue.emplace_back([i](long long& sum) { sum += i; });
+                return true;
+            },
+            [&](long long& sum) {
+                std::function<void(long long&)> task;
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    if (queue.empty())
+                    {
+                        return false;
+                    }
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                }
+                task(sum);
+                return true;
+            });
+    }
+
+    BENCHMARK("spsc_queue<move_only_function>")
+    {
+        ohmy::spsc_queue<ohmy::move_only_function<void(long long&)>> queue{
+            1024};
+        run(
+            [&](int i) {
+                return queue.try_emplace([i](long long& sum) { sum += i; });
+            },
+            [&](long long& sum) {
+                ohmy::move_only_function<void(long long&)> task;
+                if (not queue.try_pop(task))
+                {
+                    return false;
+                }
+                task(sum);
+                return true;
+            });
+    }
+
+    BENCHMARK("spsc_queue<int>")
+    {
+        ohmy::spsc_queue<int> queue{1024};
+        run([&](int i) { return queue.try_push(i); },
+            [&](long long& sum) {
+                int value;
+                if (not queue.try_pop(value))
+                {
+                    return false;
+                }
+                sum += value;
+                return true;
+            });
+    }
+}
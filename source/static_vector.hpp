@@ -0,0 +1,475 @@
+#ifndef OHMY_STATIC_VECTOR_HPP
+#define OHMY_STATIC_VECTOR_HPP
+
+#include "c++config.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+
+namespace ohmy
+{
+namespace detail
+{
+// Storage for trivial element types. A Type array has the same size and
+// alignment as the equivalent aligned byte array, but unlike one it can be
+// used in constant expressions, and it keeps the vector trivially copyable.
+// C++17 constexpr constructors have to initialize every member, so there
+// the elements start zeroed; from C++20 on only constant evaluation zeroes
+// them, and at run time constructing costs no more than setting the size.
+template <typename Type, size_t Capacity>
+struct static_vector_trivial_storage
+{
+#if __cpp_constexpr >= 201907L
+    constexpr static_vector_trivial_storage() noexcept
+    {
+        if (__builtin_is_constant_evaluated())
+        {
+            for (size_t i = 0; i < Capacity; ++i)
+            {
+                m_elements[i] = Type();
+            }
+        }
+    }
+#endif
+
+    constexpr Type* elements() noexcept
+    {
+        return m_elements;
+    }
+    constexpr const Type* elements() const noexcept
+    {
+        return m_elements;
+    }
+
+#if __cpp_constexpr >= 201907L
+    Type m_elements[Capacity];
+#else
+    Type m_elements[Capacity] = {};
+#endif
+    size_t m_size = 0;
+};
+
+// Storage for trivially copyable element types that are not trivial, such
+// as types with default member initializers. The elements are constructed
+// in place as for any other type, but the implicit copies and destructor
+// keep the vector trivially copyable.
+template <typename Type, size_t Capacity>
+struct static_vector_copyable_storage
+{
+    static_vector_copyable_storage() noexcept : m_size{0}
+    {
+    }
+
+    Type* elements() noexcept
+    {
+        return reinterpret_cast<Type*>(m_elements);
+    }
+    const Type* elements() const noexcept
+    {
+        return reinterpret_cast<const Type*>(m_elements);
+    }
+
+    alignas(Type) unsigned char m_elements[sizeof(Type) * Capacity];
+    size_t m_size;
+};
+
+template <typename Type, size_t Capacity>
+struct static_vector_storage
+{
+    static_vector_storage() noexcept : m_size{0}
+    {
+    }
+
+    static_vector_storage(const static_vector_storage& other) : m_size{0}
+    {
+        ohmy::uninitialized_copy(other.elements(),
+                                 other.elements() + other.m_size, elements());
+        m_size = other.m_size;
+    }
+
+    // Moving relocates the elements and leaves the source empty.
+    static_vector_storage(static_vector_storage&& other) noexcept(
+        is_nothrow_relocatable_v<Type>)
+        : m_size{0}
+    {
+        ohmy::uninitialized_relocate(
+            other.elements(), other.elements() + other.m_size, elements());
+        m_size = other.m_size;
+        other.m_size = 0;
+    }
+
+    static_vector_storage& operator=(const static_vector_storage& other)
+    {
+        if (this != ohmy::addressof(other))
+        {
+            clear();
+            ohmy::uninitialized_copy(
+                other.elements(), other.elements() + other.m_size, elements());
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    static_vector_storage& operator=(static_vector_storage&& other) noexcept(
+        is_nothrow_relocatable_v<Type>)
+    {
+        if (this != ohmy::addressof(other))
+        {
+            clear();
+            ohmy::uninitialized_relocate(
+                other.elements(), other.elements() + other.m_size, elements());
+            m_size = other.m_size;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    ~static_vector_storage()
+    {
+        clear();
+    }
+
+    void clear() noexcept
+    {
+        ohmy::destroy(elements(), elements() + m_size);
+        m_size = 0;
+    }
+
+    Type* elements() noexcept
+    {
+        return reinterpret_cast<Type*>(m_elements);
+    }
+    const Type* elements() const noexcept
+    {
+        return reinterpret_cast<const Type*>(m_elements);
+    }
+
+    alignas(Type) unsigned char m_elements[sizeof(Type) * Capacity];
+    size_t m_size;
+};
+
+template <typename Type, size_t Capacity>
+using static_vector_storage_t = conditional_t<
+    is_trivial_v<Type>, static_vector_trivial_storage<Type, Capacity>,
+    conditional_t<is_trivially_copiable_v<Type>,
+                  static_vector_copyable_storage<Type, Capacity>,
+                  static_vector_storage<Type, Capacity>>>;
+} // namespace detail
+
+// A vector with a fixed capacity that never allocates. The elements live
+// in the object, followed by the element count, so a static_vector of a
+// trivially copyable type is itself trivially copyable and standard-layout
+// and can be placed in shared memory or copied into a queue slot. For
+// trivial element types every operation is constexpr.
+//
+// push_back throws std::bad_alloc when the vector is full; try_push_back
+// and try_emplace_back return nullptr instead.
+template <typename Type, size_t Capacity>
+class static_vector : private detail::static_vector_storage_t<Type, Capacity>
+{
+    static constexpr bool trivial = is_trivial_v<Type>;
+
+public:
+    using value_type = Type;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = Type&;
+    using const_reference = const Type&;
+    using pointer = Type*;
+    using const_pointer = const Type*;
+    using iterator = Type*;
+    using const_iterator = const Type*;
+
+    static_assert(Capacity > 0, "static_vector needs a non-zero capacity");
+
+    constexpr static_vector() noexcept = default;
+
+    constexpr explicit static_vector(size_type count)
+    {
+        check_capacity(count);
+        if constexpr (trivial)
+        {
+            this->m_size = count;
+        }
+        else
+        {
+            ohmy::uninitialized_value_construct_n(data(), count);
+            this->m_size = count;
+        }
+    }
+
+    constexpr static_vector(size_type count, const Type& value)
+    {
+        check_capacity(count);
+        for (size_type i = 0; i < count; ++i)
+        {
+            unchecked_emplace_back(value);
+        }
+    }
+
+    constexpr static_vector(std::initializer_list<Type> values)
+    {
+        check_capacity(values.size());
+        for (const Type& value : values)
+        {
+            unchecked_emplace_back(value);
+        }
+    }
+
+    constexpr iterator begin() noexcept
+    {
+        return data();
+    }
+    constexpr const_iterator begin() const noexcept
+    {
+        return data();
+    }
+    constexpr const_iterator cbegin() const noexcept
+    {
+        return data();
+    }
+    constexpr iterator end() noexcept
+    {
+        return data() + size();
+    }
+    constexpr const_iterator end() const noexcept
+    {
+        return data() + size();
+    }
+    constexpr const_iterator cend() const noexcept
+    {
+        return data() + size();
+    }
+
+    constexpr pointer data() noexcept
+    {
+        return this->elements();
+    }
+    constexpr const_pointer data() const noexcept
+    {
+        return this->elements();
+    }
+
+    constexpr size_type size() const noexcept
+    {
+        return this->m_size;
+    }
+    static constexpr size_type capacity() noexcept
+    {
+        return Capacity;
+    }
+    static constexpr size_type max_size() noexcept
+    {
+        return Capacity;
+    }
+    constexpr bool empty() const noexcept
+    {
+        return this->m_size == 0;
+    }
+    constexpr bool full() const noexcept
+    {
+        return this->m_size == Capacity;
+    }
+
+    constexpr reference operator[](size_type pos)
+    {
+        return data()[pos];
+    }
+    constexpr const_reference operator[](size_type pos) const
+    {
+        return data()[pos];
+    }
+
+    constexpr reference at(size_type pos)
+    {
+        if (pos >= size())
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+        return data()[pos];
+    }
+    constexpr const_reference at(size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+        return data()[pos];
+    }
+
+    constexpr reference front()
+    {
+        return data()[0];
+    }
+    constexpr const_reference front() const
+    {
+        return data()[0];
+    }
+    constexpr reference back()
+    {
+        return data()[size() - 1];
+    }
+    constexpr const_reference back() const
+    {
+        return data()[size() - 1];
+    }
+
+    constexpr void push_back(const Type& value)
+    {
+        emplace_back(value);
+    }
+
+    constexpr void push_back(Type&& value)
+    {
+        emplace_back(ohmy::move(value));
+    }
+
+    template <typename... ArgumentTypes>
+    constexpr reference emplace_back(ArgumentTypes&&... arguments)
+    {
+        if (full())
+            throw std::bad_alloc{};
+        return unchecked_emplace_back(
+            ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    constexpr pointer try_push_back(const Type& value)
+    {
+        return try_emplace_back(value);
+    }
+
+    constexpr pointer try_push_back(Type&& value)
+    {
+        return try_emplace_back(ohmy::move(value));
+    }
+
+    // Returns a pointer to the new element, or nullptr if the vector is full.
+    template <typename... ArgumentTypes>
+    constexpr pointer try_emplace_back(ArgumentTypes&&... arguments)
+    {
+        if (full())
+            return nullptr;
+        return &unchecked_emplace_back(
+            ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    // Precondition: the vector is not full.
+    template <typename... ArgumentTypes>
+    constexpr reference unchecked_emplace_back(ArgumentTypes&&... arguments)
+    {
+        pointer slot = data() + this->m_size;
+        if constexpr (trivial)
+        {
+            *slot = Type(ohmy::forward<ArgumentTypes>(arguments)...);
+        }
+        else
+        {
+            ohmy::construct_at(slot,
+                               ohmy::forward<ArgumentTypes>(arguments)...);
+        }
+        ++this->m_size;
+        return *slot;
+    }
+
+    constexpr void pop_back() noexcept
+    {
+        --this->m_size;
+        if constexpr (not trivial)
+        {
+            ohmy::destroy_at(data() + this->m_size);
+        }
+    }
+
+    constexpr void clear() noexcept
+    {
+        if constexpr (not trivial)
+        {
+            ohmy::destroy(data(), data() + this->m_size);
+        }
+        this->m_size = 0;
+    }
+
+    constexpr void resize(size_type count)
+    {
+        check_capacity(count);
+        while (size() > count)
+        {
+            pop_back();
+        }
+        while (size() < count)
+        {
+            unchecked_emplace_back();
+        }
+    }
+
+    constexpr void resize(size_type count, const Type& value)
+    {
+        check_capacity(count);
+        while (size() > count)
+        {
+            pop_back();
+        }
+        while (size() < count)
+        {
+            unchecked_emplace_back(value);
+        }
+    }
+
+    constexpr iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    constexpr iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator begin = data() + (first - data());
+        iterator end = data() + (last - data());
+        if (begin == end)
+        {
+            return begin;
+        }
+
+        iterator new_end = begin;
+        for (iterator it = end; it != this->end(); ++it, ++new_end)
+        {
+            *new_end = ohmy::move(*it);
+        }
+        while (this->end() != new_end)
+        {
+            pop_back();
+        }
+        return begin;
+    }
+
+private:
+    static constexpr void check_capacity(size_type count)
+    {
+        if (count > Capacity)
+            throw std::bad_alloc{};
+    }
+};
+
+template <typename Type, size_t Capacity>
+constexpr bool operator==(const static_vector<Type, Capacity>& lhs,
+                          const static_vector<Type, Capacity>& rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        if (not(lhs[i] == rhs[i]))
+            return false;
+    }
+    return true;
+}
+
+template <typename Type, size_t Capacity>
+constexpr bool operator!=(const static_vector<Type, Capacity>& lhs,
+                          const static_vector<Type, Capacity>& rhs)
+{
+    return not(lhs == rhs);
+}
+} // namespace ohmy
+
+#endif // OHMY_STATIC_VECTOR_HPP
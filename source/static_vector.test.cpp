@@ -0,0 +1,118 @@
+#include <catch/catch.hpp>
+
+#include "static_vector.hpp"
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace
+{
+constexpr int sum_of_first(int count)
+{
+    ohmy::static_vector<int, 8> v;
+    for (int i = 1; i <= count; ++i)
+    {
+        v.push_back(i);
+    }
+    v.erase(v.begin());
+
+    int sum = 0;
+    for (int value : v)
+    {
+        sum += value;
+    }
+    return sum;
+}
+
+// Trivially copyable, but not trivial.
+struct point
+{
+    int x = 0;
+    int y = 0;
+};
+
+constexpr bool overflow_is_reported()
+{
+    ohmy::static_vector<int, 2> v{1, 2};
+    return v.try_push_back(3) == nullptr and v.size() == 2u;
+}
+} // namespace
+
+static_assert(sum_of_first(4) == 2 + 3 + 4);
+static_assert(overflow_is_reported());
+
+using int_vector = ohmy::static_vector<int, 4>;
+static_assert(sizeof(int_vector) == 4 * sizeof(int) + sizeof(std::size_t));
+static_assert(std::is_trivially_copyable_v<int_vector>);
+static_assert(std::is_standard_layout_v<int_vector>);
+static_assert(not std::is_trivially_copyable_v<
+              ohmy::static_vector<std::string, 4>>);
+
+using point_vector = ohmy::static_vector<point, 4>;
+static_assert(sizeof(point_vector) == 4 * sizeof(point) + sizeof(std::size_t));
+static_assert(std::is_trivially_copyable_v<point_vector>);
+static_assert(std::is_standard_layout_v<point_vector>);
+
+TEST_CASE("static_vector with trivial elements")
+{
+    int_vector v;
+    REQUIRE(v.empty());
+    REQUIRE(v.capacity() == 4u);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        REQUIRE(v.try_push_back(i) != nullptr);
+    }
+    REQUIRE(v.full());
+    REQUIRE(v.try_push_back(4) == nullptr);
+    REQUIRE_THROWS_AS(v.push_back(4), std::bad_alloc);
+    REQUIRE(v == int_vector{0, 1, 2, 3});
+
+    int_vector copy = v;
+    copy.pop_back();
+    copy.resize(4, 9);
+    REQUIRE(copy == int_vector{0, 1, 2, 9});
+    REQUIRE(v.back() == 3);
+}
+
+TEST_CASE("static_vector with trivially copyable elements")
+{
+    point_vector v(2);
+    REQUIRE(v[1].x == 0);
+    v.push_back(point{3, 4});
+    v.emplace_back();
+
+    point_vector copy;
+    std::memcpy(static_cast<void*>(&copy), &v, sizeof(v));
+    REQUIRE(copy.size() == 4u);
+    REQUIRE(copy[2].y == 4);
+    REQUIRE(copy[3].x == 0);
+    copy.erase(copy.begin());
+    REQUIRE(copy[1].x == 3);
+}
+
+TEST_CASE("static_vector with non-trivial elements")
+{
+    using string_vector = ohmy::static_vector<std::string, 3>;
+
+    string_vector v{"one", "two"};
+    REQUIRE(v.try_emplace_back(3u, 'x') != nullptr);
+    REQUIRE(v.back() == "xxx");
+    REQUIRE(v.try_push_back("four") == nullptr);
+
+    string_vector copy{v};
+    REQUIRE(copy == v);
+
+    string_vector moved{ohmy::move(copy)};
+    REQUIRE(moved == v);
+    REQUIRE(copy.empty());
+
+    moved.erase(moved.begin());
+    REQUIRE(moved == string_vector{"two", "xxx"});
+
+    moved.resize(1);
+    REQUIRE(moved == string_vector{"two"});
+    REQUIRE_THROWS_AS(moved.resize(4), std::bad_alloc);
+    REQUIRE_THROWS_AS(moved.at(1), std::out_of_range);
+}
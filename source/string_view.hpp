@@ -1,6 +1,8 @@
 #ifndef MY_STRING_VIEW
 #define MY_STRING_VIEW
 
+#include "expected.hpp"
+
 #include <algorithm>
 #include <iterator>
 #include <limits>
@@ -9,6 +11,12 @@
 namespace my
 {
 
+// Why a try_ member could not give its result.
+enum class view_error
+{
+    out_of_range
+};
+
 template <typename CharT, typename Traits = std::char_traits<CharT>>
 class basic_string_view
 {
@@ -69,6 +77,14 @@ public:
             throw std::out_of_range{__PRETTY_FUNCTION__};
     }
 
+    constexpr ohmy::expected<value_type, view_error> try_at(size_type pos) const noexcept
+    {
+        if (pos < sz)
+            return *(data_ptr + pos);
+        else
+            return ohmy::unexpected{view_error::out_of_range};
+    }
+
     constexpr const_reference front() const { return *(data_ptr); }
     constexpr const_reference back() const { return *(data_ptr + sz - 1); }
 
@@ -95,10 +111,18 @@ public:
             throw std::out_of_range(__PRETTY_FUNCTION__);
 
         auto rcount = std::min(count, sz - pos);
-        auto dest_end_it = std::copy_n(data_ptr, rcount, dest);
+        auto dest_end_it = std::copy_n(data_ptr + pos, rcount, dest);
         return std::distance(dest, dest_end_it);
     }
 
+    ohmy::expected<size_type, view_error> try_copy(CharT* dest, size_type count, size_type pos = 0ull) const noexcept
+    {
+        if (pos >= sz)
+            return ohmy::unexpected{view_error::out_of_range};
+
+        return copy(dest, count, pos);
+    }
+
     basic_string_view substr(size_type pos = 0, size_type count = npos) const
     {
         if (pos >= sz)
@@ -107,6 +131,14 @@ public:
         return basic_string_view(data_ptr + pos, std::min(count, sz - pos));
     }
 
+    constexpr ohmy::expected<basic_string_view, view_error> try_substr(size_type pos = 0, size_type count = npos) const noexcept
+    {
+        if (pos >= sz)
+            return ohmy::unexpected{view_error::out_of_range};
+
+        return basic_string_view(data_ptr + pos, std::min(count, sz - pos));
+    }
+
     constexpr int compare(basic_string_view v) const
     {
         return compare(0, npos, v, 0, npos);
@@ -132,6 +164,20 @@ public:
             return sz < v.sz ? -1 : (sz > v.sz ? 1 : 0);
     }
 
+    constexpr ohmy::expected<int, view_error> try_compare(size_type pos, size_type count, basic_string_view v) const noexcept
+    {
+        return try_compare(pos, count, v, 0, npos);
+    }
+
+    constexpr ohmy::expected<int, view_error> try_compare(size_type pos1, size_type count1, basic_string_view v,
+                                                          size_type pos2, size_type count2) const noexcept
+    {
+        if (pos1 >= sz or pos2 >= v.sz)
+            return ohmy::unexpected{view_error::out_of_range};
+
+        return compare(pos1, count1, v, pos2, count2);
+    }
+
     constexpr int compare(const_pointer s) const
     {
         return compare(basic_string_view(s));
@@ -128,6 +128,12 @@ TEST_CASE("will allow read only access to elements")
         (void)out_of_bounds;
     }
 
+    SECTION("will report out of bounds access without throwing via try_at")
+    {
+        REQUIRE(sv.try_at(15) == 'p');
+        REQUIRE(sv.try_at(123).error() == my::view_error::out_of_range);
+    }
+
     SECTION("will grant access to first and last element by dedicated functions")
     {
         REQUIRE(sv.front() == 'a');
@@ -186,6 +192,47 @@ TEST_CASE("will allow comparing views")
     }
 }
 
+TEST_CASE("non-throwing variants report positions past the end")
+{
+    my::string_view sv("abcdef");
+
+    SECTION("try_substr gives the same view as substr")
+    {
+        REQUIRE(sv.try_substr(2, 3)->compare(sv.substr(2, 3)) == 0);
+        REQUIRE(sv.try_substr(6) == ohmy::unexpected{my::view_error::out_of_range});
+    }
+
+    SECTION("try_compare gives the same result as compare")
+    {
+        my::string_view other("xbcd");
+        REQUIRE(sv.try_compare(1, 3, other, 1, 3) == sv.compare(1, 3, other, 1, 3));
+        REQUIRE(sv.try_compare(1, 3, other) == sv.compare(1, 3, other));
+        REQUIRE_FALSE(sv.try_compare(9, 1, other).has_value());
+        REQUIRE_FALSE(sv.try_compare(0, 1, other, 4, 1).has_value());
+    }
+
+    SECTION("try_copy copies the same characters as copy")
+    {
+        char out[4]{};
+        REQUIRE(sv.try_copy(out, 3, 4) == 2u);
+        REQUIRE(out[1] == 'f');
+        REQUIRE_FALSE(sv.try_copy(out, 1, 6));
+    }
+
+    SECTION("results chain without checking each step")
+    {
+        auto last = sv.try_substr(2)
+                        .and_then([](my::string_view rest) { return rest.try_at(3); })
+                        .value_or('?');
+        REQUIRE(last == 'f');
+
+        auto missing = sv.try_substr(4)
+                           .and_then([](my::string_view rest) { return rest.try_at(3); })
+                           .value_or('?');
+        REQUIRE(missing == '?');
+    }
+}
+
 TEST_CASE("searching in view")
 {
     SECTION("basic search using find method")
@@ -0,0 +1,562 @@
+#ifndef OHMY_TASK_HPP
+#define OHMY_TASK_HPP
+
+#if not defined(__cpp_impl_coroutine) or __cplusplus < 202002L
+#error "task.hpp needs C++20 coroutines; configure with -DOHMY_CXX20=ON"
+#endif
+
+#include "c++config.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <new>
+
+namespace ohmy
+{
+namespace detail
+{
+// Coroutine frames of a thread are recycled through free lists kept per
+// 64-byte size class, so a steady stream of tasks of similar shapes stops
+// allocating after warming up. A frame freed on another thread than the
+// one it was allocated on joins that thread's lists. Frames larger than
+// the biggest class, and frames beyond a bounded number per class, go
+// straight to the global allocator.
+class frame_allocator
+{
+public:
+    static constexpr size_t granularity = 64;
+    static constexpr size_t size_classes = 64;
+    static constexpr size_t max_cached_frames = 64;
+
+    static void* allocate(size_t bytes)
+    {
+        const size_t size_class = class_of(bytes);
+        if (size_class >= size_classes)
+        {
+            return ::operator new(bytes);
+        }
+
+        // Frames of a class are always allocated with the full class size,
+        // since any thread may later cache and reuse them.
+        cache& frames = local();
+        free_frame* frame = frames.heads[size_class];
+        if (frame != nullptr)
+        {
+            frames.heads[size_class] = frame->next;
+            --frames.counts[size_class];
+            return frame;
+        }
+        return ::operator new((size_class + 1) * granularity);
+    }
+
+    static void deallocate(void* pointer, size_t bytes) noexcept
+    {
+        const size_t size_class = class_of(bytes);
+        cache& frames = local();
+        if (size_class < size_classes and not frames.closed and
+            frames.counts[size_class] < max_cached_frames)
+        {
+            auto* frame = static_cast<free_frame*>(pointer);
+            frame->next = frames.heads[size_class];
+            frames.heads[size_class] = frame;
+            ++frames.counts[size_class];
+            return;
+        }
+        ::operator delete(pointer);
+    }
+
+private:
+    struct free_frame
+    {
+        free_frame* next;
+    };
+
+    // Trivially destructible, so frames freed while the thread is being
+    // torn down, after the lists were drained, still find the cache and
+    // see that it is closed.
+    struct cache
+    {
+        free_frame* heads[size_classes];
+        unsigned char counts[size_classes];
+        bool closed;
+    };
+
+    struct drain_on_exit
+    {
+        ~drain_on_exit()
+        {
+            frames.closed = true;
+            for (free_frame*& head : frames.heads)
+            {
+                while (head != nullptr)
+                {
+                    free_frame* next = head->next;
+                    ::operator delete(head);
+                    head = next;
+                }
+            }
+        }
+
+        cache& frames;
+    };
+
+    static cache& local() noexcept
+    {
+        static thread_local cache frames{};
+        static thread_local drain_on_exit drain{frames};
+        return frames;
+    }
+
+    static constexpr size_t class_of(size_t bytes) noexcept
+    {
+        return bytes == 0 ? 0 : (bytes - 1) / granularity;
+    }
+};
+
+struct task_final_awaiter
+{
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    // Symmetric transfer: the awaiting coroutine is resumed by returning
+    // its handle, without growing the stack.
+    template <typename Promise>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> finished) const noexcept
+    {
+        return finished.promise().m_continuation;
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+};
+
+class task_promise_base
+{
+public:
+    static void* operator new(size_t bytes)
+    {
+        return frame_allocator::allocate(bytes);
+    }
+
+    static void operator delete(void* frame, size_t bytes) noexcept
+    {
+        frame_allocator::deallocate(frame, bytes);
+    }
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    task_final_awaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception() noexcept
+    {
+        m_exception = std::current_exception();
+    }
+
+    std::coroutine_handle<> m_continuation = std::noop_coroutine();
+
+protected:
+    void rethrow_if_failed() const
+    {
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+    std::exception_ptr m_exception;
+};
+} // namespace detail
+
+template <typename Type = void>
+class task;
+
+namespace detail
+{
+template <typename Type>
+class task_promise : public task_promise_base
+{
+public:
+    task_promise() noexcept
+    {
+    }
+
+    ~task_promise()
+    {
+        if (m_has_value)
+        {
+            ohmy::destroy_at(ohmy::addressof(m_value));
+        }
+    }
+
+    task<Type> get_return_object() noexcept;
+
+    template <typename Value,
+              typename = enable_if_t<is_convertible_v<Value&&, Type>>>
+    void return_value(Value&& value) noexcept(
+        is_nothrow_constructible<Type, Value&&>::value)
+    {
+        ohmy::construct_at(ohmy::addressof(m_value),
+                           ohmy::forward<Value>(value));
+        m_has_value = true;
+    }
+
+    Type result()
+    {
+        rethrow_if_failed();
+        return ohmy::move(m_value);
+    }
+
+private:
+    union
+    {
+        Type m_value;
+    };
+    bool m_has_value = false;
+};
+
+template <typename Type>
+class task_promise<Type&> : public task_promise_base
+{
+public:
+    task<Type&> get_return_object() noexcept;
+
+    void return_value(Type& value) noexcept
+    {
+        m_value = ohmy::addressof(value);
+    }
+
+    Type& result()
+    {
+        rethrow_if_failed();
+        return *m_value;
+    }
+
+private:
+    Type* m_value = nullptr;
+};
+
+template <>
+class task_promise<void> : public task_promise_base
+{
+public:
+    task<void> get_return_object() noexcept;
+
+    void return_void() noexcept
+    {
+    }
+
+    void result()
+    {
+        rethrow_if_failed();
+    }
+};
+} // namespace detail
+
+// A lazily started coroutine producing a Type. Nothing runs until the task
+// is awaited; the awaiting coroutine is then suspended, the task runs, and
+// when it finishes it resumes its awaiter directly by symmetric transfer,
+// so long chains of tasks that complete synchronously run in constant
+// stack space once the compiler emits the transfer as a tail call, which
+// GCC does when optimizing. Exceptions are rethrown in the awaiter.
+//
+// Frames come from a per-thread recycling allocator, so a continuation
+// costs neither an allocation after warm-up nor a type-erased call. Use
+// resume_on to continue on an executor's thread and sync_wait to run a
+// task from ordinary code.
+template <typename Type>
+class [[nodiscard]] task
+{
+public:
+    using promise_type = detail::task_promise<Type>;
+    using value_type = Type;
+
+    task() noexcept = default;
+
+    task(task&& other) noexcept : m_handle{other.m_handle}
+    {
+        other.m_handle = nullptr;
+    }
+
+    task& operator=(task&& other) noexcept
+    {
+        if (this != ohmy::addressof(other))
+        {
+            destroy();
+            m_handle = other.m_handle;
+            other.m_handle = nullptr;
+        }
+        return *this;
+    }
+
+    ~task()
+    {
+        destroy();
+    }
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    bool done() const noexcept
+    {
+        return not m_handle or m_handle.done();
+    }
+
+    // Awaiting runs the task and yields its result.
+    auto operator co_await() && noexcept
+    {
+        struct awaiter : ready_awaiter
+        {
+            decltype(auto) await_resume()
+            {
+                return this->m_handle.promise().result();
+            }
+        };
+        return awaiter{{m_handle}};
+    }
+
+    // Runs the task without consuming its result, which stays available
+    // through result(); exceptions are only rethrown there.
+    auto when_ready() noexcept
+    {
+        return ready_awaiter{m_handle};
+    }
+
+    decltype(auto) result()
+    {
+        return m_handle.promise().result();
+    }
+
+private:
+    friend promise_type;
+
+    struct ready_awaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return not m_handle or m_handle.done();
+        }
+
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            m_handle.promise().m_continuation = awaiting;
+            return m_handle;
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept
+        : m_handle{handle}
+    {
+    }
+
+    void destroy() noexcept
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    std::coroutine_handle<promise_type> m_handle = nullptr;
+};
+
+namespace detail
+{
+template <typename Type>
+task<Type> task_promise<Type>::get_return_object() noexcept
+{
+    return task<Type>{
+        std::coroutine_handle<task_promise>::from_promise(*this)};
+}
+
+template <typename Type>
+task<Type&> task_promise<Type&>::get_return_object() noexcept
+{
+    return task<Type&>{
+        std::coroutine_handle<task_promise>::from_promise(*this)};
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept
+{
+    return task<void>{
+        std::coroutine_handle<task_promise>::from_promise(*this)};
+}
+} // namespace detail
+
+// Suspends the awaiting coroutine and hands its resumption to executor,
+// any object with a submit(callable) member such as thread_pool, so the
+// rest of the coroutine runs on a thread the executor chooses. An executor
+// may also resume the coroutine before submit returns.
+template <typename Executor>
+class resume_on_awaiter
+{
+public:
+    explicit resume_on_awaiter(Executor& executor) noexcept
+        : m_executor{executor}
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting)
+    {
+        // Nothing of *this may be used after submit, which can resume and
+        // finish the coroutine that owns it.
+        m_executor.submit([awaiting] { awaiting.resume(); });
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+private:
+    Executor& m_executor;
+};
+
+template <typename Executor>
+resume_on_awaiter<Executor> resume_on(Executor& executor) noexcept
+{
+    return resume_on_awaiter<Executor>{executor};
+}
+
+namespace detail
+{
+struct sync_wait_state
+{
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+};
+
+// Awaits a task from a coroutine that the blocked thread can wait for.
+class sync_wait_driver
+{
+public:
+    struct promise_type
+    {
+        template <typename Task>
+        promise_type(Task&, sync_wait_state& state) noexcept : m_state{state}
+        {
+        }
+
+        sync_wait_driver get_return_object() noexcept
+        {
+            return sync_wait_driver{
+                std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        auto final_suspend() const noexcept
+        {
+            struct signal
+            {
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                // Notifying under the lock keeps the waiting thread, which
+                // owns the state, from returning before this is done.
+                void await_suspend(
+                    std::coroutine_handle<promise_type> self) const noexcept
+                {
+                    sync_wait_state& state = self.promise().m_state;
+                    std::lock_guard<std::mutex> lock{state.mutex};
+                    state.done = true;
+                    state.finished.notify_one();
+                }
+
+                void await_resume() const noexcept
+                {
+                }
+            };
+            return signal{};
+        }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception() const noexcept
+        {
+            std::terminate();
+        }
+
+        sync_wait_state& m_state;
+    };
+
+    explicit sync_wait_driver(std::coroutine_handle<promise_type> handle)
+        : m_handle{handle}
+    {
+    }
+
+    sync_wait_driver(const sync_wait_driver&) = delete;
+    sync_wait_driver& operator=(const sync_wait_driver&) = delete;
+
+    ~sync_wait_driver()
+    {
+        m_handle.destroy();
+    }
+
+    void start() const
+    {
+        m_handle.resume();
+    }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template <typename Task>
+sync_wait_driver drive(Task& awaited, sync_wait_state&)
+{
+    co_await awaited.when_ready();
+}
+} // namespace detail
+
+// Runs a task to completion, blocking the calling thread while it is
+// suspended on other threads, and returns its result.
+template <typename Type>
+Type sync_wait(task<Type> awaited)
+{
+    detail::sync_wait_state state;
+    {
+        detail::sync_wait_driver driver = detail::drive(awaited, state);
+        driver.start();
+
+        std::unique_lock<std::mutex> lock{state.mutex};
+        state.finished.wait(lock, [&state] { return state.done; });
+    }
+    return awaited.result();
+}
+} // namespace ohmy
+
+#endif // OHMY_TASK_HPP
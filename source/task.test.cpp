@@ -0,0 +1,227 @@
+#include <catch/catch.hpp>
+
+#include "allocation_tracking.hpp"
+#include "functional.hpp"
+#include "task.hpp"
+#include "thread_pool.hpp"
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+ohmy::task<int> answer()
+{
+    co_return 42;
+}
+
+ohmy::task<int> add(int a, int b)
+{
+    const int first = co_await answer();
+    co_return first + a + b - 42;
+}
+
+ohmy::task<std::string> greet(std::string name)
+{
+    co_return "hello " + name;
+}
+
+ohmy::task<int&> select(int& value)
+{
+    co_return value;
+}
+
+ohmy::task<> fail()
+{
+    throw std::runtime_error{"failed"};
+    co_return;
+}
+
+ohmy::task<int> count_down(int n)
+{
+    int total = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        total += co_await answer() - 41;
+    }
+    co_return total;
+}
+
+ohmy::task<int> recurse(int depth)
+{
+    if (depth == 0)
+    {
+        co_return 0;
+    }
+    co_return 1 + co_await recurse(depth - 1);
+}
+
+// Runs submitted work on one thread that the test owns, the way an I/O
+// loop would.
+class loop_executor
+{
+public:
+    template <typename Functor>
+    void submit(Functor&& f)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_work.emplace_back(std::forward<Functor>(f));
+    }
+
+    bool run_one()
+    {
+        std::function<void()> work;
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_work.empty())
+            {
+                return false;
+            }
+            work = std::move(m_work.front());
+            m_work.pop_front();
+        }
+        work();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<std::function<void()>> m_work;
+};
+
+template <typename Executor>
+ohmy::task<std::thread::id> hop(Executor& executor)
+{
+    co_await ohmy::resume_on(executor);
+    co_return std::this_thread::get_id();
+}
+} // namespace
+
+TEST_CASE("task")
+{
+    SECTION("tasks are lazy and produce values")
+    {
+        bool started = false;
+        auto body = [&]() -> ohmy::task<int> {
+            started = true;
+            co_return 7;
+        };
+        ohmy::task<int> pending = body();
+        REQUIRE_FALSE(started);
+        REQUIRE(ohmy::sync_wait(ohmy::move(pending)) == 7);
+        REQUIRE(started);
+
+        REQUIRE(ohmy::sync_wait(add(1, 2)) == 3);
+        REQUIRE(ohmy::sync_wait(greet("world")) == "hello world");
+    }
+
+    SECTION("reference results refer to the returned object")
+    {
+        int value = 1;
+        int& selected = ohmy::sync_wait(select(value));
+        REQUIRE(&selected == &value);
+    }
+
+    SECTION("exceptions are rethrown in the awaiter")
+    {
+        REQUIRE_THROWS_AS(ohmy::sync_wait(fail()), std::runtime_error);
+    }
+
+    // Unoptimized builds do not turn the transfer into a tail call, so the
+    // chains stay short enough to fit the stack without it.
+    SECTION("long synchronous chains complete")
+    {
+        REQUIRE(ohmy::sync_wait(count_down(10000)) == 10000);
+        REQUIRE(ohmy::sync_wait(recurse(10000)) == 10000);
+    }
+
+    SECTION("frames are recycled after warming up")
+    {
+        REQUIRE(ohmy::sync_wait(count_down(10)) == 10);
+
+        ohmy::allocation_scope scope;
+        ohmy::task<int> work = count_down(1000);
+        REQUIRE(scope.allocations() == 0u);
+        REQUIRE(ohmy::sync_wait(ohmy::move(work)) == 1000);
+    }
+
+    SECTION("resume_on continues on the executor's thread")
+    {
+        ohmy::thread_pool pool{2};
+        REQUIRE(ohmy::sync_wait(hop(pool)) != std::this_thread::get_id());
+
+        loop_executor loop;
+        std::thread::id resumed_on;
+        std::thread caller{[&] { resumed_on = ohmy::sync_wait(hop(loop)); }};
+        while (not loop.run_one())
+        {
+            std::this_thread::yield();
+        }
+        caller.join();
+        REQUIRE(resumed_on == std::this_thread::get_id());
+    }
+}
+
+namespace
+{
+constexpr int chain_length = 1 << 20;
+
+// A continuation-passing chain in which every step allocates a new
+// type-erased callback, the way callback-based handlers are written.
+void callback_step(int remaining, long long sum,
+                   const ohmy::function<void(long long)>& done)
+{
+    if (remaining == 0)
+    {
+        done(sum);
+        return;
+    }
+    ohmy::function<void(long long)> next = [&done](long long total) {
+        done(total);
+    };
+    callback_step(remaining - 1, sum + remaining, next);
+}
+
+ohmy::task<long long> task_step(int remaining)
+{
+    co_return remaining;
+}
+
+ohmy::task<long long> task_chain()
+{
+    long long sum = 0;
+    for (int remaining = chain_length; remaining > 0; --remaining)
+    {
+        sum += co_await task_step(remaining);
+    }
+    co_return sum;
+}
+} // namespace
+
+TEST_CASE("task benchmarks", "[.benchmark]")
+{
+    const long long expected =
+        static_cast<long long>(chain_length) * (chain_length + 1) / 2;
+
+    // The callback chain recurses, so it runs as 16 chains of 2^16 steps.
+    BENCHMARK("ohmy::function continuation chain, 2^20 steps")
+    {
+        long long result = 0;
+        for (int round = 0; round < 16; ++round)
+        {
+            callback_step(1 << 16, 0, [&result](long long sum) {
+                result += sum;
+            });
+        }
+        REQUIRE(result == 16LL * (1 << 16) * ((1 << 16) + 1) / 2);
+    }
+
+    BENCHMARK("ohmy::task continuation chain, 2^20 steps")
+    {
+        REQUIRE(ohmy::sync_wait(task_chain()) == expected);
+    }
+}
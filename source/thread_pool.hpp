@@ -0,0 +1,512 @@
+#ifndef OHMY_THREAD_POOL_HPP
+#define OHMY_THREAD_POOL_HPP
+
+#include "c++config.hpp"
+#include "cache_padded.hpp"
+#include "functional.hpp"
+#include "memory.hpp"
+#include "mpmc_queue.hpp"
+#include "spsc_queue.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace ohmy
+{
+// A bounded Chase-Lev work-stealing deque. The owning thread pushes and
+// pops at the bottom, so it runs its most recent work first while that is
+// still in cache, and any other thread steals the oldest element from the
+// top.
+//
+// The classic algorithm copies an element out before claiming it, which
+// only works for trivially copyable elements. Here a thief claims the top
+// position first and then moves the element out, and each slot carries a
+// flag that stays set until that move is done, so the owner never reuses
+// a slot that is still being read: it reports the deque as full instead.
+template <typename Type>
+class work_stealing_deque
+{
+    static_assert(is_nothrow_move_constructible_v<Type> and
+                      is_nothrow_move_assignable_v<Type>,
+                  "work_stealing_deque elements need nothrow moves");
+
+    struct slot
+    {
+        Type* get() noexcept
+        {
+            return reinterpret_cast<Type*>(storage);
+        }
+
+        std::atomic<bool> full;
+        alignas(Type) unsigned char storage[sizeof(Type)];
+    };
+
+public:
+    explicit work_stealing_deque(size_t capacity)
+        : m_capacity{detail::ring_capacity(capacity)},
+          m_slots{allocator<slot>{}.allocate(m_capacity)}
+    {
+        for (size_t i = 0; i < m_capacity; ++i)
+        {
+            ohmy::construct_at(&m_slots[i].full, false);
+        }
+    }
+
+    ~work_stealing_deque()
+    {
+        const ptrdiff_t top = m_top->load(std::memory_order_relaxed);
+        const ptrdiff_t bottom = m_bottom->load(std::memory_order_relaxed);
+        for (ptrdiff_t position = top; position < bottom; ++position)
+        {
+            ohmy::destroy_at(at(position).get());
+        }
+        allocator<slot>{}.deallocate(m_slots, m_capacity);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    // Owner only.
+    bool push(Type&& value) noexcept
+    {
+        const ptrdiff_t bottom = m_bottom->load(std::memory_order_relaxed);
+        const ptrdiff_t top = m_top->load(std::memory_order_acquire);
+        slot& target = at(bottom);
+        if (bottom - top >= static_cast<ptrdiff_t>(m_capacity) or
+            target.full.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        ohmy::construct_at(target.get(), ohmy::move(value));
+        target.full.store(true, std::memory_order_relaxed);
+        m_bottom->store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only; takes the most recently pushed element.
+    bool pop(Type& destination) noexcept
+    {
+        const ptrdiff_t bottom = m_bottom->load(std::memory_order_relaxed) - 1;
+        m_bottom->store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ptrdiff_t top = m_top->load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            m_bottom->store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+        if (top == bottom)
+        {
+            // The last element; race the thieves for it.
+            const bool won = m_top->compare_exchange_strong(
+                top, top + 1, std::memory_order_seq_cst,
+                std::memory_order_relaxed);
+            m_bottom->store(bottom + 1, std::memory_order_relaxed);
+            if (not won)
+            {
+                return false;
+            }
+        }
+        take(at(bottom), destination);
+        return true;
+    }
+
+    // Any thread; takes the oldest element. Fails spuriously when another
+    // thread wins the race for it.
+    bool steal(Type& destination) noexcept
+    {
+        ptrdiff_t top = m_top->load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const ptrdiff_t bottom = m_bottom->load(std::memory_order_acquire);
+        if (top >= bottom or
+            not m_top->compare_exchange_strong(top, top + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed))
+        {
+            return false;
+        }
+        take(at(top), destination);
+        return true;
+    }
+
+    // A snapshot that may be stale by the time it is used.
+    bool empty() const noexcept
+    {
+        const ptrdiff_t top = m_top->load(std::memory_order_acquire);
+        const ptrdiff_t bottom = m_bottom->load(std::memory_order_acquire);
+        return bottom <= top;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+private:
+    slot& at(ptrdiff_t position) const noexcept
+    {
+        return m_slots[static_cast<size_t>(position) & (m_capacity - 1)];
+    }
+
+    static void take(slot& source, Type& destination) noexcept
+    {
+        destination = ohmy::move(*source.get());
+        ohmy::destroy_at(source.get());
+        source.full.store(false, std::memory_order_release);
+    }
+
+    const size_t m_capacity;
+    slot* const m_slots;
+    cache_padded<std::atomic<ptrdiff_t>> m_top;
+    cache_padded<std::atomic<ptrdiff_t>> m_bottom;
+};
+
+// A single-use countdown, like std::latch. wait() blocks by yielding; a
+// thread that can run tasks meanwhile should use thread_pool::wait.
+class latch
+{
+public:
+    explicit latch(ptrdiff_t expected) noexcept : m_count{expected}
+    {
+    }
+
+    latch(const latch&) = delete;
+    latch& operator=(const latch&) = delete;
+
+    void count_down(ptrdiff_t update = 1) noexcept
+    {
+        m_count.fetch_sub(update, std::memory_order_release);
+    }
+
+    bool try_wait() const noexcept
+    {
+        return m_count.load(std::memory_order_acquire) == 0;
+    }
+
+    void wait() const noexcept
+    {
+        while (not try_wait())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    std::atomic<ptrdiff_t> m_count;
+};
+
+// A fixed set of worker threads for CPU-bound fork-join work.
+//
+// Each worker owns a work_stealing_deque. Tasks submitted from a worker go
+// to its own deque and tasks submitted from other threads to a shared
+// injection queue; an idle worker takes from its own deque, then from the
+// injection queue, and then steals from the other workers starting at a
+// random victim. Tasks are move_only_functions with a buffer large enough
+// for typical fork-join lambdas and both queues are allocated up front, so
+// submitting does not allocate. When a queue is full the submitting thread
+// runs the task itself.
+//
+// Waiting on a latch with wait() runs other tasks meanwhile, so a task can
+// fork subtasks and join them without tying up its worker. An exception
+// escaping a task terminates the program, as it would from a std::thread.
+class thread_pool
+{
+public:
+    using task = move_only_function<void(), 112>;
+
+    static_assert(sizeof(task) == 2 * cache_line_size);
+
+    explicit thread_pool(unsigned threads = default_thread_count(),
+                         size_t queue_capacity = 1024)
+        : m_injection{queue_capacity}
+    {
+        m_workers.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i)
+        {
+            m_workers.push_back(ohmy::make_unique<worker>(queue_capacity, i));
+        }
+        for (auto& w : m_workers)
+        {
+            worker* self = w.get();
+            self->thread = std::thread{[this, self] { run(*self); }};
+        }
+    }
+
+    // Runs every task submitted before and during destruction, then joins
+    // the workers.
+    ~thread_pool()
+    {
+        m_stopping.store(true);
+        wake_all();
+        for (auto& w : m_workers)
+        {
+            w->thread.join();
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    template <typename Functor,
+              typename = enable_if_t<is_invocable_r_v<void, decay_t<Functor>&>>>
+    void submit(Functor&& f)
+    {
+        task work{ohmy::forward<Functor>(f)};
+        worker* self = current_worker();
+        const bool queued = self != nullptr
+                                ? self->tasks.push(ohmy::move(work))
+                                : m_injection.try_push(ohmy::move(work));
+        if (not queued)
+        {
+            work();
+            return;
+        }
+        wake_one();
+    }
+
+    // Runs tasks until the latch is released.
+    void wait(latch& done)
+    {
+        worker* self = current_worker();
+        task work;
+        while (not done.try_wait())
+        {
+            if (find_task(self, work))
+            {
+                work();
+                work = nullptr;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Calls body(i) for every i in [first, last), split into chunks of
+    // grain indices (by default about eight per worker), and returns when
+    // all have finished. The calling thread takes part. If body throws, the
+    // chunks still all run to the end, and the first exception propagates
+    // once they have.
+    template <typename Index, typename Body>
+    void parallel_for(Index first, Index last, Body&& body, Index grain = 0)
+    {
+        if (not(first < last))
+        {
+            return;
+        }
+        const Index count = last - first;
+        if (grain <= 0)
+        {
+            const unsigned workers = size() != 0 ? size() : 1;
+            const Index chunks = static_cast<Index>(8 * workers);
+            grain = count / chunks > 0 ? count / chunks : 1;
+        }
+
+        const Index first_end = count > grain ? first + grain : last;
+        const Index remaining = last - first_end;
+        const ptrdiff_t chunks =
+            1 + static_cast<ptrdiff_t>((remaining + grain - 1) / grain);
+        latch done{chunks};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        auto fail = [&failed, &error](std::exception_ptr exception) noexcept {
+            if (not failed.exchange(true, std::memory_order_relaxed))
+            {
+                error = ohmy::move(exception);
+            }
+        };
+
+        // Counts down whether body throws or not, so that waiting on done
+        // keeps this frame alive for every chunk, including those submit
+        // runs inline when the queues are full.
+        auto run_chunk = [&body, &done, &fail](Index begin,
+                                               Index end) noexcept {
+            try
+            {
+                for (Index i = begin; i < end; ++i)
+                {
+                    body(i);
+                }
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+            done.count_down();
+        };
+
+        ptrdiff_t submitted = 0;
+        try
+        {
+            for (Index begin = first_end; begin < last; ++submitted)
+            {
+                const Index end = last - begin > grain ? begin + grain : last;
+                submit([&run_chunk, begin, end] { run_chunk(begin, end); });
+                begin = end;
+            }
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+            done.count_down(chunks - 1 - submitted);
+        }
+        run_chunk(first, first_end);
+        wait(done);
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    unsigned size() const noexcept
+    {
+        return static_cast<unsigned>(m_workers.size());
+    }
+
+    static unsigned default_thread_count() noexcept
+    {
+        const unsigned hardware = std::thread::hardware_concurrency();
+        return hardware != 0 ? hardware : 1;
+    }
+
+private:
+    struct worker
+    {
+        worker(size_t capacity, unsigned seed)
+            : tasks{capacity}, random{seed * 2654435761u + 1}
+        {
+        }
+
+        work_stealing_deque<task> tasks;
+        std::uint32_t random;
+        std::thread thread;
+    };
+
+    struct current
+    {
+        thread_pool* pool;
+        worker* self;
+    };
+
+    static current& current_thread() noexcept
+    {
+        thread_local current state{nullptr, nullptr};
+        return state;
+    }
+
+    worker* current_worker() noexcept
+    {
+        const current& state = current_thread();
+        return state.pool == this ? state.self : nullptr;
+    }
+
+    bool find_task(worker* self, task& destination) noexcept
+    {
+        if (self != nullptr and self->tasks.pop(destination))
+        {
+            return true;
+        }
+        if (m_injection.try_pop(destination))
+        {
+            return true;
+        }
+
+        const size_t count = m_workers.size();
+        size_t victim = self != nullptr ? next_random(*self) % count : 0;
+        for (size_t attempt = 0; attempt < count; ++attempt)
+        {
+            worker& other = *m_workers[victim];
+            if (&other != self and other.tasks.steal(destination))
+            {
+                return true;
+            }
+            victim = victim + 1 == count ? 0 : victim + 1;
+        }
+        return false;
+    }
+
+    static std::uint32_t next_random(worker& w) noexcept
+    {
+        // xorshift32
+        w.random ^= w.random << 13;
+        w.random ^= w.random >> 17;
+        w.random ^= w.random << 5;
+        return w.random;
+    }
+
+    void run(worker& self)
+    {
+        current_thread() = current{this, &self};
+        task work;
+        for (;;)
+        {
+            if (find_task(&self, work))
+            {
+                work();
+                work = nullptr;
+                continue;
+            }
+
+            // Sleep until a submission after this ticket; rechecking for
+            // work after taking the ticket closes the race with a submitter
+            // that saw no sleepers.
+            const std::uint64_t ticket = m_wakeups->load();
+            if (find_task(&self, work))
+            {
+                work();
+                work = nullptr;
+                continue;
+            }
+            if (m_stopping.load())
+            {
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock{m_sleep_mutex};
+            m_sleepers.fetch_add(1);
+            while (m_wakeups->load() == ticket and not m_stopping.load())
+            {
+                m_sleep.wait(lock);
+            }
+            m_sleepers.fetch_sub(1);
+        }
+    }
+
+    void wake_one()
+    {
+        m_wakeups->fetch_add(1);
+        if (m_sleepers.load() != 0)
+        {
+            std::lock_guard<std::mutex> lock{m_sleep_mutex};
+            m_sleep.notify_one();
+        }
+    }
+
+    void wake_all()
+    {
+        m_wakeups->fetch_add(1);
+        std::lock_guard<std::mutex> lock{m_sleep_mutex};
+        m_sleep.notify_all();
+    }
+
+    vector<unique_ptr<worker>> m_workers;
+    mpmc_queue<task> m_injection;
+    cache_padded<std::atomic<std::uint64_t>> m_wakeups;
+    std::atomic<unsigned> m_sleepers{0};
+    std::atomic<bool> m_stopping{false};
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_sleep;
+};
+} // namespace ohmy
+
+#endif // OHMY_THREAD_POOL_HPP
@@ -0,0 +1,424 @@
+#include <catch/catch.hpp>
+
+#include "allocation_tracking.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+template <typename Pool>
+long fib(Pool& pool, int n)
+{
+    if (n < 2)
+    {
+        return n;
+    }
+    if (n < 12)
+    {
+        return fib(pool, n - 1) + fib(pool, n - 2);
+    }
+
+    long first = 0;
+    ohmy::latch done{1};
+    pool.submit([&] {
+        first = fib(pool, n - 1);
+        done.count_down();
+    });
+    const long second = fib(pool, n - 2);
+    pool.wait(done);
+    return first + second;
+}
+
+template <typename Pool, typename Iterator>
+void parallel_sort(Pool& pool, Iterator first, Iterator last)
+{
+    if (last - first < 4096)
+    {
+        std::sort(first, last);
+        return;
+    }
+
+    const Iterator middle = first + (last - first) / 2;
+    ohmy::latch done{1};
+    pool.submit([&] {
+        parallel_sort(pool, first, middle);
+        done.count_down();
+    });
+    parallel_sort(pool, middle, last);
+    pool.wait(done);
+    std::inplace_merge(first, middle, last);
+}
+
+// The baseline for the benchmarks: one queue behind one lock, with the
+// same helping wait as thread_pool.
+class locked_pool
+{
+public:
+    explicit locked_pool(unsigned threads)
+    {
+        for (unsigned i = 0; i < threads; ++i)
+        {
+            m_threads.emplace_back([this] {
+                std::function<void()> work;
+                while (pop(work, true))
+                {
+                    work();
+                }
+            });
+        }
+    }
+
+    ~locked_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_stopping = true;
+        }
+        m_ready.notify_all();
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    template <typename Functor>
+    void submit(Functor&& f)
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_tasks.emplace_back(std::forward<Functor>(f));
+        }
+        m_ready.notify_one();
+    }
+
+    void wait(ohmy::latch& done)
+    {
+        std::function<void()> work;
+        while (not done.try_wait())
+        {
+            if (pop(work, false))
+            {
+                work();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    bool pop(std::function<void()>& work, bool block)
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (block and m_tasks.empty() and not m_stopping)
+        {
+            m_ready.wait(lock);
+        }
+        if (m_tasks.empty())
+        {
+            return false;
+        }
+        work = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        return true;
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
+} // namespace
+
+TEST_CASE("work_stealing_deque")
+{
+    SECTION("the owner pops newest first and thieves steal oldest first")
+    {
+        ohmy::work_stealing_deque<int> deque{4};
+        for (int i = 0; i < 4; ++i)
+        {
+            int value = i;
+            REQUIRE(deque.push(ohmy::move(value)));
+        }
+        int overflow = 4;
+        REQUIRE_FALSE(deque.push(ohmy::move(overflow)));
+
+        int value = -1;
+        REQUIRE(deque.pop(value));
+        REQUIRE(value == 3);
+        REQUIRE(deque.steal(value));
+        REQUIRE(value == 0);
+        REQUIRE(deque.steal(value));
+        REQUIRE(value == 1);
+        REQUIRE(deque.pop(value));
+        REQUIRE(value == 2);
+        REQUIRE_FALSE(deque.pop(value));
+        REQUIRE_FALSE(deque.steal(value));
+        REQUIRE(deque.empty());
+    }
+
+    SECTION("each element is taken exactly once under contention")
+    {
+        constexpr int count = 50000;
+        ohmy::work_stealing_deque<int> deque{64};
+        std::vector<std::atomic<int>> seen(count);
+        std::atomic<int> taken{0};
+
+        std::vector<std::thread> thieves;
+        for (int t = 0; t < 3; ++t)
+        {
+            thieves.emplace_back([&] {
+                int value;
+                while (taken.load() < count)
+                {
+                    if (deque.steal(value))
+                    {
+                        seen[value].fetch_add(1);
+                        taken.fetch_add(1);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        int value;
+        for (int i = 0; i < count; ++i)
+        {
+            int pushed = i;
+            while (not deque.push(ohmy::move(pushed)))
+            {
+                if (deque.pop(value))
+                {
+                    seen[value].fetch_add(1);
+                    taken.fetch_add(1);
+                }
+            }
+            if (i % 3 == 0 and deque.pop(value))
+            {
+                seen[value].fetch_add(1);
+                taken.fetch_add(1);
+            }
+        }
+        while (deque.pop(value))
+        {
+            seen[value].fetch_add(1);
+            taken.fetch_add(1);
+        }
+        for (auto& thief : thieves)
+        {
+            thief.join();
+        }
+
+        REQUIRE(std::all_of(seen.begin(), seen.end(),
+                            [](const std::atomic<int>& n) { return n == 1; }));
+    }
+}
+
+TEST_CASE("thread_pool")
+{
+    ohmy::thread_pool pool{4};
+    REQUIRE(pool.size() == 4u);
+
+    SECTION("submitted tasks run, and submitting does not allocate")
+    {
+        constexpr int count = 200;
+        std::atomic<int> sum{0};
+        ohmy::latch done{count};
+        {
+            ohmy::allocation_scope scope;
+            for (int i = 0; i < count; ++i)
+            {
+                pool.submit([&sum, &done, i] {
+                    sum += i;
+                    done.count_down();
+                });
+            }
+            REQUIRE(scope.allocations() == 0u);
+        }
+        pool.wait(done);
+        REQUIRE(sum == count * (count - 1) / 2);
+    }
+
+    SECTION("tasks fork and join recursively")
+    {
+        REQUIRE(fib(pool, 24) == 46368);
+    }
+
+    SECTION("parallel_for visits every index once")
+    {
+        std::vector<int> visits(10007);
+        pool.parallel_for(std::size_t{0}, visits.size(),
+                          [&](std::size_t i) { ++visits[i]; });
+        REQUIRE(std::all_of(visits.begin(), visits.end(),
+                            [](int n) { return n == 1; }));
+
+        int calls = 0;
+        pool.parallel_for(5, 5, [&](int) { ++calls; });
+        pool.parallel_for(0, 3, [&](int) { ++calls; }, 100);
+        REQUIRE(calls == 3);
+    }
+
+    SECTION("parallel_for finishes the other chunks when body throws")
+    {
+        std::vector<std::atomic<int>> visits(1000);
+        auto body = [&](std::size_t i) {
+            if (i == 0)
+                throw std::runtime_error("first index");
+            ++visits[i];
+        };
+        REQUIRE_THROWS_AS(pool.parallel_for(std::size_t{0}, visits.size(),
+                                            body, std::size_t{10}),
+                          std::runtime_error);
+        REQUIRE(std::all_of(visits.begin() + 10, visits.end(),
+                            [](const std::atomic<int>& n) { return n == 1; }));
+    }
+
+    SECTION("parallel sort")
+    {
+        std::vector<int> values(100000);
+        std::mt19937 generator{42};
+        for (int& value : values)
+        {
+            value = static_cast<int>(generator());
+        }
+        parallel_sort(pool, values.begin(), values.end());
+        REQUIRE(std::is_sorted(values.begin(), values.end()));
+    }
+
+    SECTION("a full queue runs the task on the submitting thread")
+    {
+        ohmy::latch release{1};
+        ohmy::latch finished{3};
+        std::atomic<int> inline_runs{0};
+        const auto caller = std::this_thread::get_id();
+
+        // One worker, blocked by the first task, and room for two more.
+        ohmy::thread_pool small{1, 2};
+
+        small.submit([&] { release.wait(); });
+        for (int i = 0; i < 3; ++i)
+        {
+            small.submit([&] {
+                if (std::this_thread::get_id() == caller)
+                {
+                    ++inline_runs;
+                }
+                finished.count_down();
+            });
+        }
+        release.count_down();
+        small.wait(finished);
+        REQUIRE(inline_runs >= 1);
+    }
+
+    SECTION("parallel_for waits for queued chunks when an inline one throws")
+    {
+        ohmy::latch release{1};
+        std::atomic<bool> blocked{false};
+        ohmy::thread_pool small{1, 2};
+        small.submit([&] {
+            blocked = true;
+            release.wait();
+        });
+        while (not blocked)
+        {
+            std::this_thread::yield();
+        }
+
+        // Two chunks fit in the queue and the rest run inline in submit,
+        // where the one starting at 40 throws.
+        std::vector<std::atomic<int>> visits(64);
+        auto body = [&](int i) {
+            if (i >= 40)
+                throw std::runtime_error("inline chunk");
+            ++visits[i];
+        };
+        REQUIRE_THROWS_AS(small.parallel_for(0, 64, body, 8),
+                          std::runtime_error);
+        REQUIRE(std::all_of(visits.begin(), visits.begin() + 40,
+                            [](const std::atomic<int>& n) { return n == 1; }));
+        release.count_down();
+    }
+}
+
+TEST_CASE("thread_pool without workers runs tasks in wait")
+{
+    ohmy::thread_pool pool{0};
+    std::vector<int> visits(100);
+    pool.parallel_for(std::size_t{0}, visits.size(),
+                      [&](std::size_t i) { ++visits[i]; });
+    REQUIRE(std::all_of(visits.begin(), visits.end(),
+                        [](int n) { return n == 1; }));
+}
+
+TEST_CASE("thread_pool destruction runs pending tasks")
+{
+    std::atomic<int> runs{0};
+    {
+        ohmy::thread_pool pool{2};
+        for (int i = 0; i < 100; ++i)
+        {
+            pool.submit([&runs] { ++runs; });
+        }
+    }
+    REQUIRE(runs == 100);
+}
+
+TEST_CASE("thread_pool benchmarks", "[.benchmark]")
+{
+    const unsigned threads = ohmy::thread_pool::default_thread_count();
+    ohmy::thread_pool stealing{threads};
+    locked_pool locked{threads};
+
+    BENCHMARK("fib(30), single global locked queue")
+    {
+        REQUIRE(fib(locked, 30) == 832040);
+    }
+
+    BENCHMARK("fib(30), work-stealing thread_pool")
+    {
+        REQUIRE(fib(stealing, 30) == 832040);
+    }
+
+    std::vector<int> input(1 << 22);
+    std::mt19937 generator{7};
+    for (int& value : input)
+    {
+        value = static_cast<int>(generator());
+    }
+
+    std::vector<int> values = input;
+    BENCHMARK("sort 4M ints, std::sort on one thread")
+    {
+        values = input;
+        std::sort(values.begin(), values.end());
+    }
+
+    BENCHMARK("sort 4M ints, single global locked queue")
+    {
+        values = input;
+        parallel_sort(locked, values.begin(), values.end());
+    }
+
+    BENCHMARK("sort 4M ints, work-stealing thread_pool")
+    {
+        values = input;
+        parallel_sort(stealing, values.begin(), values.end());
+    }
+    REQUIRE(std::is_sorted(values.begin(), values.end()));
+}
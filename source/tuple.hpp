@@ -0,0 +1,583 @@
+#ifndef OHMY_TUPLE_HPP
+#define OHMY_TUPLE_HPP
+
+#include "c++config.hpp"
+#include "functional.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <utility>
+
+// Fixed-size heterogeneous aggregates whose empty members take no space,
+// so a stateless deleter, allocator or comparator kept next to a pointer
+// leaves it pointer-sized. Every element sits in its own leaf with a
+// [[no_unique_address]] member, which also works for final types that
+// cannot be derived from.
+//
+// tuple derives from all of its leaves at once rather than from a chain of
+// tuples one element shorter, and get picks its leaf by overload
+// resolution, so a wide tuple instantiates its leaves and nothing nested.
+// Copying and moving are trivial when they are for every element. Both
+// work with structured bindings through the std::tuple_size and
+// std::tuple_element protocol.
+namespace ohmy
+{
+template <typename... Types>
+class tuple;
+
+template <typename First, typename Second>
+struct pair;
+
+namespace detail
+{
+template <typename... Types>
+inline constexpr bool is_tuple_like_v<tuple<Types...>> = true;
+
+template <typename First, typename Second>
+inline constexpr bool is_tuple_like_v<pair<First, Second>> = true;
+} // namespace detail
+
+template <typename... Types>
+void swap(tuple<Types...>& lhs, tuple<Types...>& rhs);
+
+template <typename First, typename Second>
+void swap(pair<First, Second>& lhs, pair<First, Second>& rhs);
+
+template <size_t Index, typename... Types>
+constexpr typename std::tuple_element<Index, tuple<Types...>>::type&
+get(tuple<Types...>& value) noexcept;
+
+template <typename Tuple>
+inline constexpr size_t tuple_size_v = std::tuple_size<Tuple>::value;
+
+template <size_t Index, typename Tuple>
+using tuple_element_t = typename std::tuple_element<Index, Tuple>::type;
+
+namespace detail
+{
+template <size_t Index, typename Type>
+struct tuple_leaf
+{
+    constexpr tuple_leaf() : m_value()
+    {
+    }
+
+    template <typename Other>
+    constexpr explicit tuple_leaf(in_place_t, Other&& value)
+        : m_value(ohmy::forward<Other>(value))
+    {
+    }
+
+    [[no_unique_address]] Type m_value;
+};
+
+// Assigning to a reference element assigns to what it refers to.
+template <size_t Index, typename Type>
+struct tuple_leaf<Index, Type&>
+{
+    template <typename Other>
+    constexpr explicit tuple_leaf(in_place_t, Other&& value)
+        : m_value(ohmy::forward<Other>(value))
+    {
+    }
+
+    tuple_leaf(const tuple_leaf&) = default;
+
+    constexpr tuple_leaf& operator=(const tuple_leaf& other)
+    {
+        m_value = other.m_value;
+        return *this;
+    }
+
+    Type& m_value;
+};
+
+template <typename Indices, typename... Types>
+struct tuple_storage;
+
+template <size_t... Indices, typename... Types>
+struct tuple_storage<index_sequence<Indices...>, Types...>
+    : tuple_leaf<Indices, Types>...
+{
+    constexpr tuple_storage() = default;
+
+    template <typename... OtherTypes>
+    constexpr explicit tuple_storage(in_place_t, OtherTypes&&... values)
+        : tuple_leaf<Indices, Types>(in_place,
+                                     ohmy::forward<OtherTypes>(values))...
+    {
+    }
+};
+
+template <size_t Index, typename Type>
+constexpr tuple_leaf<Index, Type>&
+leaf_at(tuple_leaf<Index, Type>& leaf) noexcept
+{
+    return leaf;
+}
+
+template <size_t Index, typename Type>
+constexpr const tuple_leaf<Index, Type>&
+leaf_at(const tuple_leaf<Index, Type>& leaf) noexcept
+{
+    return leaf;
+}
+
+template <typename Type, size_t Index>
+constexpr tuple_leaf<Index, Type>&
+select_leaf(tuple_leaf<Index, Type>& leaf) noexcept
+{
+    return leaf;
+}
+
+template <typename Type, size_t Index>
+constexpr const tuple_leaf<Index, Type>&
+select_leaf(const tuple_leaf<Index, Type>& leaf) noexcept
+{
+    return leaf;
+}
+
+struct tuple_access
+{
+    template <typename... Types>
+    static constexpr auto& storage(tuple<Types...>& value) noexcept
+    {
+        return static_cast<
+            tuple_storage<index_sequence_for<Types...>, Types...>&>(value);
+    }
+
+    template <typename... Types>
+    static constexpr const auto& storage(const tuple<Types...>& value) noexcept
+    {
+        return static_cast<
+            const tuple_storage<index_sequence_for<Types...>, Types...>&>(
+            value);
+    }
+
+    template <size_t Index, typename Tuple>
+    static constexpr auto& leaf(Tuple& value) noexcept
+    {
+        return leaf_at<Index>(storage(value));
+    }
+};
+
+template <bool SameSize, typename Tuple, typename... OtherTypes>
+struct is_tuple_constructible : false_type
+{
+};
+
+template <typename... Types, typename... OtherTypes>
+struct is_tuple_constructible<true, tuple<Types...>, OtherTypes...>
+    : bool_constant<(is_constructible_v<Types, OtherTypes> and ...)>
+{
+};
+
+template <typename Tuple, typename... OtherTypes>
+inline constexpr bool is_tuple_constructible_v = is_tuple_constructible<
+    tuple_size_v<Tuple> == sizeof...(OtherTypes), Tuple, OtherTypes...>::value;
+} // namespace detail
+
+template <typename... Types>
+class tuple
+    : private detail::tuple_storage<index_sequence_for<Types...>, Types...>
+{
+    using base = detail::tuple_storage<index_sequence_for<Types...>, Types...>;
+
+    friend struct detail::tuple_access;
+
+    template <typename Other>
+    static constexpr bool is_self_v =
+        sizeof...(Types) == 1 and is_same_v<remove_cvref_t<Other>, tuple>;
+
+public:
+    constexpr tuple() = default;
+    constexpr tuple(const tuple&) = default;
+    constexpr tuple(tuple&&) = default;
+    tuple& operator=(const tuple&) = default;
+    tuple& operator=(tuple&&) = default;
+
+    template <typename... OtherTypes,
+              typename = enable_if_t<
+                  sizeof...(OtherTypes) != 0 and
+                  not(is_self_v<OtherTypes> and ...) and
+                  detail::is_tuple_constructible_v<tuple, OtherTypes&&...>>>
+    constexpr tuple(OtherTypes&&... values)
+        : base(in_place, ohmy::forward<OtherTypes>(values)...)
+    {
+    }
+
+    template <typename... OtherTypes,
+              typename = enable_if_t<
+                  not is_same_v<tuple<OtherTypes...>, tuple> and
+                  detail::is_tuple_constructible_v<tuple,
+                                                   const OtherTypes&...>>>
+    constexpr tuple(const tuple<OtherTypes...>& other)
+        : tuple(other, index_sequence_for<Types...>{})
+    {
+    }
+
+    template <typename... OtherTypes,
+              typename = enable_if_t<
+                  not is_same_v<tuple<OtherTypes...>, tuple> and
+                  detail::is_tuple_constructible_v<tuple, OtherTypes&&...>>>
+    constexpr tuple(tuple<OtherTypes...>&& other)
+        : tuple(ohmy::move(other), index_sequence_for<Types...>{})
+    {
+    }
+
+    // Assigns element by element, which is how tie unpacks a tuple into
+    // existing variables.
+    template <typename... OtherTypes,
+              typename = enable_if_t<
+                  sizeof...(OtherTypes) == sizeof...(Types) and
+                  not is_same_v<tuple<OtherTypes...>, tuple>>>
+    constexpr tuple& operator=(const tuple<OtherTypes...>& other)
+    {
+        assign(other, index_sequence_for<Types...>{});
+        return *this;
+    }
+
+    template <typename... OtherTypes,
+              typename = enable_if_t<
+                  sizeof...(OtherTypes) == sizeof...(Types) and
+                  not is_same_v<tuple<OtherTypes...>, tuple>>>
+    constexpr tuple& operator=(tuple<OtherTypes...>&& other)
+    {
+        assign(ohmy::move(other), index_sequence_for<Types...>{});
+        return *this;
+    }
+
+    void swap(tuple& other)
+    {
+        swap(other, index_sequence_for<Types...>{});
+    }
+
+private:
+    template <typename Other, size_t... Indices>
+    constexpr tuple(Other&& other, index_sequence<Indices...>)
+        : base(in_place, get<Indices>(ohmy::forward<Other>(other))...)
+    {
+    }
+
+    template <typename Other, size_t... Indices>
+    constexpr void assign(Other&& other, index_sequence<Indices...>)
+    {
+        ((get<Indices>(*this) = get<Indices>(ohmy::forward<Other>(other))),
+         ...);
+    }
+
+    template <size_t... Indices>
+    void swap(tuple& other, index_sequence<Indices...>)
+    {
+        (ohmy::swap(get<Indices>(*this), get<Indices>(other)), ...);
+    }
+};
+
+template <typename... Types>
+tuple(Types...) -> tuple<Types...>;
+
+template <typename First, typename Second>
+struct pair
+{
+    using first_type = First;
+    using second_type = Second;
+
+    template <typename OtherFirst = First, typename OtherSecond = Second,
+              typename = enable_if_t<is_default_constructible_v<OtherFirst> and
+                                     is_default_constructible_v<OtherSecond>>>
+    constexpr pair() : first(), second()
+    {
+    }
+
+    template <typename OtherFirst = First, typename OtherSecond = Second,
+              typename = enable_if_t<
+                  is_constructible_v<First, OtherFirst&&> and
+                  is_constructible_v<Second, OtherSecond&&>>>
+    constexpr pair(OtherFirst&& first_value, OtherSecond&& second_value)
+        : first(ohmy::forward<OtherFirst>(first_value)),
+          second(ohmy::forward<OtherSecond>(second_value))
+    {
+    }
+
+    template <typename OtherFirst, typename OtherSecond,
+              typename = enable_if_t<
+                  is_constructible_v<First, const OtherFirst&> and
+                  is_constructible_v<Second, const OtherSecond&>>>
+    constexpr pair(const pair<OtherFirst, OtherSecond>& other)
+        : first(other.first), second(other.second)
+    {
+    }
+
+    template <typename OtherFirst, typename OtherSecond,
+              typename = enable_if_t<
+                  is_constructible_v<First, OtherFirst&&> and
+                  is_constructible_v<Second, OtherSecond&&>>>
+    constexpr pair(pair<OtherFirst, OtherSecond>&& other)
+        : first(ohmy::forward<OtherFirst>(other.first)),
+          second(ohmy::forward<OtherSecond>(other.second))
+    {
+    }
+
+    constexpr pair(const pair&) = default;
+    constexpr pair(pair&&) = default;
+    pair& operator=(const pair&) = default;
+    pair& operator=(pair&&) = default;
+
+    void swap(pair& other)
+    {
+        ohmy::swap(first, other.first);
+        ohmy::swap(second, other.second);
+    }
+
+    [[no_unique_address]] First first;
+    [[no_unique_address]] Second second;
+};
+
+template <typename First, typename Second>
+pair(First, Second) -> pair<First, Second>;
+
+template <size_t Index, typename... Types>
+constexpr tuple_element_t<Index, tuple<Types...>>&
+get(tuple<Types...>& value) noexcept
+{
+    return detail::tuple_access::leaf<Index>(value).m_value;
+}
+
+template <size_t Index, typename... Types>
+constexpr const tuple_element_t<Index, tuple<Types...>>&
+get(const tuple<Types...>& value) noexcept
+{
+    return detail::tuple_access::leaf<Index>(value).m_value;
+}
+
+template <size_t Index, typename... Types>
+constexpr tuple_element_t<Index, tuple<Types...>>&&
+get(tuple<Types...>&& value) noexcept
+{
+    using type = tuple_element_t<Index, tuple<Types...>>;
+    return static_cast<type&&>(
+        detail::tuple_access::leaf<Index>(value).m_value);
+}
+
+template <size_t Index, typename... Types>
+constexpr const tuple_element_t<Index, tuple<Types...>>&&
+get(const tuple<Types...>&& value) noexcept
+{
+    using type = tuple_element_t<Index, tuple<Types...>>;
+    return static_cast<const type&&>(
+        detail::tuple_access::leaf<Index>(value).m_value);
+}
+
+// The element of type Type, which must occur exactly once.
+template <typename Type, typename... Types>
+constexpr Type& get(tuple<Types...>& value) noexcept
+{
+    return detail::select_leaf<Type>(detail::tuple_access::storage(value))
+        .m_value;
+}
+
+template <typename Type, typename... Types>
+constexpr const Type& get(const tuple<Types...>& value) noexcept
+{
+    return detail::select_leaf<Type>(detail::tuple_access::storage(value))
+        .m_value;
+}
+
+template <typename Type, typename... Types>
+constexpr Type&& get(tuple<Types...>&& value) noexcept
+{
+    return static_cast<Type&&>(ohmy::get<Type>(value));
+}
+
+template <size_t Index, typename First, typename Second>
+constexpr tuple_element_t<Index, pair<First, Second>>&
+get(pair<First, Second>& value) noexcept
+{
+    if constexpr (Index == 0)
+        return value.first;
+    else
+        return value.second;
+}
+
+template <size_t Index, typename First, typename Second>
+constexpr const tuple_element_t<Index, pair<First, Second>>&
+get(const pair<First, Second>& value) noexcept
+{
+    if constexpr (Index == 0)
+        return value.first;
+    else
+        return value.second;
+}
+
+template <size_t Index, typename First, typename Second>
+constexpr tuple_element_t<Index, pair<First, Second>>&&
+get(pair<First, Second>&& value) noexcept
+{
+    using type = tuple_element_t<Index, pair<First, Second>>;
+    return static_cast<type&&>(ohmy::get<Index>(value));
+}
+
+template <typename... Types>
+constexpr tuple<decay_t<Types>...> make_tuple(Types&&... values)
+{
+    return tuple<decay_t<Types>...>(ohmy::forward<Types>(values)...);
+}
+
+template <typename... Types>
+constexpr tuple<Types&...> tie(Types&... values) noexcept
+{
+    return tuple<Types&...>(values...);
+}
+
+template <typename First, typename Second>
+constexpr pair<decay_t<First>, decay_t<Second>> make_pair(First&& first,
+                                                         Second&& second)
+{
+    return pair<decay_t<First>, decay_t<Second>>(
+        ohmy::forward<First>(first), ohmy::forward<Second>(second));
+}
+
+namespace detail
+{
+template <typename Function, typename Tuple, size_t... Indices>
+constexpr decltype(auto) apply_indexed(Function&& function, Tuple&& value,
+                                       index_sequence<Indices...>)
+{
+    return ohmy::invoke(ohmy::forward<Function>(function),
+                        get<Indices>(ohmy::forward<Tuple>(value))...);
+}
+
+template <typename Lhs, typename Rhs, size_t... Indices>
+constexpr bool tuple_equal(const Lhs& lhs, const Rhs& rhs,
+                           index_sequence<Indices...>)
+{
+    return ((get<Indices>(lhs) == get<Indices>(rhs)) and ...);
+}
+
+// Lexicographic, without recursion: the fold stops at the first element
+// that differs, which decides the result.
+template <typename Lhs, typename Rhs, size_t... Indices>
+constexpr bool tuple_less(const Lhs& lhs, const Rhs& rhs,
+                          index_sequence<Indices...>)
+{
+    bool less = false;
+    (void)(((get<Indices>(lhs) < get<Indices>(rhs))
+                ? (less = true)
+                : static_cast<bool>(get<Indices>(rhs) < get<Indices>(lhs))) or
+           ...);
+    return less;
+}
+} // namespace detail
+
+// Calls function with the elements of a tuple, a pair or anything else
+// with tuple_size and get.
+template <typename Function, typename Tuple>
+constexpr decltype(auto) apply(Function&& function, Tuple&& value)
+{
+    return detail::apply_indexed(
+        ohmy::forward<Function>(function), ohmy::forward<Tuple>(value),
+        make_index_sequence<tuple_size_v<remove_cvref_t<Tuple>>>{});
+}
+
+template <typename... Types, typename... OtherTypes>
+constexpr bool operator==(const tuple<Types...>& lhs,
+                          const tuple<OtherTypes...>& rhs)
+{
+    static_assert(sizeof...(Types) == sizeof...(OtherTypes),
+                  "only tuples of the same size compare");
+    return detail::tuple_equal(lhs, rhs, index_sequence_for<Types...>{});
+}
+
+template <typename... Types, typename... OtherTypes>
+constexpr bool operator!=(const tuple<Types...>& lhs,
+                          const tuple<OtherTypes...>& rhs)
+{
+    return not(lhs == rhs);
+}
+
+template <typename... Types, typename... OtherTypes>
+constexpr bool operator<(const tuple<Types...>& lhs,
+                         const tuple<OtherTypes...>& rhs)
+{
+    static_assert(sizeof...(Types) == sizeof...(OtherTypes),
+                  "only tuples of the same size compare");
+    return detail::tuple_less(lhs, rhs, index_sequence_for<Types...>{});
+}
+
+template <typename First, typename Second, typename OtherFirst,
+          typename OtherSecond>
+constexpr bool operator==(const pair<First, Second>& lhs,
+                          const pair<OtherFirst, OtherSecond>& rhs)
+{
+    return lhs.first == rhs.first and lhs.second == rhs.second;
+}
+
+template <typename First, typename Second, typename OtherFirst,
+          typename OtherSecond>
+constexpr bool operator!=(const pair<First, Second>& lhs,
+                          const pair<OtherFirst, OtherSecond>& rhs)
+{
+    return not(lhs == rhs);
+}
+
+template <typename First, typename Second, typename OtherFirst,
+          typename OtherSecond>
+constexpr bool operator<(const pair<First, Second>& lhs,
+                         const pair<OtherFirst, OtherSecond>& rhs)
+{
+    return lhs.first < rhs.first or
+           (not(rhs.first < lhs.first) and lhs.second < rhs.second);
+}
+
+template <typename... Types>
+void swap(tuple<Types...>& lhs, tuple<Types...>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+template <typename First, typename Second>
+void swap(pair<First, Second>& lhs, pair<First, Second>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+template <typename... Types>
+struct is_trivially_relocatable<tuple<Types...>>
+    : conjunction<is_trivially_relocatable<Types>...>
+{
+};
+
+template <typename First, typename Second>
+struct is_trivially_relocatable<pair<First, Second>>
+    : conjunction<is_trivially_relocatable<First>,
+                  is_trivially_relocatable<Second>>
+{
+};
+} // namespace ohmy
+
+template <typename... Types>
+struct std::tuple_size<ohmy::tuple<Types...>>
+    : std::integral_constant<std::size_t, sizeof...(Types)>
+{
+};
+
+template <std::size_t Index, typename... Types>
+struct std::tuple_element<Index, ohmy::tuple<Types...>>
+{
+    using type = ohmy::detail::nth_type_t<Index, Types...>;
+};
+
+template <typename First, typename Second>
+struct std::tuple_size<ohmy::pair<First, Second>>
+    : std::integral_constant<std::size_t, 2>
+{
+};
+
+template <std::size_t Index, typename First, typename Second>
+struct std::tuple_element<Index, ohmy::pair<First, Second>>
+{
+    static_assert(Index < 2, "pair has two elements");
+    using type = ohmy::conditional_t<Index == 0, First, Second>;
+};
+
+#endif // OHMY_TUPLE_HPP
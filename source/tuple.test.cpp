@@ -0,0 +1,157 @@
+#include <catch/catch.hpp>
+
+#include "tuple.hpp"
+#include "memory.hpp"
+
+#include <string>
+
+namespace
+{
+struct empty
+{
+};
+
+struct other_empty
+{
+};
+
+struct final_empty final
+{
+};
+
+struct stateless_less
+{
+    bool operator()(int lhs, int rhs) const noexcept
+    {
+        return lhs < rhs;
+    }
+};
+
+template <size_t... Indices>
+ohmy::tuple<decltype(Indices)...> wide_tuple(ohmy::index_sequence<Indices...>);
+
+using wide = decltype(wide_tuple(ohmy::make_index_sequence<256>{}));
+} // namespace
+
+// Empty elements take no space, final ones included.
+static_assert(sizeof(ohmy::tuple<int*, empty>) == sizeof(int*));
+static_assert(sizeof(ohmy::tuple<empty, other_empty, int*>) == sizeof(int*));
+static_assert(sizeof(ohmy::tuple<final_empty, int*>) == sizeof(int*));
+static_assert(sizeof(ohmy::pair<stateless_less, int*>) == sizeof(int*));
+static_assert(sizeof(ohmy::pair<int*, final_empty>) == sizeof(int*));
+static_assert(ohmy::is_empty_v<ohmy::tuple<empty, other_empty>>);
+
+// Triviality follows the elements.
+static_assert(ohmy::is_trivially_copiable_v<ohmy::tuple<int, double, empty>>);
+static_assert(ohmy::is_trivially_copiable_v<ohmy::pair<int, char*>>);
+static_assert(not ohmy::is_trivially_copiable_v<ohmy::tuple<int, std::string>>);
+static_assert(ohmy::is_trivially_relocatable_v<
+              ohmy::tuple<ohmy::unique_ptr<int>, int>>);
+
+static_assert(ohmy::tuple_size_v<wide> == 256);
+static_assert(sizeof(wide) == 256 * sizeof(size_t));
+static_assert(ohmy::is_same_v<ohmy::tuple_element_t<200, wide>, size_t>);
+
+static_assert(ohmy::get<1>(ohmy::tuple<int, long, char>{1, 2, 'c'}) == 2);
+static_assert(ohmy::tuple{1, 'a'} < ohmy::tuple{1, 'b'});
+
+TEST_CASE("tuple")
+{
+    SECTION("elements by index and by type")
+    {
+        ohmy::tuple<int, std::string, double> value{1, "two", 3.0};
+        REQUIRE(ohmy::get<0>(value) == 1);
+        REQUIRE(ohmy::get<std::string>(value) == "two");
+        ohmy::get<double>(value) = 4.0;
+        REQUIRE(ohmy::get<2>(value) == 4.0);
+
+        std::string moved = ohmy::get<1>(std::move(value));
+        REQUIRE(moved == "two");
+    }
+
+    SECTION("default construction value-initializes")
+    {
+        ohmy::tuple<int, double, std::string> value;
+        REQUIRE(ohmy::get<0>(value) == 0);
+        REQUIRE(ohmy::get<1>(value) == 0.0);
+        REQUIRE(ohmy::get<2>(value).empty());
+    }
+
+    SECTION("structured bindings")
+    {
+        auto [number, text] = ohmy::make_tuple(7, std::string{"seven"});
+        REQUIRE(number == 7);
+        REQUIRE(text == "seven");
+
+        ohmy::pair<int, std::string> entry{8, "eight"};
+        auto& [key, name] = entry;
+        name += "!";
+        REQUIRE(key == 8);
+        REQUIRE(entry.second == "eight!");
+    }
+
+    SECTION("tie assigns through references")
+    {
+        int number = 0;
+        std::string text;
+        ohmy::tie(number, text) = ohmy::make_tuple(5, std::string{"five"});
+        REQUIRE(number == 5);
+        REQUIRE(text == "five");
+    }
+
+    SECTION("converting construction")
+    {
+        ohmy::tuple<int, const char*> narrow{1, "text"};
+        ohmy::tuple<long, std::string> widened = narrow;
+        REQUIRE(ohmy::get<0>(widened) == 1);
+        REQUIRE(ohmy::get<1>(widened) == "text");
+
+        ohmy::tuple<ohmy::unique_ptr<int>> owner{ohmy::make_unique<int>(3)};
+        ohmy::tuple<ohmy::unique_ptr<int>> moved = std::move(owner);
+        REQUIRE(*ohmy::get<0>(moved) == 3);
+        REQUIRE_FALSE(ohmy::get<0>(owner));
+    }
+
+    SECTION("apply")
+    {
+        auto sum = [](int a, long b, short c) { return a + b + c; };
+        REQUIRE(ohmy::apply(sum, ohmy::make_tuple(1, 2L, short{3})) == 6);
+        REQUIRE(ohmy::apply([](int a, int b) { return a * b; },
+                            ohmy::make_pair(4, 5)) == 20);
+        REQUIRE(ohmy::apply([] { return 9; }, ohmy::tuple<>{}) == 9);
+    }
+
+    SECTION("comparison is lexicographic")
+    {
+        REQUIRE(ohmy::make_tuple(1, 2, 3) == ohmy::make_tuple(1, 2, 3));
+        REQUIRE(ohmy::make_tuple(1, 2, 3) != ohmy::make_tuple(1, 2, 4));
+        REQUIRE(ohmy::make_tuple(1, 2, 3) < ohmy::make_tuple(1, 3, 0));
+        REQUIRE_FALSE(ohmy::make_tuple(1, 3, 0) < ohmy::make_tuple(1, 2, 3));
+        REQUIRE_FALSE(ohmy::make_tuple(1, 2, 3) < ohmy::make_tuple(1, 2, 3));
+        REQUIRE(ohmy::make_pair(1, 9) < ohmy::make_pair(2, 0));
+        REQUIRE(ohmy::make_pair(1, 9) != ohmy::make_pair(1, 8));
+    }
+
+    SECTION("swap exchanges every element")
+    {
+        ohmy::tuple<int, std::string> a{1, "one"};
+        ohmy::tuple<int, std::string> b{2, "two"};
+        ohmy::swap(a, b);
+        REQUIRE(a == ohmy::make_tuple(2, std::string{"two"}));
+        REQUIRE(ohmy::get<1>(b) == "one");
+
+        ohmy::pair<ohmy::tuple<int>, int> c{ohmy::tuple<int>{3}, 4};
+        ohmy::pair<ohmy::tuple<int>, int> d{ohmy::tuple<int>{5}, 6};
+        ohmy::swap(c, d);
+        REQUIRE(ohmy::get<0>(c.first) == 5);
+        REQUIRE(d.second == 4);
+    }
+
+    SECTION("wide tuples")
+    {
+        wide value{};
+        ohmy::get<255>(value) = 255;
+        REQUIRE(ohmy::get<255>(value) == 255u);
+        REQUIRE(ohmy::get<0>(value) == 0u);
+    }
+}
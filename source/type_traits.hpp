@@ -3,6 +3,8 @@
 
 #include "c++config.hpp"
 
+#include <utility>
+
 namespace ohmy
 {
 template <typename Type, Type parameter_value>
@@ -294,6 +296,9 @@ struct is_const<Type const> : true_type
 {
 };
 
+template <typename Type>
+inline constexpr bool is_const_v = is_const<Type>::value;
+
 template <typename Type>
 struct is_lvalue_reference : false_type
 {
@@ -366,6 +371,41 @@ struct is_object
 template <typename Type>
 inline constexpr bool is_object_v = is_object<Type>::value;
 
+namespace detail
+{
+template <typename>
+struct is_member_function_pointer_helper : false_type
+{
+};
+
+template <typename Type, typename Class>
+struct is_member_function_pointer_helper<Type Class::*>
+    : is_function<Type>::type
+{
+};
+} // namespace detail
+
+template <typename Type>
+struct is_member_function_pointer
+    : detail::is_member_function_pointer_helper<remove_cv_t<Type>>::type
+{
+};
+
+template <typename Type>
+inline constexpr bool is_member_function_pointer_v =
+    is_member_function_pointer<Type>::value;
+
+template <typename Type>
+struct is_member_object_pointer
+    : bool_constant<is_member_pointer_v<Type> and
+                    not is_member_function_pointer_v<Type>>
+{
+};
+
+template <typename Type>
+inline constexpr bool is_member_object_pointer_v =
+    is_member_object_pointer<Type>::value;
+
 namespace detail
 {
 template <typename Type>
@@ -373,6 +413,27 @@ struct is_referencable : operator_or<is_object<Type>, is_reference<Type>>::type
 {
 };
 
+// Function types without cv- or ref-qualifiers can be referenced as well.
+template <typename Result, typename... ArgumentTypes>
+struct is_referencable<Result(ArgumentTypes...)> : true_type
+{
+};
+
+template <typename Result, typename... ArgumentTypes>
+struct is_referencable<Result(ArgumentTypes..., ...)> : true_type
+{
+};
+
+template <typename Result, typename... ArgumentTypes>
+struct is_referencable<Result(ArgumentTypes...) noexcept> : true_type
+{
+};
+
+template <typename Result, typename... ArgumentTypes>
+struct is_referencable<Result(ArgumentTypes..., ...) noexcept> : true_type
+{
+};
+
 template <typename Type>
 inline constexpr bool is_referencable_v = is_referencable<Type>::value;
 
@@ -441,6 +502,15 @@ struct remove_reference<Type&&>
 template <typename Type>
 using remove_reference_t = typename remove_reference<Type>::type;
 
+template <typename Type>
+struct remove_cvref
+{
+    using type = remove_cv_t<remove_reference_t<Type>>;
+};
+
+template <typename Type>
+using remove_cvref_t = typename remove_cvref<Type>::type;
+
 namespace detail
 {
 template <typename Type>
@@ -497,6 +567,38 @@ struct is_convertible : detail::is_convertible_helper<From, To>::type
 template <typename From, typename To>
 inline constexpr bool is_convertible_v = is_convertible<From, To>::value;
 
+namespace detail
+{
+template <typename From, typename To,
+          bool = is_void<To>::value or not is_convertible<From, To>::value>
+struct is_nothrow_convertible_helper
+{
+    using type = typename is_convertible<From, To>::type;
+};
+
+template <typename From, typename To>
+struct is_nothrow_convertible_helper<From, To, false>
+{
+private:
+    template <typename To_Internal>
+    static void test_function_aux(To_Internal) noexcept;
+
+public:
+    using type =
+        bool_constant<noexcept(test_function_aux<To>(declval<From>()))>;
+};
+} // namespace detail
+
+template <typename From, typename To>
+struct is_nothrow_convertible
+    : detail::is_nothrow_convertible_helper<From, To>::type
+{
+};
+
+template <typename From, typename To>
+inline constexpr bool is_nothrow_convertible_v =
+    is_nothrow_convertible<From, To>::value;
+
 template <bool, typename Type = void>
 struct enable_if
 {
@@ -1024,6 +1126,11 @@ inline constexpr bool is_assignable_v<
     Type, OtherType, void_t<decltype(declval<Type>() = declval<OtherType>())>> =
     true;
 
+template <typename Type>
+inline constexpr bool is_copy_assignable_v =
+    (detail::is_referencable_v<Type> ? is_assignable_v<Type&, const Type&>
+                                     : false);
+
 template <typename Type>
 inline constexpr bool is_move_assignable_v =
     (detail::is_referencable_v<Type> ? is_assignable_v<Type&, Type&&> : false);
@@ -1053,6 +1160,64 @@ struct is_trivially_copiable
 template <typename Type>
 inline constexpr bool is_trivially_copiable_v = (__is_trivially_copyable(Type));
 
+template <typename Type>
+struct is_trivial : bool_constant<__is_trivial(Type)>
+{
+};
+
+template <typename Type>
+inline constexpr bool is_trivial_v = is_trivial<Type>::value;
+
+template <typename Type>
+struct is_trivially_destructible
+    : bool_constant<is_destructible_v<Type> and __has_trivial_destructor(Type)>
+{
+};
+
+template <typename Type>
+inline constexpr bool is_trivially_destructible_v =
+    is_trivially_destructible<Type>::value;
+
+template <typename Type>
+struct is_empty : bool_constant<__is_empty(Type)>
+{
+};
+
+template <typename Type>
+inline constexpr bool is_empty_v = is_empty<Type>::value;
+
+// Relocating an object of a trivially relocatable type (move-constructing it
+// at a new address and destroying the source) is equivalent to copying its
+// bytes. Trivially copyable types are inferred; any other type can opt in by
+// specializing this trait.
+template <typename Type>
+struct is_trivially_relocatable : is_trivially_copiable<Type>
+{
+};
+
+template <typename Type, size_t Size>
+struct is_trivially_relocatable<Type[Size]> : is_trivially_relocatable<Type>
+{
+};
+
+// A pair is relocated by relocating its members. This lives next to the
+// primary template so every translation unit sees the same answer.
+template <typename First, typename Second>
+struct is_trivially_relocatable<std::pair<First, Second>>
+    : conjunction<is_trivially_relocatable<First>,
+                  is_trivially_relocatable<Second>>
+{
+};
+
+template <typename Type>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<Type>::value;
+
+template <typename Type>
+inline constexpr bool is_nothrow_relocatable_v =
+    (is_trivially_relocatable_v<Type> or
+     is_nothrow_move_constructible_v<Type>);
+
 namespace detail
 {
 template <typename Type, bool = is_referencable_v<Type> or is_void_v<Type>>
@@ -1076,6 +1241,39 @@ struct add_pointer : public detail::add_pointer_helper<Type>
 template <typename Type>
 using add_pointer_t = typename add_pointer<Type>::type;
 
+template <typename Type>
+struct remove_pointer
+{
+    using type = Type;
+};
+
+template <typename Type>
+struct remove_pointer<Type*>
+{
+    using type = Type;
+};
+
+template <typename Type>
+struct remove_pointer<Type* const>
+{
+    using type = Type;
+};
+
+template <typename Type>
+struct remove_pointer<Type* volatile>
+{
+    using type = Type;
+};
+
+template <typename Type>
+struct remove_pointer<Type* const volatile>
+{
+    using type = Type;
+};
+
+template <typename Type>
+using remove_pointer_t = typename remove_pointer<Type>::type;
+
 namespace detail
 {
 template <typename Type, bool IsArray = is_array_v<Type>,
@@ -1141,6 +1339,23 @@ struct invoke_result_success : success_type<Type>
     using invoke_type = Tag;
 };
 
+template <typename Type, typename OtherType = decay_t<Type>>
+struct inv_unwrap
+{
+    using type = Type;
+};
+
+template <typename Type, typename OtherType>
+struct inv_unwrap<Type, reference_wrapper<OtherType>>
+{
+    using type = OtherType&;
+};
+
+template <typename Type, typename OtherType = decay_t<Type>>
+using inv_unwrap_t = typename inv_unwrap<Type, OtherType>::type;
+
+// Each *_impl tests one form of INVOKE and names the invoke_impl overload
+// that performs it through invoke_type.
 struct invoke_result_memfun_ref_impl
 {
     template <typename MemberFunction, typename Type, typename... ArgumentTypes>
@@ -1154,28 +1369,190 @@ struct invoke_result_memfun_ref_impl
     static failure_type private_test(...);
 };
 
-template <typename Type, typename OtherType = decay_t<Type>>
-struct inv_unwrap
+struct invoke_result_memfun_deref_impl
 {
-    using type = Type;
+    template <typename MemberFunction, typename Type, typename... ArgumentTypes>
+    static invoke_result_success<decltype(((*ohmy::declval<Type>()).*
+                                           ohmy::declval<MemberFunction>())(
+                                     ohmy::declval<ArgumentTypes>()...)),
+                                 invoke_memfun_deref>
+    private_test(int);
+
+    template <typename...>
+    static failure_type private_test(...);
 };
 
-template <typename Type, typename OtherType>
-struct inv_unwrap<Type, reference_wrapper<OtherType>>
+struct invoke_result_memobj_ref_impl
 {
-    using type = OtherType&;
+    template <typename MemberPointer, typename Type>
+    static invoke_result_success<decltype(ohmy::declval<Type>().*
+                                          ohmy::declval<MemberPointer>()),
+                                 invoke_memobj_ref>
+    private_test(int);
+
+    template <typename, typename>
+    static failure_type private_test(...);
 };
 
-template <typename Type, typename OtherType = decay_t<Type>>
-using inv_unwrap_t = typename inv_unwrap<Type, OtherType>::type;
+struct invoke_result_memobj_deref_impl
+{
+    template <typename MemberPointer, typename Type>
+    static invoke_result_success<decltype((*ohmy::declval<Type>()).*
+                                          ohmy::declval<MemberPointer>()),
+                                 invoke_memobj_deref>
+    private_test(int);
+
+    template <typename, typename>
+    static failure_type private_test(...);
+};
+
+struct invoke_result_other_impl
+{
+    template <typename Callable, typename... ArgumentTypes>
+    static invoke_result_success<decltype(ohmy::declval<Callable>()(
+                                     ohmy::declval<ArgumentTypes>()...)),
+                                 invoke_other>
+    private_test(int);
+
+    template <typename...>
+    static failure_type private_test(...);
+};
+
+// The object argument of a member pointer call is used directly when it is
+// the class or derived from it, unwrapped when it is a reference_wrapper,
+// and dereferenced otherwise.
+template <typename Class, typename Argument,
+          typename Object = remove_cv_t<remove_reference_t<Argument>>>
+inline constexpr bool is_invoke_object_v =
+    is_same_v<Class, Object> or is_base_of_v<Class, Object>;
 
-template <bool, bool, typename Callable, typename... ArgumentTypes>
+template <typename Argument,
+          typename Object = remove_cv_t<remove_reference_t<Argument>>>
+inline constexpr bool is_invoke_reference_wrapper_v =
+    not is_same_v<inv_unwrap_t<Object>, Object>;
+
+template <typename MemberPointer, typename Argument, typename... ArgumentTypes>
+struct invoke_result_memfun;
+
+template <typename Member, typename Class, typename Argument,
+          typename... ArgumentTypes>
+struct invoke_result_memfun<Member Class::*, Argument, ArgumentTypes...>
+{
+    using impl = conditional_t<is_invoke_object_v<Class, Argument> or
+                                   is_invoke_reference_wrapper_v<Argument>,
+                               invoke_result_memfun_ref_impl,
+                               invoke_result_memfun_deref_impl>;
+    using object = conditional_t<is_invoke_reference_wrapper_v<Argument>,
+                                 inv_unwrap_t<Argument>, Argument>;
+
+    using type = decltype(impl::template private_test<Member Class::*, object,
+                                                      ArgumentTypes...>(0));
+};
+
+template <typename MemberPointer, typename Argument>
+struct invoke_result_memobj;
+
+template <typename Member, typename Class, typename Argument>
+struct invoke_result_memobj<Member Class::*, Argument>
+{
+    using impl = conditional_t<is_invoke_object_v<Class, Argument> or
+                                   is_invoke_reference_wrapper_v<Argument>,
+                               invoke_result_memobj_ref_impl,
+                               invoke_result_memobj_deref_impl>;
+    using object = conditional_t<is_invoke_reference_wrapper_v<Argument>,
+                                 inv_unwrap_t<Argument>, Argument>;
+
+    using type =
+        decltype(impl::template private_test<Member Class::*, object>(0));
+};
+
+template <bool IsMemberObjectPointer, bool IsMemberFunctionPointer,
+          typename Callable, typename... ArgumentTypes>
 struct invoke_result_impl
 {
     using type = failure_type;
 };
 
+template <typename MemberPointer, typename Argument>
+struct invoke_result_impl<true, false, MemberPointer, Argument>
+    : invoke_result_memobj<decay_t<MemberPointer>, Argument>
+{
+};
+
+template <typename MemberPointer, typename Argument, typename... ArgumentTypes>
+struct invoke_result_impl<false, true, MemberPointer, Argument,
+                          ArgumentTypes...>
+    : invoke_result_memfun<decay_t<MemberPointer>, Argument, ArgumentTypes...>
+{
+};
+
+template <typename Callable, typename... ArgumentTypes>
+struct invoke_result_impl<false, false, Callable, ArgumentTypes...>
+{
+    using type = decltype(invoke_result_other_impl::template private_test<
+                          Callable, ArgumentTypes...>(0));
+};
 } // namespace detail
+
+// The type of INVOKE(declval<Callable>(), declval<ArgumentTypes>()...), and
+// in invoke_type the tag of the form of INVOKE that applies. Empty when the
+// call is ill-formed.
+template <typename Callable, typename... ArgumentTypes>
+struct invoke_result
+    : detail::invoke_result_impl<
+          is_member_object_pointer_v<remove_reference_t<Callable>>,
+          is_member_function_pointer_v<remove_reference_t<Callable>>,
+          Callable, ArgumentTypes...>::type
+{
+};
+
+template <typename Callable, typename... ArgumentTypes>
+using invoke_result_t =
+    typename invoke_result<Callable, ArgumentTypes...>::type;
+
+namespace detail
+{
+template <typename Result, typename Void, typename Callable,
+          typename... ArgumentTypes>
+struct is_invocable_r_impl : false_type
+{
+};
+
+template <typename Result, typename Callable, typename... ArgumentTypes>
+struct is_invocable_r_impl<Result,
+                           void_t<invoke_result_t<Callable, ArgumentTypes...>>,
+                           Callable, ArgumentTypes...>
+    : disjunction<is_void<Result>,
+                  is_convertible<invoke_result_t<Callable, ArgumentTypes...>,
+                                 Result>>
+{
+};
+} // namespace detail
+
+// Whether INVOKE(declval<Callable>(), declval<ArgumentTypes>()...) is
+// well-formed. The nothrow variants need ohmy::invoke and are declared in
+// functional.hpp.
+template <typename Callable, typename... ArgumentTypes>
+struct is_invocable
+    : detail::is_invocable_r_impl<void, void, Callable, ArgumentTypes...>
+{
+};
+
+template <typename Callable, typename... ArgumentTypes>
+inline constexpr bool is_invocable_v =
+    is_invocable<Callable, ArgumentTypes...>::value;
+
+// Whether the call is well-formed and its result converts to Result; any
+// result can be discarded when Result is void.
+template <typename Result, typename Callable, typename... ArgumentTypes>
+struct is_invocable_r
+    : detail::is_invocable_r_impl<Result, void, Callable, ArgumentTypes...>
+{
+};
+
+template <typename Result, typename Callable, typename... ArgumentTypes>
+inline constexpr bool is_invocable_r_v =
+    is_invocable_r<Result, Callable, ArgumentTypes...>::value;
 } // namespace ohmy
 
 #endif // MY_TYPE_TRAITS_HPP
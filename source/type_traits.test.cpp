@@ -153,3 +153,64 @@ static_assert(ohmy::is_arithmetic_v<BB> == false);
 static_assert(ohmy::is_arithmetic_v<Fake> == false);
 static_assert(ohmy::is_arithmetic_v<int[]> == false);
 static_assert(ohmy::is_arithmetic_v<int[4]> == false);
+
+struct NonTrivialDestructor
+{
+    ~NonTrivialDestructor();
+};
+
+static_assert(ohmy::is_trivially_destructible_v<int> == true);
+static_assert(ohmy::is_trivially_destructible_v<AA> == true);
+static_assert(ohmy::is_trivially_destructible_v<NonTrivialDestructor> == false);
+
+static_assert(ohmy::is_empty_v<AA> == true);
+static_assert(ohmy::is_empty_v<int> == false);
+
+static_assert(ohmy::is_trivially_relocatable_v<int> == true);
+static_assert(ohmy::is_trivially_relocatable_v<int*> == true);
+static_assert(ohmy::is_trivially_relocatable_v<AA[3]> == true);
+static_assert(ohmy::is_trivially_relocatable_v<NonTrivialDestructor> == false);
+
+struct OptedIn
+{
+    OptedIn(OptedIn&&);
+    ~OptedIn();
+};
+
+namespace ohmy
+{
+template <>
+struct is_trivially_relocatable<OptedIn> : true_type
+{
+};
+} // namespace ohmy
+
+static_assert(ohmy::is_trivially_relocatable_v<OptedIn> == true);
+static_assert(ohmy::is_trivially_relocatable_v<OptedIn[2]> == true);
+static_assert(ohmy::is_nothrow_relocatable_v<OptedIn> == true);
+static_assert(
+    ohmy::is_trivially_relocatable_v<std::pair<OptedIn, int>> == true);
+static_assert(
+    ohmy::is_trivially_relocatable_v<std::pair<int, NonTrivialDestructor>> ==
+    false);
+
+static_assert(ohmy::is_same_v<ohmy::add_pointer_t<int(int)>, int (*)(int)>);
+static_assert(ohmy::is_same_v<ohmy::decay_t<int (&)(int)>, int (*)(int)>);
+
+struct ThrowingConversion
+{
+    operator int() const;
+};
+
+static_assert(ohmy::is_nothrow_convertible_v<int, long> == true);
+static_assert(ohmy::is_nothrow_convertible_v<ThrowingConversion, int> == false);
+static_assert(ohmy::is_nothrow_convertible_v<void, void> == true);
+static_assert(ohmy::is_nothrow_convertible_v<int*, int> == false);
+
+static_assert(ohmy::is_invocable_v<int (*)(int), int> == true);
+static_assert(ohmy::is_invocable_v<int (*)(int), int*> == false);
+static_assert(ohmy::is_invocable_r_v<long, int (*)(int), short> == true);
+static_assert(ohmy::is_invocable_r_v<int*, int (*)(int), int> == false);
+static_assert(ohmy::is_invocable_r_v<void, int (*)(int), int> == true);
+static_assert(ohmy::is_invocable_v<int B::*, D*> == true);
+static_assert(ohmy::is_invocable_v<int B::*, A&> == false);
@@ -37,9 +37,161 @@ auto move_if_noexcept(Type& x) noexcept
     -> conditional_t<detail::move_if_noexcept_condition_v<Type>, const Type&,
                      Type&&>
 {
-    return move(x);
+    return ohmy::move(x);
 }
 
+template <typename Type, Type... Values>
+struct integer_sequence
+{
+    using value_type = Type;
+
+    static constexpr size_t size() noexcept
+    {
+        return sizeof...(Values);
+    }
+};
+
+template <size_t... Indices>
+using index_sequence = integer_sequence<size_t, Indices...>;
+
+template <typename Type, Type Count>
+using make_integer_sequence = integer_sequence<Type, __integer_pack(Count)...>;
+
+template <size_t Count>
+using make_index_sequence = make_integer_sequence<size_t, Count>;
+
+template <typename... Types>
+using index_sequence_for = make_index_sequence<sizeof...(Types)>;
+
+namespace detail
+{
+template <size_t Index, typename Type>
+struct indexed_type
+{
+    using type = Type;
+};
+
+template <typename Indices, typename... Types>
+struct indexed_types;
+
+template <size_t... Indices, typename... Types>
+struct indexed_types<index_sequence<Indices...>, Types...>
+    : indexed_type<Indices, Types>...
+{
+};
+
+template <size_t Index, typename Type>
+indexed_type<Index, Type> select_indexed(const indexed_type<Index, Type>&);
+
+// The type at Index in Types. Overload resolution picks it out of a class
+// that derives from all of them at once, so that long packs are not taken
+// apart one type per instantiation.
+template <size_t Index, typename... Types>
+using nth_type_t = typename decltype(select_indexed<Index>(
+    indexed_types<index_sequence_for<Types...>, Types...>{}))::type;
+
+// Empty bases that delete one copy or move operation each and default the
+// rest.
+template <bool Enabled, typename Tag>
+struct copy_constructor_base
+{
+};
+
+template <typename Tag>
+struct copy_constructor_base<false, Tag>
+{
+    copy_constructor_base() = default;
+    copy_constructor_base(const copy_constructor_base&) = delete;
+    copy_constructor_base(copy_constructor_base&&) = default;
+    copy_constructor_base& operator=(const copy_constructor_base&) = default;
+    copy_constructor_base& operator=(copy_constructor_base&&) = default;
+};
+
+template <bool Enabled, typename Tag>
+struct copy_assignment_base
+{
+};
+
+template <typename Tag>
+struct copy_assignment_base<false, Tag>
+{
+    copy_assignment_base() = default;
+    copy_assignment_base(const copy_assignment_base&) = default;
+    copy_assignment_base(copy_assignment_base&&) = default;
+    copy_assignment_base& operator=(const copy_assignment_base&) = delete;
+    copy_assignment_base& operator=(copy_assignment_base&&) = default;
+};
+
+template <bool Enabled, typename Tag>
+struct move_constructor_base
+{
+};
+
+template <typename Tag>
+struct move_constructor_base<false, Tag>
+{
+    move_constructor_base() = default;
+    move_constructor_base(const move_constructor_base&) = default;
+    move_constructor_base(move_constructor_base&&) = delete;
+    move_constructor_base& operator=(const move_constructor_base&) = default;
+    move_constructor_base& operator=(move_constructor_base&&) = default;
+};
+
+template <bool Enabled, typename Tag>
+struct move_assignment_base
+{
+};
+
+template <typename Tag>
+struct move_assignment_base<false, Tag>
+{
+    move_assignment_base() = default;
+    move_assignment_base(const move_assignment_base&) = default;
+    move_assignment_base(move_assignment_base&&) = default;
+    move_assignment_base& operator=(const move_assignment_base&) = default;
+    move_assignment_base& operator=(move_assignment_base&&) = delete;
+};
+
+// A base for wrappers whose storage layers define their copy and move
+// operations unconditionally: the wrapper's implicit operations are then
+// deleted where the wrapped types lack them, so traits and overload
+// resolution see what would actually compile. Tag, the wrapper itself,
+// keeps the bases of nested wrappers distinct so they can share an
+// address.
+template <bool Copy, bool CopyAssign, bool Move, bool MoveAssign, typename Tag>
+struct enable_copy_move : copy_constructor_base<Copy, Tag>,
+                          copy_assignment_base<CopyAssign, Tag>,
+                          move_constructor_base<Move, Tag>,
+                          move_assignment_base<MoveAssign, Tag>
+{
+};
+} // namespace detail
+
+struct in_place_t
+{
+    explicit in_place_t() = default;
+};
+
+inline constexpr in_place_t in_place{};
+
+template <typename Type>
+struct in_place_type_t
+{
+    explicit in_place_type_t() = default;
+};
+
+template <typename Type>
+inline constexpr in_place_type_t<Type> in_place_type{};
+
+template <size_t Index>
+struct in_place_index_t
+{
+    explicit in_place_index_t() = default;
+};
+
+template <size_t Index>
+inline constexpr in_place_index_t<Index> in_place_index{};
+
 // clang-format off
 template <typename Type>
 inline enable_if_t<(not detail::is_tuple_like_v<Type>)
@@ -48,9 +200,9 @@ inline enable_if_t<(not detail::is_tuple_like_v<Type>)
 swap(Type& a, Type& b) noexcept(is_nothrow_move_constructible_v<Type>
                                 and is_nothrow_move_assignable_v<Type>)
 {
-    Type tmp = move(a);
-    a = move(b);
-    b = move(tmp);
+    Type tmp = ohmy::move(a);
+    a = ohmy::move(b);
+    b = ohmy::move(tmp);
 }
 // clang-format on
 } // namespace ohmy
@@ -0,0 +1,789 @@
+#ifndef OHMY_VARIANT_HPP
+#define OHMY_VARIANT_HPP
+
+#include "c++config.hpp"
+#include "functional.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <new>
+
+// A tagged union. The alternatives share aligned bytes followed by the
+// index of the one that is live, which is a single byte for up to 255
+// alternatives, so variant<int, float> takes eight bytes. Copying, moving
+// and destroying are trivial when they are for every alternative.
+//
+// visit dispatches without recursion. The indices of the variants number
+// the combination of alternatives they hold; up to visit_switch_limit
+// combinations are the cases of a switch, which the visitor is inlined
+// into, and beyond that they index a flat table of functions, so a visit
+// of any number of variants is a single indirect jump or call.
+namespace ohmy
+{
+template <typename... Types>
+class variant;
+
+inline constexpr size_t variant_npos = static_cast<size_t>(-1);
+
+inline constexpr size_t visit_switch_limit = 32;
+
+class bad_variant_access : public std::exception
+{
+public:
+    const char* what() const noexcept override
+    {
+        return "bad variant access";
+    }
+};
+
+template <typename Variant>
+struct variant_size;
+
+template <typename... Types>
+struct variant_size<variant<Types...>>
+    : integral_constant<size_t, sizeof...(Types)>
+{
+};
+
+template <typename Variant>
+struct variant_size<const Variant> : variant_size<Variant>
+{
+};
+
+template <typename Variant>
+inline constexpr size_t variant_size_v = variant_size<Variant>::value;
+
+template <size_t Index, typename Variant>
+struct variant_alternative;
+
+template <size_t Index, typename... Types>
+struct variant_alternative<Index, variant<Types...>>
+{
+    using type = detail::nth_type_t<Index, Types...>;
+};
+
+template <size_t Index, typename Variant>
+struct variant_alternative<Index, const Variant>
+{
+    using type = const typename variant_alternative<Index, Variant>::type;
+};
+
+template <size_t Index, typename Variant>
+using variant_alternative_t =
+    typename variant_alternative<Index, Variant>::type;
+
+namespace detail
+{
+template <size_t Count>
+using variant_index_t = conditional_t<
+    Count <= 0xff, uint8_t, conditional_t<Count <= 0xffff, uint16_t, uint32_t>>;
+
+template <typename Type, typename... Types>
+constexpr size_t find_alternative() noexcept
+{
+    constexpr bool matches[] = {is_same_v<Type, Types>...};
+    size_t found = variant_npos;
+    for (size_t index = 0; index < sizeof...(Types); ++index)
+    {
+        if (matches[index])
+        {
+            // Found twice: the type does not identify an alternative.
+            found = found == variant_npos ? index : variant_npos - 1;
+        }
+    }
+    return found;
+}
+
+// The index of Type in Types, if it occurs exactly once.
+template <typename Type, typename... Types>
+inline constexpr size_t alternative_index_v =
+    find_alternative<Type, Types...>();
+
+template <typename Type>
+struct single_element
+{
+    Type element[1];
+};
+
+// One overload of the set a converting constructor chooses from. It only
+// takes arguments that initialize the alternative without narrowing.
+template <size_t Index, typename Alternative>
+struct variant_candidate
+{
+    template <typename Argument,
+              typename = decltype(single_element<Alternative>{
+                  {declval<Argument>()}})>
+    static integral_constant<size_t, Index> select(Alternative);
+};
+
+template <typename Indices, typename... Types>
+struct variant_candidates;
+
+template <size_t... Indices, typename... Types>
+struct variant_candidates<index_sequence<Indices...>, Types...>
+    : variant_candidate<Indices, Types>...
+{
+    using variant_candidate<Indices, Types>::select...;
+};
+
+template <typename Argument, typename Candidates, typename = void>
+inline constexpr size_t converting_index_v = variant_npos;
+
+template <typename Argument, typename Candidates>
+inline constexpr size_t converting_index_v<
+    Argument, Candidates,
+    void_t<decltype(Candidates::template select<Argument>(
+        declval<Argument>()))>> =
+    decltype(Candidates::template select<Argument>(
+        declval<Argument>()))::value;
+
+// The alternative a variant is initialized with from an Argument: the
+// best match of the overloads of select, like a function call would pick.
+template <typename Argument, typename... Types>
+inline constexpr size_t converting_alternative_v = converting_index_v<
+    Argument, variant_candidates<index_sequence_for<Types...>, Types...>>;
+
+// Reaches the alternatives of a variant by index, without checking it.
+struct variant_access
+{
+    template <size_t Index, typename Variant>
+    static constexpr decltype(auto) get(Variant&& variant) noexcept
+    {
+        return ohmy::forward<Variant>(variant).template unchecked<Index>();
+    }
+
+    // The index of a variant known not to be valueless.
+    template <typename Variant>
+    static constexpr size_t index(const Variant& variant) noexcept
+    {
+        return variant.m_index;
+    }
+
+    template <typename Variant>
+    static const void* storage(const Variant& variant) noexcept
+    {
+        return variant.storage();
+    }
+};
+
+template <typename Type>
+void destroy_alternative(void* storage) noexcept
+{
+    ohmy::destroy_at(static_cast<Type*>(storage));
+}
+
+template <typename Type>
+void copy_alternative(void* destination, const void* source)
+{
+    ohmy::construct_at(static_cast<Type*>(destination),
+                       *static_cast<const Type*>(source));
+}
+
+template <typename Type>
+void move_alternative(void* destination, void* source)
+{
+    ohmy::construct_at(static_cast<Type*>(destination),
+                       ohmy::move(*static_cast<Type*>(source)));
+}
+
+template <typename Type>
+void copy_assign_alternative(void* destination, const void* source)
+{
+    *static_cast<Type*>(destination) = *static_cast<const Type*>(source);
+}
+
+template <typename Type>
+void move_assign_alternative(void* destination, void* source)
+{
+    *static_cast<Type*>(destination) = ohmy::move(*static_cast<Type*>(source));
+}
+
+template <typename Type>
+bool equal_alternatives(const void* lhs, const void* rhs)
+{
+    return *static_cast<const Type*>(lhs) == *static_cast<const Type*>(rhs);
+}
+
+template <typename... Types>
+constexpr size_t largest_size() noexcept
+{
+    size_t size = 0;
+    ((size = sizeof(Types) > size ? sizeof(Types) : size), ...);
+    return size;
+}
+
+template <typename... Types>
+struct variant_base
+{
+    using index_type = variant_index_t<sizeof...(Types)>;
+
+    static constexpr index_type valueless = static_cast<index_type>(-1);
+
+    variant_base() noexcept : m_index{valueless}
+    {
+    }
+
+    size_t index() const noexcept
+    {
+        return m_index == valueless ? variant_npos : m_index;
+    }
+
+    void* storage() noexcept
+    {
+        return m_storage;
+    }
+
+    const void* storage() const noexcept
+    {
+        return m_storage;
+    }
+
+    template <size_t Index, typename... ArgumentTypes>
+    void construct(ArgumentTypes&&... arguments)
+    {
+        using alternative = nth_type_t<Index, Types...>;
+        ohmy::construct_at(static_cast<alternative*>(storage()),
+                           ohmy::forward<ArgumentTypes>(arguments)...);
+        m_index = static_cast<index_type>(Index);
+    }
+
+    void destroy() noexcept
+    {
+        if constexpr (not(is_trivially_destructible_v<Types> and ...))
+        {
+            static constexpr void (*destroyers[])(void*) noexcept = {
+                &destroy_alternative<Types>...};
+            if (m_index != valueless)
+            {
+                destroyers[m_index](storage());
+            }
+        }
+        m_index = valueless;
+    }
+
+    void copy_from(const variant_base& other)
+    {
+        static constexpr void (*copiers[])(void*, const void*) = {
+            &copy_alternative<Types>...};
+        if (other.m_index != valueless)
+        {
+            copiers[other.m_index](storage(), other.storage());
+            m_index = other.m_index;
+        }
+    }
+
+    void move_from(variant_base& other)
+    {
+        static constexpr void (*movers[])(void*, void*) = {
+            &move_alternative<Types>...};
+        if (other.m_index != valueless)
+        {
+            movers[other.m_index](storage(), other.storage());
+            m_index = other.m_index;
+        }
+    }
+
+    // Assigns alternative to alternative when the indices match, and
+    // otherwise destroys and reconstructs, leaving the variant valueless if
+    // that throws.
+    void copy_assign(const variant_base& other)
+    {
+        static constexpr void (*assigners[])(void*, const void*) = {
+            &copy_assign_alternative<Types>...};
+        if (m_index == other.m_index and m_index != valueless)
+        {
+            assigners[m_index](storage(), other.storage());
+        }
+        else if (this != ohmy::addressof(other))
+        {
+            destroy();
+            copy_from(other);
+        }
+    }
+
+    void move_assign(variant_base& other)
+    {
+        static constexpr void (*assigners[])(void*, void*) = {
+            &move_assign_alternative<Types>...};
+        if (m_index == other.m_index and m_index != valueless)
+        {
+            assigners[m_index](storage(), other.storage());
+        }
+        else if (this != ohmy::addressof(other))
+        {
+            destroy();
+            move_from(other);
+        }
+    }
+
+    alignas(Types...) unsigned char m_storage[largest_size<Types...>()];
+    index_type m_index;
+};
+
+template <bool TriviallyDestructible, typename... Types>
+struct variant_storage : variant_base<Types...>
+{
+};
+
+template <typename... Types>
+struct variant_storage<false, Types...> : variant_base<Types...>
+{
+    variant_storage() = default;
+    variant_storage(const variant_storage&) = default;
+    variant_storage(variant_storage&&) = default;
+    variant_storage& operator=(const variant_storage&) = default;
+    variant_storage& operator=(variant_storage&&) = default;
+
+    ~variant_storage()
+    {
+        this->destroy();
+    }
+};
+
+template <typename... Types>
+using variant_storage_t =
+    variant_storage<(is_trivially_destructible_v<Types> and ...), Types...>;
+
+// Copies and moves the live alternative where copying the bytes would not
+// do.
+template <bool TriviallyCopyable, typename... Types>
+struct variant_copy : variant_storage_t<Types...>
+{
+};
+
+template <typename... Types>
+struct variant_copy<false, Types...> : variant_storage_t<Types...>
+{
+    variant_copy() = default;
+
+    variant_copy(const variant_copy& other) : variant_storage_t<Types...>()
+    {
+        this->copy_from(other);
+    }
+
+    variant_copy(variant_copy&& other) noexcept(
+        (is_nothrow_move_constructible_v<Types> and ...))
+        : variant_storage_t<Types...>()
+    {
+        this->move_from(other);
+    }
+
+    variant_copy& operator=(const variant_copy& other)
+    {
+        this->copy_assign(other);
+        return *this;
+    }
+
+    variant_copy& operator=(variant_copy&& other) noexcept(
+        (is_nothrow_move_constructible_v<Types> and ...) and
+        (is_nothrow_move_assignable_v<Types> and ...))
+    {
+        this->move_assign(other);
+        return *this;
+    }
+};
+
+template <typename... Types>
+using variant_copy_t =
+    variant_copy<(is_trivially_copiable_v<Types> and ...), Types...>;
+
+template <typename Type>
+inline constexpr bool is_in_place_v = false;
+
+template <typename Type>
+inline constexpr bool is_in_place_v<in_place_type_t<Type>> = true;
+
+template <size_t Index>
+inline constexpr bool is_in_place_v<in_place_index_t<Index>> = true;
+} // namespace detail
+
+template <typename... Types>
+class variant
+    : private detail::variant_copy_t<Types...>,
+      private detail::enable_copy_move<
+          (is_copy_constructible_v<Types> and ...),
+          ((is_copy_constructible_v<Types> and
+            is_copy_assignable_v<Types>) and
+           ...),
+          (is_move_constructible_v<Types> and ...),
+          ((is_move_constructible_v<Types> and
+            is_move_assignable_v<Types>) and
+           ...),
+          variant<Types...>>
+{
+    static_assert(sizeof...(Types) > 0, "variant needs an alternative");
+
+    using base = detail::variant_base<Types...>;
+
+    template <typename Argument>
+    static constexpr size_t converting_index =
+        is_same_v<decay_t<Argument>, variant> or
+                detail::is_in_place_v<decay_t<Argument>>
+            ? variant_npos
+            : detail::converting_alternative_v<Argument, Types...>;
+
+public:
+    template <typename First = detail::nth_type_t<0, Types...>,
+              typename = enable_if_t<is_default_constructible_v<First>>>
+    variant() noexcept(is_nothrow_default_constructible_v<First>)
+    {
+        this->template construct<0>();
+    }
+
+    template <typename Argument,
+              size_t Index = converting_index<Argument>,
+              typename = enable_if_t<Index != variant_npos>>
+    variant(Argument&& argument)
+    {
+        this->template construct<Index>(ohmy::forward<Argument>(argument));
+    }
+
+    template <size_t Index, typename... ArgumentTypes>
+    explicit variant(in_place_index_t<Index>, ArgumentTypes&&... arguments)
+    {
+        this->template construct<Index>(
+            ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    template <typename Type, typename... ArgumentTypes,
+              size_t Index = detail::alternative_index_v<Type, Types...>,
+              typename = enable_if_t<Index < sizeof...(Types)>>
+    explicit variant(in_place_type_t<Type>, ArgumentTypes&&... arguments)
+    {
+        this->template construct<Index>(
+            ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    template <typename Argument,
+              size_t Index = converting_index<Argument>,
+              typename = enable_if_t<Index != variant_npos>>
+    variant& operator=(Argument&& argument)
+    {
+        if (index() == Index)
+        {
+            unchecked<Index>() = ohmy::forward<Argument>(argument);
+        }
+        else
+        {
+            emplace<Index>(ohmy::forward<Argument>(argument));
+        }
+        return *this;
+    }
+
+    // Destroys the live alternative, then constructs the new one; the
+    // variant is valueless if that throws.
+    template <size_t Index, typename... ArgumentTypes>
+    variant_alternative_t<Index, variant>&
+    emplace(ArgumentTypes&&... arguments)
+    {
+        this->destroy();
+        this->template construct<Index>(
+            ohmy::forward<ArgumentTypes>(arguments)...);
+        return unchecked<Index>();
+    }
+
+    template <typename Type, typename... ArgumentTypes,
+              size_t Index = detail::alternative_index_v<Type, Types...>,
+              typename = enable_if_t<Index < sizeof...(Types)>>
+    Type& emplace(ArgumentTypes&&... arguments)
+    {
+        return emplace<Index>(ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    size_t index() const noexcept
+    {
+        return base::index();
+    }
+
+    bool valueless_by_exception() const noexcept
+    {
+        return index() == variant_npos;
+    }
+
+private:
+    friend struct detail::variant_access;
+
+    template <size_t Index>
+    using alternative = detail::nth_type_t<Index, Types...>;
+
+    template <size_t Index>
+    alternative<Index>& unchecked() & noexcept
+    {
+        return *std::launder(static_cast<alternative<Index>*>(this->storage()));
+    }
+
+    template <size_t Index>
+    const alternative<Index>& unchecked() const& noexcept
+    {
+        return *std::launder(
+            static_cast<const alternative<Index>*>(this->storage()));
+    }
+
+    template <size_t Index>
+    alternative<Index>&& unchecked() && noexcept
+    {
+        return ohmy::move(unchecked<Index>());
+    }
+
+    template <size_t Index>
+    const alternative<Index>&& unchecked() const&& noexcept
+    {
+        return ohmy::move(unchecked<Index>());
+    }
+};
+
+template <typename Type, typename... Types>
+bool holds_alternative(const variant<Types...>& variant) noexcept
+{
+    return variant.index() == detail::alternative_index_v<Type, Types...>;
+}
+
+template <size_t Index, typename... Types>
+variant_alternative_t<Index, variant<Types...>>*
+get_if(variant<Types...>* variant) noexcept
+{
+    return variant != nullptr and variant->index() == Index
+               ? &detail::variant_access::get<Index>(*variant)
+               : nullptr;
+}
+
+template <size_t Index, typename... Types>
+const variant_alternative_t<Index, variant<Types...>>*
+get_if(const variant<Types...>* variant) noexcept
+{
+    return variant != nullptr and variant->index() == Index
+               ? &detail::variant_access::get<Index>(*variant)
+               : nullptr;
+}
+
+template <typename Type, typename... Types>
+Type* get_if(variant<Types...>* variant) noexcept
+{
+    return get_if<detail::alternative_index_v<Type, Types...>>(variant);
+}
+
+template <typename Type, typename... Types>
+const Type* get_if(const variant<Types...>* variant) noexcept
+{
+    return get_if<detail::alternative_index_v<Type, Types...>>(variant);
+}
+
+namespace detail
+{
+template <typename Variant>
+using variant_of_t = remove_cv_t<remove_reference_t<Variant>>;
+
+template <size_t Index, typename Variant>
+decltype(auto) checked_get(Variant&& variant)
+{
+    if (variant.index() != Index)
+        throw bad_variant_access{};
+    return variant_access::get<Index>(ohmy::forward<Variant>(variant));
+}
+} // namespace detail
+
+template <size_t Index, typename... Types>
+decltype(auto) get(variant<Types...>& variant)
+{
+    return detail::checked_get<Index>(variant);
+}
+
+template <size_t Index, typename... Types>
+decltype(auto) get(const variant<Types...>& variant)
+{
+    return detail::checked_get<Index>(variant);
+}
+
+template <size_t Index, typename... Types>
+decltype(auto) get(variant<Types...>&& variant)
+{
+    return detail::checked_get<Index>(ohmy::move(variant));
+}
+
+template <typename Type, typename... Types>
+decltype(auto) get(variant<Types...>& variant)
+{
+    return get<detail::alternative_index_v<Type, Types...>>(variant);
+}
+
+template <typename Type, typename... Types>
+decltype(auto) get(const variant<Types...>& variant)
+{
+    return get<detail::alternative_index_v<Type, Types...>>(variant);
+}
+
+template <typename Type, typename... Types>
+decltype(auto) get(variant<Types...>&& variant)
+{
+    return get<detail::alternative_index_v<Type, Types...>>(
+        ohmy::move(variant));
+}
+
+namespace detail
+{
+template <size_t Index, typename Variant>
+using alternative_reference_t =
+    decltype(variant_access::get<Index>(declval<Variant>()));
+
+template <typename Visitor, typename... Variants>
+using visit_result_t =
+    invoke_result_t<Visitor, alternative_reference_t<0, Variants>...>;
+
+// Dispatches a visit on the combination of alternatives the variants
+// hold, numbered in row-major order of their indices.
+template <typename Result, typename Visitor, typename... Variants>
+struct visit_dispatch
+{
+    static constexpr size_t sizes[] = {
+        variant_size_v<variant_of_t<Variants>>...};
+
+    // The distance between the entries of consecutive alternatives of the
+    // variant at position.
+    static constexpr size_t stride(size_t position) noexcept
+    {
+        size_t stride = 1;
+        for (size_t next = position + 1; next < sizeof...(Variants); ++next)
+        {
+            stride *= sizes[next];
+        }
+        return stride;
+    }
+
+    static constexpr size_t entries = stride(0) * sizes[0];
+
+    template <size_t... Positions>
+    static size_t entry(index_sequence<Positions...>,
+                        const Variants&... variants) noexcept
+    {
+        return ((variant_access::index(variants) * stride(Positions)) + ...);
+    }
+
+    template <size_t Entry, size_t... Positions>
+    static Result call(Visitor&& visitor, Variants&&... variants)
+    {
+        if constexpr (Entry < entries)
+        {
+            return ohmy::invoke(
+                ohmy::forward<Visitor>(visitor),
+                variant_access::get<Entry / stride(Positions) %
+                                    sizes[Positions]>(
+                    ohmy::forward<Variants>(variants))...);
+        }
+        else
+        {
+            __builtin_unreachable();
+        }
+    }
+
+    // A switch with a case for each of up to visit_switch_limit entries,
+    // which compiles to a jump table with the visitor inlined into each
+    // case.
+    template <size_t... Positions>
+    static Result visit_switch(index_sequence<Positions...>, size_t entry,
+                               Visitor&& visitor, Variants&&... variants)
+    {
+        static_assert(visit_switch_limit == 32);
+#define OHMY_VISIT_CASE(Entry)                                             \
+    case Entry:                                                            \
+        return call<Entry, Positions...>(ohmy::forward<Visitor>(visitor),  \
+                                         ohmy::forward<Variants>(variants)...)
+#define OHMY_VISIT_CASES(Entry)                                            \
+    OHMY_VISIT_CASE(Entry);                                                \
+    OHMY_VISIT_CASE(Entry + 1);                                            \
+    OHMY_VISIT_CASE(Entry + 2);                                            \
+    OHMY_VISIT_CASE(Entry + 3)
+        switch (entry)
+        {
+            OHMY_VISIT_CASES(0);
+            OHMY_VISIT_CASES(4);
+            OHMY_VISIT_CASES(8);
+            OHMY_VISIT_CASES(12);
+            OHMY_VISIT_CASES(16);
+            OHMY_VISIT_CASES(20);
+            OHMY_VISIT_CASES(24);
+            OHMY_VISIT_CASES(28);
+        default:
+            __builtin_unreachable();
+        }
+#undef OHMY_VISIT_CASES
+#undef OHMY_VISIT_CASE
+    }
+
+    // A table of functions with an entry each, for more combinations than
+    // a switch is written for.
+    template <size_t... Entries, size_t... Positions>
+    static Result visit_table(index_sequence<Entries...>,
+                              index_sequence<Positions...>, size_t entry,
+                              Visitor&& visitor, Variants&&... variants)
+    {
+        static constexpr Result (*table[])(Visitor&&, Variants&&...) = {
+            &call<Entries, Positions...>...};
+        return table[entry](ohmy::forward<Visitor>(visitor),
+                            ohmy::forward<Variants>(variants)...);
+    }
+};
+} // namespace detail
+
+// Calls visitor with the live alternative of every variant. Throws
+// bad_variant_access if any of them is valueless.
+template <typename Visitor, typename... Variants>
+detail::visit_result_t<Visitor, Variants...> visit(Visitor&& visitor,
+                                                   Variants&&... variants)
+{
+    using dispatch = detail::visit_dispatch<
+        detail::visit_result_t<Visitor, Variants...>, Visitor, Variants...>;
+    constexpr index_sequence_for<Variants...> positions{};
+
+    if ((variants.valueless_by_exception() or ...))
+        throw bad_variant_access{};
+
+    const size_t entry = dispatch::entry(positions, variants...);
+    if constexpr (dispatch::entries <= visit_switch_limit)
+    {
+        return dispatch::visit_switch(positions, entry,
+                                      ohmy::forward<Visitor>(visitor),
+                                      ohmy::forward<Variants>(variants)...);
+    }
+    else
+    {
+        return dispatch::visit_table(make_index_sequence<dispatch::entries>{},
+                                     positions, entry,
+                                     ohmy::forward<Visitor>(visitor),
+                                     ohmy::forward<Variants>(variants)...);
+    }
+}
+
+template <typename... Types>
+bool operator==(const variant<Types...>& lhs, const variant<Types...>& rhs)
+{
+    if (lhs.index() != rhs.index())
+    {
+        return false;
+    }
+    if (lhs.valueless_by_exception())
+    {
+        return true;
+    }
+    static constexpr bool (*equal[])(const void*, const void*) = {
+        &detail::equal_alternatives<Types>...};
+    return equal[lhs.index()](detail::variant_access::storage(lhs),
+                              detail::variant_access::storage(rhs));
+}
+
+template <typename... Types>
+bool operator!=(const variant<Types...>& lhs, const variant<Types...>& rhs)
+{
+    return not(lhs == rhs);
+}
+
+template <typename... Types>
+struct is_trivially_relocatable<variant<Types...>>
+    : conjunction<is_trivially_relocatable<Types>...>
+{
+};
+} // namespace ohmy
+
+#endif // OHMY_VARIANT_HPP
@@ -0,0 +1,463 @@
+#include <catch/catch.hpp>
+
+#include "memory.hpp"
+#include "variant.hpp"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace
+{
+// Counts its live instances.
+struct Tracked
+{
+    explicit Tracked(int value, int& live) : value{value}, live{&live}
+    {
+        ++*this->live;
+    }
+
+    Tracked(const Tracked& other) : value{other.value}, live{other.live}
+    {
+        ++*live;
+    }
+
+    Tracked& operator=(const Tracked& other)
+    {
+        value = other.value;
+        return *this;
+    }
+
+    ~Tracked()
+    {
+        --*live;
+    }
+
+    int value;
+    int* live;
+};
+
+struct Throwing
+{
+    explicit Throwing(bool fail) : failed{fail}
+    {
+        if (fail)
+            throw std::runtime_error("construction failed");
+    }
+
+    bool failed;
+};
+
+template <size_t Index>
+using tag = std::integral_constant<size_t, Index>;
+
+template <size_t... Indices>
+ohmy::variant<tag<Indices>...> tags(ohmy::index_sequence<Indices...>);
+
+template <size_t Count>
+using tag_variant = decltype(tags(ohmy::make_index_sequence<Count>{}));
+
+template <size_t... Indices>
+std::vector<tag_variant<sizeof...(Indices)>>
+every_tag(ohmy::index_sequence<Indices...>)
+{
+    return {tag_variant<sizeof...(Indices)>{tag<Indices>{}}...};
+}
+
+struct index_of_tag
+{
+    template <size_t Index>
+    size_t operator()(tag<Index>) const noexcept
+    {
+        return Index;
+    }
+};
+} // namespace
+
+static_assert(std::is_same_v<ohmy::detail::nth_type_t<2, int, char, long>,
+                             long>);
+static_assert(sizeof(ohmy::variant<int, float>) == 8);
+static_assert(sizeof(ohmy::variant<char, bool>) == 2);
+static_assert(sizeof(tag_variant<255>) == 2);
+static_assert(sizeof(tag_variant<256>) == 4);
+
+static_assert(ohmy::is_trivially_copiable_v<ohmy::variant<int, double>>);
+static_assert(ohmy::is_trivially_destructible_v<ohmy::variant<int, double>>);
+static_assert(
+    not ohmy::is_trivially_copiable_v<ohmy::variant<int, std::string>>);
+static_assert(
+    not ohmy::is_trivially_destructible_v<ohmy::variant<int, std::string>>);
+
+// Copies and moves exist only where every alternative has them.
+static_assert(not std::is_copy_constructible_v<
+              ohmy::variant<int, ohmy::unique_ptr<int>>>);
+static_assert(
+    not std::is_copy_assignable_v<ohmy::variant<int, ohmy::unique_ptr<int>>>);
+static_assert(std::is_nothrow_move_constructible_v<
+              ohmy::variant<int, ohmy::unique_ptr<int>>>);
+static_assert(
+    std::is_move_assignable_v<ohmy::variant<int, ohmy::unique_ptr<int>>>);
+static_assert(std::is_copy_assignable_v<ohmy::variant<int, std::string>>);
+static_assert(sizeof(ohmy::variant<ohmy::variant<int>>) ==
+              sizeof(ohmy::variant<int>) + 4);
+static_assert(ohmy::variant_size_v<ohmy::variant<int, char>> == 2);
+static_assert(
+    std::is_same_v<ohmy::variant_alternative_t<1, ohmy::variant<int, char>>,
+                   char>);
+
+// Conversions pick the best alternative that does not narrow.
+static_assert(std::is_constructible_v<ohmy::variant<float, long>, int>);
+static_assert(not std::is_constructible_v<ohmy::variant<float, char>, int>);
+static_assert(not std::is_constructible_v<ohmy::variant<long, long long>, int>);
+
+TEST_CASE("variant")
+{
+    SECTION("construction, assignment and access")
+    {
+        ohmy::variant<int, std::string> value;
+        REQUIRE(value.index() == 0u);
+        REQUIRE(ohmy::get<int>(value) == 0);
+
+        value = "text";
+        REQUIRE(value.index() == 1u);
+        REQUIRE(ohmy::holds_alternative<std::string>(value));
+        REQUIRE(ohmy::get<1>(value) == "text");
+        REQUIRE(ohmy::get_if<int>(&value) == nullptr);
+        REQUIRE_THROWS_AS(ohmy::get<int>(value), ohmy::bad_variant_access);
+
+        value = 3;
+        REQUIRE(*ohmy::get_if<0>(&value) == 3);
+
+        ohmy::variant<float, long> number = 3;
+        REQUIRE(number.index() == 1u);
+
+        ohmy::variant<int, int> twice{ohmy::in_place_index<1>, 7};
+        REQUIRE(twice.index() == 1u);
+        REQUIRE(ohmy::get<1>(twice) == 7);
+        twice.emplace<0>(8);
+        REQUIRE(ohmy::get<0>(twice) == 8);
+
+        ohmy::variant<int, std::string> text{
+            ohmy::in_place_type<std::string>, 3u, 'x'};
+        REQUIRE(ohmy::get<std::string>(text) == "xxx");
+        REQUIRE(ohmy::get<std::string>(std::move(text)) == "xxx");
+    }
+
+    SECTION("alternatives are constructed and destroyed once")
+    {
+        int live = 0;
+        {
+            ohmy::variant<int, Tracked> first{ohmy::in_place_type<Tracked>,
+                                              1, live};
+            ohmy::variant<int, Tracked> second = first;
+            REQUIRE(live == 2);
+
+            second = 5;
+            REQUIRE(live == 1);
+            second = first;
+            REQUIRE(live == 2);
+            ohmy::get<Tracked>(second).value = 2;
+            first = second;
+            REQUIRE(ohmy::get<Tracked>(first).value == 2);
+            REQUIRE(live == 2);
+
+            ohmy::variant<int, Tracked> third = std::move(first);
+            REQUIRE(live == 3);
+            third.emplace<int>(4);
+            REQUIRE(live == 2);
+        }
+        REQUIRE(live == 0);
+    }
+
+    SECTION("move-only alternatives")
+    {
+        using owner = ohmy::variant<int, ohmy::unique_ptr<int>>;
+        owner first{ohmy::make_unique<int>(5)};
+        owner second = std::move(first);
+        REQUIRE(*ohmy::get<1>(second) == 5);
+        first = 3;
+        first = std::move(second);
+        REQUIRE(*ohmy::get<1>(first) == 5);
+    }
+
+    SECTION("a failed emplace leaves the variant valueless")
+    {
+        ohmy::variant<int, Throwing> value{4};
+        REQUIRE_THROWS_AS(value.emplace<Throwing>(true), std::runtime_error);
+        REQUIRE(value.valueless_by_exception());
+        REQUIRE(value.index() == ohmy::variant_npos);
+        REQUIRE_THROWS_AS(ohmy::visit([](const auto&) { return 0; }, value),
+                          ohmy::bad_variant_access);
+
+        const ohmy::variant<int, Throwing> copy = value;
+        REQUIRE(copy.valueless_by_exception());
+        value = 5;
+        REQUIRE(ohmy::get<int>(value) == 5);
+    }
+
+    SECTION("comparison")
+    {
+        using number = ohmy::variant<int, double, std::string>;
+        REQUIRE(number{1} == number{1});
+        REQUIRE(number{1} != number{2});
+        REQUIRE(number{1} != number{1.0});
+        REQUIRE(number{"one"} == number{"one"});
+    }
+}
+
+TEST_CASE("visit")
+{
+    SECTION("a single variant")
+    {
+        ohmy::variant<int, std::string> value{"four"};
+        const auto size = [](const auto& alternative) -> size_t {
+            if constexpr (std::is_same_v<decltype(alternative), const int&>)
+                return sizeof(int);
+            else
+                return alternative.size();
+        };
+        REQUIRE(ohmy::visit(size, value) == 4u);
+        value = 1;
+        REQUIRE(ohmy::visit(size, value) == sizeof(int));
+
+        // References and value categories pass through.
+        value = "moved";
+        std::string taken = ohmy::visit(
+            [](auto&& alternative) -> std::string {
+                if constexpr (std::is_same_v<decltype(alternative),
+                                             std::string&&>)
+                    return std::move(alternative);
+                else
+                    return {};
+            },
+            std::move(value));
+        REQUIRE(taken == "moved");
+
+        ohmy::variant<int, long> number{2};
+        ohmy::visit([](auto& alternative) { alternative *= 3; }, number);
+        REQUIRE(ohmy::get<int>(number) == 6);
+    }
+
+    SECTION("every alternative of a large variant, through the table")
+    {
+        const auto values = every_tag(ohmy::make_index_sequence<40>{});
+        for (size_t index = 0; index < values.size(); ++index)
+        {
+            REQUIRE(values[index].index() == index);
+            REQUIRE(ohmy::visit(index_of_tag{}, values[index]) == index);
+        }
+    }
+
+    SECTION("several variants at once")
+    {
+        const auto text = [](const auto& value) {
+            if constexpr (std::is_same_v<decltype(value), const int&>)
+                return std::to_string(value);
+            else
+                return value;
+        };
+        const ohmy::variant<int, std::string> number{1};
+        const ohmy::variant<int, std::string> word{"two"};
+        const auto concatenate = [&text](const auto& lhs, const auto& rhs) {
+            return text(lhs) + text(rhs);
+        };
+        REQUIRE(ohmy::visit(concatenate, number, word) == "1two");
+        REQUIRE(ohmy::visit(concatenate, word, word) == "twotwo");
+        REQUIRE(ohmy::visit(concatenate, word, number) == "two1");
+
+        const auto small = every_tag(ohmy::make_index_sequence<3>{});
+        const auto large = every_tag(ohmy::make_index_sequence<11>{});
+        for (const auto& first : small)
+        {
+            for (const auto& second : large)
+            {
+                for (const auto& third : small)
+                {
+                    const size_t expected = first.index() * 10000 +
+                                            second.index() * 100 +
+                                            third.index();
+                    REQUIRE(ohmy::visit(
+                                [](auto lhs, auto middle, auto rhs) {
+                                    return lhs.value * 10000 +
+                                           middle.value * 100 + rhs.value;
+                                },
+                                first, second, third) == expected);
+                }
+            }
+        }
+    }
+}
+
+namespace
+{
+struct heartbeat
+{
+    uint32_t sequence;
+};
+
+struct order
+{
+    uint64_t id;
+    uint32_t quantity;
+    int32_t price;
+};
+
+struct cancel
+{
+    uint64_t id;
+};
+
+struct trade
+{
+    uint64_t id;
+    uint32_t quantity;
+    int32_t price;
+};
+
+struct message_value
+{
+    uint64_t operator()(const heartbeat& message) const noexcept
+    {
+        return message.sequence;
+    }
+
+    uint64_t operator()(const order& message) const noexcept
+    {
+        return message.id + message.quantity * 3;
+    }
+
+    uint64_t operator()(const cancel& message) const noexcept
+    {
+        return message.id ^ 0xff;
+    }
+
+    uint64_t operator()(const trade& message) const noexcept
+    {
+        return message.quantity * static_cast<uint64_t>(message.price);
+    }
+};
+
+struct message_pair_value
+{
+    template <typename Message, typename OtherMessage>
+    uint64_t operator()(const Message& lhs,
+                        const OtherMessage& rhs) const noexcept
+    {
+        return message_value{}(lhs) * 31 + message_value{}(rhs);
+    }
+};
+
+struct tag_value
+{
+    template <size_t Index>
+    uint64_t operator()(tag<Index>) const noexcept
+    {
+        return Index * Index;
+    }
+};
+
+template <typename Message>
+Message make_message(uint32_t kind, uint32_t value)
+{
+    switch (kind)
+    {
+    case 0:
+        return heartbeat{value};
+    case 1:
+        return order{value, value % 100, 17};
+    case 2:
+        return cancel{value};
+    default:
+        return trade{value, value % 50, 23};
+    }
+}
+
+template <typename Variant, size_t... Indices>
+std::vector<Variant> tag_prototypes(ohmy::index_sequence<Indices...>)
+{
+    return {Variant{tag<Indices>{}}...};
+}
+
+// Visits decoded messages one at a time and in pairs, and a variant of
+// sixteen alternatives, which ohmy::visit dispatches through its table.
+template <typename Message, typename Tags, typename Visit>
+uint64_t visit_benchmarks(const char* name, const std::vector<uint32_t>& kinds,
+                          Visit visit)
+{
+    std::vector<Message> messages;
+    for (uint32_t i = 0; i < kinds.size(); ++i)
+    {
+        messages.push_back(make_message<Message>(kinds[i] % 4, i));
+    }
+    const std::vector<Tags> prototypes =
+        tag_prototypes<Tags>(ohmy::make_index_sequence<16>{});
+    std::vector<Tags> tags;
+    for (const uint32_t kind : kinds)
+    {
+        tags.push_back(prototypes[kind % 16]);
+    }
+
+    uint64_t single_sum = 0;
+    const std::string single = std::string{"visit 4 alternatives, "} + name;
+    BENCHMARK(single)
+    {
+        for (const Message& message : messages)
+        {
+            single_sum += visit(message_value{}, message);
+        }
+    }
+
+    uint64_t double_sum = 0;
+    const std::string pairs = std::string{"visit 4x4 alternatives, "} + name;
+    BENCHMARK(pairs)
+    {
+        for (size_t i = 1; i < messages.size(); ++i)
+        {
+            double_sum +=
+                visit(message_pair_value{}, messages[i - 1], messages[i]);
+        }
+    }
+
+    uint64_t tag_sum = 0;
+    const std::string wide = std::string{"visit 16 alternatives, "} + name;
+    BENCHMARK(wide)
+    {
+        for (const Tags& value : tags)
+        {
+            tag_sum += visit(tag_value{}, value);
+        }
+    }
+    return single_sum ^ double_sum ^ tag_sum;
+}
+
+template <size_t... Indices>
+std::variant<tag<Indices>...> std_tags(ohmy::index_sequence<Indices...>);
+} // namespace
+
+TEST_CASE("variant benchmarks", "[.benchmark]")
+{
+    std::mt19937 generator{5};
+    std::vector<uint32_t> kinds(1 << 22);
+    for (uint32_t& kind : kinds)
+    {
+        kind = generator();
+    }
+
+    const uint64_t std_sum =
+        visit_benchmarks<std::variant<heartbeat, order, cancel, trade>,
+                         decltype(std_tags(ohmy::make_index_sequence<16>{}))>(
+            "std::visit", kinds, [](auto&& visitor, auto&&... variants) {
+                return std::visit(visitor, variants...);
+            });
+    const uint64_t ohmy_sum =
+        visit_benchmarks<ohmy::variant<heartbeat, order, cancel, trade>,
+                         tag_variant<16>>(
+            "ohmy::visit", kinds, [](auto&& visitor, auto&&... variants) {
+                return ohmy::visit(visitor, variants...);
+            });
+    REQUIRE(ohmy_sum == std_sum);
+}
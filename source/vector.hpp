@@ -0,0 +1,579 @@
+#ifndef OHMY_VECTOR_HPP
+#define OHMY_VECTOR_HPP
+
+#include "c++config.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <initializer_list>
+#include <stdexcept>
+
+namespace ohmy
+{
+// A contiguous sequence container. Growth relocates the elements instead of
+// move-constructing and destroying them one by one: trivially relocatable
+// elements are moved with a single memcpy, or with allocator.reallocate()
+// when the allocator provides it, so the buffer may be extended in place.
+// Other elements are moved with move_if_noexcept, which keeps the strong
+// exception guarantee of push_back.
+template <typename Type, typename Allocator = allocator<Type>>
+class vector
+{
+    static constexpr bool reallocates_in_place =
+        is_trivially_relocatable_v<Type> and
+        detail::has_reallocate_v<Allocator>;
+
+public:
+    using value_type = Type;
+    using allocator_type = Allocator;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = Type&;
+    using const_reference = const Type&;
+    using pointer = Type*;
+    using const_pointer = const Type*;
+    using iterator = Type*;
+    using const_iterator = const Type*;
+
+    static_assert(is_same_v<typename Allocator::value_type, Type>,
+                  "allocator value_type must match the element type");
+
+    vector() noexcept(noexcept(Allocator())) : vector(Allocator())
+    {
+    }
+
+    explicit vector(const Allocator& alloc) noexcept
+        : m_allocator{alloc}, m_begin{nullptr}, m_end{nullptr},
+          m_capacity{nullptr}
+    {
+    }
+
+    explicit vector(size_type count, const Allocator& alloc = Allocator())
+        : vector(alloc)
+    {
+        allocate_exactly(count);
+        m_end = ohmy::uninitialized_value_construct_n(m_begin, count);
+    }
+
+    vector(size_type count, const Type& value,
+           const Allocator& alloc = Allocator())
+        : vector(alloc)
+    {
+        allocate_exactly(count);
+        m_end = ohmy::uninitialized_fill_n(m_begin, count, value);
+    }
+
+    vector(std::initializer_list<Type> values,
+           const Allocator& alloc = Allocator())
+        : vector(alloc)
+    {
+        allocate_exactly(values.size());
+        m_end = ohmy::uninitialized_copy(values.begin(), values.end(), m_begin);
+    }
+
+    vector(const vector& other) : vector(other.m_allocator)
+    {
+        allocate_exactly(other.size());
+        m_end = ohmy::uninitialized_copy(other.cbegin(), other.cend(), m_begin);
+    }
+
+    vector(vector&& other) noexcept
+        : m_allocator{ohmy::move(other.m_allocator)}, m_begin{other.m_begin},
+          m_end{other.m_end}, m_capacity{other.m_capacity}
+    {
+        other.m_begin = other.m_end = other.m_capacity = nullptr;
+    }
+
+    ~vector()
+    {
+        ohmy::destroy(m_begin, m_end);
+        deallocate_storage();
+    }
+
+    vector& operator=(const vector& other)
+    {
+        if (this != ohmy::addressof(other))
+        {
+            vector copy(other.cbegin(), other.cend(), m_allocator);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    vector& operator=(vector&& other) noexcept
+    {
+        if (this != ohmy::addressof(other))
+        {
+            ohmy::destroy(m_begin, m_end);
+            deallocate_storage();
+            m_allocator = ohmy::move(other.m_allocator);
+            m_begin = other.m_begin;
+            m_end = other.m_end;
+            m_capacity = other.m_capacity;
+            other.m_begin = other.m_end = other.m_capacity = nullptr;
+        }
+        return *this;
+    }
+
+    vector& operator=(std::initializer_list<Type> values)
+    {
+        vector copy(values, m_allocator);
+        swap(copy);
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return m_allocator;
+    }
+
+    iterator begin() noexcept
+    {
+        return m_begin;
+    }
+    const_iterator begin() const noexcept
+    {
+        return m_begin;
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return m_begin;
+    }
+    iterator end() noexcept
+    {
+        return m_end;
+    }
+    const_iterator end() const noexcept
+    {
+        return m_end;
+    }
+    const_iterator cend() const noexcept
+    {
+        return m_end;
+    }
+
+    pointer data() noexcept
+    {
+        return m_begin;
+    }
+    const_pointer data() const noexcept
+    {
+        return m_begin;
+    }
+
+    size_type size() const noexcept
+    {
+        return static_cast<size_type>(m_end - m_begin);
+    }
+    size_type capacity() const noexcept
+    {
+        return static_cast<size_type>(m_capacity - m_begin);
+    }
+    size_type max_size() const noexcept
+    {
+        return size_type(-1) / sizeof(Type);
+    }
+    bool empty() const noexcept
+    {
+        return m_begin == m_end;
+    }
+
+    reference operator[](size_type pos)
+    {
+        return m_begin[pos];
+    }
+    const_reference operator[](size_type pos) const
+    {
+        return m_begin[pos];
+    }
+
+    reference at(size_type pos)
+    {
+        if (pos >= size())
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+        return m_begin[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range(__PRETTY_FUNCTION__);
+        return m_begin[pos];
+    }
+
+    reference front()
+    {
+        return *m_begin;
+    }
+    const_reference front() const
+    {
+        return *m_begin;
+    }
+    reference back()
+    {
+        return *(m_end - 1);
+    }
+    const_reference back() const
+    {
+        return *(m_end - 1);
+    }
+
+    void reserve(size_type new_capacity)
+    {
+        if (new_capacity > capacity())
+        {
+            reallocate_storage(new_capacity);
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        if (empty())
+        {
+            deallocate_storage();
+            m_begin = m_end = m_capacity = nullptr;
+        }
+        else if (m_end != m_capacity)
+        {
+            reallocate_storage(size());
+        }
+    }
+
+    void clear() noexcept
+    {
+        ohmy::destroy(m_begin, m_end);
+        m_end = m_begin;
+    }
+
+    void resize(size_type count)
+    {
+        if (count <= size())
+        {
+            erase(m_begin + count, m_end);
+            return;
+        }
+        if (count > capacity())
+        {
+            reserve(grown_capacity(count));
+        }
+        m_end = ohmy::uninitialized_value_construct_n(m_end, count - size());
+    }
+
+    void resize(size_type count, const Type& value)
+    {
+        if (count <= size())
+        {
+            erase(m_begin + count, m_end);
+            return;
+        }
+        if (count > capacity())
+        {
+            // value may live in the buffer that is about to be released.
+            const Type copy(value);
+            reserve(grown_capacity(count));
+            m_end = ohmy::uninitialized_fill_n(m_end, count - size(), copy);
+            return;
+        }
+        m_end = ohmy::uninitialized_fill_n(m_end, count - size(), value);
+    }
+
+    void push_back(const Type& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(Type&& value)
+    {
+        emplace_back(ohmy::move(value));
+    }
+
+    template <typename... ArgumentTypes>
+    reference emplace_back(ArgumentTypes&&... arguments)
+    {
+        if (m_end != m_capacity)
+        {
+            ohmy::construct_at(m_end,
+                               ohmy::forward<ArgumentTypes>(arguments)...);
+            return *m_end++;
+        }
+        return grow_and_emplace_back(
+            ohmy::forward<ArgumentTypes>(arguments)...);
+    }
+
+    void pop_back() noexcept
+    {
+        ohmy::destroy_at(--m_end);
+    }
+
+    iterator insert(const_iterator pos, const Type& value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, Type&& value)
+    {
+        return emplace(pos, ohmy::move(value));
+    }
+
+    template <typename... ArgumentTypes>
+    iterator emplace(const_iterator pos, ArgumentTypes&&... arguments)
+    {
+        const auto index = static_cast<size_type>(pos - m_begin);
+        if (m_end == m_capacity)
+        {
+            return grow_and_emplace(index,
+                                    ohmy::forward<ArgumentTypes>(arguments)...);
+        }
+
+        iterator position = m_begin + index;
+        if (position == m_end)
+        {
+            ohmy::construct_at(m_end,
+                               ohmy::forward<ArgumentTypes>(arguments)...);
+            ++m_end;
+            return position;
+        }
+
+        if constexpr (is_trivially_relocatable_v<Type>)
+        {
+            // Build the new element before shifting: the arguments may refer
+            // to elements that are about to move.
+            detail::relocation_buffer<Type> value(
+                ohmy::forward<ArgumentTypes>(arguments)...);
+            ohmy::uninitialized_relocate(position, m_end, position + 1);
+            ohmy::relocate_at(value.release(), position);
+            ++m_end;
+        }
+        else
+        {
+            Type value(ohmy::forward<ArgumentTypes>(arguments)...);
+            ohmy::construct_at(m_end, ohmy::move(*(m_end - 1)));
+            ++m_end;
+            for (iterator it = m_end - 2; it != position; --it)
+            {
+                *it = ohmy::move(*(it - 1));
+            }
+            *position = ohmy::move(value);
+        }
+        return position;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator begin = m_begin + (first - m_begin);
+        iterator end = m_begin + (last - m_begin);
+        if (begin == end)
+        {
+            return begin;
+        }
+
+        if constexpr (is_trivially_relocatable_v<Type>)
+        {
+            ohmy::destroy(begin, end);
+            ohmy::uninitialized_relocate(end, m_end, begin);
+            m_end -= (end - begin);
+        }
+        else
+        {
+            iterator new_end = begin;
+            for (iterator it = end; it != m_end; ++it, ++new_end)
+            {
+                *new_end = ohmy::move(*it);
+            }
+            ohmy::destroy(new_end, m_end);
+            m_end = new_end;
+        }
+        return begin;
+    }
+
+    void swap(vector& other) noexcept
+    {
+        ohmy::swap(m_allocator, other.m_allocator);
+        ohmy::swap(m_begin, other.m_begin);
+        ohmy::swap(m_end, other.m_end);
+        ohmy::swap(m_capacity, other.m_capacity);
+    }
+
+private:
+    vector(const_iterator first, const_iterator last, const Allocator& alloc)
+        : vector(alloc)
+    {
+        allocate_exactly(static_cast<size_type>(last - first));
+        m_end = ohmy::uninitialized_copy(first, last, m_begin);
+    }
+
+    size_type grown_capacity(size_type required) const
+    {
+        if (required > max_size())
+            throw std::length_error(__PRETTY_FUNCTION__);
+
+        const size_type current = capacity();
+        if (current >= max_size() / 2)
+            return max_size();
+
+        const size_type doubled = current != 0 ? 2 * current : 1;
+        return doubled < required ? required : doubled;
+    }
+
+    void allocate_exactly(size_type count)
+    {
+        if (count != 0)
+        {
+            m_begin = m_end = m_allocator.allocate(count);
+            m_capacity = m_begin + count;
+        }
+    }
+
+    void deallocate_storage() noexcept
+    {
+        if (m_begin != nullptr)
+        {
+            m_allocator.deallocate(m_begin, capacity());
+        }
+    }
+
+    void reallocate_storage(size_type new_capacity)
+    {
+        const size_type count = size();
+        if constexpr (reallocates_in_place)
+        {
+            if (m_begin != nullptr)
+            {
+                m_begin =
+                    m_allocator.reallocate(m_begin, capacity(), new_capacity);
+                m_end = m_begin + count;
+                m_capacity = m_begin + new_capacity;
+                return;
+            }
+        }
+
+        pointer new_begin = m_allocator.allocate(new_capacity);
+        try
+        {
+            ohmy::uninitialized_relocate(m_begin, m_end, new_begin);
+        }
+        catch (...)
+        {
+            m_allocator.deallocate(new_begin, new_capacity);
+            throw;
+        }
+        deallocate_storage();
+        m_begin = new_begin;
+        m_end = new_begin + count;
+        m_capacity = new_begin + new_capacity;
+    }
+
+    template <typename... ArgumentTypes>
+    reference grow_and_emplace_back(ArgumentTypes&&... arguments)
+    {
+        const size_type new_capacity = grown_capacity(size() + 1);
+
+        if constexpr (reallocates_in_place)
+        {
+            // realloc releases the old buffer, which the arguments may point
+            // into, so the element has to exist before the buffer moves.
+            detail::relocation_buffer<Type> value(
+                ohmy::forward<ArgumentTypes>(arguments)...);
+            reallocate_storage(new_capacity);
+            ohmy::relocate_at(value.release(), m_end);
+            return *m_end++;
+        }
+        else
+        {
+            return *grow_and_emplace(
+                size(), ohmy::forward<ArgumentTypes>(arguments)...);
+        }
+    }
+
+    template <typename... ArgumentTypes>
+    iterator grow_and_emplace(size_type index, ArgumentTypes&&... arguments)
+    {
+        const size_type count = size();
+        const size_type new_capacity = grown_capacity(count + 1);
+        pointer new_begin = m_allocator.allocate(new_capacity);
+        pointer position = new_begin + index;
+
+        try
+        {
+            ohmy::construct_at(position,
+                               ohmy::forward<ArgumentTypes>(arguments)...);
+        }
+        catch (...)
+        {
+            m_allocator.deallocate(new_begin, new_capacity);
+            throw;
+        }
+
+        if constexpr (is_nothrow_relocatable_v<Type>)
+        {
+            ohmy::uninitialized_relocate(m_begin, m_begin + index, new_begin);
+            ohmy::uninitialized_relocate(m_begin + index, m_end, position + 1);
+        }
+        else
+        {
+            pointer prefix_end = new_begin;
+            try
+            {
+                prefix_end = detail::uninitialized_move_if_noexcept(
+                    m_begin, m_begin + index, new_begin);
+                detail::uninitialized_move_if_noexcept(m_begin + index, m_end,
+                                                       position + 1);
+            }
+            catch (...)
+            {
+                ohmy::destroy(new_begin, prefix_end);
+                ohmy::destroy_at(position);
+                m_allocator.deallocate(new_begin, new_capacity);
+                throw;
+            }
+            ohmy::destroy(m_begin, m_end);
+        }
+
+        deallocate_storage();
+        m_begin = new_begin;
+        m_end = new_begin + count + 1;
+        m_capacity = new_begin + new_capacity;
+        return position;
+    }
+
+    [[no_unique_address]] Allocator m_allocator;
+    pointer m_begin;
+    pointer m_end;
+    pointer m_capacity;
+};
+
+template <typename Type, typename Allocator>
+bool operator==(const vector<Type, Allocator>& lhs,
+                const vector<Type, Allocator>& rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        if (not(lhs[i] == rhs[i]))
+            return false;
+    }
+    return true;
+}
+
+template <typename Type, typename Allocator>
+bool operator!=(const vector<Type, Allocator>& lhs,
+                const vector<Type, Allocator>& rhs)
+{
+    return not(lhs == rhs);
+}
+
+template <typename Type, typename Allocator>
+void swap(vector<Type, Allocator>& lhs, vector<Type, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+} // namespace ohmy
+
+#endif // OHMY_VECTOR_HPP
@@ -0,0 +1,303 @@
+#include <catch/catch.hpp>
+
+#include "vector.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Bump allocator over a caller-provided buffer; deallocation is a no-op.
+struct Arena
+{
+    unsigned char* buffer;
+    std::size_t capacity;
+    std::size_t used = 0;
+    std::size_t allocations = 0;
+};
+
+template <typename Type>
+struct arena_allocator
+{
+    using value_type = Type;
+
+    explicit arena_allocator(Arena& arena) : arena{&arena}
+    {
+    }
+
+    Type* allocate(std::size_t count)
+    {
+        auto offset = (arena->used + alignof(Type) - 1) & ~(alignof(Type) - 1);
+        if (offset + count * sizeof(Type) > arena->capacity)
+            throw std::bad_alloc{};
+
+        arena->used = offset + count * sizeof(Type);
+        ++arena->allocations;
+        return reinterpret_cast<Type*>(arena->buffer + offset);
+    }
+
+    void deallocate(Type*, std::size_t)
+    {
+    }
+
+    Arena* arena;
+};
+
+struct Counted
+{
+    static int live;
+
+    Counted(int v) : value{v}
+    {
+        ++live;
+    }
+    Counted(const Counted& other) : value{other.value}
+    {
+        ++live;
+    }
+    Counted(Counted&& other) noexcept : value{other.value}
+    {
+        ++live;
+    }
+    Counted& operator=(const Counted&) = default;
+    Counted& operator=(Counted&&) = default;
+    ~Counted()
+    {
+        --live;
+    }
+
+    bool operator==(const Counted& other) const
+    {
+        return value == other.value;
+    }
+
+    int value;
+};
+
+int Counted::live = 0;
+} // namespace
+
+static_assert(sizeof(ohmy::vector<int>) == 3 * sizeof(int*));
+
+TEST_CASE("vector construction")
+{
+    SECTION("default-constructed vector is empty and does not allocate")
+    {
+        ohmy::vector<int> v;
+
+        REQUIRE(v.empty());
+        REQUIRE(v.size() == 0u);
+        REQUIRE(v.capacity() == 0u);
+        REQUIRE(v.data() == nullptr);
+    }
+
+    SECTION("count and value constructors")
+    {
+        ohmy::vector<int> zeros(4);
+        ohmy::vector<int> sevens(3, 7);
+
+        REQUIRE(zeros == ohmy::vector<int>{0, 0, 0, 0});
+        REQUIRE(sevens == ohmy::vector<int>{7, 7, 7});
+    }
+
+    SECTION("copy and move")
+    {
+        ohmy::vector<std::string> a{"one", "two", "three"};
+        ohmy::vector<std::string> b{a};
+        REQUIRE(a == b);
+
+        ohmy::vector<std::string> c{ohmy::move(a)};
+        REQUIRE(a.empty());
+        REQUIRE(c == b);
+
+        a = c;
+        REQUIRE(a == c);
+        b = ohmy::move(c);
+        REQUIRE(c.empty());
+        REQUIRE(a == b);
+    }
+}
+
+TEST_CASE("vector growth")
+{
+    SECTION("push_back keeps elements in order across regrowth")
+    {
+        ohmy::vector<int> v;
+        for (int i = 0; i < 1000; ++i)
+        {
+            v.push_back(i);
+        }
+
+        REQUIRE(v.size() == 1000u);
+        REQUIRE(v.capacity() >= 1000u);
+        for (int i = 0; i < 1000; ++i)
+        {
+            REQUIRE(v[i] == i);
+        }
+    }
+
+    SECTION("unique_ptr elements survive relocation")
+    {
+        ohmy::vector<ohmy::unique_ptr<int>> v;
+        for (int i = 0; i < 100; ++i)
+        {
+            v.emplace_back(new int{i});
+        }
+        v.shrink_to_fit();
+
+        REQUIRE(v.size() == v.capacity());
+        for (int i = 0; i < 100; ++i)
+        {
+            REQUIRE(*v[i] == i);
+        }
+    }
+
+    SECTION("pushing an element of the vector itself is safe")
+    {
+        ohmy::vector<std::string> v{"self"};
+        for (int i = 0; i < 10; ++i)
+        {
+            v.push_back(v.front());
+        }
+
+        REQUIRE(v.size() == 11u);
+        REQUIRE(v.back() == "self");
+
+        ohmy::vector<int> w{42};
+        for (int i = 0; i < 10; ++i)
+        {
+            w.push_back(w.front());
+        }
+        REQUIRE(w.back() == 42);
+    }
+
+    SECTION("non-relocatable elements are moved and destroyed exactly once")
+    {
+        Counted::live = 0;
+        {
+            ohmy::vector<Counted> v;
+            for (int i = 0; i < 50; ++i)
+            {
+                v.emplace_back(i);
+            }
+            REQUIRE(Counted::live == 50);
+        }
+        REQUIRE(Counted::live == 0);
+    }
+
+    SECTION("resize value-initializes and truncates")
+    {
+        ohmy::vector<int> v{1, 2};
+        v.resize(5);
+        REQUIRE(v == ohmy::vector<int>{1, 2, 0, 0, 0});
+        v.resize(1);
+        REQUIRE(v == ohmy::vector<int>{1});
+        v.resize(3, v.front());
+        REQUIRE(v == ohmy::vector<int>{1, 1, 1});
+    }
+}
+
+TEST_CASE("vector insert and erase")
+{
+    SECTION("trivially relocatable elements")
+    {
+        ohmy::vector<int> v{1, 2, 4};
+        v.insert(v.begin() + 2, 3);
+        v.insert(v.begin(), 0);
+        v.insert(v.end(), 5);
+        REQUIRE(v == ohmy::vector<int>{0, 1, 2, 3, 4, 5});
+
+        v.erase(v.begin() + 1, v.begin() + 3);
+        REQUIRE(v == ohmy::vector<int>{0, 3, 4, 5});
+        v.erase(v.begin());
+        REQUIRE(v == ohmy::vector<int>{3, 4, 5});
+    }
+
+    SECTION("non-relocatable elements")
+    {
+        Counted::live = 0;
+        {
+            ohmy::vector<Counted> v{1, 2, 4};
+            v.reserve(8);
+            v.insert(v.begin() + 2, Counted{3});
+            v.insert(v.begin(), v.back());
+            REQUIRE(v == ohmy::vector<Counted>{4, 1, 2, 3, 4});
+
+            v.erase(v.begin(), v.begin() + 2);
+            REQUIRE(v == ohmy::vector<Counted>{2, 3, 4});
+            REQUIRE(Counted::live == 3);
+        }
+        REQUIRE(Counted::live == 0);
+    }
+
+    SECTION("at checks bounds")
+    {
+        ohmy::vector<int> v{1};
+        REQUIRE(v.at(0) == 1);
+        REQUIRE_THROWS_AS(v.at(1), std::out_of_range);
+    }
+}
+
+TEST_CASE("vector with an arena allocator")
+{
+    alignas(std::max_align_t) unsigned char buffer[4096];
+    Arena arena{buffer, sizeof(buffer)};
+
+    ohmy::vector<int, arena_allocator<int>> v{arena_allocator<int>{arena}};
+    for (int i = 0; i < 100; ++i)
+    {
+        v.push_back(i);
+    }
+
+    REQUIRE(v.size() == 100u);
+    REQUIRE(v[99] == 99);
+    REQUIRE(arena.allocations > 0u);
+    REQUIRE(reinterpret_cast<unsigned char*>(v.data()) >= buffer);
+    REQUIRE(reinterpret_cast<unsigned char*>(v.data()) < buffer + sizeof(buffer));
+}
+
+TEST_CASE("vector benchmarks", "[.benchmark]")
+{
+    constexpr int count = 1 << 20;
+
+    BENCHMARK("std::vector<int> push_back")
+    {
+        std::vector<int> v;
+        for (int i = 0; i < count; ++i)
+        {
+            v.push_back(i);
+        }
+        REQUIRE(v.size() == static_cast<std::size_t>(count));
+    }
+
+    BENCHMARK("ohmy::vector<int> push_back")
+    {
+        ohmy::vector<int> v;
+        for (int i = 0; i < count; ++i)
+        {
+            v.push_back(i);
+        }
+        REQUIRE(v.size() == static_cast<std::size_t>(count));
+    }
+
+    std::vector<std::unique_ptr<int>> std_pointers;
+    ohmy::vector<ohmy::unique_ptr<int>> ohmy_pointers;
+    for (int i = 0; i < count; ++i)
+    {
+        std_pointers.emplace_back(new int{i});
+        ohmy_pointers.emplace_back(new int{i});
+    }
+
+    BENCHMARK("std::vector<std::unique_ptr<int>> regrow")
+    {
+        std_pointers.shrink_to_fit();
+        std_pointers.reserve(2 * std_pointers.size());
+    }
+
+    BENCHMARK("ohmy::vector<ohmy::unique_ptr<int>> regrow")
+    {
+        ohmy_pointers.shrink_to_fit();
+        ohmy_pointers.reserve(2 * ohmy_pointers.size());
+    }
+}